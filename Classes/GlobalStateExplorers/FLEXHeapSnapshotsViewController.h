@@ -0,0 +1,29 @@
+//
+//  FLEXHeapSnapshotsViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+
+@class FLEXHeapCensusSnapshot;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Lists the snapshots in \c FLEXHeapSnapshotStore.sharedStore, and compares them
+/// by the change in instance count and size of each class, sortable by either.
+@interface FLEXHeapSnapshotsViewController : FLEXTableViewController
+
+/// Lists every snapshot; tap one to compare it with another
++ (instancetype)snapshotsViewController;
+/// The classes that changed between two snapshots
++ (instancetype)diffViewControllerFromSnapshot:(FLEXHeapCensusSnapshot *)before
+                                    toSnapshot:(FLEXHeapCensusSnapshot *)after;
+/// The classes that grew with every one of the given snapshots, oldest first
++ (instancetype)growthViewControllerForSnapshots:(NSArray<FLEXHeapCensusSnapshot *> *)snapshots;
+
+@end
+
+NS_ASSUME_NONNULL_END
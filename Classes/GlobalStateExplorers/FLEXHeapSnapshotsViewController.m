@@ -0,0 +1,316 @@
+//
+//  FLEXHeapSnapshotsViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapSnapshotsViewController.h"
+#import "FLEXHeapSnapshotStore.h"
+#import "FLEXObjectListViewController.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXUtility.h"
+#import "NSDateFormatter+FLEX.h"
+#import "UIBarButtonItem+FLEX.h"
+
+typedef NS_ENUM(NSUInteger, FLEXHeapDeltaSort) {
+    FLEXHeapDeltaSortCount,
+    FLEXHeapDeltaSortBytes,
+    FLEXHeapDeltaSortName,
+    FLEXHeapDeltaSortAll
+};
+
+@interface FLEXHeapSnapshotsViewController ()
+/// \c nil when listing snapshots
+@property (nonatomic, readonly, nullable) NSArray<FLEXHeapClassDelta *> *allDeltas;
+/// For growth, the number of times the heap was expected to grow
+@property (nonatomic, readonly) NSUInteger steps;
+@property (nonatomic) FLEXHeapDeltaSort sort;
+/// Sorted and filtered by the search text
+@property (nonatomic, copy) NSArray<FLEXHeapClassDelta *> *deltas;
+@property (nonatomic, copy) NSArray<FLEXHeapCensusSnapshot *> *snapshots;
+@end
+
+@implementation FLEXHeapSnapshotsViewController
+
++ (instancetype)snapshotsViewController {
+    FLEXHeapSnapshotsViewController *controller = [self new];
+    controller.title = @"Heap Snapshots";
+    return controller;
+}
+
++ (instancetype)diffViewControllerFromSnapshot:(FLEXHeapCensusSnapshot *)before
+                                    toSnapshot:(FLEXHeapCensusSnapshot *)after {
+    FLEXHeapSnapshotsViewController *controller = [self new];
+    controller->_allDeltas = [FLEXHeapSnapshotStore.sharedStore diffFromSnapshot:before toSnapshot:after];
+    controller.title = [NSString stringWithFormat:@"%@ → %@", before.name, after.name];
+    return controller;
+}
+
++ (instancetype)growthViewControllerForSnapshots:(NSArray<FLEXHeapCensusSnapshot *> *)snapshots {
+    FLEXHeapSnapshotsViewController *controller = [self new];
+    controller->_allDeltas = [FLEXHeapSnapshotStore.sharedStore monotonicGrowersInSnapshots:snapshots];
+    controller->_steps = snapshots.count - 1;
+    controller.title = @"Growing Classes";
+    return controller;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStylePlain];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    if (self.allDeltas) {
+        self.showsSearchBar = YES;
+        self.sort = FLEXHeapDeltaSortCount;
+        [self addToolbarItems:@[
+            [UIBarButtonItem flex_itemWithTitle:@"Sort" target:self action:@selector(sortButtonTapped:)],
+        ]];
+        [self reloadDeltas];
+    } else {
+        [self addToolbarItems:@[
+            [UIBarButtonItem
+                flex_itemWithImage:[UIImage systemImageNamed:@"camera"]
+                target:self
+                action:@selector(captureButtonTapped:)
+            ],
+            [UIBarButtonItem flex_itemWithTitle:@"Growth" target:self action:@selector(growthButtonTapped:)],
+            [UIBarButtonItem
+                flex_systemItem:UIBarButtonSystemItemTrash
+                target:self
+                action:@selector(trashButtonTapped:)
+            ],
+        ]];
+    }
+}
+
+- (void)viewWillAppear:(BOOL)animated {
+    [super viewWillAppear:animated];
+
+    if (!self.allDeltas) {
+        self.snapshots = FLEXHeapSnapshotStore.sharedStore.snapshots;
+        [self.tableView reloadData];
+    }
+}
+
+#pragma mark Snapshots
+
+- (void)captureButtonTapped:(UIBarButtonItem *)sender {
+    NSUInteger number = self.snapshots.count + 1;
+    [FLEXAlert makeAlert:^(FLEXAlert *make) {
+        make.title(@"Capture Snapshot");
+        make.configuredTextField(^(UITextField *field) {
+            field.placeholder = @"Name";
+            field.text = [NSString stringWithFormat:@"Snapshot %@", @(number)];
+        });
+        make.button(@"Capture").handler(^(NSArray<NSString *> *strings) {
+            NSString *name = strings[0].length ? strings[0] : [NSString stringWithFormat:@"Snapshot %@", @(number)];
+            [FLEXHeapSnapshotStore.sharedStore captureSnapshotNamed:name completion:^(FLEXHeapCensusSnapshot *snapshot) {
+                self.snapshots = FLEXHeapSnapshotStore.sharedStore.snapshots;
+                [self.tableView reloadData];
+            }];
+        });
+        make.button(@"Cancel").cancelStyle();
+    } showFrom:self];
+}
+
+- (void)growthButtonTapped:(UIBarButtonItem *)sender {
+    if (self.snapshots.count < 3) {
+        [FLEXAlert showAlert:@"Not Enough Snapshots"
+            message:@"Capture a snapshot, repeat an action you suspect of leaking, and capture "
+            "another snapshot after each repetition. Classes that grow every time are listed."
+            from:self
+        ];
+        return;
+    }
+
+    UIViewController *growth = [[self class] growthViewControllerForSnapshots:self.snapshots];
+    [self.navigationController pushViewController:growth animated:YES];
+}
+
+- (void)trashButtonTapped:(UIBarButtonItem *)sender {
+    [FLEXAlert makeSheet:^(FLEXAlert *make) {
+        make.title(@"Delete All Snapshots?");
+        make.button(@"Delete All").destructiveStyle().handler(^(NSArray<NSString *> *strings) {
+            [FLEXHeapSnapshotStore.sharedStore removeAllSnapshots];
+            self.snapshots = @[];
+            [self.tableView reloadData];
+        });
+        make.button(@"Cancel").cancelStyle();
+    } showFrom:self source:sender];
+}
+
+- (void)compareSnapshotAtIndex:(NSUInteger)index {
+    FLEXHeapCensusSnapshot *selected = self.snapshots[index];
+    [FLEXAlert makeSheet:^(FLEXAlert *make) {
+        make.title([NSString stringWithFormat:@"Compare %@ With", selected.name]);
+        [self.snapshots enumerateObjectsUsingBlock:^(FLEXHeapCensusSnapshot *other, NSUInteger i, BOOL *stop) {
+            if (i == index) {
+                return;
+            }
+
+            make.button(other.name).handler(^(NSArray<NSString *> *strings) {
+                // Always from the older snapshot to the newer one
+                FLEXHeapCensusSnapshot *before = i < index ? other : selected;
+                FLEXHeapCensusSnapshot *after = i < index ? selected : other;
+                UIViewController *diff = [[self class] diffViewControllerFromSnapshot:before toSnapshot:after];
+                [self.navigationController pushViewController:diff animated:YES];
+            });
+        }];
+        make.button(@"Cancel").cancelStyle();
+    } showFrom:self source:[self.tableView cellForRowAtIndexPath:[NSIndexPath indexPathForRow:index inSection:0]]];
+}
+
+#pragma mark Deltas
+
++ (NSString *)titleForSort:(FLEXHeapDeltaSort)sort {
+    switch (sort) {
+        case FLEXHeapDeltaSortCount: return @"Count Change";
+        case FLEXHeapDeltaSortBytes: return @"Size Change";
+        case FLEXHeapDeltaSortName: return @"Name";
+        case FLEXHeapDeltaSortAll: break;
+    }
+
+    return nil;
+}
+
+- (void)reloadDeltas {
+    NSArray<FLEXHeapClassDelta *> *deltas = self.allDeltas;
+    NSString *filter = self.searchText;
+    if (filter.length) {
+        deltas = [deltas flex_filtered:^BOOL(FLEXHeapClassDelta *delta, NSUInteger idx) {
+            return [delta.className localizedCaseInsensitiveContainsString:filter];
+        }];
+    }
+
+    FLEXHeapDeltaSort sort = self.sort;
+    self.deltas = [deltas sortedArrayUsingComparator:^NSComparisonResult(FLEXHeapClassDelta *a, FLEXHeapClassDelta *b) {
+        // Largest growth first
+        int64_t x = sort == FLEXHeapDeltaSortBytes ? a.bytesDelta : a.countDelta;
+        int64_t y = sort == FLEXHeapDeltaSortBytes ? b.bytesDelta : b.countDelta;
+        if (sort != FLEXHeapDeltaSortName && x != y) {
+            return x > y ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return [a.className caseInsensitiveCompare:b.className];
+    }];
+
+    [self.tableView reloadData];
+}
+
+- (void)sortButtonTapped:(UIBarButtonItem *)sender {
+    [FLEXAlert makeSheet:^(FLEXAlert *make) {
+        make.title(@"Sort By");
+        for (FLEXHeapDeltaSort sort = 0; sort < FLEXHeapDeltaSortAll; sort++) {
+            NSString *title = [[self class] titleForSort:sort];
+            if (sort == self.sort) {
+                title = [title stringByAppendingString:@" ✓"];
+            }
+
+            make.button(title).handler(^(NSArray<NSString *> *strings) {
+                self.sort = sort;
+                [self reloadDeltas];
+            });
+        }
+        make.button(@"Cancel").cancelStyle();
+    } showFrom:self source:sender];
+}
+
+- (void)updateSearchResults:(NSString *)newText {
+    if (self.allDeltas) {
+        [self reloadDeltas];
+    }
+}
+
+#pragma mark Formatting
+
++ (NSString *)stringFromByteDelta:(int64_t)delta {
+    NSString *bytes = [NSByteCountFormatter stringFromByteCount:llabs(delta) countStyle:NSByteCountFormatterCountStyleFile];
+    return [NSString stringWithFormat:@"%@%@", delta < 0 ? @"−" : @"+", bytes];
+}
+
+- (NSString *)summaryOfDelta:(FLEXHeapClassDelta *)delta {
+    NSString *summary = [NSString stringWithFormat:@"%+lld instances, %@ · %@ → %@",
+        delta.countDelta, [[self class] stringFromByteDelta:delta.bytesDelta],
+        @(delta.countBefore), @(delta.countAfter)
+    ];
+
+    if (self.steps) {
+        summary = [summary stringByAppendingFormat:@" · %.1f per step", (double)delta.countDelta / self.steps];
+    }
+
+    return summary;
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return self.allDeltas ? self.deltas.count : self.snapshots.count;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
+    if (self.allDeltas) {
+        return [NSString stringWithFormat:@"%@ classes by %@", @(self.deltas.count), [[self class] titleForSort:self.sort]];
+    }
+
+    return self.snapshots.count ? nil : @"Capture snapshots before and after something "
+        "you suspect of leaking, then tap one to compare it with another.";
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDetailCell forIndexPath:indexPath];
+    cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+
+    if (self.allDeltas) {
+        FLEXHeapClassDelta *delta = self.deltas[indexPath.row];
+        cell.titleLabel.text = delta.className;
+        cell.subtitleLabel.text = [self summaryOfDelta:delta];
+        return cell;
+    }
+
+    FLEXHeapCensusSnapshot *snapshot = self.snapshots[indexPath.row];
+    cell.titleLabel.text = snapshot.name;
+    cell.subtitleLabel.text = [NSString stringWithFormat:@"%@ · %@ objects, %@",
+        [NSDateFormatter flex_stringFrom:snapshot.date format:FLEXDateFormatPreciseClock],
+        @(snapshot.objectCount),
+        [NSByteCountFormatter stringFromByteCount:snapshot.byteCount countStyle:NSByteCountFormatterCountStyleFile]
+    ];
+
+    return cell;
+}
+
+- (BOOL)tableView:(UITableView *)tableView canEditRowAtIndexPath:(NSIndexPath *)indexPath {
+    return !self.allDeltas;
+}
+
+- (void)tableView:(UITableView *)tableView commitEditingStyle:(UITableViewCellEditingStyle)style
+forRowAtIndexPath:(NSIndexPath *)indexPath {
+    NSParameterAssert(style == UITableViewCellEditingStyleDelete);
+
+    [FLEXHeapSnapshotStore.sharedStore removeSnapshot:self.snapshots[indexPath.row]];
+    self.snapshots = FLEXHeapSnapshotStore.sharedStore.snapshots;
+    [tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationAutomatic];
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    if (!self.allDeltas) {
+        [tableView deselectRowAtIndexPath:indexPath animated:YES];
+        if (self.snapshots.count < 2) {
+            [FLEXAlert showQuickAlert:@"Capture another snapshot to compare this one with" from:self];
+            return;
+        }
+
+        [self compareSnapshotAtIndex:indexPath.row];
+        return;
+    }
+
+    NSString *className = self.deltas[indexPath.row].className;
+    UIViewController *instances = [FLEXObjectListViewController instancesOfClassWithName:className retained:YES];
+    [self.navigationController pushViewController:instances animated:YES];
+}
+
+@end
@@ -0,0 +1,23 @@
+//
+//  FLEXJSONViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+@class FLEXJSONDocument;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Shows a JSON document one pretty-printed line per row. Only the visible rows are ever
+/// formatted, so large documents open quickly. Tap a line that opens an object or array
+/// to collapse or expand it.
+@interface FLEXJSONViewController : FLEXTableViewController
+
++ (instancetype)viewerWithDocument:(FLEXJSONDocument *)document;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,130 @@
+//
+//  FLEXJSONViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXJSONViewController.h"
+#import "FLEXJSONDocument.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXActivityViewController.h"
+#import "UIFont+FLEX.h"
+
+@interface FLEXJSONViewController ()
+@property (nonatomic, readonly) FLEXJSONDocument *document;
+/// Lines that open an object or array whose contents are hidden
+@property (nonatomic, readonly) NSMutableIndexSet *collapsedLines;
+/// The uint32_t line shown in each row, or \c nil when nothing is collapsed
+@property (nonatomic) NSData *rowLines;
+@end
+
+@implementation FLEXJSONViewController
+
++ (instancetype)viewerWithDocument:(FLEXJSONDocument *)document {
+    FLEXJSONViewController *viewer = [self new];
+    viewer->_document = document;
+    viewer->_collapsedLines = [NSMutableIndexSet new];
+    return viewer;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStylePlain];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    self.showsShareToolbarItem = YES;
+    self.tableView.separatorStyle = UITableViewCellSeparatorStyleNone;
+    self.tableView.rowHeight = UITableViewAutomaticDimension;
+    self.tableView.estimatedRowHeight = 24;
+}
+
+- (void)shareButtonPressed:(UIBarButtonItem *)sender {
+    FLEXJSONDocument *document = self.document;
+    [self onBackgroundQueue:^NSArray *{
+        return @[document.prettyString];
+    } thenOnMainQueue:^(NSArray *items) {
+        [self presentViewController:[FLEXActivityViewController sharing:items source:sender]
+            animated:YES completion:nil
+        ];
+    }];
+}
+
+#pragma mark Rows
+
+- (NSUInteger)lineAtRow:(NSInteger)row {
+    return self.rowLines ? ((const uint32_t *)self.rowLines.bytes)[row] : row;
+}
+
+- (void)appendLinesInRange:(NSRange)range to:(NSMutableData *)rows {
+    for (uint32_t line = (uint32_t)range.location; line < NSMaxRange(range); line++) {
+        [rows appendBytes:&line length:sizeof(line)];
+    }
+}
+
+/// Skips the contents of every collapsed line, except those nested inside another collapsed line
+- (void)updateRowLines {
+    if (!self.collapsedLines.count) {
+        self.rowLines = nil;
+        return;
+    }
+
+    NSMutableData *rows = [NSMutableData new];
+    __block NSUInteger next = 0;
+    [self.collapsedLines enumerateIndexesUsingBlock:^(NSUInteger line, BOOL *stop) {
+        if (line < next) {
+            return;
+        }
+
+        [self appendLinesInRange:NSMakeRange(next, line + 1 - next) to:rows];
+        next = [self.document closingLineOfLine:line] + 1;
+    }];
+    [self appendLinesInRange:NSMakeRange(next, self.document.lineCount - next) to:rows];
+
+    self.rowLines = rows;
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return self.rowLines ? self.rowLines.length / sizeof(uint32_t) : self.document.lineCount;
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDefaultCell forIndexPath:indexPath];
+    NSUInteger line = [self lineAtRow:indexPath.row];
+    BOOL collapsible = [self.document closingLineOfLine:line] != NSNotFound;
+
+    cell.titleLabel.font = UIFont.flex_codeFont;
+    cell.titleLabel.numberOfLines = 0;
+    cell.titleLabel.lineBreakMode = NSLineBreakByCharWrapping;
+    cell.titleLabel.text = [self.document textOfLine:line collapsed:[self.collapsedLines containsIndex:line]];
+    cell.selectionStyle = collapsible ? UITableViewCellSelectionStyleDefault : UITableViewCellSelectionStyleNone;
+
+    return cell;
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    [tableView deselectRowAtIndexPath:indexPath animated:YES];
+
+    NSUInteger line = [self lineAtRow:indexPath.row];
+    if ([self.document closingLineOfLine:line] == NSNotFound) {
+        return;
+    }
+
+    if ([self.collapsedLines containsIndex:line]) {
+        [self.collapsedLines removeIndex:line];
+    } else {
+        [self.collapsedLines addIndex:line];
+    }
+
+    [self updateRowLines];
+    [tableView reloadData];
+}
+
+@end
@@ -7,11 +7,17 @@
 //
 
 #import "FLEXLiveObjectsController.h"
-#import "FLEXHeapEnumerator.h"
+#import "FLEXActivityViewController.h"
+#import "FLEXHeapCensus.h"
+#import "FLEXHeapDumpExporter.h"
+#import "FLEXHeapReferenceIndex.h"
+#import "FLEXHeapSnapshotsViewController.h"
 #import "FLEXObjectListViewController.h"
+#import "FLEXRetainCyclesViewController.h"
 #import "FLEXUtility.h"
 #import "FLEXScopeCarousel.h"
 #import "FLEXTableView.h"
+#import "UIBarButtonItem+FLEX.h"
 #import <objc/runtime.h>
 
 static const NSInteger kFLEXLiveObjectsSortAlphabeticallyIndex = 0;
@@ -21,7 +27,8 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
 @interface FLEXLiveObjectsController ()
 
 @property (nonatomic) NSDictionary<NSString *, NSNumber *> *instanceCountsForClassNames;
-@property (nonatomic) NSDictionary<NSString *, NSNumber *> *instanceSizesForClassNames;
+/// The total malloc size of the instances of each class
+@property (nonatomic) NSDictionary<NSString *, NSNumber *> *instanceBytesForClassNames;
 @property (nonatomic, readonly) NSArray<NSString *> *allClassNames;
 @property (nonatomic) NSArray<NSString *> *filteredClassNames;
 @property (nonatomic) NSString *headerTitle;
@@ -42,6 +49,21 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
     
     self.refreshControl = [UIRefreshControl new];
     [self.refreshControl addTarget:self action:@selector(refreshControlDidRefresh:) forControlEvents:UIControlEventValueChanged];
+
+    // Snapshots compare the heap at different times to find what grew
+    [self addToolbarItems:@[
+        [UIBarButtonItem
+            flex_itemWithImage:[UIImage systemImageNamed:@"square.stack.3d.up"]
+            target:self
+            action:@selector(snapshotsButtonTapped:)
+        ],
+        // Dumps are analyzed on a computer with Tools/flexheap
+        [UIBarButtonItem
+            flex_systemItem:UIBarButtonSystemItemAction
+            target:self
+            action:@selector(exportButtonTapped:)
+        ],
+    ]];
     
     [self reloadTableData];
 }
@@ -51,49 +73,53 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
 }
 
 - (void)reloadTableData {
-    // Set up a CFMutableDictionary with class pointer keys and NSUInteger values.
-    // We abuse CFMutableDictionary a little to have primitive keys through judicious casting, but it gets the job done.
-    // The dictionary is intialized with a 0 count for each class so that it doesn't have to expand during enumeration.
-    // While it might be a little cleaner to populate an NSMutableDictionary with class name string keys to NSNumber counts,
-    // we choose the CF/primitives approach because it lets us enumerate the objects in the heap without allocating any memory during enumeration.
-    // The alternative of creating one NSString/NSNumber per object on the heap ends up polluting the count of live objects quite a bit.
-    unsigned int classCount = 0;
-    Class *classes = objc_copyClassList(&classCount);
-    CFMutableDictionaryRef mutableCountsForClasses = CFDictionaryCreateMutable(NULL, classCount, NULL, NULL);
-    for (unsigned int i = 0; i < classCount; i++) {
-        CFDictionarySetValue(mutableCountsForClasses, (__bridge const void *)classes[i], (const void *)0);
-    }
-    
-    // Enumerate all objects on the heap to build the counts of instances for each class.
-    [FLEXHeapEnumerator enumerateLiveObjectsUsingBlock:^(__unsafe_unretained id object, __unsafe_unretained Class actualClass) {
-        NSUInteger instanceCount = (NSUInteger)CFDictionaryGetValue(mutableCountsForClasses, (__bridge const void *)actualClass);
-        instanceCount++;
-        CFDictionarySetValue(mutableCountsForClasses, (__bridge const void *)actualClass, (const void *)instanceCount);
-    }];
-    
-    // Convert our CF primitive dictionary into a nicer mapping of class name strings to counts that we will use as the table's model.
-    NSMutableDictionary<NSString *, NSNumber *> *mutableCountsForClassNames = [NSMutableDictionary new];
-    NSMutableDictionary<NSString *, NSNumber *> *mutableSizesForClassNames = [NSMutableDictionary new];
-    for (unsigned int i = 0; i < classCount; i++) {
-        Class class = classes[i];
-        NSUInteger instanceCount = (NSUInteger)CFDictionaryGetValue(mutableCountsForClasses, (__bridge const void *)(class));
-        NSString *className = @(class_getName(class));
-        if (instanceCount > 0) {
-            [mutableCountsForClassNames setObject:@(instanceCount) forKey:className];
+    // A census of a large heap can take a moment, so keep it off the main thread
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+
+        // Convert the census into a mapping of class name strings to counts that we will use as the table's model.
+        NSMutableDictionary<NSString *, NSNumber *> *mutableCountsForClassNames = [NSMutableDictionary new];
+        NSMutableDictionary<NSString *, NSNumber *> *mutableBytesForClassNames = [NSMutableDictionary new];
+        for (uint32_t i = 0; i < census.entryCount; i++) {
+            FLEXHeapCensusEntry entry = census.entries[i];
+            NSString *className = @(class_getName(entry.cls));
+            mutableCountsForClassNames[className] = @(entry.count);
+            mutableBytesForClassNames[className] = @(entry.bytes);
         }
-        [mutableSizesForClassNames setObject:@(class_getInstanceSize(class)) forKey:className];
+        FLEXHeapCensusResultFree(&census);
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            self.instanceCountsForClassNames = mutableCountsForClassNames;
+            self.instanceBytesForClassNames = mutableBytesForClassNames;
+            [self updateSearchResults:self.searchText];
+            [self.refreshControl endRefreshing];
+        });
+    });
+}
+
+- (void)snapshotsButtonTapped:(UIBarButtonItem *)sender {
+    [self.navigationController
+        pushViewController:[FLEXHeapSnapshotsViewController snapshotsViewController]
+        animated:YES
+    ];
+}
+
+- (void)exportButtonTapped:(UIBarButtonItem *)sender {
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"FLEX Heap.flexheap"];
+    [FLEXActivityViewController shareFileAtPath:path exportedUsing:^NSProgress *(void (^completion)(NSError *)) {
+        return [FLEXHeapDumpExporter exportHeapToFile:path completion:completion];
     }
-    free(classes);
-    
-    self.instanceCountsForClassNames = mutableCountsForClassNames;
-    self.instanceSizesForClassNames = mutableSizesForClassNames;
-    
-    [self updateSearchResults:nil];
+        title:@"Exporting Heap"
+        message:@"Writing every object and reference to a heap dump…"
+        from:self
+        source:sender
+    ];
 }
 
 - (void)refreshControlDidRefresh:(id)sender {
+    // Reference queries should see the same heap as the refreshed counts
+    [FLEXHeapReferenceIndex invalidate];
     [self reloadTableData];
-    [self.refreshControl endRefreshing];
 }
 
 - (void)updateHeaderTitle {
@@ -102,7 +128,7 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
     for (NSString *className in self.allClassNames) {
         NSUInteger count = self.instanceCountsForClassNames[className].unsignedIntegerValue;
         totalCount += count;
-        totalSize += count * self.instanceSizesForClassNames[className].unsignedIntegerValue;
+        totalSize += self.instanceBytesForClassNames[className].unsignedIntegerValue;
     }
 
     NSUInteger filteredCount = 0;
@@ -110,7 +136,7 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
     for (NSString *className in self.filteredClassNames) {
         NSUInteger count = self.instanceCountsForClassNames[className].unsignedIntegerValue;
         filteredCount += count;
-        filteredSize += count * self.instanceSizesForClassNames[className].unsignedIntegerValue;
+        filteredSize += self.instanceBytesForClassNames[className].unsignedIntegerValue;
     }
     
     if (filteredCount == totalCount) {
@@ -171,12 +197,10 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
         }];
     } else if (selectedScope == kFLEXLiveObjectsSortBySizeIndex) {
         self.filteredClassNames = [self.filteredClassNames sortedArrayUsingComparator:^NSComparisonResult(NSString *className1, NSString *className2) {
-            NSNumber *count1 = self.instanceCountsForClassNames[className1];
-            NSNumber *count2 = self.instanceCountsForClassNames[className2];
-            NSNumber *size1 = self.instanceSizesForClassNames[className1];
-            NSNumber *size2 = self.instanceSizesForClassNames[className2];
+            NSNumber *size1 = self.instanceBytesForClassNames[className1];
+            NSNumber *size2 = self.instanceBytesForClassNames[className2];
             // Reversed for descending sizes.
-            return [@(count2.integerValue * size2.integerValue) compare:@(count1.integerValue * size1.integerValue)];
+            return [size2 compare:size1];
         }];
     }
     
@@ -203,8 +227,7 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
 
     NSString *className = self.filteredClassNames[indexPath.row];
     NSNumber *count = self.instanceCountsForClassNames[className];
-    NSNumber *size = self.instanceSizesForClassNames[className];
-    unsigned long totalSize = count.unsignedIntegerValue * size.unsignedIntegerValue;
+    unsigned long totalSize = self.instanceBytesForClassNames[className].unsignedLongValue;
     cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
     cell.textLabel.text = [NSString stringWithFormat:@"%@ (%ld, %@)",
         className, (long)[count integerValue],
@@ -233,4 +256,31 @@ static const NSInteger kFLEXLiveObjectsSortBySizeIndex = 2;
     [self.navigationController pushViewController:instances animated:YES];
 }
 
+- (UIContextMenuConfiguration *)tableView:(UITableView *)tableView contextMenuConfigurationForRowAtIndexPath:(NSIndexPath *)indexPath point:(CGPoint)point __IOS_AVAILABLE(13.0) {
+    Class cls = NSClassFromString(self.filteredClassNames[indexPath.row]);
+    if (!cls) {
+        return nil;
+    }
+
+    return [UIContextMenuConfiguration
+        configurationWithIdentifier:nil
+        previewProvider:nil
+        actionProvider:^UIMenu *(NSArray<UIMenuElement *> *suggestedActions) {
+            UIAction *cycles = [UIAction
+                actionWithTitle:@"Find Retain Cycles"
+                image:nil
+                identifier:nil
+                handler:^(__kindof UIAction *action) {
+                    [self.navigationController
+                        pushViewController:[FLEXRetainCyclesViewController cyclesThroughInstancesOfClass:cls]
+                        animated:YES
+                    ];
+                }
+            ];
+
+            return [UIMenu menuWithTitle:@"" image:nil identifier:nil options:0 children:@[cycles]];
+        }
+    ];
+}
+
 @end
@@ -0,0 +1,22 @@
+//
+//  FLEXRetainCyclesViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Searches the heap for retain cycles with \c FLEXRetainCycleDetector and lists them,
+/// one section per cycle. The search is cancelled if the view controller is popped first.
+@interface FLEXRetainCyclesViewController : FLEXTableViewController
+
++ (instancetype)cyclesThroughObject:(id)object;
++ (instancetype)cyclesThroughInstancesOfClass:(Class)cls;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,157 @@
+//
+//  FLEXRetainCyclesViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXRetainCyclesViewController.h"
+#import "FLEXRetainCycleDetector.h"
+#import "FLEXObjectExplorerFactory.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXUtility.h"
+#import "NSTimer+FLEX.h"
+
+@interface FLEXRetainCyclesViewController ()
+/// Starts the search; called once the view loads
+@property (nonatomic, copy) NSProgress *(^search)(FLEXRetainCycleDetector *detector,
+    void(^completion)(NSArray<FLEXRetainCycle *> *cycles, NSError *error));
+@property (nonatomic) NSProgress *progress;
+@property (nonatomic) NSTimer *progressTimer;
+/// \c nil while searching
+@property (nonatomic, copy) NSArray<FLEXRetainCycle *> *cycles;
+@property (nonatomic) NSError *error;
+@end
+
+@implementation FLEXRetainCyclesViewController
+
++ (instancetype)cyclesThroughObject:(id)object {
+    FLEXRetainCyclesViewController *controller = [self new];
+    // Not retained, or the search would find our own reference
+    __unsafe_unretained id unretained = object;
+    controller.search = ^NSProgress *(FLEXRetainCycleDetector *detector, void(^completion)(NSArray *, NSError *)) {
+        return [detector findCyclesThroughObject:unretained completion:completion];
+    };
+    controller.title = [NSString stringWithFormat:@"Cycles Through %@ %p",
+        NSStringFromClass(object_getClass(object)), object
+    ];
+    return controller;
+}
+
++ (instancetype)cyclesThroughInstancesOfClass:(Class)cls {
+    FLEXRetainCyclesViewController *controller = [self new];
+    controller.search = ^NSProgress *(FLEXRetainCycleDetector *detector, void(^completion)(NSArray *, NSError *)) {
+        return [detector findCyclesThroughInstancesOfClass:cls completion:completion];
+    };
+    controller.title = [NSString stringWithFormat:@"Cycles Through %@", NSStringFromClass(cls)];
+    return controller;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStyleGrouped];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    __weak __typeof(self) weakSelf = self;
+    self.progress = self.search([FLEXRetainCycleDetector new], ^(NSArray *cycles, NSError *error) {
+        [weakSelf searchDidFinishWithCycles:cycles error:error];
+    });
+    self.progressTimer = [NSTimer flex_fireEverySeconds:0.25 block:^{
+        [weakSelf.tableView reloadData];
+    }];
+}
+
+- (void)dealloc {
+    // Dismissing the whole navigation stack doesn't pop this controller first
+    [_progress cancel];
+    [_progressTimer invalidate];
+}
+
+- (void)viewDidDisappear:(BOOL)animated {
+    [super viewDidDisappear:animated];
+
+    if (self.isMovingFromParentViewController) {
+        [self.progress cancel];
+        [self.progressTimer invalidate];
+    }
+}
+
+- (void)searchDidFinishWithCycles:(NSArray<FLEXRetainCycle *> *)cycles error:(NSError *)error {
+    [self.progressTimer invalidate];
+    self.progressTimer = nil;
+
+    if ([error.domain isEqualToString:NSCocoaErrorDomain] && error.code == NSUserCancelledError) {
+        return;
+    }
+
+    self.cycles = cycles ?: @[];
+    self.error = error;
+    [self.tableView reloadData];
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+    return MAX(self.cycles.count, 1);
+}
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return self.cycles.count ? self.cycles[section].length : 0;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
+    if (!self.cycles) {
+        return [NSString stringWithFormat:@"Searching the heap… %.0f%%", self.progress.fractionCompleted * 100];
+    }
+    if (self.error) {
+        return self.error.localizedDescription;
+    }
+    if (!self.cycles.count) {
+        return @"No retain cycles found";
+    }
+
+    FLEXRetainCycle *cycle = self.cycles[section];
+    if (cycle.componentSize > cycle.length) {
+        return [NSString stringWithFormat:@"%@ objects, among %@ that retain each other",
+            @(cycle.length), @(cycle.componentSize)
+        ];
+    }
+
+    return [NSString stringWithFormat:@"%@ objects", @(cycle.length)];
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDetailCell forIndexPath:indexPath];
+    FLEXRetainCycle *cycle = self.cycles[indexPath.section];
+    NSUInteger i = indexPath.row;
+
+    BOOL exists = [cycle objectAtIndex:i] != nil;
+    cell.titleLabel.text = [NSString stringWithFormat:@"%@ %p",
+        cycle.classNames[i], (void *)cycle.addresses[i].unsignedLongValue
+    ];
+    cell.subtitleLabel.text = [NSString stringWithFormat:@"%@ → %@%@",
+        cycle.labels[i], cycle.classNames[(i + 1) % cycle.length], exists ? @"" : @" · Deallocated"
+    ];
+    cell.accessoryType = exists ? UITableViewCellAccessoryDisclosureIndicator : UITableViewCellAccessoryNone;
+
+    return cell;
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    id object = [self.cycles[indexPath.section] objectAtIndex:indexPath.row];
+    if (!object) {
+        [tableView deselectRowAtIndexPath:indexPath animated:YES];
+        [FLEXAlert showQuickAlert:@"This object has been deallocated" from:self];
+        return;
+    }
+
+    UIViewController *explorer = [FLEXObjectExplorerFactory explorerViewControllerForObject:object];
+    [self.navigationController pushViewController:explorer animated:YES];
+}
+
+@end
@@ -15,6 +15,17 @@ NS_ASSUME_NONNULL_BEGIN
 /// @param source A \c UIVIew, \c UIBarButtonItem, or \c NSValue representing a source rect.
 + (id)sharing:(NSArray *)items source:(nullable id)source;
 
+/// Shows a cancellable alert while \c export writes a file in the background,
+/// then shares the file from \c source, or shows why the export failed.
+/// @param export Starts the export and returns its cancellable progress. It must call \c completion
+/// on the main queue, with \c NSUserCancelledError if the export was cancelled.
++ (void)shareFileAtPath:(NSString *)path
+          exportedUsing:(NSProgress *(^)(void(^completion)(NSError *_Nullable error)))export
+                  title:(NSString *)title
+                message:(NSString *)message
+                   from:(UIViewController *)viewController
+                 source:(nullable id)source;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -7,6 +7,7 @@
 
 #import "FLEXActivityViewController.h"
 #import "FLEXMacros.h"
+#import "FLEXAlert.h"
 
 @interface FLEXActivityViewController ()
 @end
@@ -39,4 +40,39 @@
     return shareSheet;
 }
 
++ (void)shareFileAtPath:(NSString *)path
+          exportedUsing:(NSProgress *(^)(void (^)(NSError *)))export
+                  title:(NSString *)title
+                message:(NSString *)message
+                   from:(UIViewController *)viewController
+                 source:(id)source {
+    __block NSProgress *progress = nil;
+    UIAlertController *alert = [FLEXAlert makeAlert:^(FLEXAlert *make) {
+        make.title(title);
+        make.message(message);
+        make.button(@"Cancel").cancelStyle().handler(^(NSArray *strings) {
+            [progress cancel];
+        });
+    }];
+    [viewController presentViewController:alert animated:YES completion:nil];
+    
+    progress = export(^(NSError *error) {
+        // The alert dismissed itself if it was cancelled
+        if ([error.domain isEqualToString:NSCocoaErrorDomain] && error.code == NSUserCancelledError) {
+            return;
+        }
+        
+        [alert dismissViewControllerAnimated:YES completion:^{
+            if (error) {
+                [FLEXAlert showAlert:@"Export Failed" message:error.localizedDescription from:viewController];
+            } else {
+                NSURL *file = [NSURL fileURLWithPath:path];
+                [viewController presentViewController:[self sharing:@[file] source:source]
+                    animated:YES completion:nil
+                ];
+            }
+        }];
+    });
+}
+
 @end
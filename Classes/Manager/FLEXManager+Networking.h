@@ -21,8 +21,9 @@ NS_ASSUME_NONNULL_BEGIN
 /// The response cache uses an NSCache, so it may purge prior to hitting the limit when the app is under memory pressure.
 @property (nonatomic) NSUInteger networkResponseCacheByteLimit;
 
-/// Requests whose host ends with one of the excluded entries in this array will be not be recorded (eg. google.com).
-/// Wildcard or subdomain entries are not required (eg. google.com will match any subdomain under google.com).
+/// Requests whose host matches one of the excluded entries in this array will be not be recorded (eg. google.com).
+/// Subdomain entries are not required (eg. google.com will match google.com and any subdomain under it).
+/// Prefix an entry with *. to match only its subdomains (eg. *.google.com), or with = to match only that exact host.
 /// Useful to remove requests that are typically noisy, such as analytics requests that you aren't interested in tracking.
 @property (nonatomic) NSMutableArray<NSString *> *networkRequestHostDenylist;
 
@@ -281,6 +281,11 @@ static FLEXFIRTransactionDirection FIRDirectionFromRequestType(FLEXFIRRequestTyp
     return NO;
 }
 
++ (BOOL)matchesSubqueries {
+    // Any pull matches "pull", but not necessarily "pul"
+    return NO;
+}
+
 //- (NSString *)responseString {
 //    if (!_responseString) {
 //        _responseString = [NSString stringWithUTF8String:(char *)self.response.bytes];
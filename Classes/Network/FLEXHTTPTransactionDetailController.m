@@ -12,9 +12,13 @@
 #import "FLEXNetworkRecorder.h"
 #import "FLEXNetworkTransaction.h"
 #import "FLEXWebViewController.h"
+#import "FLEXJSONViewController.h"
+#import "FLEXJSONDocument.h"
+#import "FLEXNetworkWaterfallViewController.h"
 #import "FLEXImagePreviewViewController.h"
 #import "FLEXMultilineTableViewCell.h"
 #import "FLEXUtility.h"
+#import "FLEXInflatingReader.h"
 #import "FLEXManager+Private.h"
 #import "FLEXTableView.h"
 #import "UIBarButtonItem+FLEX.h"
@@ -63,8 +67,8 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
     [super viewDidLoad];
 
     [NSNotificationCenter.defaultCenter addObserver:self
-        selector:@selector(handleTransactionUpdatedNotification:)
-        name:kFLEXNetworkRecorderTransactionUpdatedNotification
+        selector:@selector(handleTransactionsChangedNotification:)
+        name:kFLEXNetworkRecorderTransactionsChangedNotification
         object:nil
     ];
     self.toolbarItems = @[
@@ -101,6 +105,10 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
     if (generalSection.rows.count > 0) {
         [sections addObject:generalSection];
     }
+    FLEXNetworkDetailSection *timingSection = [[self class] timingSectionForTransaction:self.transaction];
+    if (timingSection.rows.count > 0) {
+        [sections addObject:timingSection];
+    }
     FLEXNetworkDetailSection *requestHeadersSection = [[self class] requestHeadersSectionForTransaction:self.transaction];
     if (requestHeadersSection.rows.count > 0) {
         [sections addObject:requestHeadersSection];
@@ -121,9 +129,9 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
     self.sections = sections;
 }
 
-- (void)handleTransactionUpdatedNotification:(NSNotification *)notification {
-    FLEXNetworkTransaction *transaction = [[notification userInfo] objectForKey:kFLEXNetworkRecorderUserInfoTransactionKey];
-    if (transaction == self.transaction) {
+- (void)handleTransactionsChangedNotification:(NSNotification *)notification {
+    NSArray *updated = notification.userInfo[kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey];
+    if ([updated indexOfObjectIdenticalTo:self.transaction] != NSNotFound) {
         [self rebuildTableSections];
     }
 }
@@ -414,6 +422,90 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
     return generalSection;
 }
 
++ (FLEXNetworkDetailSection *)timingSectionForTransaction:(FLEXHTTPTransaction *)transaction {
+    FLEXNetworkDetailSection *timingSection = [FLEXNetworkDetailSection new];
+    timingSection.title = @"Timing";
+
+    FLEXNetworkTimings *timings = transaction.timings;
+    FLEXNetworkExchangeTimings *exchange = timings.finalExchange;
+    if (!exchange) {
+        return timingSection;
+    }
+
+    NSMutableArray<FLEXNetworkDetailRow *> *rows = [NSMutableArray new];
+
+    FLEXNetworkDetailRow *waterfallRow = [FLEXNetworkDetailRow new];
+    waterfallRow.title = @"Waterfall";
+    waterfallRow.detailText = [FLEXUtility stringFromRequestDuration:timings.duration];
+    waterfallRow.selectionFuture = ^UIViewController *{
+        return [FLEXNetworkWaterfallViewController withTimings:timings];
+    };
+    [rows addObject:waterfallRow];
+
+    if (timings.redirectCount > 0) {
+        FLEXNetworkDetailRow *redirectsRow = [FLEXNetworkDetailRow new];
+        redirectsRow.title = @"Redirects";
+        redirectsRow.detailText = @(timings.redirectCount).stringValue;
+        [rows addObject:redirectsRow];
+    }
+
+    if (exchange.fetchType == NSURLSessionTaskMetricsResourceFetchTypeLocalCache) {
+        FLEXNetworkDetailRow *cacheRow = [FLEXNetworkDetailRow new];
+        cacheRow.title = @"Source";
+        cacheRow.detailText = @"Local cache";
+        [rows addObject:cacheRow];
+        timingSection.rows = rows;
+        return timingSection;
+    }
+
+    FLEXNetworkDetailRow *protocolRow = [FLEXNetworkDetailRow new];
+    protocolRow.title = @"Protocol";
+    protocolRow.detailText = exchange.networkProtocolName ?: @"unknown";
+    [rows addObject:protocolRow];
+
+    FLEXNetworkDetailRow *connectionRow = [FLEXNetworkDetailRow new];
+    connectionRow.title = @"Connection";
+    connectionRow.detailText = exchange.reusedConnection ? @"reused" : @"new";
+    if (exchange.proxyConnection) {
+        connectionRow.detailText = [connectionRow.detailText stringByAppendingString:@", through a proxy"];
+    }
+    [rows addObject:connectionRow];
+
+    if (exchange.TLSVersion) {
+        FLEXNetworkDetailRow *tlsRow = [FLEXNetworkDetailRow new];
+        tlsRow.title = @"TLS Version";
+        tlsRow.detailText = exchange.TLSVersion;
+        [rows addObject:tlsRow];
+    }
+
+    if (exchange.remoteAddress) {
+        FLEXNetworkDetailRow *addressRow = [FLEXNetworkDetailRow new];
+        addressRow.title = @"Remote Address";
+        addressRow.detailText = exchange.remoteAddress;
+        [rows addObject:addressRow];
+    }
+
+    NSByteCountFormatterCountStyle style = NSByteCountFormatterCountStyleBinary;
+    FLEXNetworkDetailRow *sentRow = [FLEXNetworkDetailRow new];
+    sentRow.title = @"Body Bytes Sent";
+    sentRow.detailText = [NSString stringWithFormat:@"%@ on the wire, %@ before encoding",
+        [NSByteCountFormatter stringFromByteCount:exchange.requestBodyBytesSent countStyle:style],
+        [NSByteCountFormatter stringFromByteCount:exchange.requestBodyBytesBeforeEncoding countStyle:style]
+    ];
+    [rows addObject:sentRow];
+
+    FLEXNetworkDetailRow *receivedRow = [FLEXNetworkDetailRow new];
+    receivedRow.title = @"Body Bytes Received";
+    receivedRow.detailText = [NSString stringWithFormat:@"%@ on the wire, %@ decoded",
+        [NSByteCountFormatter stringFromByteCount:exchange.responseBodyBytesReceived countStyle:style],
+        [NSByteCountFormatter stringFromByteCount:exchange.responseBodyBytesAfterDecoding countStyle:style]
+    ];
+    [rows addObject:receivedRow];
+
+    timingSection.rows = rows;
+    return timingSection;
+}
+
 + (FLEXNetworkDetailSection *)requestHeadersSectionForTransaction:(FLEXHTTPTransaction *)transaction {
     FLEXNetworkDetailSection *requestHeadersSection = [FLEXNetworkDetailSection new];
     requestHeadersSection.title = @"Request Headers";
@@ -504,11 +596,9 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
 
     // FIXME (RKO): Don't rely on UTF8 string encoding
     UIViewController *detailViewController = nil;
-    if ([FLEXUtility isValidJSONData:data]) {
-        NSString *prettyJSON = [FLEXUtility prettyJSONStringFromData:data];
-        if (prettyJSON.length > 0) {
-            detailViewController = [[FLEXWebViewController alloc] initWithText:prettyJSON];
-        }
+    FLEXJSONDocument *json = [FLEXJSONDocument documentWithData:data];
+    if (json) {
+        detailViewController = [FLEXJSONViewController viewerWithDocument:json];
     } else if ([mimeType hasPrefix:@"image/"]) {
         UIImage *image = [UIImage imageWithData:data];
         detailViewController = [FLEXImagePreviewViewController forImage:image];
@@ -528,9 +618,29 @@ typedef UIViewController *(^FLEXNetworkDetailRowSelectionFuture)(void);
 }
 
 + (NSData *)postBodyDataForTransaction:(FLEXHTTPTransaction *)transaction {
+    // The body is inflated for both the parameters section and the body viewer,
+    // and again every time the transaction is viewed, so keep recent ones around
+    static NSCache<FLEXHTTPTransaction *, NSData *> *inflatedBodies = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        inflatedBodies = [NSCache new];
+        inflatedBodies.totalCostLimit = 32 * 1024 * 1024;
+    });
+
     NSData *bodyData = transaction.cachedRequestBody;
     if (bodyData.length > 0 && [FLEXUtility hasCompressedContentEncoding:transaction.request]) {
-        bodyData = [FLEXUtility inflatedDataFromCompressedData:bodyData];
+        NSData *inflated = [inflatedBodies objectForKey:transaction];
+        if (!inflated) {
+            inflated = [FLEXInflatingReader
+                inflatedDataFromCompressedData:bodyData
+                byteLimit:FLEXInflatingReader.defaultByteLimit
+            ];
+            if (inflated) {
+                [inflatedBodies setObject:inflated forKey:transaction cost:inflated.length];
+            }
+        }
+
+        bodyData = inflated;
     }
     return bodyData;
 }
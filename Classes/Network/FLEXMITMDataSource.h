@@ -13,6 +13,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 + (instancetype)dataSourceWithProvider:(NSArray<TransactionType> *(^)(void))future;
 
+/// Optional. Called in the background with the search string to find the transactions whose
+/// content contains it, which are included in the results alongside those matching \c matchesQuery:
+@property (nonatomic, copy, nullable) NSArray<TransactionType> *(^contentSearch)(NSString *query);
+/// Optional. Whether a single new or updated transaction's content contains the search string.
+/// Should agree with \c contentSearch
+@property (nonatomic, copy, nullable) BOOL (^contentMatcher)(TransactionType transaction, NSString *query);
+
 /// Whether or not the data in \c transactions and \c bytesReceived are actually filtered yet or not
 @property (nonatomic, readonly) BOOL isFiltered;
 
@@ -20,12 +27,26 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, readonly) NSArray<TransactionType> *transactions;
 @property (nonatomic, readonly) NSArray<TransactionType> *allTransactions;
 
-/// The content of this array is filtered to match the input of \c filter:completion:
-@property (nonatomic) NSInteger bytesReceived;
-@property (nonatomic) NSInteger totalBytesReceived;
+/// The bytes received by the transactions in \c transactions.
+/// Both byte counts are running sums, kept current by \c reloadData: and \c didUpdateTransactions:
+@property (nonatomic, readonly) NSInteger bytesReceived;
+/// The bytes received by the transactions in \c allTransactions
+@property (nonatomic, readonly) NSInteger totalBytesReceived;
 
+/// Recomputes both byte counts from scratch
 - (void)reloadByteCounts;
+
+/// Fetches the transactions from the provider again. When only new transactions were added
+/// (and old ones dropped from the end), only the new transactions are tested against the filter.
 - (void)reloadData:(void (^_Nullable)(FLEXMITMDataSource *dataSource))completion;
+
+/// Re-counts the bytes of the given transactions, and re-tests them against the filter.
+/// Transactions that don't belong to this data source are ignored.
+/// @return Whether any of them were added to or removed from \c transactions
+- (BOOL)didUpdateTransactions:(NSArray<TransactionType> *)transactions;
+
+/// Filtering happens in the background unless the query is unchanged. When the new query contains
+/// the current one, only the current results are tested.
 - (void)filter:(NSString *)searchString completion:(void(^_Nullable)(FLEXMITMDataSource *dataSource))completion;
 
 @end
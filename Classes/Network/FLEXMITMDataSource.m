@@ -9,16 +9,63 @@
 #import "FLEXNetworkTransaction.h"
 #import "FLEXUtility.h"
 
+/// Membership tests by identity, which is all we need and cheaper than -isEqual:
+static NSHashTable *FLEXIdentitySet(NSArray *objects) {
+    NSHashTable *set = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    for (id object in objects) {
+        [set addObject:object];
+    }
+
+    return set;
+}
+
+/// @return The number of transactions at the start of \c transactions that aren't in \c previous,
+/// or \c NSNotFound if \c transactions is anything other than \c previous with new transactions
+/// inserted at the start and possibly some dropped from the end.
+static NSUInteger FLEXCountOfInsertedTransactions(NSArray *previous, NSArray *transactions) {
+    if (!previous.count) {
+        return transactions.count;
+    }
+
+    NSUInteger inserted = [transactions indexOfObjectIdenticalTo:previous.firstObject];
+    if (inserted == NSNotFound) {
+        return NSNotFound;
+    }
+
+    // Transactions are only ever removed, never reordered, so if the last transaction we kept
+    // is where it would be if nothing was removed from the middle, nothing was
+    NSUInteger kept = transactions.count - inserted;
+    if (kept > previous.count || transactions.lastObject != previous[kept - 1]) {
+        return NSNotFound;
+    }
+
+    return inserted;
+}
+
 @interface FLEXMITMDataSource ()
 @property (nonatomic, readonly) NSArray *(^dataProvider)(void);
 @property (nonatomic) NSString *filterString;
+/// The query \c transactions currently reflects, which lags behind
+/// \c filterString while a new filter is running in the background
+@property (nonatomic) NSString *appliedFilterString;
 @end
 
-@implementation FLEXMITMDataSource
+@implementation FLEXMITMDataSource {
+    /// The contents of \c _transactions, or \c nil when no filter is applied
+    NSHashTable<FLEXNetworkTransaction *> *_matches;
+    /// Every transaction in \c _allTransactions to its length as included in the byte counts
+    NSMapTable<FLEXNetworkTransaction *, NSNumber *> *_countedLengths;
+}
 
 + (instancetype)dataSourceWithProvider:(NSArray<id> *(^)(void))future {
     FLEXMITMDataSource *ds = [self new];
     ds->_dataProvider = future;
+    ds->_allTransactions = @[];
+    ds->_transactions = @[];
+    ds->_countedLengths = [NSMapTable
+        mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality
+        valueOptions:NSPointerFunctionsStrongMemory
+    ];
     [ds reloadData:nil];
     
     return ds;
@@ -28,68 +75,235 @@
     return self.filterString.length > 0;
 }
 
+#pragma mark Public
+
 - (void)reloadByteCounts {
-    [self updateBytesReceived];
-    [self updateFilteredBytesReceived];
+    _totalBytesReceived = 0;
+    for (FLEXNetworkTransaction *transaction in self.allTransactions) {
+        [self countTransaction:transaction];
+    }
+
+    if (_matches) {
+        _bytesReceived = 0;
+        for (FLEXNetworkTransaction *transaction in self.transactions) {
+            _bytesReceived += [self countedLengthOfTransaction:transaction];
+        }
+    } else {
+        _bytesReceived = _totalBytesReceived;
+    }
 }
 
 - (void)reloadData:(void (^)(FLEXMITMDataSource *dataSource))completion {
-    self.allTransactions = self.dataProvider();
-    [self filter:self.filterString completion:completion];
+    NSArray *previous = self.allTransactions;
+    NSArray *transactions = self.dataProvider().copy ?: @[];
+    NSUInteger insertedCount = FLEXCountOfInsertedTransactions(previous, transactions);
+
+    if (insertedCount == NSNotFound) {
+        [self resetWithTransactions:transactions];
+    } else {
+        NSUInteger keptCount = transactions.count - insertedCount;
+        NSArray *dropped = [previous subarrayWithRange:NSMakeRange(keptCount, previous.count - keptCount)];
+        NSArray *inserted = [transactions subarrayWithRange:NSMakeRange(0, insertedCount)];
+        _allTransactions = transactions;
+        [self dropTransactions:dropped insertTransactions:inserted];
+    }
+
+    // A filter still running in the background will catch up with
+    // these transactions once it finishes, so there is no need to wait
+    if (completion) completion(self);
+}
+
+- (BOOL)didUpdateTransactions:(NSArray *)transactions {
+    BOOL membershipChanged = NO;
+    for (FLEXNetworkTransaction *transaction in transactions) {
+        NSNumber *counted = [_countedLengths objectForKey:transaction];
+        if (!counted) {
+            continue;
+        }
+
+        int64_t length = transaction.receivedDataLength;
+        int64_t delta = length - counted.longLongValue;
+        if (delta) {
+            [_countedLengths setObject:@(length) forKey:transaction];
+            _totalBytesReceived += delta;
+            if ([_matches containsObject:transaction]) {
+                _bytesReceived += delta;
+            }
+        }
+
+        if (_matches) {
+            BOOL wasMatch = [_matches containsObject:transaction];
+            if ([self transaction:transaction matchesQuery:self.appliedFilterString] != wasMatch) {
+                membershipChanged = YES;
+                if (wasMatch) {
+                    [_matches removeObject:transaction];
+                    _bytesReceived -= length;
+                } else {
+                    [_matches addObject:transaction];
+                    _bytesReceived += length;
+                }
+            }
+        }
+    }
+
+    if (!_matches) {
+        _bytesReceived = _totalBytesReceived;
+    } else if (membershipChanged) {
+        NSHashTable *matches = _matches;
+        _transactions = [self.allTransactions flex_filtered:^BOOL(id transaction, NSUInteger idx) {
+            return [matches containsObject:transaction];
+        }];
+    }
+
+    return membershipChanged;
 }
 
 - (void)filter:(NSString *)searchString completion:(void (^)(FLEXMITMDataSource *dataSource))completion {
     self.filterString = searchString;
     
     if (!searchString.length) {
-        self.filteredTransactions = self.allTransactions;
+        [self removeFilter];
         if (completion) completion(self);
-    } else {
-        NSArray<FLEXNetworkTransaction *> *allTransactions = self.allTransactions.copy;
-        [self onBackgroundQueue:^NSArray *{
-            return [allTransactions flex_filtered:^BOOL(FLEXNetworkTransaction *entry, NSUInteger idx) {
-                return [entry matchesQuery:searchString];
-            }];
-        } thenOnMainQueue:^(NSArray *filteredNetworkTransactions) {
-            if ([self.filterString isEqual:searchString]) {
-                self.filteredTransactions = filteredNetworkTransactions;
-                if (completion) completion(self);
-            }
+        return;
+    }
+
+    if ([searchString isEqualToString:self.appliedFilterString]) {
+        if (completion) completion(self);
+        return;
+    }
+
+    // Narrowing the search can only remove results, so only the current results need testing
+    NSArray *allTransactions = self.allTransactions;
+    NSArray *candidates = allTransactions;
+    NSString *previousSearch = self.appliedFilterString;
+    BOOL narrowed = previousSearch.length && [searchString localizedCaseInsensitiveContainsString:previousSearch];
+    if (narrowed && [[allTransactions.firstObject class] matchesSubqueries]) {
+        candidates = self.transactions;
+    }
+
+    NSArray *(^contentSearch)(NSString *) = self.contentSearch;
+    [self onBackgroundQueue:^NSArray *{
+        NSHashTable *contentMatches = contentSearch ? FLEXIdentitySet(contentSearch(searchString)) : nil;
+        NSArray *matches = [candidates flex_filtered:^BOOL(FLEXNetworkTransaction *entry, NSUInteger idx) {
+            return [entry matchesQuery:searchString] || [contentMatches containsObject:entry];
         }];
+        return @[FLEXIdentitySet(matches), FLEXIdentitySet(allTransactions)];
+    } thenOnMainQueue:^(NSArray *results) {
+        if ([self.filterString isEqual:searchString]) {
+            [self applyFilter:searchString matches:results[0] among:results[1]];
+            if (completion) completion(self);
+        }
+    }];
+}
+
+#pragma mark Private
+
+- (BOOL)transaction:(FLEXNetworkTransaction *)transaction matchesQuery:(NSString *)query {
+    if ([transaction matchesQuery:query]) {
+        return YES;
     }
+
+    return self.contentMatcher && self.contentMatcher(transaction, query);
 }
 
-- (void)setAllTransactions:(NSArray *)transactions {
-    _allTransactions = transactions.copy;
-    [self updateBytesReceived];
+- (int64_t)countedLengthOfTransaction:(FLEXNetworkTransaction *)transaction {
+    return [_countedLengths objectForKey:transaction].longLongValue;
 }
 
-/// This is really just a semantic setter for \c _transactions
-- (void)setFilteredTransactions:(NSArray *)filteredTransactions {
-    _transactions = filteredTransactions.copy;
-    [self updateFilteredBytesReceived];
+- (void)countTransaction:(FLEXNetworkTransaction *)transaction {
+    int64_t length = transaction.receivedDataLength;
+    [_countedLengths setObject:@(length) forKey:transaction];
+    _totalBytesReceived += length;
 }
 
-- (void)setTransactions:(NSArray *)transactions {
-    self.filteredTransactions = transactions;
+- (void)uncountTransaction:(FLEXNetworkTransaction *)transaction {
+    _totalBytesReceived -= [self countedLengthOfTransaction:transaction];
+    [_countedLengths removeObjectForKey:transaction];
 }
 
-- (void)updateBytesReceived {
-    NSInteger bytesReceived = 0;
-    for (FLEXNetworkTransaction *transaction in self.transactions) {
-        bytesReceived += transaction.receivedDataLength;
+/// Only the inserted transactions are tested against the filter
+- (void)dropTransactions:(NSArray *)dropped insertTransactions:(NSArray *)inserted {
+    // Dropped transactions come from the end of the list, so
+    // any matches among them are at the end of the results
+    NSUInteger droppedMatchCount = 0;
+    for (FLEXNetworkTransaction *transaction in dropped) {
+        if ([_matches containsObject:transaction]) {
+            [_matches removeObject:transaction];
+            _bytesReceived -= [self countedLengthOfTransaction:transaction];
+            droppedMatchCount++;
+        }
+
+        [self uncountTransaction:transaction];
+    }
+
+    NSMutableArray *insertedMatches = [NSMutableArray new];
+    for (FLEXNetworkTransaction *transaction in inserted) {
+        [self countTransaction:transaction];
+
+        if (_matches && [self transaction:transaction matchesQuery:self.appliedFilterString]) {
+            [_matches addObject:transaction];
+            [insertedMatches addObject:transaction];
+            _bytesReceived += [self countedLengthOfTransaction:transaction];
+        }
+    }
+
+    if (_matches) {
+        NSRange kept = NSMakeRange(0, self.transactions.count - droppedMatchCount);
+        [insertedMatches addObjectsFromArray:[self.transactions subarrayWithRange:kept]];
+        _transactions = insertedMatches.copy;
+    } else {
+        _transactions = self.allTransactions;
+        _bytesReceived = _totalBytesReceived;
     }
-    
-    self.bytesReceived = bytesReceived;
 }
 
-- (void)updateFilteredBytesReceived {
-    NSInteger filteredBytesReceived = 0;
-    for (FLEXNetworkTransaction *transaction in self.transactions) {
-        filteredBytesReceived += transaction.receivedDataLength;
+/// For changes other than insertions at the start and removals from the end.
+/// Still only tests transactions we haven't seen before against the filter.
+- (void)resetWithTransactions:(NSArray *)transactions {
+    NSArray *previous = self.allTransactions;
+    NSHashTable *previousMatches = _matches;
+
+    [_countedLengths removeAllObjects];
+    _totalBytesReceived = 0;
+    _allTransactions = transactions;
+    for (FLEXNetworkTransaction *transaction in transactions) {
+        [self countTransaction:transaction];
     }
-    
-    self.bytesReceived = filteredBytesReceived;
+
+    if (previousMatches) {
+        [self applyFilter:self.appliedFilterString matches:previousMatches among:FLEXIdentitySet(previous)];
+    } else {
+        [self removeFilter];
+    }
+}
+
+/// @param matches Which of the transactions in \c tested match \c query. Any transaction
+/// not in \c tested is tested now.
+- (void)applyFilter:(NSString *)query matches:(NSHashTable *)matches among:(NSHashTable *)tested {
+    self.appliedFilterString = query;
+    _matches = [NSHashTable hashTableWithOptions:NSPointerFunctionsObjectPointerPersonality];
+    _bytesReceived = 0;
+
+    NSMutableArray *filtered = [NSMutableArray new];
+    for (FLEXNetworkTransaction *transaction in self.allTransactions) {
+        BOOL isMatch = [tested containsObject:transaction]
+            ? [matches containsObject:transaction]
+            : [self transaction:transaction matchesQuery:query];
+        if (isMatch) {
+            [_matches addObject:transaction];
+            [filtered addObject:transaction];
+            _bytesReceived += [self countedLengthOfTransaction:transaction];
+        }
+    }
+
+    _transactions = filtered.copy;
+}
+
+- (void)removeFilter {
+    self.appliedFilterString = nil;
+    _matches = nil;
+    _transactions = self.allTransactions;
+    _bytesReceived = _totalBytesReceived;
 }
 
 - (void)onBackgroundQueue:(NSArray *(^)(void))backgroundBlock thenOnMainQueue:(void(^)(NSArray *))mainBlock {
@@ -0,0 +1,63 @@
+//
+//  FLEXNetworkAnalytics.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FLEXHTTPTransaction;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A snapshot of the traffic to one host, or to one path template of a host
+@interface FLEXNetworkEndpointStats : NSObject
+
+@property (nonatomic, readonly) NSString *host;
+/// The path with IDs replaced by placeholders, like /users/{id}/posts. \c nil for a whole host.
+@property (nonatomic, readonly, nullable) NSString *pathTemplate;
+
+@property (nonatomic, readonly) NSUInteger requestCount;
+/// Requests that failed, or whose status code was 400 or above
+@property (nonatomic, readonly) NSUInteger errorCount;
+@property (nonatomic, readonly) double errorRate;
+/// Bytes on the wire when known, otherwise the request and response body sizes
+@property (nonatomic, readonly) int64_t bytesSent;
+@property (nonatomic, readonly) int64_t bytesReceived;
+
+/// Quantiles of the total duration of each request that got a response, within 2%
+@property (nonatomic, readonly) NSTimeInterval p50;
+@property (nonatomic, readonly) NSTimeInterval p90;
+@property (nonatomic, readonly) NSTimeInterval p99;
+
+@end
+
+/// Aggregates finished HTTP transactions per host and per path template as they are recorded.
+///
+/// Each aggregate keeps a few counters and a quantile sketch that only allocates the range of durations
+/// it has seen, so memory per endpoint is bounded no matter how many requests it sees. The number of hosts and of templates per host
+/// is capped too; once either cap is hit, new ones are folded into a catch-all aggregate.
+/// Safe to use from any thread.
+@interface FLEXNetworkAnalytics : NSObject
+
+/// Replaces numeric, UUID, and long hexadecimal path segments with placeholders
++ (NSString *)templateForPath:(NSString *)path;
+
+/// Call once for each transaction when it finishes or fails
+- (void)recordTransaction:(FLEXHTTPTransaction *)transaction;
+
+/// Every host seen, in no particular order
+- (NSArray<FLEXNetworkEndpointStats *> *)hostStats;
+/// Every path template seen for the host, in no particular order
+- (NSArray<FLEXNetworkEndpointStats *> *)endpointStatsForHost:(NSString *)host;
+/// All hosts combined, with a host of "All Hosts"
+- (FLEXNetworkEndpointStats *)totalStats;
+
+- (void)removeAllStats;
+- (void)removeStatsForHostsPassingTest:(BOOL(^)(NSString *host))predicate;
+
+@end
+
+NS_ASSUME_NONNULL_END
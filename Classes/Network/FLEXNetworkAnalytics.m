@@ -0,0 +1,304 @@
+//
+//  FLEXNetworkAnalytics.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkAnalytics.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXQuantileSketch.h"
+#import <os/lock.h>
+
+static const NSUInteger kFLEXNetworkAnalyticsMaxHosts = 256;
+static const NSUInteger kFLEXNetworkAnalyticsMaxTemplatesPerHost = 128;
+static NSString * const kFLEXNetworkAnalyticsOtherHosts = @"(other hosts)";
+static NSString * const kFLEXNetworkAnalyticsOtherPaths = @"(other paths)";
+
+#pragma mark Path Templates
+
+static BOOL FLEXIsHexDigit(char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/// @return The placeholder for a path segment that looks like an identifier, or \c NULL
+static const char *FLEXPlaceholderForSegment(const char *segment, size_t length) {
+    size_t digits = 0, hexDigits = 0, dashes = 0, alphanumerics = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = segment[i];
+        digits += c >= '0' && c <= '9';
+        hexDigits += FLEXIsHexDigit(c);
+        dashes += c == '-';
+        alphanumerics += (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    if (length && digits == length) {
+        return "{id}";
+    }
+    if (length == 36 && dashes == 4 && hexDigits == 32 &&
+        segment[8] == '-' && segment[13] == '-' && segment[18] == '-' && segment[23] == '-') {
+        return "{uuid}";
+    }
+    if (length >= 16 && hexDigits == length) {
+        return "{hex}";
+    }
+    // Long random-looking tokens, like base64 IDs
+    if (length >= 24 && digits && alphanumerics + dashes >= length - length / 8) {
+        return "{token}";
+    }
+
+    return NULL;
+}
+
+#pragma mark - FLEXNetworkEndpointStats
+
+@interface FLEXNetworkEndpointStats ()
+@property (nonatomic, readwrite) NSString *host;
+@property (nonatomic, readwrite) NSString *pathTemplate;
+@property (nonatomic, readwrite) NSUInteger requestCount;
+@property (nonatomic, readwrite) NSUInteger errorCount;
+@property (nonatomic, readwrite) int64_t bytesSent;
+@property (nonatomic, readwrite) int64_t bytesReceived;
+@property (nonatomic, readwrite) NSTimeInterval p50;
+@property (nonatomic, readwrite) NSTimeInterval p90;
+@property (nonatomic, readwrite) NSTimeInterval p99;
+@end
+
+@implementation FLEXNetworkEndpointStats
+
+- (double)errorRate {
+    return self.requestCount ? (double)self.errorCount / self.requestCount : 0;
+}
+
+@end
+
+#pragma mark - Aggregates
+
+/// The running totals of one host or path template
+@interface FLEXNetworkAggregate : NSObject {
+    @package
+    NSUInteger _requestCount;
+    NSUInteger _errorCount;
+    int64_t _bytesSent;
+    int64_t _bytesReceived;
+    FLEXQuantileSketch *_durations;
+}
+@end
+
+@implementation FLEXNetworkAggregate
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _durations = [FLEXQuantileSketch new];
+    }
+
+    return self;
+}
+
+- (void)mergeAggregate:(FLEXNetworkAggregate *)other {
+    _requestCount += other->_requestCount;
+    _errorCount += other->_errorCount;
+    _bytesSent += other->_bytesSent;
+    _bytesReceived += other->_bytesReceived;
+    [_durations mergeSketch:other->_durations];
+}
+
+- (FLEXNetworkEndpointStats *)statsWithHost:(NSString *)host pathTemplate:(NSString *)pathTemplate {
+    FLEXNetworkEndpointStats *stats = [FLEXNetworkEndpointStats new];
+    stats.host = host;
+    stats.pathTemplate = pathTemplate;
+    stats.requestCount = _requestCount;
+    stats.errorCount = _errorCount;
+    stats.bytesSent = _bytesSent;
+    stats.bytesReceived = _bytesReceived;
+    stats.p50 = [_durations valueAtQuantile:0.5];
+    stats.p90 = [_durations valueAtQuantile:0.9];
+    stats.p99 = [_durations valueAtQuantile:0.99];
+    return stats;
+}
+
+@end
+
+@interface FLEXNetworkHostAggregate : FLEXNetworkAggregate {
+    @package
+    NSMutableDictionary<NSString *, FLEXNetworkAggregate *> *_templates;
+}
+@end
+
+@implementation FLEXNetworkHostAggregate
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _templates = [NSMutableDictionary new];
+    }
+
+    return self;
+}
+
+@end
+
+#pragma mark - FLEXNetworkAnalytics
+
+@implementation FLEXNetworkAnalytics {
+    os_unfair_lock _lock;
+    NSMutableDictionary<NSString *, FLEXNetworkHostAggregate *> *_hosts;
+}
+
++ (NSString *)templateForPath:(NSString *)path {
+    if (!path.length) {
+        return @"/";
+    }
+
+    const char *bytes = path.UTF8String;
+    size_t length = strlen(bytes);
+    NSMutableData *template = [NSMutableData dataWithCapacity:length];
+
+    size_t start = 0;
+    while (start <= length) {
+        const char *slash = memchr(bytes + start, '/', length - start);
+        size_t end = slash ? (size_t)(slash - bytes) : length;
+
+        const char *placeholder = FLEXPlaceholderForSegment(bytes + start, end - start);
+        if (placeholder) {
+            [template appendBytes:placeholder length:strlen(placeholder)];
+        } else {
+            [template appendBytes:bytes + start length:end - start];
+        }
+
+        if (!slash) {
+            break;
+        }
+        [template appendBytes:"/" length:1];
+        start = end + 1;
+    }
+
+    return [[NSString alloc] initWithData:template encoding:NSUTF8StringEncoding] ?: path;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _hosts = [NSMutableDictionary new];
+    }
+
+    return self;
+}
+
+- (void)recordTransaction:(FLEXHTTPTransaction *)transaction {
+    NSURL *url = transaction.request.URL;
+    NSString *host = url.host.lowercaseString ?: @"";
+    NSString *pathTemplate = [[self class] templateForPath:url.path];
+
+    // Requests that never got a response have no meaningful duration
+    BOOL incomplete = transaction.error || transaction.state == FLEXNetworkTransactionStateFailed;
+    BOOL failed = incomplete;
+    if ([transaction.response isKindOfClass:[NSHTTPURLResponse class]]) {
+        failed = failed || ((NSHTTPURLResponse *)transaction.response).statusCode >= 400;
+    }
+
+    // Prefer what actually went over the wire, including redirects and headers
+    int64_t sent = 0, received = 0;
+    NSArray<FLEXNetworkExchangeTimings *> *exchanges = transaction.timings.exchanges;
+    if (exchanges.count) {
+        for (FLEXNetworkExchangeTimings *exchange in exchanges) {
+            sent += exchange.requestHeaderBytesSent + exchange.requestBodyBytesSent;
+            received += exchange.responseHeaderBytesReceived + exchange.responseBodyBytesReceived;
+        }
+    } else {
+        sent = transaction.request.HTTPBody.length;
+        received = transaction.receivedDataLength;
+    }
+
+    os_unfair_lock_lock(&_lock);
+
+    FLEXNetworkHostAggregate *hostAggregate = _hosts[host];
+    if (!hostAggregate) {
+        if (_hosts.count >= kFLEXNetworkAnalyticsMaxHosts) {
+            host = kFLEXNetworkAnalyticsOtherHosts;
+            hostAggregate = _hosts[host];
+        }
+        if (!hostAggregate) {
+            hostAggregate = [FLEXNetworkHostAggregate new];
+            _hosts[host] = hostAggregate;
+        }
+    }
+
+    FLEXNetworkAggregate *templateAggregate = hostAggregate->_templates[pathTemplate];
+    if (!templateAggregate) {
+        if (hostAggregate->_templates.count >= kFLEXNetworkAnalyticsMaxTemplatesPerHost) {
+            pathTemplate = kFLEXNetworkAnalyticsOtherPaths;
+            templateAggregate = hostAggregate->_templates[pathTemplate];
+        }
+        if (!templateAggregate) {
+            templateAggregate = [FLEXNetworkAggregate new];
+            hostAggregate->_templates[pathTemplate] = templateAggregate;
+        }
+    }
+
+    for (FLEXNetworkAggregate *aggregate in @[hostAggregate, templateAggregate]) {
+        aggregate->_requestCount++;
+        aggregate->_errorCount += failed;
+        aggregate->_bytesSent += sent;
+        aggregate->_bytesReceived += received;
+        if (!incomplete) {
+            [aggregate->_durations addValue:transaction.duration];
+        }
+    }
+
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (NSArray<FLEXNetworkEndpointStats *> *)hostStats {
+    NSMutableArray<FLEXNetworkEndpointStats *> *stats = [NSMutableArray new];
+    os_unfair_lock_lock(&_lock);
+    [_hosts enumerateKeysAndObjectsUsingBlock:^(NSString *host, FLEXNetworkHostAggregate *aggregate, BOOL *stop) {
+        [stats addObject:[aggregate statsWithHost:host pathTemplate:nil]];
+    }];
+    os_unfair_lock_unlock(&_lock);
+
+    return stats;
+}
+
+- (NSArray<FLEXNetworkEndpointStats *> *)endpointStatsForHost:(NSString *)host {
+    NSMutableArray<FLEXNetworkEndpointStats *> *stats = [NSMutableArray new];
+    os_unfair_lock_lock(&_lock);
+    FLEXNetworkHostAggregate *hostAggregate = _hosts[host];
+    [hostAggregate->_templates enumerateKeysAndObjectsUsingBlock:^(NSString *path, FLEXNetworkAggregate *aggregate, BOOL *stop) {
+        [stats addObject:[aggregate statsWithHost:host pathTemplate:path]];
+    }];
+    os_unfair_lock_unlock(&_lock);
+
+    return stats;
+}
+
+- (FLEXNetworkEndpointStats *)totalStats {
+    FLEXNetworkAggregate *total = [FLEXNetworkAggregate new];
+    os_unfair_lock_lock(&_lock);
+    for (FLEXNetworkHostAggregate *aggregate in _hosts.objectEnumerator) {
+        [total mergeAggregate:aggregate];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    return [total statsWithHost:@"All Hosts" pathTemplate:nil];
+}
+
+- (void)removeAllStats {
+    os_unfair_lock_lock(&_lock);
+    [_hosts removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)removeStatsForHostsPassingTest:(BOOL (^)(NSString *))predicate {
+    os_unfair_lock_lock(&_lock);
+    NSSet<NSString *> *removed = [_hosts keysOfEntriesPassingTest:^BOOL(NSString *host, id obj, BOOL *stop) {
+        return predicate(host);
+    }];
+    [_hosts removeObjectsForKeys:removed.allObjects];
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
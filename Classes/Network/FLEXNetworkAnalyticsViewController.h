@@ -0,0 +1,24 @@
+//
+//  FLEXNetworkAnalyticsViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A dashboard of request counts, error rates, bytes, and latency percentiles
+/// from \c FLEXNetworkRecorder.analytics, sortable by any of them.
+@interface FLEXNetworkAnalyticsViewController : FLEXTableViewController
+
+/// Lists every host; tap one to see its endpoints
++ (instancetype)hostsViewController;
+/// Lists the path templates of one host
++ (instancetype)endpointsViewControllerForHost:(NSString *)host;
+
+@end
+
+NS_ASSUME_NONNULL_END
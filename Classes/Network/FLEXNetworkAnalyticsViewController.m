@@ -0,0 +1,249 @@
+//
+//  FLEXNetworkAnalyticsViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkAnalyticsViewController.h"
+#import "FLEXNetworkAnalytics.h"
+#import "FLEXNetworkRecorder.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXUtility.h"
+#import "UIBarButtonItem+FLEX.h"
+
+typedef NS_ENUM(NSUInteger, FLEXNetworkStatsSort) {
+    FLEXNetworkStatsSortRequests,
+    FLEXNetworkStatsSortErrorRate,
+    FLEXNetworkStatsSortP50,
+    FLEXNetworkStatsSortP90,
+    FLEXNetworkStatsSortP99,
+    FLEXNetworkStatsSortReceived,
+    FLEXNetworkStatsSortSent,
+    FLEXNetworkStatsSortCount
+};
+
+/// Stats are refreshed at most this often while traffic is coming in
+static const NSTimeInterval kFLEXNetworkAnalyticsRefreshInterval = 0.5;
+
+@interface FLEXNetworkAnalyticsViewController ()
+/// \c nil when listing hosts
+@property (nonatomic, readonly, nullable) NSString *host;
+@property (nonatomic) FLEXNetworkStatsSort sort;
+@property (nonatomic, nullable) FLEXNetworkEndpointStats *totalStats;
+/// Sorted and filtered by the search text
+@property (nonatomic, copy) NSArray<FLEXNetworkEndpointStats *> *stats;
+@property (nonatomic) BOOL refreshScheduled;
+@end
+
+@implementation FLEXNetworkAnalyticsViewController
+
++ (instancetype)hostsViewController {
+    FLEXNetworkAnalyticsViewController *controller = [self new];
+    controller.title = @"Hosts";
+    return controller;
+}
+
++ (instancetype)endpointsViewControllerForHost:(NSString *)host {
+    FLEXNetworkAnalyticsViewController *controller = [self new];
+    controller->_host = host;
+    controller.title = host;
+    return controller;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStyleGrouped];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    self.showsSearchBar = YES;
+    self.sort = FLEXNetworkStatsSortP90;
+    [self addToolbarItems:@[
+        [UIBarButtonItem flex_itemWithTitle:@"Sort" target:self action:@selector(sortButtonTapped:)],
+    ]];
+
+    [NSNotificationCenter.defaultCenter addObserver:self
+        selector:@selector(handleTransactionsChangedNotification:)
+        name:kFLEXNetworkRecorderTransactionsChangedNotification
+        object:nil
+    ];
+    [NSNotificationCenter.defaultCenter addObserver:self
+        selector:@selector(handleTransactionsChangedNotification:)
+        name:kFLEXNetworkRecorderTransactionsClearedNotification
+        object:nil
+    ];
+
+    [self reloadStats];
+}
+
+- (void)dealloc {
+    [NSNotificationCenter.defaultCenter removeObserver:self];
+}
+
+#pragma mark Stats
+
++ (NSString *)titleForSort:(FLEXNetworkStatsSort)sort {
+    switch (sort) {
+        case FLEXNetworkStatsSortRequests: return @"Requests";
+        case FLEXNetworkStatsSortErrorRate: return @"Error Rate";
+        case FLEXNetworkStatsSortP50: return @"Median Latency";
+        case FLEXNetworkStatsSortP90: return @"p90 Latency";
+        case FLEXNetworkStatsSortP99: return @"p99 Latency";
+        case FLEXNetworkStatsSortReceived: return @"Bytes Received";
+        case FLEXNetworkStatsSortSent: return @"Bytes Sent";
+        case FLEXNetworkStatsSortCount: break;
+    }
+
+    return nil;
+}
+
+/// The value stats are sorted by, largest first
++ (double)valueOfStats:(FLEXNetworkEndpointStats *)stats forSort:(FLEXNetworkStatsSort)sort {
+    switch (sort) {
+        case FLEXNetworkStatsSortRequests: return stats.requestCount;
+        case FLEXNetworkStatsSortErrorRate: return stats.errorRate;
+        case FLEXNetworkStatsSortP50: return stats.p50;
+        case FLEXNetworkStatsSortP90: return stats.p90;
+        case FLEXNetworkStatsSortP99: return stats.p99;
+        case FLEXNetworkStatsSortReceived: return stats.bytesReceived;
+        case FLEXNetworkStatsSortSent: return stats.bytesSent;
+        case FLEXNetworkStatsSortCount: break;
+    }
+
+    return 0;
+}
+
+- (void)reloadStats {
+    FLEXNetworkAnalytics *analytics = FLEXNetworkRecorder.defaultRecorder.analytics;
+    NSArray<FLEXNetworkEndpointStats *> *stats = nil;
+    if (self.host) {
+        stats = [analytics endpointStatsForHost:self.host];
+    } else {
+        stats = analytics.hostStats;
+        self.totalStats = stats.count ? analytics.totalStats : nil;
+    }
+
+    NSString *filter = self.searchText;
+    if (filter.length) {
+        stats = [stats flex_filtered:^BOOL(FLEXNetworkEndpointStats *obj, NSUInteger idx) {
+            NSString *name = obj.pathTemplate ?: obj.host;
+            return [name localizedCaseInsensitiveContainsString:filter];
+        }];
+    }
+
+    FLEXNetworkStatsSort sort = self.sort;
+    self.stats = [stats sortedArrayUsingComparator:^NSComparisonResult(FLEXNetworkEndpointStats *a, FLEXNetworkEndpointStats *b) {
+        // NAN latencies of hosts without finished requests sort last
+        double x = [FLEXNetworkAnalyticsViewController valueOfStats:a forSort:sort];
+        double y = [FLEXNetworkAnalyticsViewController valueOfStats:b forSort:sort];
+        if (x > y || (isnan(y) && !isnan(x))) return NSOrderedAscending;
+        if (x < y || (isnan(x) && !isnan(y))) return NSOrderedDescending;
+        return [(a.pathTemplate ?: a.host) compare:(b.pathTemplate ?: b.host)];
+    }];
+
+    [self.tableView reloadData];
+}
+
+- (void)handleTransactionsChangedNotification:(NSNotification *)notification {
+    if (self.refreshScheduled) {
+        return;
+    }
+
+    self.refreshScheduled = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kFLEXNetworkAnalyticsRefreshInterval * NSEC_PER_SEC),
+        dispatch_get_main_queue(), ^{
+        self.refreshScheduled = NO;
+        [self reloadStats];
+    });
+}
+
+- (void)sortButtonTapped:(UIBarButtonItem *)sender {
+    [FLEXAlert makeSheet:^(FLEXAlert *make) {
+        make.title(@"Sort By");
+        for (FLEXNetworkStatsSort sort = 0; sort < FLEXNetworkStatsSortCount; sort++) {
+            NSString *title = [[self class] titleForSort:sort];
+            if (sort == self.sort) {
+                title = [title stringByAppendingString:@" ✓"];
+            }
+
+            make.button(title).handler(^(NSArray<NSString *> *strings) {
+                self.sort = sort;
+                [self reloadStats];
+            });
+        }
+        make.button(@"Cancel").cancelStyle();
+    } showFrom:self source:sender];
+}
+
+- (void)updateSearchResults:(NSString *)newText {
+    [self reloadStats];
+}
+
+#pragma mark Formatting
+
++ (NSString *)stringFromLatency:(NSTimeInterval)latency {
+    return isnan(latency) ? @"–" : [FLEXUtility stringFromRequestDuration:latency];
+}
+
++ (NSString *)summaryOfStats:(FLEXNetworkEndpointStats *)stats {
+    NSByteCountFormatterCountStyle style = NSByteCountFormatterCountStyleBinary;
+    return [NSString stringWithFormat:@"%@ requests · %.1f%% errors · ↓%@ ↑%@\np50 %@ · p90 %@ · p99 %@",
+        @(stats.requestCount), stats.errorRate * 100,
+        [NSByteCountFormatter stringFromByteCount:stats.bytesReceived countStyle:style],
+        [NSByteCountFormatter stringFromByteCount:stats.bytesSent countStyle:style],
+        [self stringFromLatency:stats.p50],
+        [self stringFromLatency:stats.p90],
+        [self stringFromLatency:stats.p99]
+    ];
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+    return 2;
+}
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return section == 0 ? (self.totalStats ? 1 : 0) : self.stats.count;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
+    if (section == 0) {
+        return nil;
+    }
+
+    return [NSString stringWithFormat:@"%@ %@ by %@",
+        @(self.stats.count), self.host ? @"Endpoints" : @"Hosts", [[self class] titleForSort:self.sort]
+    ];
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDetailCell forIndexPath:indexPath];
+    FLEXNetworkEndpointStats *stats = indexPath.section == 0 ? self.totalStats : self.stats[indexPath.row];
+
+    cell.titleLabel.text = stats.pathTemplate ?: stats.host;
+    cell.subtitleLabel.text = [[self class] summaryOfStats:stats];
+    cell.subtitleLabel.numberOfLines = 2;
+
+    BOOL drillsDown = !self.host && indexPath.section == 1;
+    cell.accessoryType = drillsDown ? UITableViewCellAccessoryDisclosureIndicator : UITableViewCellAccessoryNone;
+    cell.selectionStyle = drillsDown ? UITableViewCellSelectionStyleDefault : UITableViewCellSelectionStyleNone;
+
+    return cell;
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    if (self.host || indexPath.section == 0) {
+        return;
+    }
+
+    NSString *host = self.stats[indexPath.row].host;
+    [self.navigationController pushViewController:[[self class] endpointsViewControllerForHost:host] animated:YES];
+}
+
+@end
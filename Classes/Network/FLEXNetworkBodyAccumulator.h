@@ -0,0 +1,39 @@
+//
+//  FLEXNetworkBodyAccumulator.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Collects a response body as it arrives without copying it.
+///
+/// Each chunk is retained as-is and the chunks are only joined when \c data is requested.
+/// Once more than \c captureLimit bytes have arrived the chunks are released and further
+/// chunks are only counted, since a body that large could never be cached anyway.
+///
+/// Not thread safe; meant to be used from a single serial queue.
+@interface FLEXNetworkBodyAccumulator : NSObject
+
++ (instancetype)accumulatorWithCaptureLimit:(NSUInteger)captureLimit;
+
+@property (nonatomic, readonly) NSUInteger captureLimit;
+/// Every byte appended so far, including any that were not captured
+@property (nonatomic, readonly) NSUInteger length;
+/// Whether the body outgrew \c captureLimit and was dropped
+@property (nonatomic, readonly) BOOL truncated;
+
+/// @param data Should be immutable, as it is retained rather than copied
+- (void)appendData:(NSData *)data;
+
+/// The complete body, or \c nil if nothing was received or the body was truncated.
+/// A body that arrived in a single chunk is returned without being copied.
+@property (nonatomic, readonly, nullable) NSData *data;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,60 @@
+//
+//  FLEXNetworkBodyAccumulator.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkBodyAccumulator.h"
+
+@implementation FLEXNetworkBodyAccumulator {
+    NSMutableArray<NSData *> *_chunks;
+}
+
++ (instancetype)accumulatorWithCaptureLimit:(NSUInteger)captureLimit {
+    FLEXNetworkBodyAccumulator *accumulator = [self new];
+    accumulator->_captureLimit = captureLimit;
+    accumulator->_chunks = [NSMutableArray new];
+    return accumulator;
+}
+
+- (void)appendData:(NSData *)data {
+    if (!data.length) {
+        return;
+    }
+
+    _length += data.length;
+    if (_truncated) {
+        return;
+    }
+
+    if (_length > _captureLimit) {
+        _truncated = YES;
+        [_chunks removeAllObjects];
+        return;
+    }
+
+    [_chunks addObject:data];
+}
+
+- (NSData *)data {
+    if (_truncated || !_chunks.count) {
+        return nil;
+    }
+
+    if (_chunks.count > 1) {
+        // Join the chunks with a single allocation, and keep the
+        // result so that asking again doesn't join them again
+        NSMutableData *body = [NSMutableData dataWithCapacity:_length];
+        for (NSData *chunk in _chunks) {
+            [body appendData:chunk];
+        }
+
+        [_chunks setArray:@[body]];
+    }
+
+    return _chunks.firstObject;
+}
+
+@end
@@ -0,0 +1,41 @@
+//
+//  FLEXNetworkBodyDiskCache.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The second tier of response body storage, for bodies evicted from the in-memory cache.
+///
+/// Bodies are appended asynchronously to a single segment file in the caches directory and
+/// located through an in-memory offset index. Reads map the body's region of the file instead
+/// of copying it into memory, and never wait for queued writes. When the live bodies exceed \c byteLimit the oldest are dropped,
+/// and the segment is compacted once most of it is dead space.
+///
+/// The index is not persisted; the segment is discarded when the cache is created.
+@interface FLEXNetworkBodyDiskCache : NSObject
+
+/// @param directory Created if needed. Existing contents are deleted.
++ (instancetype)cacheInDirectory:(NSString *)directory byteLimit:(NSUInteger)byteLimit;
+
+@property (nonatomic) NSUInteger byteLimit;
+/// The total size of every body currently retrievable from the cache
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
+/// Queues the data to be written to disk. Returns immediately.
+- (void)setData:(NSData *)data forKey:(id<NSCopying>)key;
+/// Safe to call from the main thread.
+/// @return A memory-mapped copy of the body, or \c nil if it was never stored or has been dropped.
+- (nullable NSData *)dataForKey:(id<NSCopying>)key;
+
+- (void)removeDataForKey:(id<NSCopying>)key;
+- (void)removeAllData;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,328 @@
+//
+//  FLEXNetworkBodyDiskCache.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkBodyDiskCache.h"
+#include <fcntl.h>
+#include <os/lock.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/// Don't bother compacting segments smaller than this
+static const off_t kFLEXBodyDiskCacheMinCompactionSize = 4 * 1024 * 1024;
+
+@interface FLEXNetworkBodyDiskCache ()
+@property (nonatomic, readonly) NSString *directory;
+@property (nonatomic, readonly) dispatch_queue_t queue;
+@end
+
+@implementation FLEXNetworkBodyDiskCache {
+    // Readers look up bodies without waiting on _queue, so the queue
+    // holds _lock while it changes these; it may read them freely
+    os_unfair_lock _lock;
+    /// Bodies handed to setData: that the queue has not written yet
+    NSMutableDictionary<id, NSData *> *_pending;
+    /// Closes itself once compaction has replaced it and the last reader is done with it
+    NSFileHandle *_segment;
+    NSUInteger _liveBytes;
+    /// Key to the range of its body within the segment
+    NSMutableDictionary<id, NSValue *> *_index;
+
+    // Everything below is only accessed on _queue
+    NSUInteger _generation;
+    off_t _fileLength;
+    /// Keys and their offsets in the order they were written, oldest first. May contain
+    /// entries that have since been removed or rewritten; those no longer match the index.
+    NSMutableArray *_order;
+    NSMutableArray<NSNumber *> *_orderOffsets;
+    NSUInteger _orderHead;
+}
+
++ (instancetype)cacheInDirectory:(NSString *)directory byteLimit:(NSUInteger)byteLimit {
+    FLEXNetworkBodyDiskCache *cache = [self new];
+    cache->_directory = directory;
+    cache->_byteLimit = byteLimit;
+    cache->_queue = dispatch_queue_create("com.flex.FLEXNetworkBodyDiskCache", DISPATCH_QUEUE_SERIAL);
+    cache->_lock = OS_UNFAIR_LOCK_INIT;
+    cache->_index = [NSMutableDictionary new];
+    cache->_pending = [NSMutableDictionary new];
+    cache->_order = [NSMutableArray new];
+    cache->_orderOffsets = [NSMutableArray new];
+
+    dispatch_async(cache.queue, ^{
+        NSFileManager *manager = NSFileManager.defaultManager;
+        [manager removeItemAtPath:directory error:nil];
+        [manager createDirectoryAtPath:directory withIntermediateDirectories:YES attributes:nil error:nil];
+        NSFileHandle *segment = [cache openSegment];
+        os_unfair_lock_lock(&cache->_lock);
+        cache->_segment = segment;
+        os_unfair_lock_unlock(&cache->_lock);
+    });
+
+    return cache;
+}
+
+#pragma mark Public
+
+- (NSUInteger)totalBytes {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger total = _liveBytes;
+    os_unfair_lock_unlock(&_lock);
+    return total;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit {
+    _byteLimit = byteLimit;
+    dispatch_async(self.queue, ^{
+        [self enforceByteLimit];
+    });
+}
+
+- (void)setData:(NSData *)data forKey:(id<NSCopying>)key {
+    if (!data.length || !key) {
+        return;
+    }
+
+    key = [key copyWithZone:nil];
+    os_unfair_lock_lock(&_lock);
+    _pending[key] = data;
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_async(self.queue, ^{
+        [self removeEntryForKey:key];
+
+        off_t offset = self->_fileLength;
+        BOOL written = data.length <= self->_byteLimit &&
+            [self writeData:data atOffset:offset toFile:self->_segment];
+
+        os_unfair_lock_lock(&self->_lock);
+        // A later call may have replaced this body already
+        if (self->_pending[key] == data) {
+            [self->_pending removeObjectForKey:key];
+        }
+        if (written) {
+            self->_liveBytes += data.length;
+            self->_index[key] = [NSValue valueWithRange:NSMakeRange((NSUInteger)offset, data.length)];
+        }
+        os_unfair_lock_unlock(&self->_lock);
+
+        if (!written) {
+            return;
+        }
+
+        self->_fileLength += data.length;
+        [self->_order addObject:key];
+        [self->_orderOffsets addObject:@(offset)];
+
+        [self enforceByteLimit];
+    });
+}
+
+- (NSData *)dataForKey:(id<NSCopying>)key {
+    if (!key) {
+        return nil;
+    }
+
+    // Holding the segment keeps its file open until the range is mapped,
+    // even if the queue compacts or clears the cache in the meantime
+    os_unfair_lock_lock(&_lock);
+    NSData *pending = _pending[key];
+    NSValue *extent = _index[key];
+    NSFileHandle *segment = _segment;
+    os_unfair_lock_unlock(&_lock);
+
+    if (pending) {
+        return pending;
+    }
+    return extent ? [self mapRange:extent.rangeValue ofFile:segment] : nil;
+}
+
+- (void)removeDataForKey:(id<NSCopying>)key {
+    if (!key) {
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    [_pending removeObjectForKey:key];
+    os_unfair_lock_unlock(&_lock);
+
+    dispatch_async(self.queue, ^{
+        [self removeEntryForKey:key];
+        [self compactIfNeeded];
+    });
+}
+
+- (void)removeAllData {
+    dispatch_async(self.queue, ^{
+        [self->_order removeAllObjects];
+        [self->_orderOffsets removeAllObjects];
+        self->_orderHead = 0;
+
+        // Start a new segment rather than truncating this one, since
+        // touching a mapping past the end of a truncated file is fatal
+        unlink([self segmentPathForGeneration:self->_generation].fileSystemRepresentation);
+        self->_generation++;
+        NSFileHandle *segment = [self openSegment];
+
+        os_unfair_lock_lock(&self->_lock);
+        [self->_index removeAllObjects];
+        self->_liveBytes = 0;
+        self->_segment = segment;
+        os_unfair_lock_unlock(&self->_lock);
+    });
+}
+
+#pragma mark Private, queue only
+
+- (NSString *)segmentPathForGeneration:(NSUInteger)generation {
+    NSString *name = [NSString stringWithFormat:@"segment-%@.dat", @(generation)];
+    return [self.directory stringByAppendingPathComponent:name];
+}
+
+/// Creates the segment for the current generation and resets the file length
+- (NSFileHandle *)openSegment {
+    _fileLength = 0;
+    int fd = open([self segmentPathForGeneration:_generation].fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    return fd < 0 ? nil : [[NSFileHandle alloc] initWithFileDescriptor:fd closeOnDealloc:YES];
+}
+
+- (BOOL)writeData:(NSData *)data atOffset:(off_t)offset toFile:(NSFileHandle *)file {
+    if (!file) {
+        return NO;
+    }
+
+    int fd = file.fileDescriptor;
+    __block BOOL success = YES;
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        const uint8_t *cursor = bytes;
+        size_t remaining = byteRange.length;
+        off_t position = offset + byteRange.location;
+        while (remaining > 0) {
+            ssize_t written = pwrite(fd, cursor, remaining, position);
+            if (written <= 0) {
+                success = NO;
+                *stop = YES;
+                return;
+            }
+
+            cursor += written;
+            position += written;
+            remaining -= written;
+        }
+    }];
+
+    return success;
+}
+
+/// The returned data unmaps itself when deallocated
+- (NSData *)mapRange:(NSRange)range ofFile:(NSFileHandle *)file {
+    if (!file || !range.length) {
+        return nil;
+    }
+
+    // mmap offsets must be page aligned
+    off_t pageSize = getpagesize();
+    off_t alignedOffset = (range.location / pageSize) * pageSize;
+    size_t slack = (size_t)(range.location - alignedOffset);
+    size_t mappedLength = slack + range.length;
+
+    void *base = mmap(NULL, mappedLength, PROT_READ, MAP_PRIVATE, file.fileDescriptor, alignedOffset);
+    if (base == MAP_FAILED) {
+        return nil;
+    }
+
+    return [[NSData alloc]
+        initWithBytesNoCopy:(uint8_t *)base + slack
+        length:range.length
+        deallocator:^(void *bytes, NSUInteger length) {
+            munmap(base, mappedLength);
+        }
+    ];
+}
+
+- (void)removeEntryForKey:(id<NSCopying>)key {
+    NSValue *extent = _index[key];
+    if (extent) {
+        os_unfair_lock_lock(&_lock);
+        _liveBytes -= extent.rangeValue.length;
+        [_index removeObjectForKey:key];
+        os_unfair_lock_unlock(&_lock);
+    }
+}
+
+- (BOOL)isLiveEntryAtOrderIndex:(NSUInteger)i {
+    NSValue *extent = _index[_order[i]];
+    return extent && extent.rangeValue.location == _orderOffsets[i].unsignedIntegerValue;
+}
+
+/// Drops the oldest bodies until we are within the byte limit
+- (void)enforceByteLimit {
+    while (_liveBytes > _byteLimit && _orderHead < _order.count) {
+        if ([self isLiveEntryAtOrderIndex:_orderHead]) {
+            [self removeEntryForKey:_order[_orderHead]];
+        }
+        _orderHead++;
+    }
+
+    [self compactIfNeeded];
+}
+
+/// Rewrites the live bodies into a new segment once more than half of the current one is dead
+- (void)compactIfNeeded {
+    if (_fileLength < kFLEXBodyDiskCacheMinCompactionSize || (off_t)_liveBytes * 2 > _fileLength) {
+        return;
+    }
+
+    NSUInteger nextGeneration = _generation + 1;
+    NSString *nextPath = [self segmentPathForGeneration:nextGeneration];
+    int nextFd = open(nextPath.fileSystemRepresentation, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (nextFd < 0) {
+        return;
+    }
+    NSFileHandle *nextSegment = [[NSFileHandle alloc] initWithFileDescriptor:nextFd closeOnDealloc:YES];
+
+    NSMutableDictionary<id, NSValue *> *nextIndex = [NSMutableDictionary new];
+    NSMutableArray *nextOrder = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *nextOrderOffsets = [NSMutableArray new];
+    off_t nextLength = 0;
+
+    for (NSUInteger i = _orderHead; i < _order.count; i++) {
+        if (![self isLiveEntryAtOrderIndex:i]) {
+            continue;
+        }
+
+        id key = _order[i];
+        NSValue *extent = _index[key];
+
+        NSData *body = [self mapRange:extent.rangeValue ofFile:_segment];
+        if (!body || ![self writeData:body atOffset:nextLength toFile:nextSegment]) {
+            unlink(nextPath.fileSystemRepresentation);
+            return;
+        }
+
+        nextIndex[key] = [NSValue valueWithRange:NSMakeRange((NSUInteger)nextLength, body.length)];
+        [nextOrder addObject:key];
+        [nextOrderOffsets addObject:@(nextLength)];
+        nextLength += body.length;
+    }
+
+    // Outstanding mappings and readers of the old segment remain valid after it is unlinked
+    unlink([self segmentPathForGeneration:_generation].fileSystemRepresentation);
+
+    os_unfair_lock_lock(&_lock);
+    _segment = nextSegment;
+    _index = nextIndex;
+    os_unfair_lock_unlock(&_lock);
+
+    _generation = nextGeneration;
+    _fileLength = nextLength;
+    _order = nextOrder;
+    _orderOffsets = nextOrderOffsets;
+    _orderHead = 0;
+}
+
+@end
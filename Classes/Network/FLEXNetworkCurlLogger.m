@@ -7,6 +7,22 @@
 
 #import "FLEXNetworkCurlLogger.h"
 #import "FLEXUtility.h"
+#import "FLEXInflatingReader.h"
+
+/// The number of bytes at the end that start a UTF-8 sequence without finishing it
+static NSUInteger FLEXIncompleteUTF8Suffix(const uint8_t *bytes, NSUInteger length) {
+    for (NSUInteger i = 1; i <= MIN(length, 3); i++) {
+        uint8_t byte = bytes[length - i];
+        if ((byte & 0xC0) == 0x80) {
+            continue;
+        }
+
+        NSUInteger sequenceLength = byte >= 0xF0 ? 4 : byte >= 0xE0 ? 3 : byte >= 0xC0 ? 2 : 1;
+        return sequenceLength > i ? i : 0;
+    }
+
+    return 0;
+}
 
 @implementation FLEXNetworkCurlLogger
 
@@ -29,11 +45,12 @@
     }
 
     if (request.HTTPBody) {
-        NSData *bodyData = request.HTTPBody;
+        NSString *body = nil;
         if ([FLEXUtility hasCompressedContentEncoding:request]) {
-            bodyData = [FLEXUtility inflatedDataFromCompressedData:bodyData];
+            body = [self inflatedTextOfBody:request.HTTPBody];
+        } else {
+            body = [[NSString alloc] initWithData:request.HTTPBody encoding:NSUTF8StringEncoding];
         }
-        NSString *body = [[NSString alloc] initWithData:bodyData encoding:NSUTF8StringEncoding];
         
         if (body != nil) {
             [curlCommandString appendFormat:@"-d \'%@\'", body];
@@ -50,4 +67,36 @@
     return curlCommandString;
 }
 
+/// Decodes the body as it is inflated, so that it is only ever held as text
+/// @return \c nil if the body is not UTF-8 text or could not be inflated
++ (NSString *)inflatedTextOfBody:(NSData *)compressedBody {
+    FLEXInflatingReader *reader = [FLEXInflatingReader
+        readerWithCompressedData:compressedBody byteLimit:FLEXInflatingReader.defaultByteLimit
+    ];
+
+    NSMutableString *text = [NSMutableString new];
+    // A character split between two chunks
+    NSData *carry = nil;
+    for (NSData *chunk = reader.readChunk; chunk; chunk = reader.readChunk) {
+        if (carry.length) {
+            NSMutableData *joined = carry.mutableCopy;
+            [joined appendData:chunk];
+            chunk = joined;
+        }
+
+        NSUInteger incomplete = FLEXIncompleteUTF8Suffix(chunk.bytes, chunk.length);
+        NSString *part = [[NSString alloc]
+            initWithBytes:chunk.bytes length:chunk.length - incomplete encoding:NSUTF8StringEncoding
+        ];
+        if (!part) {
+            return nil;
+        }
+
+        [text appendString:part];
+        carry = [chunk subdataWithRange:NSMakeRange(chunk.length - incomplete, incomplete)];
+    }
+
+    return reader.atEnd && !carry.length ? text : nil;
+}
+
 @end
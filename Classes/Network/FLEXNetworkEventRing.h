@@ -0,0 +1,58 @@
+//
+//  FLEXNetworkEventRing.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "FLEXNetworkTransaction.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A fixed-size record of something that happened to a request
+typedef struct {
+    FLEXNetworkRequestID requestID;
+    /// From \c mach_absolute_time, taken when the event was posted
+    uint64_t timestamp;
+    int64_t length;
+    /// Retained until the handler returns, or \c NULL
+    __unsafe_unretained id _Nullable object;
+    /// Defined by the owner of the ring
+    uint32_t kind;
+} FLEXNetworkEvent;
+
+/// Called on the ring's queue with events in the order they were posted.
+/// The events and their objects are only valid until the handler returns.
+typedef void (^FLEXNetworkEventHandler)(const FLEXNetworkEvent *events, NSUInteger count);
+
+/// A bounded, lock-free queue of events from many threads, applied in batches on one serial queue.
+///
+/// Posting an event claims a slot with a single compare-and-swap and never allocates;
+/// only the post that finds the ring idle schedules a drain on the queue. Events posted from the same
+/// thread are handled in order. If the ring is full, posting waits for the queue to drain it.
+@interface FLEXNetworkEventRing : NSObject
+
+/// @param capacity Rounded up to a power of 2
+/// @param queue A serial queue, on which the handler is called
++ (instancetype)ringWithCapacity:(NSUInteger)capacity
+                           queue:(dispatch_queue_t)queue
+                         handler:(FLEXNetworkEventHandler)handler;
+
+@property (nonatomic, readonly) NSUInteger capacity;
+
+/// Safe to call from any thread. Timestamps the event with \c mach_absolute_time.
+/// @param object Retained until the event is handled
+- (void)post:(uint32_t)kind requestID:(FLEXNetworkRequestID)requestID
+      length:(int64_t)length object:(nullable id)object;
+
+/// Handles every event posted so far. Must be called on the ring's queue.
+- (void)drain;
+
+/// The wall clock time of a timestamp from \c mach_absolute_time, assuming the device hasn't slept since
++ (NSDate *)dateOfTimestamp:(uint64_t)timestamp;
+
+@end
+
+NS_ASSUME_NONNULL_END
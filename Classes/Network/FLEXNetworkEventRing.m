@@ -0,0 +1,195 @@
+//
+//  FLEXNetworkEventRing.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkEventRing.h"
+#include <stdatomic.h>
+#include <mach/mach_time.h>
+#include <sched.h>
+
+/// Events are copied out of the ring and handed to the handler this many at a time
+#define kFLEXNetworkEventBatchSize 64
+
+/// A slot is free for the producer claiming position \c p when its sequence is \c p,
+/// and holds a published event for the consumer at \c p when its sequence is \c p+1.
+typedef struct {
+    _Atomic(uint64_t) sequence;
+    FLEXNetworkEvent event;
+} FLEXNetworkEventSlot;
+
+static void FLEXNetworkEventRelease(FLEXNetworkEvent *event) {
+    if (event->object) {
+        CFRelease((__bridge CFTypeRef)event->object);
+    }
+}
+
+@interface FLEXNetworkEventRing ()
+@property (nonatomic, readonly) dispatch_queue_t queue;
+@property (nonatomic, readonly) FLEXNetworkEventHandler handler;
+@end
+
+@implementation FLEXNetworkEventRing {
+    FLEXNetworkEventSlot *_slots;
+    uint64_t _mask;
+    /// The next position a producer will claim
+    _Atomic(uint64_t) _writePosition;
+    /// Whether a drain has been dispatched and hasn't started yet
+    atomic_bool _drainScheduled;
+    // Only accessed on the queue
+    uint64_t _readPosition;
+}
+
++ (instancetype)ringWithCapacity:(NSUInteger)capacity
+                           queue:(dispatch_queue_t)queue
+                         handler:(FLEXNetworkEventHandler)handler {
+    NSUInteger size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    FLEXNetworkEventRing *ring = [self new];
+    ring->_capacity = size;
+    ring->_mask = size - 1;
+    ring->_queue = queue;
+    ring->_handler = handler;
+    // Lets a post made on the queue drain a full ring itself instead of waiting on the queue
+    dispatch_queue_set_specific(queue, (__bridge const void *)ring, (__bridge void *)ring, NULL);
+    ring->_slots = calloc(size, sizeof(FLEXNetworkEventSlot));
+    for (NSUInteger i = 0; i < size; i++) {
+        atomic_init(&ring->_slots[i].sequence, i);
+    }
+    atomic_init(&ring->_writePosition, 0);
+    atomic_init(&ring->_drainScheduled, false);
+    return ring;
+}
+
+- (void)dealloc {
+    // Anything still posted was never handled
+    uint64_t end = atomic_load(&_writePosition);
+    for (uint64_t position = _readPosition; position < end; position++) {
+        FLEXNetworkEventSlot *slot = &_slots[position & _mask];
+        if (atomic_load(&slot->sequence) == position + 1) {
+            FLEXNetworkEventRelease(&slot->event);
+        }
+    }
+
+    free(_slots);
+}
+
+#pragma mark Producers
+
+- (void)post:(uint32_t)kind requestID:(FLEXNetworkRequestID)requestID
+      length:(int64_t)length object:(id)object {
+    FLEXNetworkEvent event = {
+        .requestID = requestID,
+        .timestamp = mach_absolute_time(),
+        .length = length,
+        .object = (__bridge id)CFBridgingRetain(object),
+        .kind = kind,
+    };
+
+    while (![self tryPush:&event]) {
+        // Full. Waiting keeps this thread's events in order, and the drain frees the whole ring at once.
+        if (dispatch_get_specific((__bridge const void *)self)) {
+            [self drain];
+        } else {
+            [self scheduleDrain];
+            sched_yield();
+        }
+    }
+
+    [self scheduleDrain];
+}
+
+/// Only the first post since the last drain started pays for a dispatch
+- (void)scheduleDrain {
+    if (!atomic_exchange(&_drainScheduled, true)) {
+        dispatch_async(self.queue, ^{
+            atomic_store(&self->_drainScheduled, false);
+            [self drain];
+        });
+    }
+}
+
+/// @return NO if the ring is full
+- (BOOL)tryPush:(const FLEXNetworkEvent *)event {
+    uint64_t position = atomic_load_explicit(&_writePosition, memory_order_relaxed);
+    FLEXNetworkEventSlot *slot;
+    for (;;) {
+        slot = &_slots[position & _mask];
+        uint64_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        int64_t lag = (int64_t)(sequence - position);
+        if (lag == 0) {
+            // On failure, position is reloaded with the current write position
+            if (atomic_compare_exchange_weak(&_writePosition, &position, position + 1)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // The slot still holds the event from one lap ago
+            return NO;
+        } else {
+            position = atomic_load_explicit(&_writePosition, memory_order_relaxed);
+        }
+    }
+
+    slot->event = *event;
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+    return YES;
+}
+
+#pragma mark Consumer
+
+- (void)drain {
+    FLEXNetworkEvent batch[kFLEXNetworkEventBatchSize];
+    NSUInteger count = 0;
+
+    // Anything claimed after this is covered by the drain its producer schedules
+    uint64_t end = atomic_load(&_writePosition);
+    while (_readPosition < end) {
+        FLEXNetworkEventSlot *slot = &_slots[_readPosition & _mask];
+        // A producer that claimed the slot is at most a struct copy away from publishing it
+        while (atomic_load_explicit(&slot->sequence, memory_order_acquire) != _readPosition + 1) {
+            sched_yield();
+        }
+
+        batch[count++] = slot->event;
+        atomic_store_explicit(&slot->sequence, _readPosition + _capacity, memory_order_release);
+        _readPosition++;
+
+        if (count == kFLEXNetworkEventBatchSize) {
+            [self handleBatch:batch count:count];
+            count = 0;
+        }
+    }
+
+    if (count) {
+        [self handleBatch:batch count:count];
+    }
+}
+
+- (void)handleBatch:(FLEXNetworkEvent *)batch count:(NSUInteger)count {
+    self.handler(batch, count);
+    for (NSUInteger i = 0; i < count; i++) {
+        FLEXNetworkEventRelease(&batch[i]);
+    }
+}
+
+#pragma mark Timestamps
+
++ (NSDate *)dateOfTimestamp:(uint64_t)timestamp {
+    static mach_timebase_info_data_t timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&timebase);
+    });
+
+    uint64_t now = mach_absolute_time();
+    double elapsed = now > timestamp ? (double)(now - timestamp) * timebase.numer / timebase.denom : 0;
+    return [NSDate dateWithTimeIntervalSinceNow:-elapsed / NSEC_PER_SEC];
+}
+
+@end
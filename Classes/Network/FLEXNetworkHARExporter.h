@@ -0,0 +1,36 @@
+//
+//  FLEXNetworkHARExporter.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FLEXNetworkRecorder, FLEXHTTPTransaction;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Exports recorded HTTP transactions as a HAR 1.2 file for desktop tools like Charles or a browser.
+///
+/// The document is streamed to disk through a small write buffer one entry at a time, so memory use
+/// does not grow with the number of transactions. Each response body is only fetched from the
+/// recorder while its entry is being written; bodies that are not valid UTF-8 are base64 encoded
+/// a chunk at a time instead of all at once. Compressed request bodies are inflated as they are written.
+@interface FLEXNetworkHARExporter : NSObject
+
+/// Writes the transactions to \c path in the background, oldest first.
+///
+/// @param transactions Usually the newest-first array of \c FLEXNetworkRecorder.HTTPTransactions
+/// @param completion Called on the main queue when the export stops. Cancelling the returned progress
+/// stops the export with \c NSUserCancelledError. The file is deleted if the export did not finish.
+/// @return The progress of the export, counted in transactions. Cancellable.
++ (NSProgress *)exportTransactions:(NSArray<FLEXHTTPTransaction *> *)transactions
+                      fromRecorder:(FLEXNetworkRecorder *)recorder
+                            toFile:(NSString *)path
+                        completion:(void(^)(NSError *_Nullable error))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,454 @@
+//
+//  FLEXNetworkHARExporter.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkHARExporter.h"
+#import "FLEXNetworkRecorder.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXUtility.h"
+#import "FLEXInflatingReader.h"
+#import "FLEXFileWriter.h"
+
+/// Output is collected in a buffer of this size before it is written to the file
+static const size_t kFLEXHARWriteBufferSize = 64 * 1024;
+/// Bodies are escaped or encoded this many bytes at a time, checking for cancellation in between
+static const NSUInteger kFLEXHARBodySliceSize = 256 * 1024;
+
+typedef void (^FLEXHARSliceBlock)(const uint8_t *bytes, size_t length);
+/// Calls the block with consecutive slices of a body. Sources can be called more than once.
+/// @return Whether the whole body was produced
+typedef BOOL (^FLEXHARBodySource)(FLEXHARSliceBlock block);
+
+static const char kFLEXBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static inline void FLEXBase64EncodeTriple(const uint8_t *triple, char *encoded) {
+    encoded[0] = kFLEXBase64Alphabet[triple[0] >> 2];
+    encoded[1] = kFLEXBase64Alphabet[((triple[0] & 0x03) << 4) | (triple[1] >> 4)];
+    encoded[2] = kFLEXBase64Alphabet[((triple[1] & 0x0F) << 2) | (triple[2] >> 6)];
+    encoded[3] = kFLEXBase64Alphabet[triple[2] & 0x3F];
+}
+
+/// Where \c FLEXValidateUTF8 left off at the end of the previous range
+typedef struct {
+    /// Continuation bytes still expected
+    uint8_t pending;
+    /// The bounds of the next continuation byte. They are only narrower than 80...BF for the
+    /// byte after E0, ED, F0 or F4, which rules out overlong forms, surrogates, and code points
+    /// past U+10FFFF.
+    uint8_t lower, upper;
+} FLEXUTF8State;
+
+static const FLEXUTF8State kFLEXUTF8StateInitial = { 0, 0x80, 0xBF };
+
+/// Validates UTF-8 one range at a time, as defined by RFC 3629
+static BOOL FLEXValidateUTF8(const uint8_t *bytes, size_t length, FLEXUTF8State *state) {
+    FLEXUTF8State s = *state;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = bytes[i];
+        if (s.pending) {
+            if (byte < s.lower || byte > s.upper) {
+                return NO;
+            }
+            s = (FLEXUTF8State){ s.pending - 1, 0x80, 0xBF };
+        } else if (byte < 0x80) {
+            continue;
+        } else if (byte >= 0xC2 && byte <= 0xDF) {
+            s.pending = 1;
+        } else if (byte == 0xE0) {
+            s = (FLEXUTF8State){ 2, 0xA0, 0xBF };
+        } else if (byte == 0xED) {
+            s = (FLEXUTF8State){ 2, 0x80, 0x9F };
+        } else if (byte >= 0xE1 && byte <= 0xEF) {
+            s.pending = 2;
+        } else if (byte == 0xF0) {
+            s = (FLEXUTF8State){ 3, 0x90, 0xBF };
+        } else if (byte == 0xF4) {
+            s = (FLEXUTF8State){ 3, 0x80, 0x8F };
+        } else if (byte >= 0xF1 && byte <= 0xF3) {
+            s.pending = 3;
+        } else {
+            return NO;
+        }
+    }
+
+    *state = s;
+    return YES;
+}
+
+@interface FLEXNetworkHARExporter ()
+@property (nonatomic, readonly) FLEXNetworkRecorder *recorder;
+@property (nonatomic, readonly) NSProgress *progress;
+@property (nonatomic, readonly) NSISO8601DateFormatter *dateFormatter;
+
+- (void)writeFormat:(NSString *)format, ... NS_FORMAT_FUNCTION(1,2);
+@end
+
+@implementation FLEXNetworkHARExporter {
+    FLEXFileWriter *_writer;
+    /// Bytes left over from the previous slice of a base64 encoded body
+    uint8_t _base64Carry[3];
+    size_t _base64CarryLength;
+}
+
++ (NSProgress *)exportTransactions:(NSArray<FLEXHTTPTransaction *> *)transactions
+                      fromRecorder:(FLEXNetworkRecorder *)recorder
+                            toFile:(NSString *)path
+                        completion:(void (^)(NSError *))completion {
+    NSProgress *progress = [NSProgress progressWithTotalUnitCount:transactions.count];
+    NSArray<FLEXHTTPTransaction *> *oldestFirst = transactions.reverseObjectEnumerator.allObjects;
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        FLEXNetworkHARExporter *exporter = [self new];
+        exporter->_recorder = recorder;
+        exporter->_progress = progress;
+
+        NSError *error = [exporter writeTransactions:oldestFirst toFile:path];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(error);
+        });
+    });
+
+    return progress;
+}
+
+#pragma mark Document
+
+- (NSError *)writeTransactions:(NSArray<FLEXHTTPTransaction *> *)transactions toFile:(NSString *)path {
+    NSError *error = nil;
+    _writer = [FLEXFileWriter writerToFile:path bufferSize:kFLEXHARWriteBufferSize error:&error];
+    if (!_writer) {
+        return error;
+    }
+
+    _dateFormatter = [NSISO8601DateFormatter new];
+    _dateFormatter.formatOptions = NSISO8601DateFormatWithInternetDateTime | NSISO8601DateFormatWithFractionalSeconds;
+
+    [self writeString:@"{\"log\":{\"version\":\"1.2\",\"creator\":{\"name\":\"FLEX\",\"version\":\"\"},\"entries\":["];
+    for (NSUInteger i = 0; i < transactions.count; i++) {
+        if (self.progress.isCancelled || _writer.failed) {
+            break;
+        }
+
+        // Response bodies may be memory-mapped; let go of each one before the next
+        @autoreleasepool {
+            if (i > 0) {
+                [self writeString:@","];
+            }
+            [self writeEntryForTransaction:transactions[i]];
+        }
+
+        self.progress.completedUnitCount = i + 1;
+    }
+    [self writeString:@"]}}\n"];
+
+    if (self.progress.isCancelled) {
+        error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSUserCancelledError userInfo:nil];
+    }
+
+    return [_writer closeWithError:error];
+}
+
+- (void)writeEntryForTransaction:(FLEXHTTPTransaction *)transaction {
+    NSURLRequest *request = transaction.request;
+    NSHTTPURLResponse *response = nil;
+    if ([transaction.response isKindOfClass:NSHTTPURLResponse.class]) {
+        response = (id)transaction.response;
+    }
+
+    // HAR times are in milliseconds, and -1 for phases that did not happen
+    double blocked = -1, dns = -1, connect = -1, ssl = -1, send = 0;
+    double wait = MAX(transaction.latency, 0) * 1000;
+    double receive = MAX(transaction.duration - transaction.latency, 0) * 1000;
+
+    FLEXNetworkExchangeTimings *exchange = transaction.timings.finalExchange;
+    if (exchange) {
+        blocked = [self durationOfPhase:FLEXNetworkPhaseQueued inExchange:exchange];
+        dns = [self durationOfPhase:FLEXNetworkPhaseDNS inExchange:exchange];
+        connect = [self durationOfPhase:FLEXNetworkPhaseConnect inExchange:exchange];
+        ssl = [self durationOfPhase:FLEXNetworkPhaseTLS inExchange:exchange];
+        send = MAX([self durationOfPhase:FLEXNetworkPhaseRequest inExchange:exchange], 0);
+        wait = MAX([self durationOfPhase:FLEXNetworkPhaseWait inExchange:exchange], 0);
+        receive = MAX([self durationOfPhase:FLEXNetworkPhaseResponse inExchange:exchange], 0);
+
+        // HAR counts the TLS handshake as part of connecting
+        if (ssl >= 0) {
+            connect = MAX(connect, 0) + ssl;
+        }
+    }
+
+    double time = MAX(blocked, 0) + MAX(dns, 0) + MAX(connect, 0) + send + wait + receive;
+
+    [self writeString:@"{\"startedDateTime\":"];
+    [self writeJSONString:[self.dateFormatter stringFromDate:transaction.startTime]];
+    [self writeFormat:@",\"time\":%.3f", time];
+
+    // The HTTP version isn't known, so it is left empty
+    [self writeString:@",\"request\":{\"method\":"];
+    [self writeJSONString:request.HTTPMethod];
+    [self writeString:@",\"url\":"];
+    [self writeJSONString:request.URL.absoluteString];
+    [self writeString:@",\"httpVersion\":\"\",\"cookies\":[],\"headers\":"];
+    [self writeNameValuePairs:request.allHTTPHeaderFields];
+    [self writeString:@",\"queryString\":"];
+    [self writeQueryItems:[NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:NO].queryItems];
+
+    NSData *requestBody = transaction.cachedRequestBody;
+    if (requestBody.length) {
+        [self writeString:@",\"postData\":{\"mimeType\":"];
+        [self writeJSONString:[request valueForHTTPHeaderField:@"Content-Type"]];
+        [self writeString:@",\"params\":[],"];
+        if (![FLEXUtility hasCompressedContentEncoding:request] ||
+            ![self writeBodyFromSource:[self inflatingSourceForData:requestBody]]) {
+            [self writeBodyFromSource:[self sourceForData:requestBody]];
+        }
+        [self writeString:@"}"];
+    }
+    [self writeFormat:@",\"headersSize\":-1,\"bodySize\":%lu}", (unsigned long)requestBody.length];
+
+    [self writeFormat:@",\"response\":{\"status\":%ld,\"statusText\":", (long)response.statusCode];
+    [self writeJSONString:response ? [NSHTTPURLResponse localizedStringForStatusCode:response.statusCode] : nil];
+    [self writeString:@",\"httpVersion\":\"\",\"cookies\":[],\"headers\":"];
+    [self writeNameValuePairs:response.allHeaderFields];
+    [self writeFormat:@",\"content\":{\"size\":%lld,\"mimeType\":", transaction.receivedDataLength];
+    [self writeJSONString:transaction.response.MIMEType];
+
+    // Only pull the body now so that at most one is in memory at a time
+    NSData *responseBody = nil;
+    if (transaction.state == FLEXNetworkTransactionStateFinished) {
+        responseBody = [self.recorder cachedResponseBodyForTransaction:transaction];
+    }
+    if (responseBody.length) {
+        [self writeString:@","];
+        [self writeBodyFromSource:[self sourceForData:responseBody]];
+    } else if (transaction.receivedDataLength > 0) {
+        [self writeString:@",\"comment\":\"The response body is no longer cached\""];
+    }
+
+    [self writeString:@"},\"redirectURL\":"];
+    [self writeJSONString:[response valueForHTTPHeaderField:@"Location"]];
+    [self writeFormat:@",\"headersSize\":-1,\"bodySize\":%lld}", transaction.receivedDataLength];
+
+    [self writeFormat:@",\"cache\":{},\"timings\":{\"blocked\":%.3f,\"dns\":%.3f,\"connect\":%.3f,\"ssl\":%.3f,"
+        "\"send\":%.3f,\"wait\":%.3f,\"receive\":%.3f}", blocked, dns, connect, ssl, send, wait, receive
+    ];
+    if (transaction.error) {
+        [self writeString:@",\"_error\":"];
+        [self writeJSONString:transaction.error.localizedDescription];
+    }
+    [self writeString:@"}"];
+}
+
+/// @return The duration in milliseconds, or -1 if the phase did not happen
+- (double)durationOfPhase:(FLEXNetworkPhase)phase inExchange:(FLEXNetworkExchangeTimings *)exchange {
+    NSTimeInterval start = 0, end = 0;
+    if (![exchange getStart:&start end:&end ofPhase:phase]) {
+        return -1;
+    }
+
+    return (end - start) * 1000;
+}
+
+- (void)writeNameValuePairs:(NSDictionary<NSString *, NSString *> *)pairs {
+    [self writeString:@"["];
+    __block BOOL first = YES;
+    [pairs enumerateKeysAndObjectsUsingBlock:^(NSString *name, NSString *value, BOOL *stop) {
+        [self writeString:first ? @"{\"name\":" : @",{\"name\":"];
+        [self writeJSONString:name];
+        [self writeString:@",\"value\":"];
+        [self writeJSONString:value.description];
+        [self writeString:@"}"];
+        first = NO;
+    }];
+    [self writeString:@"]"];
+}
+
+- (void)writeQueryItems:(NSArray<NSURLQueryItem *> *)items {
+    [self writeString:@"["];
+    for (NSUInteger i = 0; i < items.count; i++) {
+        [self writeString:i ? @",{\"name\":" : @"{\"name\":"];
+        [self writeJSONString:items[i].name];
+        [self writeString:@",\"value\":"];
+        [self writeJSONString:items[i].value];
+        [self writeString:@"}"];
+    }
+    [self writeString:@"]"];
+}
+
+#pragma mark Bodies
+
+/// Writes the \c text of a HAR content or postData object, base64 encoded unless it is valid UTF-8.
+/// The source is read twice, once to validate it and once to write it.
+/// @return \c NO without writing anything if the source could not produce the whole body
+- (BOOL)writeBodyFromSource:(FLEXHARBodySource)source {
+    __block FLEXUTF8State state = kFLEXUTF8StateInitial;
+    __block BOOL utf8 = YES;
+    BOOL complete = source(^(const uint8_t *bytes, size_t length) {
+        if (utf8) {
+            utf8 = FLEXValidateUTF8(bytes, length, &state);
+        }
+    });
+    if (!complete) {
+        return NO;
+    }
+
+    if (utf8 && !state.pending) {
+        [self writeString:@"\"text\":\""];
+        source(^(const uint8_t *bytes, size_t length) {
+            [self writeEscapedBytes:bytes length:length];
+        });
+        [self writeString:@"\""];
+    } else {
+        [self writeString:@"\"encoding\":\"base64\",\"text\":\""];
+        _base64CarryLength = 0;
+        source(^(const uint8_t *bytes, size_t length) {
+            [self writeBase64Bytes:bytes length:length];
+        });
+        [self finishBase64];
+        [self writeString:@"\""];
+    }
+
+    return YES;
+}
+
+/// Slices the data until the export is cancelled or fails
+- (FLEXHARBodySource)sourceForData:(NSData *)data {
+    return ^BOOL(FLEXHARSliceBlock block) {
+        __block BOOL complete = YES;
+        [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange range, BOOL *stop) {
+            for (NSUInteger offset = 0; offset < range.length; offset += kFLEXHARBodySliceSize) {
+                if (self.progress.isCancelled || self->_writer.failed) {
+                    complete = NO;
+                    *stop = YES;
+                    return;
+                }
+
+                block((const uint8_t *)bytes + offset, MIN(kFLEXHARBodySliceSize, range.length - offset));
+            }
+        }];
+
+        return complete;
+    };
+}
+
+/// Inflates the compressed data a chunk at a time as it is read, so it is never held inflated all at once
+- (FLEXHARBodySource)inflatingSourceForData:(NSData *)compressedData {
+    return ^BOOL(FLEXHARSliceBlock block) {
+        FLEXInflatingReader *reader = [FLEXInflatingReader
+            readerWithCompressedData:compressedData byteLimit:FLEXInflatingReader.defaultByteLimit
+        ];
+
+        while (YES) {
+            @autoreleasepool {
+                NSData *chunk = reader.readChunk;
+                if (!chunk || self.progress.isCancelled || self->_writer.failed) {
+                    break;
+                }
+
+                block(chunk.bytes, chunk.length);
+            }
+        }
+
+        return reader.atEnd;
+    };
+}
+
+- (void)writeBase64Bytes:(const uint8_t *)bytes length:(size_t)length {
+    // Complete the triple left over from the previous slice
+    while (_base64CarryLength && _base64CarryLength < 3 && length) {
+        _base64Carry[_base64CarryLength++] = *bytes++;
+        length--;
+    }
+    if (_base64CarryLength == 3) {
+        char encoded[4];
+        FLEXBase64EncodeTriple(_base64Carry, encoded);
+        [_writer writeBytes:encoded length:sizeof(encoded)];
+        _base64CarryLength = 0;
+    }
+
+    char encoded[4096];
+    while (length >= 3) {
+        size_t triples = MIN(length / 3, sizeof(encoded) / 4);
+        for (size_t i = 0; i < triples; i++) {
+            FLEXBase64EncodeTriple(bytes + i * 3, encoded + i * 4);
+        }
+
+        [_writer writeBytes:encoded length:triples * 4];
+        bytes += triples * 3;
+        length -= triples * 3;
+    }
+
+    memcpy(_base64Carry + _base64CarryLength, bytes, length);
+    _base64CarryLength += length;
+}
+
+- (void)finishBase64 {
+    if (!_base64CarryLength) {
+        return;
+    }
+
+    char encoded[4];
+    memset(_base64Carry + _base64CarryLength, 0, 3 - _base64CarryLength);
+    FLEXBase64EncodeTriple(_base64Carry, encoded);
+    encoded[3] = '=';
+    if (_base64CarryLength == 1) {
+        encoded[2] = '=';
+    }
+
+    [_writer writeBytes:encoded length:sizeof(encoded)];
+    _base64CarryLength = 0;
+}
+
+#pragma mark Output
+
+- (void)writeString:(NSString *)string {
+    [_writer writeString:string];
+}
+
+- (void)writeFormat:(NSString *)format, ... {
+    va_list args;
+    va_start(args, format);
+    [self writeString:[[NSString alloc] initWithFormat:format arguments:args]];
+    va_end(args);
+}
+
+/// Writes \c nil as an empty string
+- (void)writeJSONString:(NSString *)string {
+    const char *utf8 = string.UTF8String ?: "";
+    [_writer writeBytes:"\"" length:1];
+    [self writeEscapedBytes:(const uint8_t *)utf8 length:strlen(utf8)];
+    [_writer writeBytes:"\"" length:1];
+}
+
+/// Writes the contents of a JSON string, escaping quotes, backslashes, and control characters.
+/// Multi-byte UTF-8 sequences never contain those, so they are copied as-is.
+- (void)writeEscapedBytes:(const uint8_t *)bytes length:(size_t)length {
+    size_t start = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t byte = bytes[i];
+        if (byte >= 0x20 && byte != '"' && byte != '\\') {
+            continue;
+        }
+
+        [_writer writeBytes:bytes + start length:i - start];
+        start = i + 1;
+
+        char escape[7];
+        switch (byte) {
+            case '"': strcpy(escape, "\\\""); break;
+            case '\\': strcpy(escape, "\\\\"); break;
+            case '\n': strcpy(escape, "\\n"); break;
+            case '\r': strcpy(escape, "\\r"); break;
+            case '\t': strcpy(escape, "\\t"); break;
+            default: snprintf(escape, sizeof(escape), "\\u%04x", byte); break;
+        }
+        [_writer writeBytes:escape length:strlen(escape)];
+    }
+
+    [_writer writeBytes:bytes + start length:length - start];
+}
+
+@end
@@ -0,0 +1,45 @@
+//
+//  FLEXNetworkHostDenylist.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// An immutable, compiled host denylist.
+///
+/// Rules are matched one whole label at a time and ignore ASCII case:
+/// - \c example.com matches \c example.com and any of its subdomains
+/// - \c *.example.com matches only the subdomains of \c example.com
+/// - \c =example.com matches only \c example.com itself
+/// - \c .example.com is the same as \c example.com
+///
+/// The rules are compiled into a trie of reversed labels (\c com → \c example → ...)
+/// whose edges live in a single open-addressed hash table, so a lookup costs one probe
+/// per label of the host. Lookups don't allocate or lock and are safe from any thread.
+@interface FLEXNetworkHostDenylist : NSObject
+
++ (instancetype)denylistWithRules:(NSArray<NSString *> *)rules;
+
+/// The rules this denylist was compiled from
+@property (nonatomic, readonly) NSArray<NSString *> *rules;
+
+- (BOOL)containsHost:(nullable NSString *)host;
+
+@end
+
+/// A mutable array of denylist rules that compiles itself on every change.
+/// It may be mutated on any thread while hosts are looked up on any other.
+@interface FLEXNetworkHostDenylistRules : NSMutableArray<NSString *>
+
+/// The rules compiled as of the last mutation, swapped in atomically.
+/// Reading it never locks or compiles.
+@property (nonatomic, readonly) FLEXNetworkHostDenylist *denylist;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,344 @@
+//
+//  FLEXNetworkHostDenylist.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkHostDenylist.h"
+#import <os/lock.h>
+#include <stdatomic.h>
+
+/// Host names are at most 253 characters, plus a trailing dot
+static const size_t kFLEXMaxHostLength = 256;
+
+typedef NS_OPTIONS(uint8_t, FLEXHostRuleMatch) {
+    FLEXHostRuleMatchSelf = 1 << 0,
+    FLEXHostRuleMatchSubdomains = 1 << 1,
+};
+
+/// A labeled edge from a node to one of its children
+typedef struct {
+    uint32_t parent;
+    /// 0 marks an empty slot, since the root is never anyone's child
+    uint32_t child;
+    uint32_t labelOffset;
+    uint32_t labelLength;
+} FLEXHostTrieEdge;
+
+static inline uint8_t FLEXFoldHostByte(uint8_t byte) {
+    return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+}
+
+/// FNV-1a over the parent node and the case folded label
+static inline uint64_t FLEXHashEdge(uint32_t parent, const char *label, size_t length) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < sizeof(parent); i++) {
+        hash = (hash ^ ((parent >> (i * 8)) & 0xFF)) * 1099511628211ull;
+    }
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ FLEXFoldHostByte(label[i])) * 1099511628211ull;
+    }
+
+    return hash;
+}
+
+@implementation FLEXNetworkHostDenylist {
+    /// The FLEXHostRuleMatch of each node, where node 0 is the root
+    uint8_t *_matches;
+    /// Open-addressed by FLEXHashEdge, with linear probing
+    FLEXHostTrieEdge *_edges;
+    /// A power of two, at least twice the number of edges
+    size_t _edgeCapacity;
+    size_t _edgeCount;
+    /// Every label, already folded to lowercase
+    char *_labels;
+}
+
++ (instancetype)denylistWithRules:(NSArray<NSString *> *)rules {
+    FLEXNetworkHostDenylist *denylist = [self new];
+    denylist->_rules = rules.copy ?: @[];
+    [denylist compile];
+    return denylist;
+}
+
+- (void)dealloc {
+    free(_matches);
+    free(_edges);
+    free(_labels);
+}
+
+#pragma mark Public
+
+- (BOOL)containsHost:(NSString *)host {
+    char buffer[kFLEXMaxHostLength];
+    if (!_edgeCount || ![host getCString:buffer maxLength:sizeof(buffer) encoding:NSUTF8StringEncoding]) {
+        return NO;
+    }
+
+    size_t end = strlen(buffer);
+    if (end && buffer[end - 1] == '.') {
+        // Fully qualified
+        end--;
+    }
+    if (!end) {
+        return NO;
+    }
+
+    // Walk down the trie from the last label to the first
+    uint32_t node = 0;
+    while (YES) {
+        size_t start = end;
+        while (start > 0 && buffer[start - 1] != '.') {
+            start--;
+        }
+
+        node = [self childOfNode:node label:buffer + start length:end - start];
+        if (!node) {
+            return NO;
+        }
+        if (start == 0) {
+            return (_matches[node] & FLEXHostRuleMatchSelf) != 0;
+        }
+        if (_matches[node] & FLEXHostRuleMatchSubdomains) {
+            return YES;
+        }
+
+        end = start - 1;
+    }
+}
+
+#pragma mark Private
+
+/// @return 0 if there is no such child
+- (uint32_t)childOfNode:(uint32_t)parent label:(const char *)label length:(size_t)length {
+    size_t mask = _edgeCapacity - 1;
+    for (size_t slot = FLEXHashEdge(parent, label, length) & mask; _edges[slot].child; slot = (slot + 1) & mask) {
+        FLEXHostTrieEdge edge = _edges[slot];
+        if (edge.parent != parent || edge.labelLength != length) {
+            continue;
+        }
+
+        const char *candidate = _labels + edge.labelOffset;
+        size_t i = 0;
+        while (i < length && FLEXFoldHostByte(label[i]) == candidate[i]) {
+            i++;
+        }
+        if (i == length) {
+            return edge.child;
+        }
+    }
+
+    return 0;
+}
+
+- (void)compile {
+    // Build the trie out of dictionaries first, then flatten it
+    NSMutableArray<NSMutableDictionary<NSString *, NSNumber *> *> *children = [NSMutableArray new];
+    NSMutableData *matches = [NSMutableData dataWithLength:1];
+    [children addObject:[NSMutableDictionary new]];
+    size_t labelBytes = 0;
+
+    NSCharacterSet *whitespace = NSCharacterSet.whitespaceAndNewlineCharacterSet;
+    for (NSString *rule in self.rules) {
+        NSString *host = [rule stringByTrimmingCharactersInSet:whitespace].lowercaseString;
+        FLEXHostRuleMatch match = FLEXHostRuleMatchSelf | FLEXHostRuleMatchSubdomains;
+        if ([host hasPrefix:@"*."]) {
+            match = FLEXHostRuleMatchSubdomains;
+            host = [host substringFromIndex:2];
+        } else if ([host hasPrefix:@"="]) {
+            match = FLEXHostRuleMatchSelf;
+            host = [host substringFromIndex:1];
+        }
+        if ([host hasPrefix:@"."]) {
+            // Written the way cookie domains are
+            host = [host substringFromIndex:1];
+        }
+        if ([host hasSuffix:@"."]) {
+            host = [host substringToIndex:host.length - 1];
+        }
+
+        NSArray<NSString *> *labels = [host componentsSeparatedByString:@"."];
+        if (!host.length || [labels containsObject:@""]) {
+            continue;
+        }
+
+        NSUInteger node = 0;
+        for (NSString *label in labels.reverseObjectEnumerator) {
+            NSNumber *child = children[node][label];
+            if (!child) {
+                child = @(children.count);
+                children[node][label] = child;
+                [children addObject:[NSMutableDictionary new]];
+                [matches increaseLengthBy:1];
+                labelBytes += strlen(label.UTF8String);
+                _edgeCount++;
+            }
+
+            node = child.unsignedIntegerValue;
+        }
+
+        ((uint8_t *)matches.mutableBytes)[node] |= match;
+    }
+
+    _matches = malloc(matches.length);
+    memcpy(_matches, matches.bytes, matches.length);
+
+    _edgeCapacity = 2;
+    while (_edgeCapacity < _edgeCount * 2) {
+        _edgeCapacity *= 2;
+    }
+    _edges = calloc(_edgeCapacity, sizeof(FLEXHostTrieEdge));
+    _labels = malloc(MAX(labelBytes, 1));
+
+    size_t mask = _edgeCapacity - 1;
+    uint32_t labelOffset = 0;
+    for (uint32_t parent = 0; parent < children.count; parent++) {
+        for (NSString *label in children[parent]) {
+            const char *bytes = label.UTF8String;
+            uint32_t length = (uint32_t)strlen(bytes);
+            memcpy(_labels + labelOffset, bytes, length);
+
+            size_t slot = FLEXHashEdge(parent, bytes, length) & mask;
+            while (_edges[slot].child) {
+                slot = (slot + 1) & mask;
+            }
+
+            _edges[slot] = (FLEXHostTrieEdge){
+                .parent = parent,
+                .child = children[parent][label].unsignedIntValue,
+                .labelOffset = labelOffset,
+                .labelLength = length,
+            };
+            labelOffset += length;
+        }
+    }
+}
+
+@end
+
+@implementation FLEXNetworkHostDenylistRules {
+    /// Serializes mutations. Lookups never take it.
+    os_unfair_lock _lock;
+    NSMutableArray<NSString *> *_storage;
+    /// The rules as last compiled, owned by \c _published
+    _Atomic(void *) _denylist;
+    /// Every denylist ever compiled, since a lookup may still be reading a replaced one.
+    /// Rules change rarely and by hand, and each trie is a few bytes per label.
+    NSMutableArray<FLEXNetworkHostDenylist *> *_published;
+}
+
+- (instancetype)init {
+    return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)numItems {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _storage = [NSMutableArray arrayWithCapacity:numItems];
+        _published = [NSMutableArray new];
+        [self publish];
+    }
+
+    return self;
+}
+
+- (instancetype)initWithObjects:(const id _Nonnull [])objects count:(NSUInteger)cnt {
+    self = [self initWithCapacity:cnt];
+    if (self) {
+        [self mutate:^(NSMutableArray<NSString *> *storage) {
+            [storage addObjectsFromArray:[NSArray arrayWithObjects:objects count:cnt]];
+        }];
+    }
+
+    return self;
+}
+
+- (FLEXNetworkHostDenylist *)denylist {
+    return (__bridge FLEXNetworkHostDenylist *)atomic_load_explicit(&_denylist, memory_order_acquire);
+}
+
+/// Compiles the rules and swaps them in for lookups. Call with the lock held.
+- (void)publish {
+    FLEXNetworkHostDenylist *denylist = [FLEXNetworkHostDenylist denylistWithRules:_storage];
+    [_published addObject:denylist];
+    atomic_store_explicit(&_denylist, (__bridge void *)denylist, memory_order_release);
+}
+
+/// Runs \c block under the lock and publishes the changed rules
+- (void)mutate:(void(^)(NSMutableArray<NSString *> *storage))block {
+    os_unfair_lock_lock(&_lock);
+    block(_storage);
+    [self publish];
+    os_unfair_lock_unlock(&_lock);
+}
+#pragma mark NSArray
+
+- (NSUInteger)count {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _storage.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSString *)objectAtIndex:(NSUInteger)index {
+    os_unfair_lock_lock(&_lock);
+    NSString *rule = index < _storage.count ? _storage[index] : nil;
+    os_unfair_lock_unlock(&_lock);
+
+    if (!rule) {
+        [NSException raise:NSRangeException format:@"Index %@ beyond bounds", @(index)];
+    }
+    return rule;
+}
+
+#pragma mark NSMutableArray
+
+- (void)insertObject:(NSString *)rule atIndex:(NSUInteger)index {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage insertObject:rule atIndex:index];
+    }];
+}
+
+- (void)removeObjectAtIndex:(NSUInteger)index {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage removeObjectAtIndex:index];
+    }];
+}
+
+- (void)addObject:(NSString *)rule {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage addObject:rule];
+    }];
+}
+
+- (void)removeLastObject {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage removeLastObject];
+    }];
+}
+
+- (void)replaceObjectAtIndex:(NSUInteger)index withObject:(NSString *)rule {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage replaceObjectAtIndex:index withObject:rule];
+    }];
+}
+
+// Overridden so that lookups never see these half done
+
+- (void)removeAllObjects {
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage removeAllObjects];
+    }];
+}
+
+- (void)setArray:(NSArray<NSString *> *)rules {
+    rules = rules.copy;
+    [self mutate:^(NSMutableArray<NSString *> *storage) {
+        [storage setArray:rules];
+    }];
+}
+
+@end
@@ -0,0 +1,85 @@
+//
+//  FLEXNetworkJournal.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTransaction.h"
+
+@class FLEXNetworkJournalSession;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// An append-only log of the HTTP transactions of one launch of the app, so that they
+/// can be inspected after a relaunch.
+///
+/// Each launch writes a session directory of log segments and an index. A record holds the
+/// metadata of one finished or failed transaction, and optionally its bodies. The index holds
+/// a fixed-size entry per record, so a session can be listed without reading the log.
+///
+/// Appending only encodes the record and queues it. A background writer commits everything
+/// queued at most once per \c kFLEXNetworkJournalCommitInterval in a single write to each file.
+/// If the writer falls too far behind, records are dropped rather than buffered without bound.
+/// Segments are rotated by size, and the oldest sessions and segments are deleted to stay
+/// within \c byteLimit.
+@interface FLEXNetworkJournal : NSObject
+
+/// Where sessions are kept unless told otherwise, in the caches directory
+@property (nonatomic, readonly, class) NSString *defaultDirectory;
+
+/// Starts a new session in the directory, which is created if needed
++ (instancetype)journalInDirectory:(NSString *)directory byteLimit:(NSUInteger)byteLimit;
+
+@property (nonatomic, readonly) NSString *directory;
+/// The total size of every session in the directory, including this one
+@property (nonatomic) NSUInteger byteLimit;
+/// Whether request and response bodies are written with the metadata
+@property (nonatomic) BOOL includesBodies;
+/// The name of this launch's session directory
+@property (nonatomic, readonly) NSString *sessionName;
+/// Records dropped because the writer couldn't keep up
+@property (nonatomic, readonly) NSUInteger droppedCount;
+
+/// Encodes the transaction on the calling thread and queues it for the writer. Call this once
+/// the transaction has finished or failed, from the thread that owns it.
+/// @param responseBody Ignored unless \c includesBodies is set
+- (void)appendTransaction:(FLEXHTTPTransaction *)transaction responseBody:(nullable NSData *)responseBody;
+
+/// Blocks until everything appended so far has been committed
+- (void)flush;
+
+/// Every session in the directory, newest first
++ (NSArray<FLEXNetworkJournalSession *> *)sessionsInDirectory:(NSString *)directory;
+/// Every session in the directory except this one, newest first
+- (NSArray<FLEXNetworkJournalSession *> *)previousSessions;
+
+@end
+
+/// A transaction read back from a journal
+@interface FLEXJournaledHTTPTransaction : FLEXHTTPTransaction
+/// Mapped from the journal on each access; \c nil if bodies weren't journaled or the segment is gone
+@property (nonatomic, readonly, nullable) NSData *responseBody;
+@end
+
+/// The journal of one launch, read lazily: records are decoded when they are first asked for.
+@interface FLEXNetworkJournalSession : NSObject
+
+@property (nonatomic, readonly) NSString *path;
+@property (nonatomic, readonly) NSDate *startDate;
+/// The number of transactions, from the index. Records in deleted segments are not counted.
+@property (nonatomic, readonly) NSUInteger count;
+/// The size of the session on disk
+@property (nonatomic, readonly) NSUInteger byteCount;
+
+/// @param idx 0 is the newest transaction
+/// @return \c nil if the record was damaged or its segment has been deleted since
+- (nullable FLEXJournaledHTTPTransaction *)transactionAtIndex:(NSUInteger)idx;
+
+/// Deletes the session from disk. It must not be the session currently being written.
+- (BOOL)remove:(NSError **)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
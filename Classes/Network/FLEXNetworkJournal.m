@@ -0,0 +1,812 @@
+//
+//  FLEXNetworkJournal.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkJournal.h"
+#import <UIKit/UIKit.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <os/lock.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/// How long appended records wait to be committed together
+static const NSTimeInterval kFLEXNetworkJournalCommitInterval = 0.25;
+/// Records appended while this much is already waiting to be committed are dropped
+static const NSUInteger kFLEXNetworkJournalMaxPendingBytes = 16 * 1024 * 1024;
+/// Segments are rotated at an eighth of the byte limit, within these bounds
+static const NSUInteger kFLEXNetworkJournalMinSegmentSize = 1024 * 1024;
+static const NSUInteger kFLEXNetworkJournalMaxSegmentSize = 32 * 1024 * 1024;
+/// Marks the start of every record, to catch an index pointing at the wrong place
+static const uint32_t kFLEXNetworkJournalRecordMagic = 0x4A584C46; // "FLXJ" on disk
+static const uint32_t kFLEXNetworkJournalRecordVersion = 1;
+
+static NSString * const kFLEXNetworkJournalSessionPrefix = @"session-";
+static NSString * const kFLEXNetworkJournalSegmentPrefix = @"segment-";
+static NSString * const kFLEXNetworkJournalIndexName = @"index";
+
+/// One fixed-size entry per record in a session's index file
+typedef struct {
+    uint32_t segment;
+    uint32_t length;
+    uint64_t offset;
+} FLEXNetworkJournalIndexEntry;
+
+/// The header of every record in a segment
+typedef struct {
+    uint32_t magic;
+    uint32_t length;
+} FLEXNetworkJournalRecordHeader;
+
+typedef NS_OPTIONS(uint32_t, FLEXNetworkJournalRecordFlags) {
+    FLEXNetworkJournalRecordHasResponse = 1 << 0,
+    FLEXNetworkJournalRecordHasHTTPResponse = 1 << 1,
+    FLEXNetworkJournalRecordHasError = 1 << 2,
+};
+
+#pragma mark - Helpers
+
+static NSString *FLEXNetworkJournalSegmentName(uint32_t segment) {
+    return [NSString stringWithFormat:@"%@%u.log", kFLEXNetworkJournalSegmentPrefix, segment];
+}
+
+/// The segment number of a segment file name, or -1 for other files
+static int64_t FLEXNetworkJournalSegmentNumber(NSString *name) {
+    if (![name hasPrefix:kFLEXNetworkJournalSegmentPrefix] || ![name.pathExtension isEqualToString:@"log"]) {
+        return -1;
+    }
+
+    NSString *number = [name.stringByDeletingPathExtension substringFromIndex:kFLEXNetworkJournalSegmentPrefix.length];
+    return number.longLongValue;
+}
+
+/// The total size of the regular files in a directory
+static NSUInteger FLEXNetworkJournalSizeOfDirectory(NSString *path) {
+    NSUInteger size = 0;
+    NSFileManager *manager = NSFileManager.defaultManager;
+    for (NSString *name in [manager contentsOfDirectoryAtPath:path error:nil]) {
+        NSDictionary *attributes = [manager attributesOfItemAtPath:[path stringByAppendingPathComponent:name] error:nil];
+        size += attributes.fileSize;
+    }
+
+    return size;
+}
+
+/// Writes every buffer, retrying after partial writes. \c iov is modified.
+static BOOL FLEXNetworkJournalWriteAll(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, MIN(count, IOV_MAX));
+        if (written < 0) {
+            return NO;
+        }
+
+        while (count > 0 && written >= (ssize_t)iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+
+        if (count > 0) {
+            iov->iov_base = (uint8_t *)iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+
+    return YES;
+}
+
+/// The returned data unmaps itself when deallocated
+static NSData *FLEXNetworkJournalMapFile(NSString *path, uint64_t offset, NSUInteger length) {
+    if (!length) {
+        return nil;
+    }
+
+    int fd = open(path.fileSystemRepresentation, O_RDONLY);
+    if (fd < 0) {
+        return nil;
+    }
+
+    // mmap offsets must be page aligned
+    uint64_t pageSize = getpagesize();
+    uint64_t alignedOffset = (offset / pageSize) * pageSize;
+    size_t slack = (size_t)(offset - alignedOffset);
+    size_t mappedLength = slack + length;
+
+    // The mapping outlives the file descriptor
+    void *base = mmap(NULL, mappedLength, PROT_READ, MAP_PRIVATE, fd, (off_t)alignedOffset);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return nil;
+    }
+
+    return [[NSData alloc]
+        initWithBytesNoCopy:(uint8_t *)base + slack
+        length:length
+        deallocator:^(void *bytes, NSUInteger len) {
+            munmap(base, mappedLength);
+        }
+    ];
+}
+
+#pragma mark - Encoding
+
+/// Appends little-endian fields to a record
+@interface FLEXNetworkJournalEncoder : NSObject
+@property (nonatomic, readonly) NSMutableData *data;
+@end
+
+@implementation FLEXNetworkJournalEncoder
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _data = [NSMutableData dataWithLength:sizeof(FLEXNetworkJournalRecordHeader)];
+    }
+
+    return self;
+}
+
+- (void)encodeUInt32:(uint32_t)value {
+    value = CFSwapInt32HostToLittle(value);
+    [_data appendBytes:&value length:sizeof(value)];
+}
+
+- (void)encodeUInt64:(uint64_t)value {
+    value = CFSwapInt64HostToLittle(value);
+    [_data appendBytes:&value length:sizeof(value)];
+}
+
+- (void)encodeDouble:(double)value {
+    CFSwappedFloat64 swapped = CFConvertDoubleHostToSwapped(value);
+    [_data appendBytes:&swapped length:sizeof(swapped)];
+}
+
+- (void)encodeBytes:(NSData *)data {
+    [self encodeUInt32:(uint32_t)data.length];
+    if (data.length) {
+        [_data appendData:data];
+    }
+}
+
+- (void)encodeString:(NSString *)string {
+    [self encodeBytes:[string dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+- (void)encodeHeaders:(NSDictionary<NSString *, NSString *> *)headers {
+    [self encodeUInt32:(uint32_t)headers.count];
+    [headers enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        [self encodeString:key];
+        [self encodeString:[value description]];
+    }];
+}
+
+/// Fills in the record header
+- (NSData *)finishWithTrailingLength:(NSUInteger)trailingLength {
+    FLEXNetworkJournalRecordHeader header = {
+        CFSwapInt32HostToLittle(kFLEXNetworkJournalRecordMagic),
+        CFSwapInt32HostToLittle((uint32_t)(_data.length + trailingLength - sizeof(header))),
+    };
+    [_data replaceBytesInRange:NSMakeRange(0, sizeof(header)) withBytes:&header];
+    return _data;
+}
+
+@end
+
+/// Reads the fields of a record back; every read fails once one has run past the end
+@interface FLEXNetworkJournalDecoder : NSObject {
+    @public
+    const uint8_t *_bytes;
+    NSUInteger _length;
+    NSUInteger _cursor;
+    BOOL _failed;
+}
+@end
+
+@implementation FLEXNetworkJournalDecoder
+
+- (BOOL)take:(NSUInteger)count into:(void *)buffer {
+    if (_failed || count > _length - _cursor) {
+        _failed = YES;
+        return NO;
+    }
+
+    if (buffer) {
+        memcpy(buffer, _bytes + _cursor, count);
+    }
+    _cursor += count;
+    return YES;
+}
+
+- (uint32_t)decodeUInt32 {
+    uint32_t value = 0;
+    [self take:sizeof(value) into:&value];
+    return CFSwapInt32LittleToHost(value);
+}
+
+- (uint64_t)decodeUInt64 {
+    uint64_t value = 0;
+    [self take:sizeof(value) into:&value];
+    return CFSwapInt64LittleToHost(value);
+}
+
+- (double)decodeDouble {
+    CFSwappedFloat64 swapped = { 0 };
+    [self take:sizeof(swapped) into:&swapped];
+    return CFConvertDoubleSwappedToHost(swapped);
+}
+
+- (NSData *)decodeBytes {
+    NSUInteger length = [self decodeUInt32];
+    NSUInteger start = _cursor;
+    if (![self take:length into:NULL] || !length) {
+        return nil;
+    }
+
+    return [NSData dataWithBytes:_bytes + start length:length];
+}
+
+- (NSString *)decodeString {
+    NSData *data = [self decodeBytes];
+    return data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+}
+
+- (NSDictionary<NSString *, NSString *> *)decodeHeaders {
+    uint32_t count = [self decodeUInt32];
+    NSMutableDictionary<NSString *, NSString *> *headers = [NSMutableDictionary new];
+    for (uint32_t i = 0; i < count && !_failed; i++) {
+        NSString *key = [self decodeString];
+        NSString *value = [self decodeString];
+        if (key) {
+            headers[key] = value ?: @"";
+        }
+    }
+
+    return headers;
+}
+
+@end
+
+#pragma mark - FLEXJournaledHTTPTransaction
+
+@interface FLEXJournaledHTTPTransaction ()
+@property (nonatomic, copy) NSString *segmentPath;
+@property (nonatomic) uint64_t responseBodyOffset;
+@property (nonatomic) NSUInteger responseBodyLength;
+@end
+
+@implementation FLEXJournaledHTTPTransaction
+
+- (NSData *)responseBody {
+    return FLEXNetworkJournalMapFile(self.segmentPath, self.responseBodyOffset, self.responseBodyLength);
+}
+
+@end
+
+#pragma mark - FLEXNetworkJournalSession
+
+@interface FLEXNetworkJournalSession ()
+@property (nonatomic, readonly) NSData *index;
+/// Entries before this one point into deleted segments
+@property (nonatomic, readonly) NSUInteger firstLiveEntry;
+@property (nonatomic, readonly) NSCache<NSNumber *, FLEXJournaledHTTPTransaction *> *decoded;
+@end
+
+@implementation FLEXNetworkJournalSession
+
++ (instancetype)sessionAtPath:(NSString *)path {
+    NSString *name = path.lastPathComponent;
+    if (![name hasPrefix:kFLEXNetworkJournalSessionPrefix]) {
+        return nil;
+    }
+
+    FLEXNetworkJournalSession *session = [self new];
+    session->_path = path;
+    uint64_t milliseconds = [name substringFromIndex:kFLEXNetworkJournalSessionPrefix.length].longLongValue;
+    session->_startDate = [NSDate dateWithTimeIntervalSince1970:milliseconds / 1000.0];
+    session->_decoded = [NSCache new];
+    session->_byteCount = FLEXNetworkJournalSizeOfDirectory(path);
+
+    // A snapshot; records committed after this are not seen
+    NSString *indexPath = [path stringByAppendingPathComponent:kFLEXNetworkJournalIndexName];
+    session->_index = [NSData dataWithContentsOfFile:indexPath options:NSDataReadingMappedIfSafe error:nil] ?: [NSData new];
+
+    // Segments are deleted oldest first, so the live records are a suffix of the index
+    int64_t oldestSegment = INT64_MAX;
+    for (NSString *file in [NSFileManager.defaultManager contentsOfDirectoryAtPath:path error:nil]) {
+        int64_t segment = FLEXNetworkJournalSegmentNumber(file);
+        if (segment >= 0) {
+            oldestSegment = MIN(oldestSegment, segment);
+        }
+    }
+
+    NSUInteger total = session.index.length / sizeof(FLEXNetworkJournalIndexEntry);
+    NSUInteger first = 0;
+    while (first < total && [session entryAtPosition:first].segment < oldestSegment) {
+        first++;
+    }
+
+    session->_firstLiveEntry = first;
+    session->_count = total - first;
+    return session;
+}
+
+- (FLEXNetworkJournalIndexEntry)entryAtPosition:(NSUInteger)position {
+    FLEXNetworkJournalIndexEntry entry;
+    [self.index getBytes:&entry range:NSMakeRange(position * sizeof(entry), sizeof(entry))];
+    entry.segment = CFSwapInt32LittleToHost(entry.segment);
+    entry.length = CFSwapInt32LittleToHost(entry.length);
+    entry.offset = CFSwapInt64LittleToHost(entry.offset);
+    return entry;
+}
+
+- (FLEXJournaledHTTPTransaction *)transactionAtIndex:(NSUInteger)idx {
+    if (idx >= self.count) {
+        return nil;
+    }
+
+    FLEXJournaledHTTPTransaction *transaction = [self.decoded objectForKey:@(idx)];
+    if (!transaction) {
+        FLEXNetworkJournalIndexEntry entry = [self entryAtPosition:self.firstLiveEntry + self.count - 1 - idx];
+        NSString *segmentPath = [self.path stringByAppendingPathComponent:FLEXNetworkJournalSegmentName(entry.segment)];
+        transaction = [[self class] decodeRecord:FLEXNetworkJournalMapFile(segmentPath, entry.offset, entry.length)
+            atOffset:entry.offset inSegment:segmentPath
+        ];
+        if (transaction) {
+            [self.decoded setObject:transaction forKey:@(idx)];
+        }
+    }
+
+    return transaction;
+}
+
++ (FLEXJournaledHTTPTransaction *)decodeRecord:(NSData *)record atOffset:(uint64_t)offset inSegment:(NSString *)segmentPath {
+    if (record.length < sizeof(FLEXNetworkJournalRecordHeader)) {
+        return nil;
+    }
+
+    FLEXNetworkJournalDecoder *decoder = [FLEXNetworkJournalDecoder new];
+    decoder->_bytes = record.bytes;
+    decoder->_length = record.length;
+
+    if ([decoder decodeUInt32] != kFLEXNetworkJournalRecordMagic ||
+        [decoder decodeUInt32] != record.length - sizeof(FLEXNetworkJournalRecordHeader) ||
+        [decoder decodeUInt32] != kFLEXNetworkJournalRecordVersion) {
+        return nil;
+    }
+
+    FLEXNetworkJournalRecordFlags flags = [decoder decodeUInt32];
+    FLEXNetworkRequestID requestID = [decoder decodeUInt64];
+    NSDate *startTime = [NSDate dateWithTimeIntervalSince1970:[decoder decodeDouble]];
+    NSTimeInterval latency = [decoder decodeDouble];
+    NSTimeInterval duration = [decoder decodeDouble];
+    FLEXNetworkTransactionState state = (int32_t)[decoder decodeUInt32];
+    int64_t receivedDataLength = [decoder decodeUInt64];
+    NSString *URLString = [decoder decodeString];
+    NSString *method = [decoder decodeString];
+    NSString *mechanism = [decoder decodeString];
+    NSDictionary *requestHeaders = [decoder decodeHeaders];
+    NSData *requestBody = [decoder decodeBytes];
+    NSInteger statusCode = (int32_t)[decoder decodeUInt32];
+    NSString *MIMEType = [decoder decodeString];
+    NSDictionary *responseHeaders = [decoder decodeHeaders];
+    NSString *errorDomain = [decoder decodeString];
+    NSInteger errorCode = (int64_t)[decoder decodeUInt64];
+    NSString *errorDescription = [decoder decodeString];
+    NSUInteger responseBodyLength = [decoder decodeUInt32];
+    NSUInteger responseBodyStart = decoder->_cursor;
+    [decoder take:responseBodyLength into:NULL];
+
+    NSURL *URL = URLString ? [NSURL URLWithString:URLString] : nil;
+    if (decoder->_failed || !URL) {
+        return nil;
+    }
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:URL];
+    request.HTTPMethod = method ?: @"GET";
+    request.allHTTPHeaderFields = requestHeaders;
+    request.HTTPBody = requestBody;
+
+    FLEXJournaledHTTPTransaction *transaction = [FLEXJournaledHTTPTransaction
+        request:request identifier:requestID startTime:startTime
+    ];
+    transaction.latency = latency;
+    transaction.duration = duration;
+    transaction.state = state;
+    transaction.receivedDataLength = receivedDataLength;
+    transaction.requestMechanism = mechanism;
+
+    if (flags & FLEXNetworkJournalRecordHasHTTPResponse) {
+        transaction.response = [[NSHTTPURLResponse alloc]
+            initWithURL:URL statusCode:statusCode HTTPVersion:nil headerFields:responseHeaders
+        ];
+    } else if (flags & FLEXNetworkJournalRecordHasResponse) {
+        transaction.response = [[NSURLResponse alloc]
+            initWithURL:URL MIMEType:MIMEType expectedContentLength:receivedDataLength textEncodingName:nil
+        ];
+    }
+
+    if (flags & FLEXNetworkJournalRecordHasError) {
+        transaction.error = [NSError errorWithDomain:errorDomain ?: @"" code:errorCode userInfo:@{
+            NSLocalizedDescriptionKey: errorDescription ?: @"",
+        }];
+    }
+
+    if (responseBodyLength) {
+        transaction.segmentPath = segmentPath;
+        transaction.responseBodyOffset = offset + responseBodyStart;
+        transaction.responseBodyLength = responseBodyLength;
+    }
+
+    return transaction;
+}
+
+- (BOOL)remove:(NSError **)error {
+    return [NSFileManager.defaultManager removeItemAtPath:self.path error:error];
+}
+
+@end
+
+#pragma mark - FLEXNetworkJournal
+
+@interface FLEXNetworkJournal ()
+@property (nonatomic, readonly) NSString *sessionPath;
+@property (nonatomic, readonly) dispatch_queue_t queue;
+@end
+
+@implementation FLEXNetworkJournal {
+    // Guarded by _lock
+    os_unfair_lock _lock;
+    /// Encoded records waiting to be committed, each followed by its body or NSNull
+    NSMutableArray *_pending;
+    NSUInteger _pendingBytes;
+    BOOL _commitScheduled;
+    /// Set from any thread, and read by appends and on _queue
+    NSUInteger _byteLimit;
+
+    // Everything below is only accessed on _queue
+    int _segmentFD;
+    int _indexFD;
+    uint32_t _segment;
+    uint64_t _segmentLength;
+    /// Sizes of this session's segments that still exist, oldest first, including the current one
+    NSMutableArray<NSNumber *> *_segmentSizes;
+    uint32_t _oldestSegment;
+    uint64_t _indexLength;
+    /// Paths and sizes of the other sessions in the directory, oldest first
+    NSMutableArray<NSString *> *_previousSessionPaths;
+    NSMutableArray<NSNumber *> *_previousSessionSizes;
+}
+
++ (NSString *)defaultDirectory {
+    NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+    return [caches stringByAppendingPathComponent:@"com.flex.FLEXNetworkJournal"];
+}
+
++ (instancetype)journalInDirectory:(NSString *)directory byteLimit:(NSUInteger)byteLimit {
+    FLEXNetworkJournal *journal = [self new];
+    journal->_directory = directory;
+    journal->_byteLimit = byteLimit;
+    journal->_lock = OS_UNFAIR_LOCK_INIT;
+    journal->_pending = [NSMutableArray new];
+    journal->_segmentFD = -1;
+    journal->_indexFD = -1;
+    journal->_segmentSizes = [NSMutableArray new];
+
+    uint64_t milliseconds = (uint64_t)(NSDate.date.timeIntervalSince1970 * 1000);
+    journal->_sessionName = [NSString stringWithFormat:@"%@%llu", kFLEXNetworkJournalSessionPrefix, milliseconds];
+    journal->_sessionPath = [directory stringByAppendingPathComponent:journal.sessionName];
+    journal->_queue = dispatch_queue_create("com.flex.FLEXNetworkJournal", DISPATCH_QUEUE_SERIAL);
+
+    dispatch_async(journal.queue, ^{
+        [journal openSession];
+    });
+
+    // Don't lose the last few records if the app is suspended and then killed
+    [NSNotificationCenter.defaultCenter addObserver:journal
+        selector:@selector(applicationDidEnterBackground:)
+        name:UIApplicationDidEnterBackgroundNotification
+        object:nil
+    ];
+
+    return journal;
+}
+
+- (void)dealloc {
+    [NSNotificationCenter.defaultCenter removeObserver:self];
+    if (_segmentFD >= 0) close(_segmentFD);
+    if (_indexFD >= 0) close(_indexFD);
+}
+
+#pragma mark Public
+
+- (NSUInteger)byteLimit {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger byteLimit = _byteLimit;
+    os_unfair_lock_unlock(&_lock);
+    return byteLimit;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit {
+    os_unfair_lock_lock(&_lock);
+    _byteLimit = byteLimit;
+    os_unfair_lock_unlock(&_lock);
+    dispatch_async(self.queue, ^{
+        [self enforceByteLimit];
+    });
+}
+
+- (void)appendTransaction:(FLEXHTTPTransaction *)transaction responseBody:(NSData *)responseBody {
+    BOOL includesBodies = self.includesBodies;
+    if (!includesBodies || responseBody.length > self.segmentLimit) {
+        responseBody = nil;
+    }
+
+    NSData *record = [self encodeTransaction:transaction
+        requestBody:includesBodies ? transaction.cachedRequestBody : nil
+        responseBodyLength:responseBody.length
+    ];
+    NSUInteger length = record.length + responseBody.length;
+
+    BOOL scheduleCommit = NO;
+    os_unfair_lock_lock(&_lock);
+    if (_pendingBytes + length > kFLEXNetworkJournalMaxPendingBytes) {
+        _droppedCount++;
+    } else {
+        // The body is retained rather than copied into the record
+        [_pending addObject:record];
+        [_pending addObject:responseBody ?: NSNull.null];
+        _pendingBytes += length;
+        scheduleCommit = !_commitScheduled;
+        _commitScheduled = YES;
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (scheduleCommit) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kFLEXNetworkJournalCommitInterval * NSEC_PER_SEC),
+            self.queue, ^{
+            [self commit];
+        });
+    }
+}
+
+- (void)flush {
+    dispatch_sync(self.queue, ^{
+        [self commit];
+    });
+}
+
++ (NSArray<FLEXNetworkJournalSession *> *)sessionsInDirectory:(NSString *)directory {
+    NSMutableArray<FLEXNetworkJournalSession *> *sessions = [NSMutableArray new];
+    for (NSString *name in [self sessionNamesInDirectory:directory].reverseObjectEnumerator) {
+        FLEXNetworkJournalSession *session = [FLEXNetworkJournalSession
+            sessionAtPath:[directory stringByAppendingPathComponent:name]
+        ];
+        if (session) {
+            [sessions addObject:session];
+        }
+    }
+
+    return sessions;
+}
+
+- (NSArray<FLEXNetworkJournalSession *> *)previousSessions {
+    NSString *current = self.sessionName;
+    return [[[self class] sessionsInDirectory:self.directory] filteredArrayUsingPredicate:
+        [NSPredicate predicateWithBlock:^BOOL(FLEXNetworkJournalSession *session, id bindings) {
+            return ![session.path.lastPathComponent isEqualToString:current];
+        }]
+    ];
+}
+
+#pragma mark Private
+
+/// Session directory names, oldest first
++ (NSArray<NSString *> *)sessionNamesInDirectory:(NSString *)directory {
+    NSArray<NSString *> *names = [NSFileManager.defaultManager contentsOfDirectoryAtPath:directory error:nil];
+    names = [names filteredArrayUsingPredicate:[NSPredicate
+        predicateWithFormat:@"SELF BEGINSWITH %@", kFLEXNetworkJournalSessionPrefix
+    ]];
+
+    return [names sortedArrayUsingComparator:^NSComparisonResult(NSString *a, NSString *b) {
+        return [a compare:b options:NSNumericSearch];
+    }];
+}
+
+- (NSUInteger)segmentLimit {
+    return MIN(MAX(self.byteLimit / 8, kFLEXNetworkJournalMinSegmentSize), kFLEXNetworkJournalMaxSegmentSize);
+}
+
+- (void)applicationDidEnterBackground:(NSNotification *)notification {
+    dispatch_async(self.queue, ^{
+        [self commit];
+    });
+}
+
+/// Everything but the response body, which goes right after it
+- (NSData *)encodeTransaction:(FLEXHTTPTransaction *)transaction
+                  requestBody:(NSData *)requestBody
+           responseBodyLength:(NSUInteger)responseBodyLength {
+    NSURLResponse *response = transaction.response;
+    NSHTTPURLResponse *HTTPResponse = [response isKindOfClass:[NSHTTPURLResponse class]] ? (id)response : nil;
+    NSError *error = transaction.error;
+
+    FLEXNetworkJournalRecordFlags flags = 0;
+    if (response) flags |= FLEXNetworkJournalRecordHasResponse;
+    if (HTTPResponse) flags |= FLEXNetworkJournalRecordHasHTTPResponse;
+    if (error) flags |= FLEXNetworkJournalRecordHasError;
+
+    FLEXNetworkJournalEncoder *encoder = [FLEXNetworkJournalEncoder new];
+    [encoder encodeUInt32:kFLEXNetworkJournalRecordVersion];
+    [encoder encodeUInt32:flags];
+    [encoder encodeUInt64:transaction.requestID];
+    [encoder encodeDouble:transaction.startTime.timeIntervalSince1970];
+    [encoder encodeDouble:transaction.latency];
+    [encoder encodeDouble:transaction.duration];
+    [encoder encodeUInt32:(uint32_t)transaction.state];
+    [encoder encodeUInt64:transaction.receivedDataLength];
+    [encoder encodeString:transaction.request.URL.absoluteString];
+    [encoder encodeString:transaction.request.HTTPMethod];
+    [encoder encodeString:transaction.requestMechanism];
+    [encoder encodeHeaders:transaction.request.allHTTPHeaderFields];
+    [encoder encodeBytes:requestBody];
+    [encoder encodeUInt32:(uint32_t)HTTPResponse.statusCode];
+    [encoder encodeString:response.MIMEType];
+    [encoder encodeHeaders:HTTPResponse.allHeaderFields];
+    [encoder encodeString:error.domain];
+    [encoder encodeUInt64:error.code];
+    [encoder encodeString:error.localizedDescription];
+    [encoder encodeUInt32:(uint32_t)responseBodyLength];
+
+    return [encoder finishWithTrailingLength:responseBodyLength];
+}
+
+#pragma mark Private, queue only
+
+- (void)openSession {
+    NSFileManager *manager = NSFileManager.defaultManager;
+    [manager createDirectoryAtPath:self.sessionPath withIntermediateDirectories:YES attributes:nil error:nil];
+
+    _previousSessionPaths = [NSMutableArray new];
+    _previousSessionSizes = [NSMutableArray new];
+    for (NSString *name in [[self class] sessionNamesInDirectory:self.directory]) {
+        if (![name isEqualToString:self.sessionName]) {
+            NSString *path = [self.directory stringByAppendingPathComponent:name];
+            [_previousSessionPaths addObject:path];
+            [_previousSessionSizes addObject:@(FLEXNetworkJournalSizeOfDirectory(path))];
+        }
+    }
+
+    NSString *indexPath = [self.sessionPath stringByAppendingPathComponent:kFLEXNetworkJournalIndexName];
+    _indexFD = open(indexPath.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+    [self openSegment:0];
+    [self enforceByteLimit];
+}
+
+- (void)openSegment:(uint32_t)segment {
+    if (_segmentFD >= 0) {
+        close(_segmentFD);
+    }
+
+    NSString *path = [self.sessionPath stringByAppendingPathComponent:FLEXNetworkJournalSegmentName(segment)];
+    _segmentFD = open(path.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0600);
+    _segment = segment;
+    _segmentLength = 0;
+    [_segmentSizes addObject:@0];
+}
+
+/// Writes everything pending with one write to the current segment and one to the index,
+/// plus one more of each for every segment rotated into along the way
+- (void)commit {
+    os_unfair_lock_lock(&_lock);
+    NSArray *pending = _pending;
+    _pending = [NSMutableArray new];
+    _pendingBytes = 0;
+    _commitScheduled = NO;
+    os_unfair_lock_unlock(&_lock);
+
+    if (!pending.count || _segmentFD < 0 || _indexFD < 0) {
+        return;
+    }
+
+    NSUInteger recordCount = pending.count / 2;
+    struct iovec *segmentIO = calloc(pending.count, sizeof(struct iovec));
+    FLEXNetworkJournalIndexEntry *entries = calloc(recordCount, sizeof(FLEXNetworkJournalIndexEntry));
+    int ioCount = 0;
+    NSUInteger entryCount = 0;
+    uint64_t batchLength = 0;
+    BOOL written = YES;
+
+    for (NSUInteger i = 0; i < recordCount; i++) {
+        NSData *record = pending[i * 2];
+        NSData *body = [pending[i * 2 + 1] isKindOfClass:[NSData class]] ? pending[i * 2 + 1] : nil;
+        uint64_t length = record.length + body.length;
+
+        // Rotate once the segment is full, but never leave a segment empty
+        if (_segmentLength + batchLength > 0 && _segmentLength + batchLength + length > self.segmentLimit) {
+            written = [self writeSegmentIO:segmentIO count:ioCount length:batchLength entries:entries count:entryCount];
+            if (!written) {
+                break;
+            }
+
+            [self openSegment:_segment + 1];
+            ioCount = 0;
+            entryCount = 0;
+            batchLength = 0;
+        }
+
+        entries[entryCount++] = (FLEXNetworkJournalIndexEntry) {
+            CFSwapInt32HostToLittle(_segment),
+            CFSwapInt32HostToLittle((uint32_t)length),
+            CFSwapInt64HostToLittle(_segmentLength + batchLength),
+        };
+        segmentIO[ioCount++] = (struct iovec) { (void *)record.bytes, record.length };
+        if (body.length) {
+            segmentIO[ioCount++] = (struct iovec) { (void *)body.bytes, body.length };
+        }
+        batchLength += length;
+    }
+
+    if (written) {
+        [self writeSegmentIO:segmentIO count:ioCount length:batchLength entries:entries count:entryCount];
+    }
+    free(segmentIO);
+    free(entries);
+
+    [self enforceByteLimit];
+}
+
+/// Writes the records first so that the index never points past the end of a segment
+- (BOOL)writeSegmentIO:(struct iovec *)io count:(int)ioCount length:(uint64_t)length
+               entries:(FLEXNetworkJournalIndexEntry *)entries count:(NSUInteger)entryCount {
+    if (!entryCount) {
+        return YES;
+    }
+
+    if (!FLEXNetworkJournalWriteAll(_segmentFD, io, ioCount)) {
+        // Whatever was partially written is never indexed, so it is only wasted space
+        return NO;
+    }
+
+    _segmentLength += length;
+    _segmentSizes[_segmentSizes.count - 1] = @(_segmentLength);
+
+    struct iovec indexIO = { entries, entryCount * sizeof(FLEXNetworkJournalIndexEntry) };
+    if (!FLEXNetworkJournalWriteAll(_indexFD, &indexIO, 1)) {
+        return NO;
+    }
+
+    _indexLength += entryCount * sizeof(FLEXNetworkJournalIndexEntry);
+    return YES;
+}
+
+/// Deletes previous sessions, oldest first, and then this session's own oldest segments
+- (void)enforceByteLimit {
+    NSUInteger byteLimit = self.byteLimit;
+    NSUInteger total = _indexLength;
+    for (NSNumber *size in _segmentSizes) total += size.unsignedIntegerValue;
+    for (NSNumber *size in _previousSessionSizes) total += size.unsignedIntegerValue;
+
+    NSFileManager *manager = NSFileManager.defaultManager;
+    while (total > byteLimit && _previousSessionPaths.count) {
+        [manager removeItemAtPath:_previousSessionPaths.firstObject error:nil];
+        total -= _previousSessionSizes.firstObject.unsignedIntegerValue;
+        [_previousSessionPaths removeObjectAtIndex:0];
+        [_previousSessionSizes removeObjectAtIndex:0];
+    }
+
+    // The segment being written is never deleted
+    while (total > byteLimit && _segmentSizes.count > 1) {
+        NSString *path = [self.sessionPath stringByAppendingPathComponent:FLEXNetworkJournalSegmentName(_oldestSegment)];
+        unlink(path.fileSystemRepresentation);
+        total -= _segmentSizes.firstObject.unsignedIntegerValue;
+        [_segmentSizes removeObjectAtIndex:0];
+        _oldestSegment++;
+    }
+}
+
+@end
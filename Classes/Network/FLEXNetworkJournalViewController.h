@@ -0,0 +1,25 @@
+//
+//  FLEXNetworkJournalViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+
+@class FLEXNetworkJournalSession;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Browses the HTTP traffic journaled by \c FLEXNetworkRecorder during earlier launches of the app.
+@interface FLEXNetworkJournalViewController : FLEXTableViewController
+
+/// Lists the journaled sessions; tap one to see its transactions
++ (instancetype)sessionsViewController;
+/// Lists the transactions of one session, decoding them as they are scrolled to
++ (instancetype)transactionsViewControllerForSession:(FLEXNetworkJournalSession *)session;
+
+@end
+
+NS_ASSUME_NONNULL_END
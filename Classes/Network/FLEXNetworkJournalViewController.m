@@ -0,0 +1,156 @@
+//
+//  FLEXNetworkJournalViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkJournalViewController.h"
+#import "FLEXNetworkJournal.h"
+#import "FLEXNetworkRecorder.h"
+#import "FLEXNetworkTransactionCell.h"
+#import "FLEXHTTPTransactionDetailController.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXColor.h"
+#import "FLEXUtility.h"
+#import "NSDateFormatter+FLEX.h"
+
+@interface FLEXNetworkJournalViewController ()
+/// \c nil when listing sessions
+@property (nonatomic, readonly, nullable) FLEXNetworkJournalSession *session;
+@property (nonatomic, copy) NSArray<FLEXNetworkJournalSession *> *sessions;
+@end
+
+@implementation FLEXNetworkJournalViewController
+
++ (instancetype)sessionsViewController {
+    FLEXNetworkJournalViewController *controller = [self new];
+    controller.title = @"Previous Launches";
+    return controller;
+}
+
++ (instancetype)transactionsViewControllerForSession:(FLEXNetworkJournalSession *)session {
+    FLEXNetworkJournalViewController *controller = [self new];
+    controller->_session = session;
+    controller.title = [NSDateFormatter flex_stringFrom:session.startDate format:FLEXDateFormatVerbose];
+    return controller;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStylePlain];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    if (self.session) {
+        [self.tableView
+            registerClass:FLEXNetworkTransactionCell.class
+            forCellReuseIdentifier:FLEXNetworkTransactionCell.reuseID
+        ];
+        self.tableView.separatorStyle = UITableViewCellSeparatorStyleNone;
+        self.tableView.rowHeight = FLEXNetworkTransactionCell.preferredCellHeight;
+    } else {
+        [self reloadSessions];
+    }
+}
+
+- (void)reloadSessions {
+    // Listing sessions reads each of their directories
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSArray<FLEXNetworkJournalSession *> *sessions = FLEXNetworkRecorder.defaultRecorder.previousJournalSessions;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            self.sessions = sessions;
+            [self.tableView reloadData];
+        });
+    });
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return self.session ? self.session.count : self.sessions.count;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
+    if (self.session || !self.sessions) {
+        return nil;
+    }
+
+    return self.sessions.count ? nil : @"No previous launches were journaled. "
+        "Turn on journaling in the network settings to keep the traffic of future launches.";
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    if (self.session) {
+        FLEXNetworkTransactionCell *cell = [tableView
+            dequeueReusableCellWithIdentifier:FLEXNetworkTransactionCell.reuseID
+            forIndexPath:indexPath
+        ];
+
+        // Decoded from the journal the first time it is scrolled to
+        cell.transaction = [self.session transactionAtIndex:indexPath.row];
+        cell.backgroundColor = indexPath.row % 2 ? FLEXColor.secondaryBackgroundColor : FLEXColor.primaryBackgroundColor;
+        return cell;
+    }
+
+    FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDetailCell forIndexPath:indexPath];
+    FLEXNetworkJournalSession *session = self.sessions[indexPath.row];
+    cell.titleLabel.text = [NSDateFormatter flex_stringFrom:session.startDate format:FLEXDateFormatVerbose];
+    cell.subtitleLabel.text = [NSString stringWithFormat:@"%@ requests · %@",
+        @(session.count),
+        [NSByteCountFormatter stringFromByteCount:session.byteCount countStyle:NSByteCountFormatterCountStyleFile]
+    ];
+    cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+
+    return cell;
+}
+
+- (BOOL)tableView:(UITableView *)tableView canEditRowAtIndexPath:(NSIndexPath *)indexPath {
+    return !self.session;
+}
+
+- (void)tableView:(UITableView *)tableView commitEditingStyle:(UITableViewCellEditingStyle)style
+forRowAtIndexPath:(NSIndexPath *)indexPath {
+    NSParameterAssert(style == UITableViewCellEditingStyleDelete);
+
+    NSError *error = nil;
+    if (![self.sessions[indexPath.row] remove:&error]) {
+        [FLEXAlert showAlert:@"Could Not Delete Session" message:error.localizedDescription from:self];
+        return;
+    }
+
+    NSMutableArray<FLEXNetworkJournalSession *> *sessions = self.sessions.mutableCopy;
+    [sessions removeObjectAtIndex:indexPath.row];
+    self.sessions = sessions;
+    [tableView deleteRowsAtIndexPaths:@[indexPath] withRowAnimation:UITableViewRowAnimationAutomatic];
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didEndDisplayingCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
+    if (self.session) {
+        [(FLEXNetworkTransactionCell *)cell cancelThumbnailLoad];
+    }
+}
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    UIViewController *next = nil;
+    if (self.session) {
+        FLEXHTTPTransaction *transaction = [self.session transactionAtIndex:indexPath.row];
+        if (!transaction) {
+            [tableView deselectRowAtIndexPath:indexPath animated:YES];
+            [FLEXAlert showQuickAlert:@"This request could not be read from the journal" from:self];
+            return;
+        }
+
+        next = [FLEXHTTPTransactionDetailController withTransaction:transaction];
+    } else {
+        next = [[self class] transactionsViewControllerForSession:self.sessions[indexPath.row]];
+    }
+
+    [self.navigationController pushViewController:next animated:YES];
+}
+
+@end
@@ -16,11 +16,16 @@
 #import "FLEXNetworkTransactionCell.h"
 #import "FLEXHTTPTransactionDetailController.h"
 #import "FLEXNetworkSettingsController.h"
+#import "FLEXNetworkHARExporter.h"
+#import "FLEXNetworkAnalyticsViewController.h"
+#import "FLEXNetworkJournalViewController.h"
+#import "FLEXWebsocketConversationViewController.h"
+#import "FLEXActivityViewController.h"
 #import "FLEXObjectExplorerFactory.h"
 #import "FLEXGlobalsViewController.h"
-#import "FLEXWebViewController.h"
 #import "UIBarButtonItem+FLEX.h"
 #import "FLEXResources.h"
+#import "FLEXSnapshotDiff.h"
 #import "NSUserDefaults+FLEX.h"
 
 #define kFirebaseAvailable NSClassFromString(@"FIRDocumentReference")
@@ -35,7 +40,12 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 @interface FLEXNetworkMITMViewController ()
 
 @property (nonatomic) BOOL updateInProgress;
+/// Whether the data source changed while an update was being animated
+@property (nonatomic) BOOL pendingUpdate;
 @property (nonatomic) BOOL pendingReload;
+/// The transactions the table view currently shows. Lags behind \c dataSource.transactions
+/// until the changes between them have been applied as row updates.
+@property (nonatomic, copy) NSArray<FLEXNetworkTransaction *> *rows;
 
 @property (nonatomic) FLEXNetworkObserverMode mode;
 
@@ -65,6 +75,13 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     _HTTPDataSource = [FLEXMITMDataSource dataSourceWithProvider:^NSArray * {
         return FLEXNetworkRecorder.defaultRecorder.HTTPTransactions;
     }];
+    // Searching REST traffic also searches headers and response bodies
+    _HTTPDataSource.contentSearch = ^NSArray *(NSString *query) {
+        return [FLEXNetworkRecorder.defaultRecorder HTTPTransactionsContainingText:query];
+    };
+    _HTTPDataSource.contentMatcher = ^BOOL(FLEXHTTPTransaction *transaction, NSString *query) {
+        return [FLEXNetworkRecorder.defaultRecorder HTTPTransaction:transaction containsText:query];
+    };
 
     if (kFirebaseAvailable) {
         _firebaseDataSource = [FLEXMITMDataSource dataSourceWithProvider:^NSArray * {
@@ -85,7 +102,19 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     self.searchController.searchBar.scopeButtonTitles = scopeTitles;
     self.mode = NSUserDefaults.standardUserDefaults.flex_lastNetworkObserverMode;
 
+    // Shares REST traffic as a HAR file
+    self.showsShareToolbarItem = YES;
     [self addToolbarItems:@[
+        [UIBarButtonItem
+            flex_itemWithImage:[UIImage systemImageNamed:@"chart.bar"]
+            target:self
+            action:@selector(analyticsButtonTapped:)
+        ],
+        [UIBarButtonItem
+            flex_itemWithImage:[UIImage systemImageNamed:@"clock.arrow.circlepath"]
+            target:self
+            action:@selector(journalButtonTapped:)
+        ],
         [UIBarButtonItem
             flex_itemWithImage:FLEXResources.gearIcon
             target:self
@@ -106,7 +135,9 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     self.tableView.rowHeight = FLEXNetworkTransactionCell.preferredCellHeight;
 
     [self registerForNotifications];
-    [self updateTransactions:nil];
+    [self updateTransactions:^{
+        [self reloadRows];
+    }];
 }
 
 - (void)viewWillAppear:(BOOL)animated {
@@ -114,7 +145,7 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     
     // Reload the table if we received updates while not on-screen
     if (self.pendingReload) {
-        [self.tableView reloadData];
+        [self reloadRows];
         self.pendingReload = NO;
     }
 }
@@ -125,10 +156,8 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 
 - (void)registerForNotifications {
     NSDictionary *notifications = @{
-        kFLEXNetworkRecorderNewTransactionNotification:
-            NSStringFromSelector(@selector(handleNewTransactionRecordedNotification:)),
-        kFLEXNetworkRecorderTransactionUpdatedNotification:
-            NSStringFromSelector(@selector(handleTransactionUpdatedNotification:)),
+        kFLEXNetworkRecorderTransactionsChangedNotification:
+            NSStringFromSelector(@selector(handleTransactionsChangedNotification:)),
         kFLEXNetworkRecorderTransactionsClearedNotification:
             NSStringFromSelector(@selector(handleTransactionsClearedNotification:)),
         kFLEXNetworkObserverEnabledStateChangedNotification:
@@ -159,6 +188,18 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     [self presentViewController:nav animated:YES completion:nil];
 }
 
+- (void)analyticsButtonTapped:(UIBarButtonItem *)sender {
+    // Per-host stats of all REST traffic so far, not just what is still listed here
+    UIViewController *dashboard = [FLEXNetworkAnalyticsViewController hostsViewController];
+    [self.navigationController pushViewController:dashboard animated:YES];
+}
+
+- (void)journalButtonTapped:(UIBarButtonItem *)sender {
+    // REST traffic journaled during earlier launches of the app
+    UIViewController *sessions = [FLEXNetworkJournalViewController sessionsViewController];
+    [self.navigationController pushViewController:sessions animated:YES];
+}
+
 - (void)trashButtonTapped:(UIBarButtonItem *)sender {
     [FLEXAlert makeSheet:^(FLEXAlert *make) {
         BOOL clearAll = !self.dataSource.isFiltered;
@@ -182,6 +223,30 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     } showFrom:self source:sender];
 }
 
+- (void)shareButtonPressed:(UIBarButtonItem *)sender {
+    // Exports what the REST tab would show, including its search filter
+    NSArray<FLEXHTTPTransaction *> *transactions = self.HTTPDataSource.transactions;
+    if (!transactions.count) {
+        [FLEXAlert showQuickAlert:@"No Requests to Export" from:self];
+        return;
+    }
+    
+    NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"FLEX Network Activity.har"];
+    [FLEXActivityViewController shareFileAtPath:path exportedUsing:^NSProgress *(void (^completion)(NSError *)) {
+        return [FLEXNetworkHARExporter
+            exportTransactions:transactions
+            fromRecorder:FLEXNetworkRecorder.defaultRecorder
+            toFile:path
+            completion:completion
+        ];
+    }
+        title:@"Exporting Requests"
+        message:[NSString stringWithFormat:@"Writing %@ requests to a HAR file…", @(transactions.count)]
+        from:self
+        source:sender
+    ];
+}
+
 - (void)settingsViewControllerDoneTapped:(id)sender {
     [self dismissViewControllerAnimated:YES completion:nil];
 }
@@ -353,8 +418,18 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 
 #pragma mark - Notification Handlers
 
-- (void)handleNewTransactionRecordedNotification:(NSNotification *)notification {
-    [self tryUpdateTransactions];
+- (void)handleTransactionsChangedNotification:(NSNotification *)notification {
+    NSArray *inserted = notification.userInfo[kFLEXNetworkRecorderUserInfoInsertedTransactionsKey];
+    NSArray *updated = notification.userInfo[kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey];
+    
+    // A whole batch of new transactions becomes a single table update
+    if (inserted.count) {
+        [self tryUpdateTransactions];
+    }
+    
+    if (updated.count) {
+        [self handleUpdatedTransactions:updated];
+    }
 }
 
 - (void)tryUpdateTransactions {
@@ -365,81 +440,140 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
         return;
     }
     
-    // Let the previous row insert animation finish before starting a new one to avoid stomping.
-    // We'll try calling the method again when the insertion completes,
-    // and we properly no-op if there haven't been changes.
+    [self updateTransactions:^{
+        [self applyRowUpdates];
+    }];
+}
+
+#pragma mark Row Updates
+
+/// Shows the current transactions without animating the changes, like when switching scopes
+- (void)reloadRows {
+    self.rows = self.dataSource.transactions;
+    [self.tableView reloadData];
+    [self updateFirstSectionHeader];
+}
+
+/// Diffs the rows against the data source and applies the difference as a batch of row updates.
+/// Rows that stayed are not reloaded; their cells are reconfigured by \c handleUpdatedTransactions:
+- (void)applyRowUpdates {
+    if (!self.viewIfLoaded.window) {
+        self.pendingReload = YES;
+        return;
+    }
+    
+    // Let the previous update finish animating before starting a new one to avoid stomping.
+    // It applies whatever changed in the meantime when it completes.
     if (self.updateInProgress) {
+        self.pendingUpdate = YES;
         return;
     }
     
-    self.updateInProgress = YES;
-
-    // Get state before update
-    NSString *currentFilter = self.searchText;
-    FLEXNetworkObserverMode currentMode = self.mode;
-    NSInteger existingRowCount = self.dataSource.transactions.count;
+    NSArray<FLEXNetworkTransaction *> *transactions = self.dataSource.transactions;
+    FLEXSnapshotDiff *diff = [FLEXSnapshotDiff diffFromSnapshot:self.rows toSnapshot:transactions];
+    if (!diff.hasChanges) {
+        self.rows = transactions;
+        return;
+    }
     
-    [self updateTransactions:^{
-        // Compare to state after update
-        NSString *newFilter = self.searchText;
-        FLEXNetworkObserverMode newMode = self.mode;
-        NSInteger newRowCount = self.dataSource.transactions.count;
-        NSInteger rowCountDiff = newRowCount - existingRowCount;
-        
-        // Abort if the observation mode changed, or if the search field text changed
-        if (newMode != currentMode || ![currentFilter isEqualToString:newFilter]) {
-            self.updateInProgress = NO;
-            return;
+    UITableView *tableView = self.tableView;
+    void (^updates)(void) = ^{
+        self.rows = transactions;
+        [tableView deleteRowsAtIndexPaths:[self indexPathsForRows:diff.deletedIndexes]
+            withRowAnimation:UITableViewRowAnimationAutomatic
+        ];
+        [tableView insertRowsAtIndexPaths:[self indexPathsForRows:diff.insertedIndexes]
+            withRowAnimation:UITableViewRowAnimationAutomatic
+        ];
+        [diff.movedFromIndexes enumerateObjectsUsingBlock:^(NSNumber *from, NSUInteger idx, BOOL *stop) {
+            [tableView
+                moveRowAtIndexPath:[NSIndexPath indexPathForRow:from.integerValue inSection:0]
+                toIndexPath:[NSIndexPath indexPathForRow:diff.movedToIndexes[idx].integerValue inSection:0]
+            ];
+        }];
+    };
+    
+    self.updateInProgress = YES;
+    void (^completion)(BOOL) = ^(BOOL finished) {
+        self.updateInProgress = NO;
+        [self updateRowBackgroundColors];
+        if (self.pendingUpdate) {
+            self.pendingUpdate = NO;
+            [self applyRowUpdates];
         }
-        
-        if (rowCountDiff) {
-            // Insert animation if we're at the top.
-            if (self.tableView.contentOffset.y <= 0.0 && rowCountDiff > 0) {
-                [CATransaction begin];
-                
-                [CATransaction setCompletionBlock:^{
-                    self.updateInProgress = NO;
-                    // This isn't an infinite loop, it won't run a third time
-                    // if there were no new transactions the second time
-                    [self tryUpdateTransactions];
-                }];
-                
-                NSMutableArray<NSIndexPath *> *indexPathsToReload = [NSMutableArray new];
-                for (NSInteger row = 0; row < rowCountDiff; row++) {
-                    [indexPathsToReload addObject:[NSIndexPath indexPathForRow:row inSection:0]];
-                }
+    };
+    
+    // Animate if we're at the top
+    if (tableView.contentOffset.y <= 0.0) {
+        [tableView performBatchUpdates:updates completion:completion];
+    } else {
+        // Maintain the user's position if they've scrolled down
+        CGSize existingContentSize = tableView.contentSize;
+        [UIView performWithoutAnimation:^{
+            [tableView performBatchUpdates:updates completion:nil];
+            [tableView layoutIfNeeded];
+        }];
+        CGFloat contentHeightChange = tableView.contentSize.height - existingContentSize.height;
+        tableView.contentOffset = CGPointMake(tableView.contentOffset.x, tableView.contentOffset.y + contentHeightChange);
+        completion(YES);
+    }
+}
 
-                [self.tableView insertRowsAtIndexPaths:indexPathsToReload withRowAnimation:UITableViewRowAnimationAutomatic];
-                [CATransaction commit];
-            } else {
-                // Maintain the user's position if they've scrolled down.
-                CGSize existingContentSize = self.tableView.contentSize;
-                [self.tableView reloadData];
-                CGFloat contentHeightChange = self.tableView.contentSize.height - existingContentSize.height;
-                self.tableView.contentOffset = CGPointMake(self.tableView.contentOffset.x, self.tableView.contentOffset.y + contentHeightChange);
-                self.updateInProgress = NO;
-            }
-        } else {
-            self.updateInProgress = NO;
-        }
+- (NSArray<NSIndexPath *> *)indexPathsForRows:(NSIndexSet *)rows {
+    NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:rows.count];
+    [rows enumerateIndexesUsingBlock:^(NSUInteger row, BOOL *stop) {
+        [indexPaths addObject:[NSIndexPath indexPathForRow:row inSection:0]];
     }];
+    
+    return indexPaths;
 }
 
-- (void)handleTransactionUpdatedNotification:(NSNotification *)notification {
-    [self.HTTPDataSource reloadByteCounts];
-    [self.websocketDataSource reloadByteCounts];
-    // Don't need to reload Firebase here
+/// Rows keep their cells across updates, so their alternating colors may need to shift
+- (void)updateRowBackgroundColors {
+    for (NSIndexPath *indexPath in self.tableView.indexPathsForVisibleRows) {
+        UITableViewCell *cell = [self.tableView cellForRowAtIndexPath:indexPath];
+        cell.backgroundColor = [self backgroundColorForRowAtIndexPath:indexPath];
+    }
+}
 
-    FLEXNetworkTransaction *transaction = notification.userInfo[kFLEXNetworkRecorderUserInfoTransactionKey];
+- (UIColor *)backgroundColorForRowAtIndexPath:(NSIndexPath *)indexPath {
+    // Since we insert from the top, assign background colors bottom up to keep them consistent for each transaction.
+    if ((self.rows.count - indexPath.row) % 2 == 0) {
+        return FLEXColor.secondaryBackgroundColor;
+    }
+    
+    return FLEXColor.primaryBackgroundColor;
+}
 
-    // Update both the main table view and search table view if needed.
+- (void)handleUpdatedTransactions:(NSArray<FLEXNetworkTransaction *> *)transactions {
+    // Updates can change whether a transaction matches the search
+    BOOL HTTPChanged = [self.HTTPDataSource didUpdateTransactions:transactions];
+    BOOL websocketChanged = [self.websocketDataSource didUpdateTransactions:transactions];
+    BOOL firebaseChanged = [self.firebaseDataSource didUpdateTransactions:transactions];
+
+    BOOL visibleRowsChanged = NO;
+    switch (self.mode) {
+        case FLEXNetworkObserverModeREST:
+            visibleRowsChanged = HTTPChanged; break;
+        case FLEXNetworkObserverModeWebsockets:
+            visibleRowsChanged = websocketChanged; break;
+        case FLEXNetworkObserverModeFirebase:
+            visibleRowsChanged = firebaseChanged; break;
+    }
+
+    if (visibleRowsChanged) {
+        [self applyRowUpdates];
+    }
+
+    NSSet<FLEXNetworkTransaction *> *updated = [NSSet setWithArray:transactions];
+
+    // Only reconfigure the visible cells whose transaction changed
     for (FLEXNetworkTransactionCell *cell in self.tableView.visibleCells) {
-        if ([cell.transaction isEqual:transaction]) {
+        if ([updated containsObject:cell.transaction]) {
             // Using -[UITableView reloadRowsAtIndexPaths:withRowAnimation:] is overkill here and kicks off a lot of
             // work that can make the table view somewhat unresponsive when lots of updates are streaming in.
             // We just need to tell the cell that it needs to re-layout.
             [cell setNeedsLayout];
-            break;
         }
     }
     
@@ -447,8 +581,9 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 }
 
 - (void)handleTransactionsClearedNotification:(NSNotification *)notification {
+    // Animating the deletion of every row is slow when there are thousands
     [self updateTransactions:^{
-        [self.tableView reloadData];
+        [self reloadRows];
     }];
 }
 
@@ -461,7 +596,7 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 #pragma mark - Table view data source
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
-    return self.dataSource.transactions.count;
+    return self.rows.count;
 }
 
 - (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
@@ -475,6 +610,11 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     }
 }
 
+- (void)tableView:(UITableView *)tableView didEndDisplayingCell:(UITableViewCell *)cell forRowAtIndexPath:(NSIndexPath *)indexPath {
+    // Don't decode image previews for rows scrolled past
+    [(FLEXNetworkTransactionCell *)cell cancelThumbnailLoad];
+}
+
 - (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
     FLEXNetworkTransactionCell *cell = [tableView
         dequeueReusableCellWithIdentifier:FLEXNetworkTransactionCell.reuseID
@@ -482,14 +622,7 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     ];
     
     cell.transaction = [self transactionAtIndexPath:indexPath];
-
-    // Since we insert from the top, assign background colors bottom up to keep them consistent for each transaction.
-    NSInteger totalRows = [tableView numberOfRowsInSection:indexPath.section];
-    if ((totalRows - indexPath.row) % 2 == 0) {
-        cell.backgroundColor = FLEXColor.secondaryBackgroundColor;
-    } else {
-        cell.backgroundColor = FLEXColor.primaryBackgroundColor;
-    }
+    cell.backgroundColor = [self backgroundColorForRowAtIndexPath:indexPath];
 
     return cell;
 }
@@ -506,14 +639,7 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
         case FLEXNetworkObserverModeWebsockets: {
             if (@available(iOS 13.0, *)) { // This check will never fail
                 FLEXWebsocketTransaction *transaction = [self websocketTransactionAtIndexPath:indexPath];
-                
-                UIViewController *details = nil;
-                if (transaction.message.type == NSURLSessionWebSocketMessageTypeData) {
-                    details = [FLEXObjectExplorerFactory explorerViewControllerForObject:transaction.message.data];
-                } else {
-                    details = [[FLEXWebViewController alloc] initWithText:transaction.message.string];
-                }
-                
+                UIViewController *details = [FLEXWebsocketConversationViewController viewControllerForFrame:transaction];
                 [self.navigationController pushViewController:details animated:YES];
             }
             break;
@@ -580,6 +706,26 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
                 
                 children = [children arrayByAddingObject:denylist];
             }
+            
+            FLEXWebsocketConversation *conversation = nil;
+            if (self.mode == FLEXNetworkObserverModeWebsockets) {
+                conversation = [self websocketTransactionAtIndexPath:indexPath].conversation;
+            }
+            if (conversation) {
+                UIAction *showConversation = [UIAction
+                    actionWithTitle:@"Show Conversation"
+                    image:nil
+                    identifier:nil
+                    handler:^(__kindof UIAction *action) {
+                        [self.navigationController
+                            pushViewController:[FLEXWebsocketConversationViewController withConversation:conversation]
+                            animated:YES
+                        ];
+                    }
+                ];
+                
+                children = [children arrayByAddingObject:showConversation];
+            }
             return [UIMenu
                 menuWithTitle:@"" image:nil identifier:nil
                 options:UIMenuOptionsDisplayInline
@@ -589,20 +735,21 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
     ];
 }
 
+// Rows come from the table's snapshot, which may lag behind the data source
 - (FLEXNetworkTransaction *)transactionAtIndexPath:(NSIndexPath *)indexPath {
-    return self.dataSource.transactions[indexPath.row];
+    return self.rows[indexPath.row];
 }
 
 - (FLEXHTTPTransaction *)HTTPTransactionAtIndexPath:(NSIndexPath *)indexPath {
-    return self.HTTPDataSource.transactions[indexPath.row];
+    return (id)self.rows[indexPath.row];
 }
 
 - (FLEXWebsocketTransaction *)websocketTransactionAtIndexPath:(NSIndexPath *)indexPath {
-    return self.websocketDataSource.transactions[indexPath.row];
+    return (id)self.rows[indexPath.row];
 }
 
 - (FLEXFirebaseTransaction *)firebaseTransactionAtIndexPath:(NSIndexPath *)indexPath {
-    return self.firebaseDataSource.transactions[indexPath.row];
+    return (id)self.rows[indexPath.row];
 }
 
 #pragma mark - Search Bar
@@ -610,7 +757,7 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 - (void)updateSearchResults:(NSString *)searchString {
     id callback = ^(FLEXMITMDataSource *dataSource) {
         if (self.dataSource == dataSource) {
-            [self.tableView reloadData];
+            [self applyRowUpdates];
         }
     };
     
@@ -620,14 +767,14 @@ typedef NS_ENUM(NSInteger, FLEXNetworkObserverMode) {
 }
 
 - (void)searchBar:(UISearchBar *)searchBar selectedScopeButtonIndexDidChange:(NSInteger)newScope {
-    [self updateFirstSectionHeader];
-    [self.tableView reloadData];
+    // A different kind of transaction; nothing to diff against
+    [self reloadRows];
 
     NSUserDefaults.standardUserDefaults.flex_lastNetworkObserverMode = self.mode;
 }
 
 - (void)willDismissSearchController:(UISearchController *)searchController {
-    [self.tableView reloadData];
+    [self applyRowUpdates];
 }
 
 @end
@@ -7,14 +7,20 @@
 //
 
 #import <Foundation/Foundation.h>
+#import "FLEXNetworkTransaction.h"
 
 // Notifications posted when the record is updated
-extern NSString *const kFLEXNetworkRecorderNewTransactionNotification;
-extern NSString *const kFLEXNetworkRecorderTransactionUpdatedNotification;
-extern NSString *const kFLEXNetworkRecorderUserInfoTransactionKey;
+
+/// Posted on the main queue at most once per display frame (or \c notificationCoalescingInterval)
+/// with every transaction recorded or changed since the last time it was posted.
+extern NSString *const kFLEXNetworkRecorderTransactionsChangedNotification;
+/// An array of new transactions in the order they were recorded
+extern NSString *const kFLEXNetworkRecorderUserInfoInsertedTransactionsKey;
+/// An array of existing transactions that have changed. Never overlaps with the inserted transactions.
+extern NSString *const kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey;
 extern NSString *const kFLEXNetworkRecorderTransactionsClearedNotification;
 
-@class FLEXNetworkTransaction, FLEXHTTPTransaction, FLEXWebsocketTransaction, FLEXFirebaseTransaction;
+@class FLEXNetworkAnalytics, FLEXNetworkJournalSession, FLEXNetworkThumbnailLoader, FLEXWebsocketConversation;
 @class FIRQuery, FIRDocumentReference, FIRCollectionReference, FIRDocumentSnapshot, FIRQuerySnapshot;
 
 typedef NS_ENUM(NSUInteger, FLEXNetworkTransactionKind) {
@@ -31,11 +37,42 @@ typedef NS_ENUM(NSUInteger, FLEXNetworkTransactionKind) {
 /// Defaults to 25 MB if never set. Values set here are persisted across launches of the app.
 @property (nonatomic) NSUInteger responseCacheByteLimit;
 
+/// Response bodies evicted from memory are written to disk, up to this many bytes.
+/// Defaults to 100 MB if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger responseDiskCacheByteLimit;
+
+/// The largest response body either cache can hold. Observers can stop buffering
+/// a response body once it grows past this, since it would be discarded anyway.
+@property (nonatomic, readonly) NSUInteger responseBodyCaptureLimit;
+
+/// The most memory the full-text index of recorded HTTP traffic may use. When it fills up,
+/// the oldest transactions are dropped from it first. Defaults to 16 MB if never set.
+/// Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger textIndexByteLimit;
+
+/// The maximum number of transactions of each kind to retain; the oldest are discarded first.
+/// Defaults to 5000 if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger transactionLimit;
+
+/// The maximum number of frames to retain for each websocket task; the oldest are discarded first.
+/// Defaults to 1000 if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger websocketFrameLimit;
+
+/// Websocket messages with a longer payload only have its beginning recorded; 0 means no limit.
+/// Defaults to 256 KB if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger websocketPayloadCaptureLimit;
+
+/// The minimum time between two \c kFLEXNetworkRecorderTransactionsChangedNotification posts.
+/// Defaults to 0, which means changes are delivered at most once per display frame.
+@property (nonatomic) NSTimeInterval notificationCoalescingInterval;
+
 /// If NO, the recorder not cache will not cache response for content types
 /// with an "image", "video", or "audio" prefix.
 @property (nonatomic) BOOL shouldCacheMediaResponses;
 
-@property (nonatomic) NSMutableArray<NSString *> *hostDenylist;
+/// Entries use the rule syntax of \c FLEXNetworkHostDenylist. Changes made by mutating this
+/// array apply to new requests right away. Setting it copies the entries of the given array.
+@property (nonatomic, null_resettable) NSMutableArray<NSString *> *hostDenylist;
 
 /// Call this after adding to or setting the \c hostDenylist to remove excluded transactions
 - (void)clearExcludedTransactions;
@@ -50,12 +87,43 @@ typedef NS_ENUM(NSUInteger, FLEXNetworkTransactionKind) {
 @property (nonatomic, readonly) NSArray<FLEXHTTPTransaction *> *HTTPTransactions;
 /// Array of FLEXWebsocketTransaction objects ordered by start time with the newest first.
 @property (nonatomic, readonly) NSArray<FLEXWebsocketTransaction *> *websocketTransactions API_AVAILABLE(ios(13.0));
+/// The messages of each recent websocket task, with the newest task first.
+@property (nonatomic, readonly) NSArray<FLEXWebsocketConversation *> *websocketConversations API_AVAILABLE(ios(13.0));
 /// Array of FLEXFirebaseTransaction objects ordered by start time with the newest first.
 @property (nonatomic, readonly) NSArray<FLEXFirebaseTransaction *> *firebaseTransactions;
 
-/// The full response data IFF it hasn't been purged due to memory pressure.
+/// The full response data IFF it hasn't been purged from both memory and disk.
+/// Bodies that were spilled to disk, or read back from a journal, are returned memory-mapped.
 - (NSData *)cachedResponseBodyForTransaction:(FLEXHTTPTransaction *)transaction;
 
+/// HTTP transactions whose URL, headers, or cached text response body contain the text,
+/// ignoring the case of ASCII letters. Candidates are found with a trigram index of finished
+/// transactions and then verified. Safe to call from any thread.
+- (NSArray<FLEXHTTPTransaction *> *)HTTPTransactionsContainingText:(NSString *)text;
+/// Whether the transaction's URL, headers, or cached text response body contain the text.
+/// Checks the transaction directly rather than through the index.
+- (BOOL)HTTPTransaction:(FLEXHTTPTransaction *)transaction containsText:(NSString *)text;
+
+/// Decodes previews of image responses for the cells that show them
+@property (nonatomic, readonly) FLEXNetworkThumbnailLoader *thumbnailLoader;
+
+/// Per-host and per-endpoint statistics of every HTTP transaction that has finished or failed,
+/// including those since evicted by \c transactionLimit. Cleared by \c clearRecordedActivity.
+@property (nonatomic, readonly) FLEXNetworkAnalytics *analytics;
+
+/// Whether finished and failed HTTP transactions are written to a journal on disk, so that the
+/// traffic of a launch can still be inspected after the app is relaunched. Takes effect right away.
+/// Defaults to NO if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) BOOL journalingEnabled;
+/// Whether the journal includes request and response bodies, not just metadata.
+/// Defaults to NO if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) BOOL journalIncludesBodies;
+/// The most disk space the journals of all launches may use; the oldest are deleted first.
+/// Defaults to 50 MB if never set. Values set here are persisted across launches of the app.
+@property (nonatomic) NSUInteger journalByteLimit;
+/// The journals of earlier launches of the app, newest first. Not affected by \c clearRecordedActivity.
+@property (nonatomic, readonly) NSArray<FLEXNetworkJournalSession *> *previousJournalSessions;
+
 /// Dumps all network transactions and cached response bodies.
 - (void)clearRecordedActivity;
 
@@ -66,57 +134,64 @@ typedef NS_ENUM(NSUInteger, FLEXNetworkTransactionKind) {
 #pragma mark Recording network activity
 
 /// Call when app is about to send HTTP request.
-- (void)recordRequestWillBeSentWithRequestID:(NSString *)requestID
+- (void)recordRequestWillBeSentWithRequestID:(FLEXNetworkRequestID)requestID
                                      request:(NSURLRequest *)request
                             redirectResponse:(NSURLResponse *)redirectResponse;
 
 /// Call when HTTP response is available.
-- (void)recordResponseReceivedWithRequestID:(NSString *)requestID response:(NSURLResponse *)response;
+- (void)recordResponseReceivedWithRequestID:(FLEXNetworkRequestID)requestID response:(NSURLResponse *)response;
 
 /// Call when data chunk is received over the network.
-- (void)recordDataReceivedWithRequestID:(NSString *)requestID dataLength:(int64_t)dataLength;
+- (void)recordDataReceivedWithRequestID:(FLEXNetworkRequestID)requestID dataLength:(int64_t)dataLength;
 
 /// Call when HTTP request has finished loading.
-- (void)recordLoadingFinishedWithRequestID:(NSString *)requestID responseBody:(NSData *)responseBody;
+- (void)recordLoadingFinishedWithRequestID:(FLEXNetworkRequestID)requestID responseBody:(NSData *)responseBody;
 
 /// Call when HTTP request has failed to load.
-- (void)recordLoadingFailedWithRequestID:(NSString *)requestID error:(NSError *)error;
+- (void)recordLoadingFailedWithRequestID:(FLEXNetworkRequestID)requestID error:(NSError *)error;
 
 /// Call to set the request mechanism anytime after recordRequestWillBeSent... has been called.
 /// This string can be set to anything useful about the API used to make the request.
-- (void)recordMechanism:(NSString *)mechanism forRequestID:(NSString *)requestID;
+- (void)recordMechanism:(NSString *)mechanism forRequestID:(FLEXNetworkRequestID)requestID;
+
+/// Call when an \c NSURLSessionTask has collected its metrics, which is usually just before it completes.
+- (void)recordMetrics:(NSURLSessionTaskMetrics *)metrics forRequestID:(FLEXNetworkRequestID)requestID;
 
 - (void)recordWebsocketMessageSend:(NSURLSessionWebSocketMessage *)message
                               task:(NSURLSessionWebSocketTask *)task API_AVAILABLE(ios(13.0));
+- (void)recordWebsocketMessageSendCompletion:(NSURLSessionWebSocketMessage *)message
+                                        task:(NSURLSessionWebSocketTask *)task
+                                       error:(NSError *)error API_AVAILABLE(ios(13.0));
+/// Prefer passing the task, which finds the message's transaction without checking every conversation
 - (void)recordWebsocketMessageSendCompletion:(NSURLSessionWebSocketMessage *)message
                                        error:(NSError *)error API_AVAILABLE(ios(13.0));
 
 - (void)recordWebsocketMessageReceived:(NSURLSessionWebSocketMessage *)message
                                   task:(NSURLSessionWebSocketTask *)task API_AVAILABLE(ios(13.0));
 
-- (void)recordFIRQueryWillFetch:(FIRQuery *)query withTransactionID:(NSString *)transactionID;
-- (void)recordFIRDocumentWillFetch:(FIRDocumentReference *)document withTransactionID:(NSString *)transactionID;
+- (void)recordFIRQueryWillFetch:(FIRQuery *)query withTransactionID:(FLEXNetworkRequestID)transactionID;
+- (void)recordFIRDocumentWillFetch:(FIRDocumentReference *)document withTransactionID:(FLEXNetworkRequestID)transactionID;
 
 - (void)recordFIRQueryDidFetch:(FIRQuerySnapshot *)response error:(NSError *)error
-                 transactionID:(NSString *)transactionID;
+                 transactionID:(FLEXNetworkRequestID)transactionID;
 - (void)recordFIRDocumentDidFetch:(FIRDocumentSnapshot *)response error:(NSError *)error
-                    transactionID:(NSString *)transactionID;
+                    transactionID:(FLEXNetworkRequestID)transactionID;
 
 - (void)recordFIRWillSetData:(FIRDocumentReference *)doc
                         data:(NSDictionary *)documentData
                        merge:(NSNumber *)yesorno
                  mergeFields:(NSArray *)fields
-               transactionID:(NSString *)transactionID;
+               transactionID:(FLEXNetworkRequestID)transactionID;
 - (void)recordFIRWillUpdateData:(FIRDocumentReference *)doc fields:(NSDictionary *)fields
-                  transactionID:(NSString *)transactionID;
-- (void)recordFIRWillDeleteDocument:(FIRDocumentReference *)doc transactionID:(NSString *)transactionID;
+                  transactionID:(FLEXNetworkRequestID)transactionID;
+- (void)recordFIRWillDeleteDocument:(FIRDocumentReference *)doc transactionID:(FLEXNetworkRequestID)transactionID;
 - (void)recordFIRWillAddDocument:(FIRCollectionReference *)initiator
                             document:(FIRDocumentReference *)doc
-                   transactionID:(NSString *)transactionID;
+                   transactionID:(FLEXNetworkRequestID)transactionID;
 
-- (void)recordFIRDidSetData:(NSError *)error transactionID:(NSString *)transactionID;
-- (void)recordFIRDidUpdateData:(NSError *)error transactionID:(NSString *)transactionID;
-- (void)recordFIRDidDeleteDocument:(NSError *)error transactionID:(NSString *)transactionID;
-- (void)recordFIRDidAddDocument:(NSError *)error transactionID:(NSString *)transactionID;
+- (void)recordFIRDidSetData:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID;
+- (void)recordFIRDidUpdateData:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID;
+- (void)recordFIRDidDeleteDocument:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID;
+- (void)recordFIRDidAddDocument:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID;
 
 @end
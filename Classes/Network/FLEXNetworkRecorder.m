@@ -9,37 +9,100 @@
 #import "FLEXNetworkRecorder.h"
 #import "FLEXNetworkCurlLogger.h"
 #import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkTransactionStore.h"
+#import "FLEXNetworkTransactionCoalescer.h"
+#import "FLEXNetworkEventRing.h"
+#import "FLEXNetworkBodyDiskCache.h"
+#import "FLEXNetworkJournal.h"
+#import "FLEXNetworkTextIndex.h"
+#import "FLEXNetworkHostDenylist.h"
+#import "FLEXNetworkAnalytics.h"
+#import "FLEXNetworkThumbnailLoader.h"
+#import "FLEXWebsocketConversation.h"
 #import "FLEXUtility.h"
 #import "FLEXResources.h"
 #import "NSUserDefaults+FLEX.h"
 #import "OSCache.h"
 
-#define Synchronized(queue, obj) ({ \
-    __block id __synchronized_retval = nil; \
-    dispatch_sync(queue, ^{ __synchronized_retval = obj; }); \
-    __synchronized_retval; \
-})
-    
-
-NSString *const kFLEXNetworkRecorderNewTransactionNotification = @"kFLEXNetworkRecorderNewTransactionNotification";
-NSString *const kFLEXNetworkRecorderTransactionUpdatedNotification = @"kFLEXNetworkRecorderTransactionUpdatedNotification";
-NSString *const kFLEXNetworkRecorderUserInfoTransactionKey = @"transaction";
+NSString *const kFLEXNetworkRecorderTransactionsChangedNotification = @"kFLEXNetworkRecorderTransactionsChangedNotification";
+NSString *const kFLEXNetworkRecorderUserInfoInsertedTransactionsKey = @"inserted";
+NSString *const kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey = @"updated";
 NSString *const kFLEXNetworkRecorderTransactionsClearedNotification = @"kFLEXNetworkRecorderTransactionsClearedNotification";
 
 NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.responseCacheLimit";
+NSString *const kFLEXNetworkRecorderTransactionLimitDefaultsKey = @"com.flex.transactionLimit";
+NSString *const kFLEXNetworkRecorderDiskCacheLimitDefaultsKey = @"com.flex.responseDiskCacheLimit";
+NSString *const kFLEXNetworkRecorderTextIndexLimitDefaultsKey = @"com.flex.textIndexLimit";
+NSString *const kFLEXNetworkRecorderWebsocketFrameLimitDefaultsKey = @"com.flex.websocketFrameLimit";
+NSString *const kFLEXNetworkRecorderWebsocketPayloadLimitDefaultsKey = @"com.flex.websocketPayloadLimit";
+NSString *const kFLEXNetworkRecorderJournalingEnabledDefaultsKey = @"com.flex.journalingEnabled";
+NSString *const kFLEXNetworkRecorderJournalBodiesDefaultsKey = @"com.flex.journalIncludesBodies";
+NSString *const kFLEXNetworkRecorderJournalLimitDefaultsKey = @"com.flex.journalLimit";
+
+static const NSUInteger kFLEXNetworkRecorderDefaultTransactionLimit = 5000;
+static const NSUInteger kFLEXNetworkRecorderDefaultWebsocketFrameLimit = 1000;
+static const NSUInteger kFLEXNetworkRecorderDefaultWebsocketPayloadLimit = 256 * 1024;
+static const NSUInteger kFLEXNetworkRecorderDefaultJournalLimit = 50 * 1024 * 1024;
+/// Conversations are only evicted once this many newer ones have started
+static const NSUInteger kFLEXNetworkRecorderWebsocketConversationLimit = 100;
+/// Room for the events of a burst of requests before posting has to wait for the queue
+static const NSUInteger kFLEXNetworkRecorderEventCapacity = 4096;
 
-@interface FLEXNetworkRecorder ()
+/// The kinds of \c FLEXNetworkEvent posted to the recorder's event ring
+typedef NS_ENUM(uint32_t, FLEXNetworkRecorderEvent) {
+    /// The object is the new transaction
+    FLEXNetworkRecorderEventRequestWillBeSent,
+    /// The object is the response
+    FLEXNetworkRecorderEventResponseReceived,
+    /// The length is the number of bytes received
+    FLEXNetworkRecorderEventDataReceived,
+    /// The object is the response body, if any
+    FLEXNetworkRecorderEventLoadingFinished,
+    /// The object is the error
+    FLEXNetworkRecorderEventLoadingFailed,
+    /// The object is the mechanism
+    FLEXNetworkRecorderEventMechanism,
+    /// The object is the task metrics
+    FLEXNetworkRecorderEventMetrics,
+};
+
+@interface FLEXNetworkRecorder () <OSCacheDelegate>
 
 @property (nonatomic) OSCache *restCache;
-@property (atomic) NSMutableArray<FLEXHTTPTransaction *> *orderedHTTPTransactions;
-@property (atomic) NSMutableArray<FLEXWebsocketTransaction *> *orderedWSTransactions;
-@property (atomic) NSMutableArray<FLEXFirebaseTransaction *> *orderedFirebaseTransactions;
-@property (atomic) NSMutableDictionary<NSString *, __kindof FLEXNetworkTransaction *> *requestIDsToTransactions;
+/// Response bodies evicted from \c restCache are spilled here
+@property (nonatomic) FLEXNetworkBodyDiskCache *restDiskCache;
+@property (nonatomic) FLEXNetworkTransactionStore<FLEXHTTPTransaction *> *orderedHTTPTransactions;
+@property (nonatomic) FLEXNetworkTransactionStore<FLEXWebsocketTransaction *> *orderedWSTransactions;
+@property (nonatomic) FLEXNetworkTransactionStore<FLEXWebsocketConversation *> *orderedWSConversations;
+/// Only holds on to the conversations still in \c orderedWSConversations, and only while their task is alive
+@property (nonatomic) NSMapTable<NSURLSessionWebSocketTask *, FLEXWebsocketConversation *> *tasksToWSConversations;
+@property (nonatomic) FLEXNetworkTransactionStore<FLEXFirebaseTransaction *> *orderedFirebaseTransactions;
+@property (nonatomic) FLEXNetworkTransactionCoalescer *coalescer;
+/// URLs and headers of finished transactions, by request ID
+@property (nonatomic) FLEXNetworkTextIndex *headerTextIndex;
+/// Text response bodies in \c restCache, by request ID
+@property (nonatomic) FLEXNetworkTextIndex *bodyTextIndex;
+/// Indexing happens here so that it doesn't hold up recording
+@property (nonatomic) dispatch_queue_t indexQueue;
 @property (nonatomic) dispatch_queue_t queue;
+/// HTTP events from every thread, applied in batches on the queue
+@property (nonatomic) FLEXNetworkEventRing *events;
+/// Only set while journaling is enabled. Only accessed on the queue.
+@property (nonatomic) FLEXNetworkJournal *journal;
 
 @end
 
-@implementation FLEXNetworkRecorder
+@implementation FLEXNetworkRecorder {
+    /// Never replaced, so that requests can be checked against it from any thread.
+    /// Setting \c hostDenylist replaces its contents instead.
+    FLEXNetworkHostDenylistRules *_hostDenylist;
+    // Only accessed on the queue
+    /// Request ID to the transaction being recorded for it. An entry is removed once its transaction
+    /// has finished or failed and has left its ordered store, since nothing can look it up after that.
+    CFMutableDictionaryRef _transactionsByRequestID;
+    /// Request IDs of HTTP transactions that left \c orderedHTTPTransactions before they ended
+    CFMutableSetRef _evictedRequestIDs;
+}
 
 - (instancetype)init {
     self = [super init];
@@ -52,20 +115,97 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
         // Default to 25 MB max. The cache will purge earlier if there is memory pressure.
         self.restCache.totalCostLimit = responseCacheLimit ?: 25 * 1024 * 1024;
         [self.restCache setTotalCostLimit:responseCacheLimit];
+        self.restCache.delegate = self;
+        
+        // Default to 100 MB on disk
+        NSUInteger diskCacheLimit = [[NSUserDefaults.standardUserDefaults
+            objectForKey:kFLEXNetworkRecorderDiskCacheLimitDefaultsKey] unsignedIntegerValue
+        ];
+        NSString *caches = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES).firstObject;
+        self.restDiskCache = [FLEXNetworkBodyDiskCache
+            cacheInDirectory:[caches stringByAppendingPathComponent:@"com.flex.FLEXNetworkRecorder"]
+            byteLimit:diskCacheLimit ?: 100 * 1024 * 1024
+        ];
+        
+        // Default to 16 MB for the search index
+        NSUInteger textIndexLimit = [[NSUserDefaults.standardUserDefaults
+            objectForKey:kFLEXNetworkRecorderTextIndexLimitDefaultsKey] unsignedIntegerValue
+        ] ?: 16 * 1024 * 1024;
+        self.headerTextIndex = [FLEXNetworkTextIndex indexWithByteLimit:textIndexLimit / 4];
+        self.bodyTextIndex = [FLEXNetworkTextIndex indexWithByteLimit:textIndexLimit - textIndexLimit / 4];
+        self.indexQueue = dispatch_queue_create("com.flex.FLEXNetworkRecorder.index", DISPATCH_QUEUE_SERIAL);
         
-        self.orderedWSTransactions = [NSMutableArray new];
-        self.orderedHTTPTransactions = [NSMutableArray new];
-        self.orderedFirebaseTransactions = [NSMutableArray new];
-        self.requestIDsToTransactions = [NSMutableDictionary new];
-        self.hostDenylist = NSUserDefaults.standardUserDefaults.flex_networkHostDenylist.mutableCopy;
+        NSUInteger transactionLimit = [[NSUserDefaults.standardUserDefaults
+            objectForKey:kFLEXNetworkRecorderTransactionLimitDefaultsKey] unsignedIntegerValue
+        ] ?: kFLEXNetworkRecorderDefaultTransactionLimit;
+        
+        self.orderedWSTransactions = [FLEXNetworkTransactionStore storeWithCapacity:transactionLimit];
+        self.orderedHTTPTransactions = [FLEXNetworkTransactionStore storeWithCapacity:transactionLimit];
+        self.orderedFirebaseTransactions = [FLEXNetworkTransactionStore storeWithCapacity:transactionLimit];
+        
+        _websocketFrameLimit = [[NSUserDefaults.standardUserDefaults
+            objectForKey:kFLEXNetworkRecorderWebsocketFrameLimitDefaultsKey] unsignedIntegerValue
+        ] ?: kFLEXNetworkRecorderDefaultWebsocketFrameLimit;
+        NSNumber *payloadLimit = [NSUserDefaults.standardUserDefaults
+            objectForKey:kFLEXNetworkRecorderWebsocketPayloadLimitDefaultsKey
+        ];
+        _websocketPayloadCaptureLimit = payloadLimit ? payloadLimit.unsignedIntegerValue : kFLEXNetworkRecorderDefaultWebsocketPayloadLimit;
+        self.orderedWSConversations = [FLEXNetworkTransactionStore
+            storeWithCapacity:kFLEXNetworkRecorderWebsocketConversationLimit
+        ];
+        self.tasksToWSConversations = [NSMapTable weakToWeakObjectsMapTable];
+        _transactionsByRequestID = CFDictionaryCreateMutable(NULL, 0, NULL, &kCFTypeDictionaryValueCallBacks);
+        _evictedRequestIDs = CFSetCreateMutable(NULL, 0, NULL);
+        _analytics = [FLEXNetworkAnalytics new];
+        
+        NSUserDefaults *defaults = NSUserDefaults.standardUserDefaults;
+        _journalingEnabled = [defaults boolForKey:kFLEXNetworkRecorderJournalingEnabledDefaultsKey];
+        _journalIncludesBodies = [defaults boolForKey:kFLEXNetworkRecorderJournalBodiesDefaultsKey];
+        _journalByteLimit = [[defaults
+            objectForKey:kFLEXNetworkRecorderJournalLimitDefaultsKey] unsignedIntegerValue
+        ] ?: kFLEXNetworkRecorderDefaultJournalLimit;
+        if (_journalingEnabled) {
+            self.journal = [self makeJournal];
+        }
+        _hostDenylist = [FLEXNetworkHostDenylistRules
+            arrayWithArray:NSUserDefaults.standardUserDefaults.flex_networkHostDenylist
+        ];
 
         // Serial queue used because we use mutable objects that are not thread safe
         self.queue = dispatch_queue_create("com.flex.FLEXNetworkRecorder", DISPATCH_QUEUE_SERIAL);
+        __weak __typeof(self) weakSelf = self;
+        self.events = [FLEXNetworkEventRing
+            ringWithCapacity:kFLEXNetworkRecorderEventCapacity
+            queue:self.queue
+            handler:^(const FLEXNetworkEvent *events, NSUInteger count) {
+                [weakSelf applyEvents:events count:count];
+            }
+        ];
+        _thumbnailLoader = [FLEXNetworkThumbnailLoader loaderWithBodyProvider:^NSData *(FLEXHTTPTransaction *transaction) {
+            return [weakSelf cachedResponseBodyForTransaction:transaction];
+        }];
+        
+        // Batch change notifications so a busy download doesn't flood the main queue
+        self.coalescer = [FLEXNetworkTransactionCoalescer coalescerWithHandler:^(NSArray *inserted, NSArray *updated) {
+            [NSNotificationCenter.defaultCenter
+                postNotificationName:kFLEXNetworkRecorderTransactionsChangedNotification
+                object:self
+                userInfo:@{
+                    kFLEXNetworkRecorderUserInfoInsertedTransactionsKey: inserted,
+                    kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey: updated,
+                }
+            ];
+        }];
     }
     
     return self;
 }
 
+- (void)dealloc {
+    CFRelease(_transactionsByRequestID);
+    CFRelease(_evictedRequestIDs);
+}
+
 + (instancetype)defaultRecorder {
     static FLEXNetworkRecorder *defaultRecorder = nil;
     static dispatch_once_t onceToken;
@@ -90,236 +230,472 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
     ];
 }
 
+- (NSUInteger)responseDiskCacheByteLimit {
+    return self.restDiskCache.byteLimit;
+}
+
+- (void)setResponseDiskCacheByteLimit:(NSUInteger)responseDiskCacheByteLimit {
+    self.restDiskCache.byteLimit = responseDiskCacheByteLimit;
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(responseDiskCacheByteLimit)
+        forKey:kFLEXNetworkRecorderDiskCacheLimitDefaultsKey
+    ];
+}
+
+- (NSUInteger)textIndexByteLimit {
+    return self.headerTextIndex.byteLimit + self.bodyTextIndex.byteLimit;
+}
+
+- (void)setTextIndexByteLimit:(NSUInteger)textIndexByteLimit {
+    // Bodies take up most of the index, same split as in -init
+    self.headerTextIndex.byteLimit = textIndexByteLimit / 4;
+    self.bodyTextIndex.byteLimit = textIndexByteLimit - textIndexByteLimit / 4;
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(textIndexByteLimit)
+        forKey:kFLEXNetworkRecorderTextIndexLimitDefaultsKey
+    ];
+}
+
+- (NSUInteger)responseBodyCaptureLimit {
+    return MAX(self.responseCacheByteLimit, self.responseDiskCacheByteLimit);
+}
+
+- (NSTimeInterval)notificationCoalescingInterval {
+    return self.coalescer.interval;
+}
+
+- (void)setNotificationCoalescingInterval:(NSTimeInterval)interval {
+    self.coalescer.interval = interval;
+}
+
+- (NSUInteger)transactionLimit {
+    return self.orderedHTTPTransactions.capacity;
+}
+
+- (void)setTransactionLimit:(NSUInteger)transactionLimit {
+    transactionLimit = MAX(transactionLimit, 1);
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(transactionLimit)
+        forKey:kFLEXNetworkRecorderTransactionLimitDefaultsKey
+    ];
+    
+    dispatch_async(self.queue, ^{
+        for (FLEXHTTPTransaction *evicted in [self.orderedHTTPTransactions resize:transactionLimit]) {
+            [self didEvictTransaction:evicted];
+        }
+        [self.orderedWSTransactions resize:transactionLimit];
+        [self.orderedFirebaseTransactions resize:transactionLimit];
+        
+        [self postTransactionsClearedNotification];
+    });
+}
+
+- (void)setWebsocketFrameLimit:(NSUInteger)websocketFrameLimit {
+    websocketFrameLimit = MAX(websocketFrameLimit, 1);
+    _websocketFrameLimit = websocketFrameLimit;
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(websocketFrameLimit)
+        forKey:kFLEXNetworkRecorderWebsocketFrameLimitDefaultsKey
+    ];
+    
+    dispatch_async(self.queue, ^{
+        for (FLEXWebsocketConversation *conversation in self.orderedWSConversations.snapshot) {
+            conversation.frameLimit = websocketFrameLimit;
+        }
+        
+        [self postTransactionsClearedNotification];
+    });
+}
+
+- (void)setWebsocketPayloadCaptureLimit:(NSUInteger)websocketPayloadCaptureLimit {
+    _websocketPayloadCaptureLimit = websocketPayloadCaptureLimit;
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(websocketPayloadCaptureLimit)
+        forKey:kFLEXNetworkRecorderWebsocketPayloadLimitDefaultsKey
+    ];
+}
+
+- (void)setJournalingEnabled:(BOOL)journalingEnabled {
+    // Enabling it again would start another session
+    if (journalingEnabled == _journalingEnabled) {
+        return;
+    }
+    
+    _journalingEnabled = journalingEnabled;
+    [NSUserDefaults.standardUserDefaults
+        setBool:journalingEnabled forKey:kFLEXNetworkRecorderJournalingEnabledDefaultsKey
+    ];
+    
+    // A disabled journal still commits what was appended to it before it goes away
+    FLEXNetworkJournal *journal = journalingEnabled ? [self makeJournal] : nil;
+    dispatch_async(self.queue, ^{
+        self.journal = journal;
+    });
+}
+
+- (void)setJournalIncludesBodies:(BOOL)journalIncludesBodies {
+    _journalIncludesBodies = journalIncludesBodies;
+    [NSUserDefaults.standardUserDefaults
+        setBool:journalIncludesBodies forKey:kFLEXNetworkRecorderJournalBodiesDefaultsKey
+    ];
+    
+    dispatch_async(self.queue, ^{
+        self.journal.includesBodies = journalIncludesBodies;
+    });
+}
+
+- (void)setJournalByteLimit:(NSUInteger)journalByteLimit {
+    _journalByteLimit = journalByteLimit;
+    [NSUserDefaults.standardUserDefaults
+        setObject:@(journalByteLimit) forKey:kFLEXNetworkRecorderJournalLimitDefaultsKey
+    ];
+    
+    dispatch_async(self.queue, ^{
+        self.journal.byteLimit = journalByteLimit;
+    });
+}
+
+- (NSArray<FLEXNetworkJournalSession *> *)previousJournalSessions {
+    __block FLEXNetworkJournal *journal = nil;
+    dispatch_sync(self.queue, ^{
+        journal = self.journal;
+    });
+    
+    return journal.previousSessions ?: [FLEXNetworkJournal sessionsInDirectory:FLEXNetworkJournal.defaultDirectory];
+}
+
+- (FLEXNetworkJournal *)makeJournal {
+    FLEXNetworkJournal *journal = [FLEXNetworkJournal
+        journalInDirectory:FLEXNetworkJournal.defaultDirectory byteLimit:self.journalByteLimit
+    ];
+    journal.includesBodies = self.journalIncludesBodies;
+    return journal;
+}
+
+// These are snapshots cached by each store until its next mutation,
+// so reading them repeatedly does not need to hop onto the queue
 - (NSArray<FLEXHTTPTransaction *> *)HTTPTransactions {
-    return Synchronized(self.queue, self.orderedHTTPTransactions.copy);
+    return self.orderedHTTPTransactions.snapshot;
 }
 
 - (NSArray<FLEXWebsocketTransaction *> *)websocketTransactions {
-    return Synchronized(self.queue, self.orderedWSTransactions.copy);
+    return self.orderedWSTransactions.snapshot;
+}
+
+- (NSArray<FLEXWebsocketConversation *> *)websocketConversations {
+    return self.orderedWSConversations.snapshot;
 }
 
 - (NSArray<FLEXFirebaseTransaction *> *)firebaseTransactions {
-    return Synchronized(self.queue, self.orderedFirebaseTransactions.copy);
+    return self.orderedFirebaseTransactions.snapshot;
 }
 
 - (NSData *)cachedResponseBodyForTransaction:(FLEXHTTPTransaction *)transaction {
-    return [self.restCache objectForKey:transaction.requestID];
+    if ([transaction isKindOfClass:[FLEXJournaledHTTPTransaction class]]) {
+        return ((FLEXJournaledHTTPTransaction *)transaction).responseBody;
+    }
+    
+    NSNumber *requestID = @(transaction.requestID);
+    return [self.restCache objectForKey:requestID] ?: [self.restDiskCache dataForKey:requestID];
+}
+
+- (NSArray<FLEXHTTPTransaction *> *)HTTPTransactionsContainingText:(NSString *)text {
+    NSArray<FLEXHTTPTransaction *> *transactions = self.HTTPTransactions;
+    NSSet<NSNumber *> *headerCandidates = [self.headerTextIndex keysOfCandidatesContainingText:text];
+    NSSet<NSNumber *> *bodyCandidates = [self.bodyTextIndex keysOfCandidatesContainingText:text];
+
+    // Too short to look up in the index
+    if (!headerCandidates) {
+        return [transactions flex_filtered:^BOOL(FLEXHTTPTransaction *transaction, NSUInteger idx) {
+            return [self HTTPTransaction:transaction containsText:text];
+        }];
+    }
+
+    return [transactions flex_filtered:^BOOL(FLEXHTTPTransaction *transaction, NSUInteger idx) {
+        NSNumber *requestID = @(transaction.requestID);
+        if ([headerCandidates containsObject:requestID] &&
+            [FLEXNetworkTextIndex text:[self indexableHeadersOfTransaction:transaction] containsText:text]) {
+            return YES;
+        }
+
+        return [bodyCandidates containsObject:requestID] &&
+            [FLEXNetworkTextIndex text:[self.restCache objectForKey:requestID] containsText:text];
+    }];
+}
+
+- (BOOL)HTTPTransaction:(FLEXHTTPTransaction *)transaction containsText:(NSString *)text {
+    if ([FLEXNetworkTextIndex text:[self indexableHeadersOfTransaction:transaction] containsText:text]) {
+        return YES;
+    }
+
+    if (![self.class isIndexableMIMEType:transaction.response.MIMEType]) {
+        return NO;
+    }
+
+    NSData *body = [self.restCache objectForKey:@(transaction.requestID)];
+    return body && [FLEXNetworkTextIndex text:body containsText:text];
 }
 
 - (void)clearRecordedActivity {
     dispatch_async(self.queue, ^{
+        // Events posted before clearing are cleared too
+        [self.events drain];
         [self.restCache removeAllObjects];
+        [self.restDiskCache removeAllData];
+        [self.thumbnailLoader removeAll];
+        dispatch_async(self.indexQueue, ^{
+            [self.headerTextIndex removeAllText];
+            [self.bodyTextIndex removeAllText];
+        });
         [self.orderedWSTransactions removeAllObjects];
+        [self.orderedWSConversations removeAllObjects];
+        [self.tasksToWSConversations removeAllObjects];
         [self.orderedHTTPTransactions removeAllObjects];
         [self.orderedFirebaseTransactions removeAllObjects];
-        [self.requestIDsToTransactions removeAllObjects];
+        CFDictionaryRemoveAllValues(self->_transactionsByRequestID);
+        CFSetRemoveAllValues(self->_evictedRequestIDs);
+        [self.analytics removeAllStats];
         
-        [self notify:kFLEXNetworkRecorderTransactionsClearedNotification transaction:nil];
+        [self postTransactionsClearedNotification];
     });
 }
 
 - (void)clearRecordedActivity:(FLEXNetworkTransactionKind)kind matching:(NSString *)query {
     dispatch_async(self.queue, ^{
+        [self.events drain];
         switch (kind) {
             case FLEXNetworkTransactionKindFirebase: {
-                [self.orderedFirebaseTransactions flex_filter:^BOOL(FLEXFirebaseTransaction *obj, NSUInteger idx) {
-                    return ![obj matchesQuery:query];
+                [self.orderedFirebaseTransactions removeObjectsPassingTest:^BOOL(FLEXFirebaseTransaction *obj) {
+                    return [obj matchesQuery:query];
                 }];
                 break;
             }
             case FLEXNetworkTransactionKindREST: {
-                NSArray<FLEXHTTPTransaction *> *toRemove;
-                toRemove = [self.orderedHTTPTransactions flex_filtered:^BOOL(FLEXHTTPTransaction *obj, NSUInteger idx) {
-                    return [obj matchesQuery:query];
+                // Match the search in the network screen, which also searches content
+                NSSet *contentMatches = [NSSet setWithArray:[self HTTPTransactionsContainingText:query]];
+                NSArray<FLEXHTTPTransaction *> *removed;
+                removed = [self.orderedHTTPTransactions removeObjectsPassingTest:^BOOL(FLEXHTTPTransaction *obj) {
+                    return [obj matchesQuery:query] || [contentMatches containsObject:obj];
                 }];
                 
                 // Remove from cache
-                for (FLEXHTTPTransaction *t in toRemove) {
-                    [self.restCache removeObjectForKey:t.requestID];
+                for (FLEXHTTPTransaction *t in removed) {
+                    [self didEvictTransaction:t];
                 }
                 
-                // Remove from list
-                [self.orderedHTTPTransactions removeObjectsInArray:toRemove];
-                
                 break;
             }
             case FLEXNetworkTransactionKindWebsockets: {
-                [self.orderedWSTransactions flex_filter:^BOOL(FLEXWebsocketTransaction *obj, NSUInteger idx) {
-                    return ![obj matchesQuery:query];
+                [self.orderedWSTransactions removeObjectsPassingTest:^BOOL(FLEXWebsocketTransaction *obj) {
+                    return [obj matchesQuery:query];
+                }];
+                
+                // Matching is by URL, so whole conversations are usually removed
+                for (FLEXWebsocketConversation *conversation in self.orderedWSConversations.snapshot) {
+                    [conversation removeFramesPassingTest:^BOOL(FLEXWebsocketTransaction *frame) {
+                        return [frame matchesQuery:query];
+                    }];
+                }
+                [self.orderedWSConversations removeObjectsPassingTest:^BOOL(FLEXWebsocketConversation *obj) {
+                    return obj.frameCount == 0;
                 }];
                 break;
             }
         }
         
-        [self notify:kFLEXNetworkRecorderTransactionsClearedNotification transaction:nil];
+        [self postTransactionsClearedNotification];
     });
 }
 
 - (void)clearExcludedTransactions {
     dispatch_sync(self.queue, ^{
-        self.orderedHTTPTransactions = ({
-            [self.orderedHTTPTransactions flex_filtered:^BOOL(FLEXHTTPTransaction *ta, NSUInteger idx) {
-                NSString *host = ta.request.URL.host;
-                for (NSString *excluded in self.hostDenylist) {
-                    if ([host hasSuffix:excluded]) {
-                        return NO;
-                    }
-                }
-                
-                return YES;
-            }];
-        });
+        NSArray<FLEXHTTPTransaction *> *removed;
+        removed = [self.orderedHTTPTransactions removeObjectsPassingTest:^BOOL(FLEXHTTPTransaction *ta) {
+            return [self isHostDenied:ta.request.URL.host];
+        }];
+        
+        for (FLEXHTTPTransaction *t in removed) {
+            [self didEvictTransaction:t];
+        }
+
+        [self.analytics removeStatsForHostsPassingTest:^BOOL(NSString *host) {
+            return [self isHostDenied:host];
+        }];
     });
 }
 
 - (void)synchronizeDenylist {
-    NSUserDefaults.standardUserDefaults.flex_networkHostDenylist = self.hostDenylist;
+    NSUserDefaults.standardUserDefaults.flex_networkHostDenylist = self.hostDenylist.copy;
+}
+
+- (NSMutableArray<NSString *> *)hostDenylist {
+    return _hostDenylist;
+}
+
+- (void)setHostDenylist:(NSMutableArray<NSString *> *)hostDenylist {
+    [_hostDenylist setArray:hostDenylist ?: @[]];
+}
+
+- (BOOL)isHostDenied:(NSString *)host {
+    return [_hostDenylist.denylist containsHost:host];
 }
 
 #pragma mark - Network Events
 
-- (void)recordRequestWillBeSentWithRequestID:(NSString *)requestID
+- (void)recordRequestWillBeSentWithRequestID:(FLEXNetworkRequestID)requestID
                                      request:(NSURLRequest *)request
                             redirectResponse:(NSURLResponse *)redirectResponse {
-    for (NSString *host in self.hostDenylist) {
-        if ([request.URL.host hasSuffix:host]) {
-            return;
-        }
+    if ([self isHostDenied:request.URL.host]) {
+        return;
     }
     
     FLEXHTTPTransaction *transaction = [FLEXHTTPTransaction request:request identifier:requestID];
 
-    // Before async block to keep times accurate
     if (redirectResponse) {
         [self recordResponseReceivedWithRequestID:requestID response:redirectResponse];
         [self recordLoadingFinishedWithRequestID:requestID responseBody:nil];
     }
 
     // A redirect is always a new request
-    dispatch_async(self.queue, ^{
-        [self.orderedHTTPTransactions insertObject:transaction atIndex:0];
-        self.requestIDsToTransactions[requestID] = transaction;
+    [self.events post:FLEXNetworkRecorderEventRequestWillBeSent requestID:requestID length:0 object:transaction];
+}
 
-        [self postNewTransactionNotificationWithTransaction:transaction];
-    });
+- (void)recordResponseReceivedWithRequestID:(FLEXNetworkRequestID)requestID response:(NSURLResponse *)response {
+    [self.events post:FLEXNetworkRecorderEventResponseReceived requestID:requestID length:0 object:response];
 }
 
-- (void)recordResponseReceivedWithRequestID:(NSString *)requestID response:(NSURLResponse *)response {
-    // Before async block to stay accurate
-    NSDate *responseDate = [NSDate date];
+- (void)recordDataReceivedWithRequestID:(FLEXNetworkRequestID)requestID dataLength:(int64_t)dataLength {
+    [self.events post:FLEXNetworkRecorderEventDataReceived requestID:requestID length:dataLength object:nil];
+}
 
-    dispatch_async(self.queue, ^{
-        FLEXHTTPTransaction *transaction = self.requestIDsToTransactions[requestID];
-        if (!transaction) {
-            return;
-        }
-        
-        transaction.response = response;
-        transaction.state = FLEXNetworkTransactionStateReceivingData;
-        transaction.latency = -[transaction.startTime timeIntervalSinceDate:responseDate];
+- (void)recordLoadingFinishedWithRequestID:(FLEXNetworkRequestID)requestID responseBody:(NSData *)responseBody {
+    [self.events post:FLEXNetworkRecorderEventLoadingFinished requestID:requestID length:0 object:responseBody];
+}
 
-        [self postUpdateNotificationForTransaction:transaction];
-    });
+- (void)recordLoadingFailedWithRequestID:(FLEXNetworkRequestID)requestID error:(NSError *)error {
+    [self.events post:FLEXNetworkRecorderEventLoadingFailed requestID:requestID length:0 object:error];
 }
 
-- (void)recordDataReceivedWithRequestID:(NSString *)requestID dataLength:(int64_t)dataLength {
-    dispatch_async(self.queue, ^{
-        FLEXHTTPTransaction *transaction = self.requestIDsToTransactions[requestID];
-        if (!transaction) {
-            return;
-        }
-        
-        transaction.receivedDataLength += dataLength;
-        [self postUpdateNotificationForTransaction:transaction];
-    });
+- (void)recordMechanism:(NSString *)mechanism forRequestID:(FLEXNetworkRequestID)requestID {
+    [self.events post:FLEXNetworkRecorderEventMechanism requestID:requestID length:0 object:mechanism];
 }
 
-- (void)recordLoadingFinishedWithRequestID:(NSString *)requestID responseBody:(NSData *)responseBody {
-    NSDate *finishedDate = [NSDate date];
+- (void)recordMetrics:(NSURLSessionTaskMetrics *)metrics forRequestID:(FLEXNetworkRequestID)requestID {
+    [self.events post:FLEXNetworkRecorderEventMetrics requestID:requestID length:0 object:metrics];
+}
 
-    dispatch_async(self.queue, ^{
-        FLEXHTTPTransaction *transaction = self.requestIDsToTransactions[requestID];
-        if (!transaction) {
-            return;
-        }
-        
-        transaction.state = FLEXNetworkTransactionStateFinished;
-        transaction.duration = -[transaction.startTime timeIntervalSinceDate:finishedDate];
+#pragma mark Network Events, on the queue
 
-        BOOL shouldCache = responseBody.length > 0;
-        if (!self.shouldCacheMediaResponses) {
-            NSArray<NSString *> *ignoredMIMETypePrefixes = @[ @"audio", @"image", @"video" ];
-            for (NSString *ignoredPrefix in ignoredMIMETypePrefixes) {
-                shouldCache = shouldCache && ![transaction.response.MIMEType hasPrefix:ignoredPrefix];
-            }
+- (void)applyEvents:(const FLEXNetworkEvent *)events count:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; i++) {
+        const FLEXNetworkEvent *event = &events[i];
+        FLEXNetworkRequestID requestID = event->requestID;
+        if (event->kind == FLEXNetworkRecorderEventRequestWillBeSent) {
+            FLEXHTTPTransaction *transaction = event->object;
+            [self didEvictTransaction:[self.orderedHTTPTransactions push:transaction]];
+            [self setTransaction:transaction forRequestID:requestID];
+            [self postNewTransactionNotificationWithTransaction:transaction];
+            continue;
         }
-        
-        if (shouldCache) {
-            [self.restCache setObject:responseBody forKey:requestID cost:responseBody.length];
+
+        FLEXHTTPTransaction *transaction = [self transactionForRequestID:requestID];
+        if (![transaction isKindOfClass:[FLEXHTTPTransaction class]]) {
+            continue;
         }
 
-        NSString *mimeType = transaction.response.MIMEType;
-        if ([mimeType hasPrefix:@"image/"] && responseBody.length > 0) {
-            // Thumbnail image previews on a separate background queue
-            dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-                NSInteger maxPixelDimension = UIScreen.mainScreen.scale * 32.0;
-                transaction.thumbnail = [FLEXUtility
-                    thumbnailedImageWithMaxPixelDimension:maxPixelDimension
-                    fromImageData:responseBody
+        switch ((FLEXNetworkRecorderEvent)event->kind) {
+            case FLEXNetworkRecorderEventRequestWillBeSent:
+                break;
+            case FLEXNetworkRecorderEventResponseReceived:
+                transaction.response = event->object;
+                transaction.state = FLEXNetworkTransactionStateReceivingData;
+                transaction.latency = [[FLEXNetworkEventRing dateOfTimestamp:event->timestamp]
+                    timeIntervalSinceDate:transaction.startTime
                 ];
-                [self postUpdateNotificationForTransaction:transaction];
-            });
-        } else if ([mimeType isEqual:@"application/json"]) {
-            transaction.thumbnail = FLEXResources.jsonIcon;
-        } else if ([mimeType isEqual:@"text/plain"]){
-            transaction.thumbnail = FLEXResources.textPlainIcon;
-        } else if ([mimeType isEqual:@"text/html"]) {
-            transaction.thumbnail = FLEXResources.htmlIcon;
-        } else if ([mimeType isEqual:@"application/x-plist"]) {
-            transaction.thumbnail = FLEXResources.plistIcon;
-        } else if ([mimeType isEqual:@"application/octet-stream"] || [mimeType isEqual:@"application/binary"]) {
-            transaction.thumbnail = FLEXResources.binaryIcon;
-        } else if ([mimeType containsString:@"javascript"]) {
-            transaction.thumbnail = FLEXResources.jsIcon;
-        } else if ([mimeType containsString:@"xml"]) {
-            transaction.thumbnail = FLEXResources.xmlIcon;
-        } else if ([mimeType hasPrefix:@"audio"]) {
-            transaction.thumbnail = FLEXResources.audioIcon;
-        } else if ([mimeType hasPrefix:@"video"]) {
-            transaction.thumbnail = FLEXResources.videoIcon;
-        } else if ([mimeType hasPrefix:@"text"]) {
-            transaction.thumbnail = FLEXResources.textIcon;
+                break;
+            case FLEXNetworkRecorderEventDataReceived:
+                transaction.receivedDataLength += event->length;
+                break;
+            case FLEXNetworkRecorderEventLoadingFinished:
+                [self finishTransaction:transaction
+                    body:event->object
+                    date:[FLEXNetworkEventRing dateOfTimestamp:event->timestamp]
+                ];
+                break;
+            case FLEXNetworkRecorderEventLoadingFailed:
+                transaction.state = FLEXNetworkTransactionStateFailed;
+                transaction.duration = [[FLEXNetworkEventRing dateOfTimestamp:event->timestamp]
+                    timeIntervalSinceDate:transaction.startTime
+                ];
+                transaction.error = event->object;
+                [self.analytics recordTransaction:transaction];
+                [self.journal appendTransaction:transaction responseBody:nil];
+                [self forgetRequestIDIfEvicted:requestID];
+                break;
+            case FLEXNetworkRecorderEventMechanism:
+                transaction.requestMechanism = event->object;
+                break;
+            case FLEXNetworkRecorderEventMetrics:
+                transaction.timings = [FLEXNetworkTimings timingsWithMetrics:event->object];
+                break;
         }
-        
+
         [self postUpdateNotificationForTransaction:transaction];
-    });
+    }
 }
 
-- (void)recordLoadingFailedWithRequestID:(NSString *)requestID error:(NSError *)error {
-    dispatch_async(self.queue, ^{
-        FLEXHTTPTransaction *transaction = self.requestIDsToTransactions[requestID];
-        if (!transaction) {
-            return;
-        }
-        
-        transaction.state = FLEXNetworkTransactionStateFailed;
-        transaction.duration = -[transaction.startTime timeIntervalSinceNow];
-        transaction.error = error;
+- (void)finishTransaction:(FLEXHTTPTransaction *)transaction body:(NSData *)responseBody date:(NSDate *)finishedDate {
+    FLEXNetworkRequestID requestID = transaction.requestID;
+    transaction.state = FLEXNetworkTransactionStateFinished;
+    transaction.duration = -[transaction.startTime timeIntervalSinceDate:finishedDate];
+    [self.analytics recordTransaction:transaction];
+    [self.journal appendTransaction:transaction responseBody:responseBody];
+    [self forgetRequestIDIfEvicted:requestID];
 
-        [self postUpdateNotificationForTransaction:transaction];
-    });
-}
+    BOOL shouldCache = responseBody.length > 0;
+    if (!self.shouldCacheMediaResponses) {
+        NSArray<NSString *> *ignoredMIMETypePrefixes = @[ @"audio", @"image", @"video" ];
+        for (NSString *ignoredPrefix in ignoredMIMETypePrefixes) {
+            shouldCache = shouldCache && ![transaction.response.MIMEType hasPrefix:ignoredPrefix];
+        }
+    }
+    
+    // Index before caching, since caching may evict the body right away
+    BOOL indexBody = shouldCache && [self.class isIndexableMIMEType:transaction.response.MIMEType];
+    [self indexTransaction:transaction body:indexBody ? responseBody : nil];
+    
+    if (shouldCache) {
+        [self.restCache setObject:responseBody forKey:@(requestID) cost:responseBody.length];
+    }
 
-- (void)recordMechanism:(NSString *)mechanism forRequestID:(NSString *)requestID {
-    dispatch_async(self.queue, ^{
-        FLEXHTTPTransaction *transaction = self.requestIDsToTransactions[requestID];
-        if (!transaction) {
-            return;
+    NSString *mimeType = transaction.response.MIMEType;
+    if ([mimeType hasPrefix:@"image/"]) {
+        // Image previews are decoded by the thumbnail loader once a cell shows them.
+        // Keep the body for it if it isn't going to be in the response cache.
+        if (!shouldCache) {
+            [self.thumbnailLoader setImageData:responseBody forRequestID:requestID];
         }
-        
-        transaction.requestMechanism = mechanism;
-        [self postUpdateNotificationForTransaction:transaction];
-    });
+    } else if ([mimeType isEqual:@"application/json"]) {
+        transaction.thumbnail = FLEXResources.jsonIcon;
+    } else if ([mimeType isEqual:@"text/plain"]){
+        transaction.thumbnail = FLEXResources.textPlainIcon;
+    } else if ([mimeType isEqual:@"text/html"]) {
+        transaction.thumbnail = FLEXResources.htmlIcon;
+    } else if ([mimeType isEqual:@"application/x-plist"]) {
+        transaction.thumbnail = FLEXResources.plistIcon;
+    } else if ([mimeType isEqual:@"application/octet-stream"] || [mimeType isEqual:@"application/binary"]) {
+        transaction.thumbnail = FLEXResources.binaryIcon;
+    } else if ([mimeType containsString:@"javascript"]) {
+        transaction.thumbnail = FLEXResources.jsIcon;
+    } else if ([mimeType containsString:@"xml"]) {
+        transaction.thumbnail = FLEXResources.xmlIcon;
+    } else if ([mimeType hasPrefix:@"audio"]) {
+        transaction.thumbnail = FLEXResources.audioIcon;
+    } else if ([mimeType hasPrefix:@"video"]) {
+        transaction.thumbnail = FLEXResources.videoIcon;
+    } else if ([mimeType hasPrefix:@"text"]) {
+        transaction.thumbnail = FLEXResources.textIcon;
+    }
 }
 
 #pragma mark - Websocket Events
@@ -328,22 +704,34 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
     dispatch_async(self.queue, ^{
         FLEXWebsocketTransaction *send = [FLEXWebsocketTransaction
             withMessage:message task:task direction:FLEXWebsocketOutgoing
+            startTime:NSDate.date payloadLimit:self.websocketPayloadCaptureLimit
         ];
         
-        [self.orderedWSTransactions insertObject:send atIndex:0];
+        [[self conversationForWebsocketTask:task] addFrame:send sentAsMessage:message];
+        [self.orderedWSTransactions push:send];
         [self postNewTransactionNotificationWithTransaction:send];
     });
 }
 
+- (void)recordWebsocketMessageSendCompletion:(NSURLSessionWebSocketMessage *)message
+                                        task:(NSURLSessionWebSocketTask *)task
+                                       error:(NSError *)error {
+    dispatch_async(self.queue, ^{
+        FLEXWebsocketConversation *conversation = [self.tasksToWSConversations objectForKey:task];
+        [self completeWebsocketSend:[conversation completeSendOfMessage:message] error:error];
+    });
+}
+
 - (void)recordWebsocketMessageSendCompletion:(NSURLSessionWebSocketMessage *)message error:(NSError *)error {
     dispatch_async(self.queue, ^{
-        FLEXWebsocketTransaction *send = [self.orderedWSTransactions flex_firstWhere:^BOOL(FLEXWebsocketTransaction *t) {
-            return t.message == message;
-        }];
-        send.error = error;
-        send.state = error ? FLEXNetworkTransactionStateFailed : FLEXNetworkTransactionStateFinished;
+        // Without the task, check each conversation's index instead
+        FLEXWebsocketTransaction *send = nil;
+        for (FLEXWebsocketConversation *conversation in self.orderedWSConversations.snapshot) {
+            send = [conversation completeSendOfMessage:message];
+            if (send) break;
+        }
         
-        [self postUpdateNotificationForTransaction:send];
+        [self completeWebsocketSend:send error:error];
     });
 }
 
@@ -351,34 +739,61 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
     dispatch_async(self.queue, ^{
         FLEXWebsocketTransaction *receive = [FLEXWebsocketTransaction
             withMessage:message task:task direction:FLEXWebsocketIncoming
+            startTime:NSDate.date payloadLimit:self.websocketPayloadCaptureLimit
         ];
         
-        [self.orderedWSTransactions insertObject:receive atIndex:0];
+        [[self conversationForWebsocketTask:task] addFrame:receive sentAsMessage:nil];
+        [self.orderedWSTransactions push:receive];
         [self postNewTransactionNotificationWithTransaction:receive];
     });
 }
 
+/// Must be called on the recorder's queue
+- (void)completeWebsocketSend:(FLEXWebsocketTransaction *)send error:(NSError *)error {
+    if (!send) {
+        return;
+    }
+    
+    send.error = error;
+    send.state = error ? FLEXNetworkTransactionStateFailed : FLEXNetworkTransactionStateFinished;
+    [self postUpdateNotificationForTransaction:send];
+}
+
+/// Must be called on the recorder's queue
+- (FLEXWebsocketConversation *)conversationForWebsocketTask:(NSURLSessionWebSocketTask *)task {
+    FLEXWebsocketConversation *conversation = [self.tasksToWSConversations objectForKey:task];
+    if (!conversation) {
+        conversation = [FLEXWebsocketConversation
+            conversationWithTask:task frameLimit:self.websocketFrameLimit
+        ];
+        [self.orderedWSConversations push:conversation];
+        [self.tasksToWSConversations setObject:conversation forKey:task];
+    }
+    
+    return conversation;
+}
+
 #pragma mark - Firebase, Reading
 
-- (void)recordFIRQueryWillFetch:(FIRQuery *)query withTransactionID:(NSString *)transactionID {
+- (void)recordFIRQueryWillFetch:(FIRQuery *)query withTransactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction queryFetch:query];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
-- (void)recordFIRDocumentWillFetch:(FIRDocumentReference *)document withTransactionID:(NSString *)transactionID {
+- (void)recordFIRDocumentWillFetch:(FIRDocumentReference *)document withTransactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction documentFetch:document];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
-- (void)recordFIRQueryDidFetch:(FIRQuerySnapshot *)response error:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRQueryDidFetch:(FIRQuerySnapshot *)response error:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
-        FLEXFirebaseTransaction *transaction = self.requestIDsToTransactions[transactionID];
+        FLEXFirebaseTransaction *transaction = [self transactionForRequestID:transactionID];
         if (!transaction) {
             return;
         }
@@ -386,15 +801,17 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
         transaction.error = error;
         transaction.documents = response.documents;
         transaction.state = FLEXNetworkTransactionStateFinished;
-        [self.orderedFirebaseTransactions insertObject:transaction atIndex:0];
+        [self.orderedFirebaseTransactions push:transaction];
+        // Nothing looks up a Firebase transaction once it ends
+        [self forgetRequestID:transactionID];
         
-        [self postUpdateNotificationForTransaction:transaction];
+        [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
-- (void)recordFIRDocumentDidFetch:(FIRDocumentSnapshot *)response error:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRDocumentDidFetch:(FIRDocumentSnapshot *)response error:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
-        FLEXFirebaseTransaction *transaction = self.requestIDsToTransactions[transactionID];
+        FLEXFirebaseTransaction *transaction = [self transactionForRequestID:transactionID];
         if (!transaction) {
             return;
         }
@@ -402,9 +819,11 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
         transaction.error = error;
         transaction.documents = response ? @[response] : @[];
         transaction.state = FLEXNetworkTransactionStateFinished;
-        [self.orderedFirebaseTransactions insertObject:transaction atIndex:0];
+        [self.orderedFirebaseTransactions push:transaction];
+        // Nothing looks up a Firebase transaction once it ends
+        [self forgetRequestID:transactionID];
         
-        [self postUpdateNotificationForTransaction:transaction];
+        [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
@@ -414,93 +833,204 @@ NSString *const kFLEXNetworkRecorderResponseCacheLimitDefaultsKey = @"com.flex.r
                         data:(NSDictionary *)documentData
                        merge:(NSNumber *)yesorno
                  mergeFields:(NSArray *)fields
-               transactionID:(NSString *)transactionID {
+               transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction
             setData:doc data:documentData merge:yesorno mergeFields:fields
         ];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
 - (void)recordFIRWillUpdateData:(FIRDocumentReference *)doc fields:(NSDictionary *)fields
-                  transactionID:(NSString *)transactionID {
+                  transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction updateData:doc data:fields];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
-- (void)recordFIRWillDeleteDocument:(FIRDocumentReference *)doc transactionID:(NSString *)transactionID {
+- (void)recordFIRWillDeleteDocument:(FIRDocumentReference *)doc transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction deleteDocument:doc];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
 - (void)recordFIRWillAddDocument:(FIRCollectionReference *)initiator document:(FIRDocumentReference *)doc
-                   transactionID:(NSString *)transactionID {
+                   transactionID:(FLEXNetworkRequestID)transactionID {
     dispatch_async(self.queue, ^{
         FLEXFirebaseTransaction *transaction = [FLEXFirebaseTransaction
             addDocument:initiator document:doc
         ];
-        self.requestIDsToTransactions[transactionID] = transaction;
+        [self setTransaction:transaction forRequestID:transactionID];
         [self postNewTransactionNotificationWithTransaction:transaction];
     });
 }
 
-- (void)recordFIRDidSetData:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRDidSetData:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     [self firebaseTransaction:transactionID didUpdate:error];
 }
 
-- (void)recordFIRDidUpdateData:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRDidUpdateData:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     [self firebaseTransaction:transactionID didUpdate:error];
 }
 
-- (void)recordFIRDidDeleteDocument:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRDidDeleteDocument:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     [self firebaseTransaction:transactionID didUpdate:error];
 }
 
-- (void)recordFIRDidAddDocument:(NSError *)error transactionID:(NSString *)transactionID {
+- (void)recordFIRDidAddDocument:(NSError *)error transactionID:(FLEXNetworkRequestID)transactionID {
     [self firebaseTransaction:transactionID didUpdate:error];
 }
 
-- (void)firebaseTransaction:(NSString *)transactionID didUpdate:(NSError *)error {
+- (void)firebaseTransaction:(FLEXNetworkRequestID)transactionID didUpdate:(NSError *)error {
     dispatch_async(self.queue, ^{
-        FLEXFirebaseTransaction *transaction = self.requestIDsToTransactions[transactionID];
+        FLEXFirebaseTransaction *transaction = [self transactionForRequestID:transactionID];
         if (!transaction) {
             return;
         }
         
         transaction.error = error;
         transaction.state = FLEXNetworkTransactionStateFinished;
-        [self.orderedFirebaseTransactions insertObject:transaction atIndex:0];
+        [self.orderedFirebaseTransactions push:transaction];
+        // Nothing looks up a Firebase transaction once it ends
+        [self forgetRequestID:transactionID];
         
-        [self postUpdateNotificationForTransaction:transaction];
+        [self postNewTransactionNotificationWithTransaction:transaction];
+    });
+}
+
+#pragma mark - Request IDs, on the queue
+
+- (id)transactionForRequestID:(FLEXNetworkRequestID)requestID {
+    return (__bridge id)CFDictionaryGetValue(_transactionsByRequestID, FLEXNetworkRequestIDKey(requestID));
+}
+
+- (void)setTransaction:(FLEXNetworkTransaction *)transaction forRequestID:(FLEXNetworkRequestID)requestID {
+    const void *key = FLEXNetworkRequestIDKey(requestID);
+    CFDictionarySetValue(_transactionsByRequestID, key, (__bridge const void *)transaction);
+    CFSetRemoveValue(_evictedRequestIDs, key);
+}
+
+- (void)forgetRequestID:(FLEXNetworkRequestID)requestID {
+    const void *key = FLEXNetworkRequestIDKey(requestID);
+    CFDictionaryRemoveValue(_transactionsByRequestID, key);
+    CFSetRemoveValue(_evictedRequestIDs, key);
+}
+
+/// Call when an HTTP transaction ends, which is the last that
+/// is heard of it if it has already left its ordered store
+- (void)forgetRequestIDIfEvicted:(FLEXNetworkRequestID)requestID {
+    if (CFSetContainsValue(_evictedRequestIDs, FLEXNetworkRequestIDKey(requestID))) {
+        [self forgetRequestID:requestID];
+    }
+}
+
+#pragma mark - Eviction
+
+/// Releases the cached response body of a transaction that is no longer retained,
+/// and forgets its request ID unless it is still being recorded
+- (void)didEvictTransaction:(FLEXHTTPTransaction *)transaction {
+    // The hops of a redirect share a request ID, and so do the caches and indexes
+    // keyed by it. They belong to the latest hop, which may still be listed.
+    if (!transaction || [self transactionForRequestID:transaction.requestID] != transaction) {
+        return;
+    }
+
+    FLEXNetworkTransactionState state = transaction.state;
+    if (state == FLEXNetworkTransactionStateFinished || state == FLEXNetworkTransactionStateFailed) {
+        [self forgetRequestID:transaction.requestID];
+    } else {
+        CFSetAddValue(_evictedRequestIDs, FLEXNetworkRequestIDKey(transaction.requestID));
+    }
+    
+    NSNumber *requestID = @(transaction.requestID);
+    [self.restCache removeObjectForKey:requestID];
+    [self.restDiskCache removeDataForKey:requestID];
+    [self.thumbnailLoader removeImageDataForRequestID:transaction.requestID];
+    dispatch_async(self.indexQueue, ^{
+        [self.headerTextIndex removeTextForKey:requestID];
+        [self.bodyTextIndex removeTextForKey:requestID];
+    });
+}
+
+#pragma mark Text Index
+
++ (BOOL)isIndexableMIMEType:(NSString *)mimeType {
+    return [mimeType hasPrefix:@"text/"] ||
+        [mimeType containsString:@"json"] ||
+        [mimeType containsString:@"xml"] ||
+        [mimeType containsString:@"javascript"] ||
+        [mimeType isEqualToString:@"application/x-www-form-urlencoded"];
+}
+
+/// The URL and the request and response headers, one per line
+- (NSData *)indexableHeadersOfTransaction:(FLEXHTTPTransaction *)transaction {
+    NSMutableString *text = [NSMutableString stringWithString:transaction.request.URL.absoluteString ?: @""];
+    [transaction.request.allHTTPHeaderFields enumerateKeysAndObjectsUsingBlock:^(NSString *key, NSString *value, BOOL *stop) {
+        [text appendFormat:@"\n%@: %@", key, value];
+    }];
+
+    if ([transaction.response isKindOfClass:[NSHTTPURLResponse class]]) {
+        NSDictionary *headers = [(NSHTTPURLResponse *)transaction.response allHeaderFields];
+        [headers enumerateKeysAndObjectsUsingBlock:^(id key, id value, BOOL *stop) {
+            [text appendFormat:@"\n%@: %@", key, value];
+        }];
+    }
+
+    return [text dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+/// @param body A text response body being added to \c restCache, if any
+- (void)indexTransaction:(FLEXHTTPTransaction *)transaction body:(NSData *)body {
+    NSNumber *requestID = @(transaction.requestID);
+    dispatch_async(self.indexQueue, ^{
+        [self.headerTextIndex setText:[self indexableHeadersOfTransaction:transaction] forKey:requestID];
+        if (body) {
+            [self.bodyTextIndex setText:body forKey:requestID];
+        } else {
+            [self.bodyTextIndex removeTextForKey:requestID];
+        }
+    });
+}
+
+#pragma mark OSCacheDelegate
+
+- (void)cache:(OSCache *)cache willEvictObject:(NSData *)body forKey:(NSNumber *)requestID {
+    // Spill to disk instead of losing the body to the memory limit or a memory warning
+    [self.restDiskCache setData:body forKey:requestID];
+    // Only bodies in memory are searchable
+    dispatch_async(self.indexQueue, ^{
+        [self.bodyTextIndex removeTextForKey:requestID];
     });
 }
 
 #pragma mark - Notification Posting
 
 - (void)postNewTransactionNotificationWithTransaction:(FLEXNetworkTransaction *)transaction {
-    [self notify:kFLEXNetworkRecorderNewTransactionNotification transaction:transaction];
+    if (transaction) {
+        [self.coalescer markInserted:transaction];
+    }
 }
 
 - (void)postUpdateNotificationForTransaction:(FLEXNetworkTransaction *)transaction {
-    [self notify:kFLEXNetworkRecorderTransactionUpdatedNotification transaction:transaction];
-}
-
-- (void)notify:(NSString *)name transaction:(FLEXNetworkTransaction *)transaction {
-    NSDictionary *userInfo = nil;
     if (transaction) {
-        userInfo = @{ kFLEXNetworkRecorderUserInfoTransactionKey : transaction };
+        [self.coalescer markUpdated:transaction];
     }
+}
+
+- (void)postTransactionsClearedNotification {
+    // Pending changes may refer to transactions that no longer exist
+    [self.coalescer discardPending];
     
     dispatch_async(dispatch_get_main_queue(), ^{
-        [NSNotificationCenter.defaultCenter postNotificationName:name object:self userInfo:userInfo];
+        [NSNotificationCenter.defaultCenter
+            postNotificationName:kFLEXNetworkRecorderTransactionsClearedNotification object:self
+        ];
     });
 }
 
@@ -0,0 +1,116 @@
+//
+//  FLEXNetworkReplayer.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FLEXHTTPTransaction;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, FLEXNetworkReplayPacing) {
+    /// Each request starts at the same offset from the first one as it did when it was recorded
+    FLEXNetworkReplayPacingOriginal,
+    /// Requests start as soon as one of \c maximumConcurrentRequests slots is free
+    FLEXNetworkReplayPacingMaximumConcurrency,
+};
+
+/// The latency of one endpoint before and after a replay.
+/// Durations are \c NAN on a side with no requests to the endpoint.
+@interface FLEXNetworkReplayEndpointDelta : NSObject
+
+@property (nonatomic, readonly) NSString *HTTPMethod;
+/// From \c FLEXNetworkAnalytics.templateForPath:
+@property (nonatomic, readonly) NSString *pathTemplate;
+
+@property (nonatomic, readonly) NSUInteger baselineCount;
+@property (nonatomic, readonly) NSUInteger replayCount;
+@property (nonatomic, readonly) NSUInteger baselineErrorCount;
+@property (nonatomic, readonly) NSUInteger replayErrorCount;
+
+@property (nonatomic, readonly) NSTimeInterval baselineP50;
+@property (nonatomic, readonly) NSTimeInterval replayP50;
+@property (nonatomic, readonly) NSTimeInterval baselineP90;
+@property (nonatomic, readonly) NSTimeInterval replayP90;
+
+/// Positive when the replay was slower
+@property (nonatomic, readonly) NSTimeInterval p50Delta;
+@property (nonatomic, readonly) NSTimeInterval p90Delta;
+
+@end
+
+/// Compares the latency of two runs of the same requests, endpoint by endpoint.
+///
+/// Endpoints are keyed by HTTP method and path template only, because a replay
+/// sends every host's requests to the same base URL.
+@interface FLEXNetworkReplayReport : NSObject
+
+/// Use this to compare two replays against the same server, like before and after a change,
+/// which is a fairer comparison than a replay against the original traffic.
++ (instancetype)reportWithBaseline:(NSArray<FLEXHTTPTransaction *> *)baseline
+                            replay:(NSArray<FLEXHTTPTransaction *> *)replay;
+
+@property (nonatomic, readonly) NSArray<FLEXHTTPTransaction *> *baselineTransactions;
+/// The new session, oldest first. These have their own request IDs and are not added to any recorder.
+@property (nonatomic, readonly) NSArray<FLEXHTTPTransaction *> *replayedTransactions;
+
+/// Sorted by \c p50Delta, largest regression first
+@property (nonatomic, readonly) NSArray<FLEXNetworkReplayEndpointDelta *> *endpoints;
+
+/// Endpoints requested in both runs whose median latency grew by more than the given fraction,
+/// like 0.1 for 10%. Medians are only accurate to within 2%, so smaller fractions are noise.
+- (NSArray<FLEXNetworkReplayEndpointDelta *> *)endpointsSlowerByMoreThan:(double)fraction;
+
+/// A plain text table of every endpoint, for logs
+@property (nonatomic, readonly) NSString *summary;
+
+@end
+
+/// Sends the requests of a recorded session again and measures how long they take now.
+///
+/// Requests are rebuilt from each transaction's request and \c cachedRequestBody,
+/// and can be pointed at a local stub server so a replay works without a network.
+/// Responses are counted but not kept. Redirects are not followed, since each hop of
+/// a redirect was recorded and is replayed on its own. Replayed requests are never
+/// recorded by \c FLEXNetworkObserver.
+@interface FLEXNetworkReplayer : NSObject
+
+/// @param transactions The session to replay, in any order. Only finished or failed transactions are used.
++ (instancetype)replayerWithTransactions:(NSArray<FLEXHTTPTransaction *> *)transactions;
+
+/// The requests that will be replayed, oldest first
+@property (nonatomic, readonly) NSArray<FLEXHTTPTransaction *> *transactions;
+
+/// Replaces the scheme, host and port of every request, like \c http://localhost:8080.
+/// Paths and queries are kept. When \c nil, requests go to their original URLs.
+@property (nonatomic, nullable) NSURL *baseURL;
+
+/// Defaults to \c FLEXNetworkReplayPacingOriginal
+@property (nonatomic) FLEXNetworkReplayPacing pacing;
+/// With original pacing, multiplies the gaps between requests; 0.5 replays twice as fast. Defaults to 1.
+@property (nonatomic) double timeScale;
+/// Only used with \c FLEXNetworkReplayPacingMaximumConcurrency. Defaults to 6.
+@property (nonatomic) NSUInteger maximumConcurrentRequests;
+
+/// Defaults to an ephemeral configuration without a URL cache. Set its \c protocolClasses
+/// to serve the replay from an \c NSURLProtocol stub instead of a server.
+@property (nonatomic) NSURLSessionConfiguration *sessionConfiguration;
+
+/// The request a transaction will be replayed as
+- (NSURLRequest *)replayRequestForTransaction:(FLEXHTTPTransaction *)transaction;
+
+/// Replays the session once. Each call is a separate replay with its own session,
+/// using the configuration of the replayer at the time of the call.
+///
+/// @param completion Called on the main queue with a report comparing the replay to the
+/// original transactions, or with \c NSUserCancelledError if the returned progress was cancelled.
+/// @return The progress of the replay, counted in completed requests. Cancellable.
+- (NSProgress *)replayWithCompletion:(void(^)(FLEXNetworkReplayReport *_Nullable report, NSError *_Nullable error))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
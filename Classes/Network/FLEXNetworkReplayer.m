@@ -0,0 +1,449 @@
+//
+//  FLEXNetworkReplayer.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkReplayer.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkTimings.h"
+#import "FLEXNetworkAnalytics.h"
+#import "FLEXQuantileSketch.h"
+#import "FLEXNetworkObserver.h"
+#include <stdatomic.h>
+
+/// Replayed transactions count down from here, so they never share an ID with recorded ones
+static _Atomic(FLEXNetworkRequestID) FLEXLastReplayRequestID = UINT64_MAX;
+
+/// Same rule as \c FLEXNetworkAnalytics
+static BOOL FLEXReplayTransactionFailed(FLEXHTTPTransaction *transaction) {
+    if (transaction.error || transaction.state == FLEXNetworkTransactionStateFailed) {
+        return YES;
+    }
+    if ([transaction.response isKindOfClass:[NSHTTPURLResponse class]]) {
+        return ((NSHTTPURLResponse *)transaction.response).statusCode >= 400;
+    }
+
+    return NO;
+}
+
+#pragma mark - FLEXNetworkReplayEndpointDelta
+
+@interface FLEXNetworkReplayEndpointDelta () {
+    @package
+    FLEXQuantileSketch *_baselineDurations;
+    FLEXQuantileSketch *_replayDurations;
+}
+@property (nonatomic, readwrite) NSString *HTTPMethod;
+@property (nonatomic, readwrite) NSString *pathTemplate;
+@property (nonatomic, readwrite) NSUInteger baselineErrorCount;
+@property (nonatomic, readwrite) NSUInteger replayErrorCount;
+@end
+
+@implementation FLEXNetworkReplayEndpointDelta
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _baselineDurations = [FLEXQuantileSketch new];
+        _replayDurations = [FLEXQuantileSketch new];
+    }
+
+    return self;
+}
+
+- (NSUInteger)baselineCount {
+    return (NSUInteger)_baselineDurations.count;
+}
+
+- (NSUInteger)replayCount {
+    return (NSUInteger)_replayDurations.count;
+}
+
+- (NSTimeInterval)baselineP50 {
+    return [_baselineDurations valueAtQuantile:0.5];
+}
+
+- (NSTimeInterval)replayP50 {
+    return [_replayDurations valueAtQuantile:0.5];
+}
+
+- (NSTimeInterval)baselineP90 {
+    return [_baselineDurations valueAtQuantile:0.9];
+}
+
+- (NSTimeInterval)replayP90 {
+    return [_replayDurations valueAtQuantile:0.9];
+}
+
+- (NSTimeInterval)p50Delta {
+    return self.replayP50 - self.baselineP50;
+}
+
+- (NSTimeInterval)p90Delta {
+    return self.replayP90 - self.baselineP90;
+}
+
+@end
+
+#pragma mark - FLEXNetworkReplayReport
+
+@interface FLEXNetworkReplayReport ()
+@property (nonatomic, readwrite) NSArray<FLEXHTTPTransaction *> *baselineTransactions;
+@property (nonatomic, readwrite) NSArray<FLEXHTTPTransaction *> *replayedTransactions;
+@property (nonatomic, readwrite) NSArray<FLEXNetworkReplayEndpointDelta *> *endpoints;
+@end
+
+@implementation FLEXNetworkReplayReport
+
++ (instancetype)reportWithBaseline:(NSArray<FLEXHTTPTransaction *> *)baseline
+                            replay:(NSArray<FLEXHTTPTransaction *> *)replay {
+    NSMutableDictionary<NSString *, FLEXNetworkReplayEndpointDelta *> *endpoints = [NSMutableDictionary new];
+    FLEXNetworkReplayEndpointDelta *(^endpointFor)(FLEXHTTPTransaction *) = ^(FLEXHTTPTransaction *transaction) {
+        NSString *method = transaction.request.HTTPMethod ?: @"GET";
+        NSString *pathTemplate = [FLEXNetworkAnalytics templateForPath:transaction.request.URL.path];
+        NSString *key = [NSString stringWithFormat:@"%@ %@", method, pathTemplate];
+
+        FLEXNetworkReplayEndpointDelta *endpoint = endpoints[key];
+        if (!endpoint) {
+            endpoint = [FLEXNetworkReplayEndpointDelta new];
+            endpoint.HTTPMethod = method;
+            endpoint.pathTemplate = pathTemplate;
+            endpoints[key] = endpoint;
+        }
+
+        return endpoint;
+    };
+
+    for (FLEXHTTPTransaction *transaction in baseline) {
+        FLEXNetworkReplayEndpointDelta *endpoint = endpointFor(transaction);
+        [endpoint->_baselineDurations addValue:transaction.duration];
+        endpoint.baselineErrorCount += FLEXReplayTransactionFailed(transaction);
+    }
+    for (FLEXHTTPTransaction *transaction in replay) {
+        FLEXNetworkReplayEndpointDelta *endpoint = endpointFor(transaction);
+        [endpoint->_replayDurations addValue:transaction.duration];
+        endpoint.replayErrorCount += FLEXReplayTransactionFailed(transaction);
+    }
+
+    FLEXNetworkReplayReport *report = [self new];
+    report.baselineTransactions = baseline;
+    report.replayedTransactions = replay;
+    report.endpoints = [endpoints.allValues sortedArrayUsingComparator:^NSComparisonResult(
+            FLEXNetworkReplayEndpointDelta *a, FLEXNetworkReplayEndpointDelta *b) {
+        // Endpoints missing from either run have a NAN delta and go last
+        double deltaA = isnan(a.p50Delta) ? -INFINITY : a.p50Delta;
+        double deltaB = isnan(b.p50Delta) ? -INFINITY : b.p50Delta;
+        if (deltaA != deltaB) {
+            return deltaA > deltaB ? NSOrderedAscending : NSOrderedDescending;
+        }
+        return [a.pathTemplate compare:b.pathTemplate];
+    }];
+
+    return report;
+}
+
+- (NSArray<FLEXNetworkReplayEndpointDelta *> *)endpointsSlowerByMoreThan:(double)fraction {
+    return [self.endpoints filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(
+            FLEXNetworkReplayEndpointDelta *endpoint, id bindings) {
+        // Comparisons with NAN are false, so endpoints missing from either run are skipped
+        return endpoint.replayP50 > endpoint.baselineP50 * (1 + fraction);
+    }]];
+}
+
+static NSString *FLEXReplayMilliseconds(NSTimeInterval duration) {
+    return isnan(duration) ? @"-" : [NSString stringWithFormat:@"%.1f", duration * 1000];
+}
+
+- (NSString *)summary {
+    NSMutableString *summary = [NSMutableString stringWithFormat:
+        @"%@ requests replayed, %@ in the baseline\n"
+        "endpoint\tcount\terrors\tp50 ms\tΔp50 ms\tp90 ms\tΔp90 ms\n",
+        @(self.replayedTransactions.count), @(self.baselineTransactions.count)
+    ];
+
+    for (FLEXNetworkReplayEndpointDelta *endpoint in self.endpoints) {
+        [summary appendFormat:@"%@ %@\t%@/%@\t%@/%@\t%@/%@\t%@\t%@/%@\t%@\n",
+            endpoint.HTTPMethod, endpoint.pathTemplate,
+            @(endpoint.baselineCount), @(endpoint.replayCount),
+            @(endpoint.baselineErrorCount), @(endpoint.replayErrorCount),
+            FLEXReplayMilliseconds(endpoint.baselineP50), FLEXReplayMilliseconds(endpoint.replayP50),
+            FLEXReplayMilliseconds(endpoint.p50Delta),
+            FLEXReplayMilliseconds(endpoint.baselineP90), FLEXReplayMilliseconds(endpoint.replayP90),
+            FLEXReplayMilliseconds(endpoint.p90Delta)
+        ];
+    }
+
+    return summary;
+}
+
+@end
+
+#pragma mark - FLEXNetworkReplayRun
+
+/// The state of one replay. Everything here is accessed on \c queue,
+/// which is also the underlying queue of the session's delegate queue.
+@interface FLEXNetworkReplayRun : NSObject <NSURLSessionDataDelegate>
+@property (nonatomic, readonly) dispatch_queue_t queue;
+@property (nonatomic, readonly) NSURLSession *session;
+@property (nonatomic, readonly) NSProgress *progress;
+@property (nonatomic, readonly) NSArray<FLEXHTTPTransaction *> *originals;
+@property (nonatomic, readonly) NSArray<NSURLRequest *> *requests;
+@property (nonatomic, readonly) FLEXNetworkReplayPacing pacing;
+@property (nonatomic, readonly) NSUInteger maximumConcurrentRequests;
+@property (nonatomic, readonly) void (^completion)(FLEXNetworkReplayReport *, NSError *);
+
+/// Replayed transactions in the same order as \c originals, or \c NSNull until started
+@property (nonatomic, readonly) NSMutableArray *replayed;
+/// Task identifier to index in \c originals
+@property (nonatomic, readonly) NSMutableDictionary<NSNumber *, NSNumber *> *taskIndexes;
+@property (nonatomic) NSUInteger nextIndex;
+@property (nonatomic) NSUInteger inFlight;
+@property (nonatomic) NSUInteger completedCount;
+@property (nonatomic) BOOL finished;
+@end
+
+@implementation FLEXNetworkReplayRun
+
+- (instancetype)initWithReplayer:(FLEXNetworkReplayer *)replayer
+                      completion:(void(^)(FLEXNetworkReplayReport *, NSError *))completion {
+    self = [super init];
+    if (self) {
+        _queue = dispatch_queue_create("com.flex.FLEXNetworkReplayer", DISPATCH_QUEUE_SERIAL);
+        _originals = replayer.transactions;
+        _pacing = replayer.pacing;
+        _maximumConcurrentRequests = MAX(replayer.maximumConcurrentRequests, 1);
+        _completion = completion;
+        _progress = [NSProgress progressWithTotalUnitCount:_originals.count];
+
+        NSMutableArray<NSURLRequest *> *requests = [NSMutableArray arrayWithCapacity:_originals.count];
+        for (FLEXHTTPTransaction *transaction in _originals) {
+            [requests addObject:[replayer replayRequestForTransaction:transaction]];
+        }
+        _requests = requests;
+
+        _replayed = [NSMutableArray arrayWithCapacity:_originals.count];
+        for (NSUInteger i = 0; i < _originals.count; i++) {
+            [_replayed addObject:NSNull.null];
+        }
+        _taskIndexes = [NSMutableDictionary new];
+
+        NSOperationQueue *delegateQueue = [NSOperationQueue new];
+        delegateQueue.maxConcurrentOperationCount = 1;
+        delegateQueue.underlyingQueue = _queue;
+        _session = [NSURLSession
+            sessionWithConfiguration:replayer.sessionConfiguration
+            delegate:self delegateQueue:delegateQueue
+        ];
+    }
+
+    return self;
+}
+
+- (void)startWithTimeScale:(double)timeScale {
+    __weak __typeof(self) weakSelf = self;
+    self.progress.cancellationHandler = ^{
+        __typeof(self) strongSelf = weakSelf;
+        if (!strongSelf) {
+            return;
+        }
+        dispatch_async(strongSelf.queue, ^{
+            [strongSelf finishWithError:[NSError
+                errorWithDomain:NSCocoaErrorDomain code:NSUserCancelledError userInfo:nil
+            ]];
+        });
+    };
+
+    dispatch_async(self.queue, ^{
+        if (!self.originals.count) {
+            [self finishWithError:nil];
+            return;
+        }
+
+        if (self.pacing == FLEXNetworkReplayPacingMaximumConcurrency) {
+            [self startPendingRequests];
+            return;
+        }
+
+        // Every request is scheduled up front relative to one start time,
+        // so a slow request does not delay the ones after it
+        NSDate *firstStart = self.originals.firstObject.startTime;
+        dispatch_time_t now = dispatch_time(DISPATCH_TIME_NOW, 0);
+        for (NSUInteger i = 0; i < self.originals.count; i++) {
+            NSTimeInterval offset = [self.originals[i].startTime timeIntervalSinceDate:firstStart] * timeScale;
+            dispatch_after(dispatch_time(now, (int64_t)(offset * NSEC_PER_SEC)), self.queue, ^{
+                [self startRequestAtIndex:i];
+            });
+        }
+    });
+}
+
+- (void)startPendingRequests {
+    while (self.inFlight < self.maximumConcurrentRequests && self.nextIndex < self.originals.count) {
+        [self startRequestAtIndex:self.nextIndex++];
+    }
+}
+
+- (void)startRequestAtIndex:(NSUInteger)index {
+    if (self.finished) {
+        return;
+    }
+
+    NSURLRequest *request = self.requests[index];
+    FLEXNetworkRequestID requestID = atomic_fetch_sub_explicit(&FLEXLastReplayRequestID, 1, memory_order_relaxed);
+    FLEXHTTPTransaction *transaction = [FLEXHTTPTransaction request:request identifier:requestID];
+    transaction.requestMechanism = @"FLEXNetworkReplayer";
+    transaction.state = FLEXNetworkTransactionStateAwaitingResponse;
+
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request];
+    self.replayed[index] = transaction;
+    self.taskIndexes[@(task.taskIdentifier)] = @(index);
+    self.inFlight++;
+    [task resume];
+}
+
+- (FLEXHTTPTransaction *)transactionForTask:(NSURLSessionTask *)task {
+    NSNumber *index = self.taskIndexes[@(task.taskIdentifier)];
+    return index ? self.replayed[index.unsignedIntegerValue] : nil;
+}
+
+- (void)finishWithError:(NSError *)error {
+    if (self.finished) {
+        return;
+    }
+    self.finished = YES;
+
+    FLEXNetworkReplayReport *report = nil;
+    if (error) {
+        [self.session invalidateAndCancel];
+    } else {
+        [self.session finishTasksAndInvalidate];
+        report = [FLEXNetworkReplayReport reportWithBaseline:self.originals replay:self.replayed];
+    }
+
+    void (^completion)(FLEXNetworkReplayReport *, NSError *) = self.completion;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        completion(report, error);
+    });
+}
+
+#pragma mark NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask
+didReceiveResponse:(NSURLResponse *)response
+ completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+    FLEXHTTPTransaction *transaction = [self transactionForTask:dataTask];
+    transaction.response = response;
+    transaction.latency = -[transaction.startTime timeIntervalSinceNow];
+    transaction.state = FLEXNetworkTransactionStateReceivingData;
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    // Only the size is kept; a replay is about timing, not content
+    [self transactionForTask:dataTask].receivedDataLength += data.length;
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+willPerformHTTPRedirection:(NSHTTPURLResponse *)response
+        newRequest:(NSURLRequest *)request
+ completionHandler:(void (^)(NSURLRequest *))completionHandler {
+    // The recorder keeps each hop of a redirect as its own transaction, and each is replayed
+    completionHandler(nil);
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task
+didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [self transactionForTask:task].timings = [FLEXNetworkTimings timingsWithMetrics:metrics];
+}
+
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    FLEXHTTPTransaction *transaction = [self transactionForTask:task];
+    if (!transaction || self.finished) {
+        return;
+    }
+
+    // Measured the way the recorder measures the baseline, from resume to completion,
+    // rather than by the metrics' task interval
+    transaction.duration = -[transaction.startTime timeIntervalSinceNow];
+    transaction.error = error;
+    transaction.state = error ? FLEXNetworkTransactionStateFailed : FLEXNetworkTransactionStateFinished;
+
+    self.inFlight--;
+    self.completedCount++;
+    self.progress.completedUnitCount = self.completedCount;
+
+    if (self.completedCount == self.originals.count) {
+        [self finishWithError:nil];
+    } else if (self.pacing == FLEXNetworkReplayPacingMaximumConcurrency) {
+        [self startPendingRequests];
+    }
+}
+
+@end
+
+#pragma mark - FLEXNetworkReplayer
+
+@implementation FLEXNetworkReplayer
+
++ (instancetype)replayerWithTransactions:(NSArray<FLEXHTTPTransaction *> *)transactions {
+    NSPredicate *completed = [NSPredicate predicateWithBlock:^BOOL(FLEXHTTPTransaction *transaction, id bindings) {
+        return transaction.state == FLEXNetworkTransactionStateFinished ||
+            transaction.state == FLEXNetworkTransactionStateFailed;
+    }];
+
+    FLEXNetworkReplayer *replayer = [self new];
+    replayer->_transactions = [[transactions filteredArrayUsingPredicate:completed]
+        sortedArrayUsingComparator:^NSComparisonResult(FLEXHTTPTransaction *a, FLEXHTTPTransaction *b) {
+            return [a.startTime compare:b.startTime];
+        }
+    ];
+    return replayer;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _timeScale = 1;
+        _maximumConcurrentRequests = 6;
+        _sessionConfiguration = NSURLSessionConfiguration.ephemeralSessionConfiguration;
+        _sessionConfiguration.URLCache = nil;
+        _sessionConfiguration.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+    }
+
+    return self;
+}
+
+- (NSURLRequest *)replayRequestForTransaction:(FLEXHTTPTransaction *)transaction {
+    NSMutableURLRequest *request = transaction.request.mutableCopy;
+
+    if (self.baseURL) {
+        NSURLComponents *components = [NSURLComponents componentsWithURL:request.URL resolvingAgainstBaseURL:YES];
+        components.scheme = self.baseURL.scheme;
+        components.host = self.baseURL.host;
+        components.port = self.baseURL.port;
+        request.URL = components.URL ?: request.URL;
+    }
+
+    // Streams can only be read once, so use the body the recorder already read
+    if (request.HTTPBodyStream || !request.HTTPBody) {
+        request.HTTPBodyStream = nil;
+        request.HTTPBody = transaction.cachedRequestBody;
+    }
+    request.cachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+    // Keeps the replay out of the live recorder, its analytics, and the journal
+    [NSURLProtocol setProperty:@YES forKey:kFLEXNetworkObserverIgnoredRequestKey inRequest:request];
+
+    return request;
+}
+
+- (NSProgress *)replayWithCompletion:(void(^)(FLEXNetworkReplayReport *, NSError *))completion {
+    FLEXNetworkReplayRun *run = [[FLEXNetworkReplayRun alloc] initWithReplayer:self completion:completion];
+    // The session keeps the run alive until it is invalidated
+    [run startWithTimeScale:MAX(self.timeScale, 0)];
+    return run.progress;
+}
+
+@end
@@ -20,6 +20,8 @@
 @property (nonatomic, readonly) UISwitch *observerSwitch;
 @property (nonatomic, readonly) UISwitch *cacheMediaSwitch;
 @property (nonatomic, readonly) UISwitch *jsonViewerSwitch;
+@property (nonatomic, readonly) UISwitch *journalSwitch;
+@property (nonatomic, readonly) UISwitch *journalBodiesSwitch;
 @property (nonatomic, readonly) UISlider *cacheLimitSlider;
 @property (nonatomic) UILabel *cacheLimitLabel;
 
@@ -39,6 +41,8 @@
     _observerSwitch = [UISwitch new];
     _cacheMediaSwitch = [UISwitch new];
     _jsonViewerSwitch = [UISwitch new];
+    _journalSwitch = [UISwitch new];
+    _journalBodiesSwitch = [UISwitch new];
     _cacheLimitSlider = [UISlider new];
     
     self.observerSwitch.on = FLEXNetworkObserver.enabled;
@@ -59,6 +63,18 @@
         forControlEvents:UIControlEventValueChanged
     ];
     
+    self.journalSwitch.on = FLEXNetworkRecorder.defaultRecorder.journalingEnabled;
+    [self.journalSwitch addTarget:self
+        action:@selector(journalingToggled:)
+        forControlEvents:UIControlEventValueChanged
+    ];
+    
+    self.journalBodiesSwitch.on = FLEXNetworkRecorder.defaultRecorder.journalIncludesBodies;
+    [self.journalBodiesSwitch addTarget:self
+        action:@selector(journalBodiesToggled:)
+        forControlEvents:UIControlEventValueChanged
+    ];
+    
     [self.cacheLimitSlider addTarget:self
         action:@selector(cacheLimitAdjusted:)
         forControlEvents:UIControlEventValueChanged
@@ -99,6 +115,14 @@
     [NSUserDefaults.standardUserDefaults flex_toggleBoolForKey:kFLEXDefaultsRegisterJSONExplorerKey];
 }
 
+- (void)journalingToggled:(UISwitch *)sender {
+    FLEXNetworkRecorder.defaultRecorder.journalingEnabled = sender.isOn;
+}
+
+- (void)journalBodiesToggled:(UISwitch *)sender {
+    FLEXNetworkRecorder.defaultRecorder.journalIncludesBodies = sender.isOn;
+}
+
 - (void)cacheLimitAdjusted:(UISlider *)sender {
     self.cacheLimitValue = sender.value;
 }
@@ -112,7 +136,7 @@
 
 - (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
     switch (section) {
-        case 0: return 5;
+        case 0: return 7;
         case 1: return self.hostDenylist.count;
         default: return 0;
     }
@@ -131,7 +155,9 @@
         return @"By default, JSON is rendered in a webview. Turn on "
         "\"View JSON as a dictionary/array\" to convert JSON payloads "
         "to objects and view them in an object explorer. "
-        "This setting requires a restart of the app.";
+        "This setting requires a restart of the app.\n\n"
+        "Turn on \"Journal Requests to Disk\" to keep the requests of each launch "
+        "so that they can be viewed after the app is relaunched.";
     }
     
     return nil;
@@ -190,6 +216,14 @@
                         UIViewAutoresizingFlexibleBottomMargin;
                     });
                     break;
+                case 5:
+                    cell.textLabel.text = @"Journal Requests to Disk";
+                    cell.accessoryView = self.journalSwitch;
+                    break;
+                case 6:
+                    cell.textLabel.text = @"Journal Request and Response Bodies";
+                    cell.accessoryView = self.journalBodiesSwitch;
+                    break;
             }
             
             break;
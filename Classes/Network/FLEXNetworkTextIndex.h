@@ -0,0 +1,54 @@
+//
+//  FLEXNetworkTextIndex.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// An in-memory trigram index for finding which of many documents contain some text.
+///
+/// Each document is indexed under a key as the set of byte trigrams of its UTF-8 text,
+/// with ASCII letters folded to lowercase. Every trigram maps to a posting list of the
+/// documents containing it, delta and varint encoded. A lookup intersects the posting
+/// lists of the query's trigrams, which yields candidates that must still be verified
+/// against the actual text, for example with \c text:containsText:
+///
+/// When the posting lists outgrow \c byteLimit the oldest documents are dropped from them.
+/// Dropped documents, and those too long to index in full, are returned as candidates for
+/// every query until their key is removed, so verifying candidates never misses a match.
+/// Thread safe.
+@interface FLEXNetworkTextIndex : NSObject
+
++ (instancetype)indexWithByteLimit:(NSUInteger)byteLimit;
+
+@property (nonatomic) NSUInteger byteLimit;
+/// The size of the posting lists, including documents removed since the last compaction
+/// but not the lists' spare capacity
+@property (nonatomic, readonly) NSUInteger byteCount;
+/// The number of documents in the index
+@property (nonatomic, readonly) NSUInteger count;
+
+/// Indexes the text as the document for \c key, replacing any previous document for that key.
+/// Only the first megabyte of the text is indexed; longer text is always a candidate.
+- (void)setText:(NSData *)UTF8Text forKey:(id<NSCopying>)key;
+- (void)removeTextForKey:(id<NSCopying>)key;
+- (void)removeAllText;
+
+/// The shortest text \c keysOfCandidatesContainingText: can look up
+@property (nonatomic, readonly, class) NSUInteger minimumQueryLength;
+
+/// @return The keys of every document that may contain the text, or \c nil
+/// if the text is shorter than \c minimumQueryLength bytes in UTF-8.
+- (nullable NSSet *)keysOfCandidatesContainingText:(NSString *)text;
+
+/// Whether the text contains the query, ignoring the case of ASCII letters like the index does
++ (BOOL)text:(NSData *)UTF8Text containsText:(NSString *)query;
+
+@end
+
+NS_ASSUME_NONNULL_END
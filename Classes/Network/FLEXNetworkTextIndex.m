@@ -0,0 +1,466 @@
+//
+//  FLEXNetworkTextIndex.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTextIndex.h"
+#import <os/lock.h>
+
+/// Only this much of each document is indexed; longer documents are always candidates
+static const NSUInteger kFLEXTextIndexMaxDocumentLength = 1024 * 1024;
+/// Don't bother compacting until at least this much of the posting lists is dead
+static const NSUInteger kFLEXTextIndexMinCompactionBytes = 256 * 1024;
+/// Roughly what each posting list costs besides its contents. Charged to the document that created the list.
+static const NSUInteger kFLEXTextIndexPostingListOverhead = 48;
+
+/// Document numbers in increasing order, each stored as a varint of the difference from the last
+typedef struct {
+    uint8_t *bytes;
+    uint32_t length;
+    uint32_t capacity;
+    uint32_t lastDocument;
+    uint32_t count;
+} FLEXPostingList;
+
+static inline uint8_t FLEXFoldByte(uint8_t byte) {
+    return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+}
+
+static inline const void *FLEXTrigramKey(uint32_t trigram) {
+    // Offset by one so that no key is NULL
+    return (const void *)(uintptr_t)(trigram + 1);
+}
+
+static int FLEXCompareTrigrams(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int FLEXComparePostingListLengths(const void *a, const void *b) {
+    uint32_t x = (*(FLEXPostingList * const *)a)->count, y = (*(FLEXPostingList * const *)b)->count;
+    return x < y ? -1 : x > y;
+}
+
+/// @return The number of distinct trigrams written to \c outTrigrams, in ascending order. Free it when done.
+static NSUInteger FLEXCopyTrigrams(const uint8_t *bytes, NSUInteger length, uint32_t **outTrigrams) {
+    *outTrigrams = NULL;
+    if (length < 3) {
+        return 0;
+    }
+
+    NSUInteger count = length - 2;
+    uint32_t *trigrams = malloc(count * sizeof(uint32_t));
+    uint32_t window = (FLEXFoldByte(bytes[0]) << 8) | FLEXFoldByte(bytes[1]);
+    for (NSUInteger i = 2; i < length; i++) {
+        window = ((window << 8) | FLEXFoldByte(bytes[i])) & 0xFFFFFF;
+        trigrams[i - 2] = window;
+    }
+
+    qsort(trigrams, count, sizeof(uint32_t), FLEXCompareTrigrams);
+    NSUInteger unique = 1;
+    for (NSUInteger i = 1; i < count; i++) {
+        if (trigrams[i] != trigrams[unique - 1]) {
+            trigrams[unique++] = trigrams[i];
+        }
+    }
+
+    *outTrigrams = trigrams;
+    return unique;
+}
+
+static inline uint32_t FLEXReadVarint(const uint8_t *bytes, uint32_t *offset) {
+    uint32_t value = 0, shift = 0;
+    uint8_t byte;
+    do {
+        byte = bytes[(*offset)++];
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+/// @return The number of bytes the posting list grew by
+static NSUInteger FLEXPostingListAppend(FLEXPostingList *list, uint32_t document) {
+    if (list->length + 5 > list->capacity) {
+        uint32_t capacity = MAX(16, list->capacity * 2);
+        list->bytes = realloc(list->bytes, capacity);
+        list->capacity = capacity;
+    }
+
+    uint32_t delta = list->count ? document - list->lastDocument : document;
+    uint32_t start = list->length;
+    do {
+        uint8_t byte = delta & 0x7F;
+        delta >>= 7;
+        list->bytes[list->length++] = delta ? byte | 0x80 : byte;
+    } while (delta);
+
+    list->lastDocument = document;
+    list->count++;
+    return list->length - start;
+}
+
+@implementation FLEXNetworkTextIndex {
+    os_unfair_lock _lock;
+    /// Trigram to FLEXPostingList *
+    CFMutableDictionaryRef _postings;
+    /// The key of each document by number, or NSNull once it is removed
+    NSMutableArray *_keys;
+    NSMutableDictionary<id, NSNumber *> *_documentsByKey;
+    /// The number of posting list bytes each document took up, by number
+    NSMutableData *_documentSizes;
+    /// Every document before this one has been removed
+    NSUInteger _oldestDocument;
+    NSUInteger _liveBytes;
+    /// Bytes of removed documents that the posting lists hold until the next compaction
+    NSUInteger _deadBytes;
+    /// Keys whose text was truncated or dropped to stay within the byte limit,
+    /// which are always candidates since the posting lists can't rule them out
+    NSMutableSet *_unindexedKeys;
+}
+
++ (instancetype)indexWithByteLimit:(NSUInteger)byteLimit {
+    FLEXNetworkTextIndex *index = [self new];
+    index->_lock = OS_UNFAIR_LOCK_INIT;
+    index->_byteLimit = byteLimit;
+    index->_postings = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+    index->_keys = [NSMutableArray new];
+    index->_documentsByKey = [NSMutableDictionary new];
+    index->_documentSizes = [NSMutableData new];
+    index->_unindexedKeys = [NSMutableSet new];
+    return index;
+}
+
++ (NSUInteger)minimumQueryLength {
+    return 3;
+}
+
+- (void)dealloc {
+    [self freePostingLists];
+    CFRelease(_postings);
+}
+
+#pragma mark Public
+
+- (NSUInteger)byteCount {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger byteCount = _liveBytes + _deadBytes;
+    os_unfair_lock_unlock(&_lock);
+    return byteCount;
+}
+
+- (NSUInteger)count {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _documentsByKey.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit {
+    os_unfair_lock_lock(&_lock);
+    _byteLimit = byteLimit;
+    [self enforceByteLimit];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)setText:(NSData *)UTF8Text forKey:(id<NSCopying>)key {
+    NSParameterAssert(key);
+
+    // Extracting the trigrams is the expensive part, so do it before taking the lock
+    uint32_t *trigrams = NULL;
+    NSUInteger length = MIN(UTF8Text.length, kFLEXTextIndexMaxDocumentLength);
+    NSUInteger trigramCount = FLEXCopyTrigrams(UTF8Text.bytes, length, &trigrams);
+
+    os_unfair_lock_lock(&_lock);
+    [self removeDocumentForKey:key];
+    [_unindexedKeys removeObject:key];
+
+    if (trigramCount) {
+        uint32_t document = (uint32_t)_keys.count;
+        uint32_t size = 0;
+        for (NSUInteger i = 0; i < trigramCount; i++) {
+            FLEXPostingList *list = [self postingListForTrigram:trigrams[i]];
+            size += (list->count ? 0 : kFLEXTextIndexPostingListOverhead) + FLEXPostingListAppend(list, document);
+        }
+
+        key = [key copyWithZone:nil];
+        if (UTF8Text.length > length) {
+            [_unindexedKeys addObject:key];
+        }
+        [_keys addObject:key];
+        [_documentSizes appendBytes:&size length:sizeof(size)];
+        _documentsByKey[key] = @(document);
+        _liveBytes += size;
+
+        [self enforceByteLimit];
+    }
+
+    [self compactIfNeeded];
+    os_unfair_lock_unlock(&_lock);
+
+    free(trigrams);
+}
+
+- (void)removeTextForKey:(id<NSCopying>)key {
+    if (!key) {
+        return;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    [self removeDocumentForKey:key];
+    [_unindexedKeys removeObject:key];
+    [self compactIfNeeded];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)removeAllText {
+    os_unfair_lock_lock(&_lock);
+    [self freePostingLists];
+    CFDictionaryRemoveAllValues(_postings);
+    [_keys removeAllObjects];
+    [_documentsByKey removeAllObjects];
+    [_unindexedKeys removeAllObjects];
+    _documentSizes.length = 0;
+    _oldestDocument = 0;
+    _liveBytes = 0;
+    _deadBytes = 0;
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (NSSet *)keysOfCandidatesContainingText:(NSString *)text {
+    NSData *query = [text dataUsingEncoding:NSUTF8StringEncoding];
+    uint32_t *trigrams = NULL;
+    NSUInteger trigramCount = FLEXCopyTrigrams(query.bytes, query.length, &trigrams);
+    if (!trigramCount) {
+        return nil;
+    }
+
+    NSMutableSet *keys = [NSMutableSet new];
+    FLEXPostingList **lists = malloc(trigramCount * sizeof(FLEXPostingList *));
+    uint32_t *candidates = NULL;
+
+    os_unfair_lock_lock(&_lock);
+    BOOL indexed = YES;
+    for (NSUInteger i = 0; i < trigramCount && indexed; i++) {
+        lists[i] = (FLEXPostingList *)CFDictionaryGetValue(_postings, FLEXTrigramKey(trigrams[i]));
+        // Otherwise no document contains this trigram
+        indexed = lists[i] != NULL;
+    }
+
+    if (indexed) {
+        // Start from the rarest trigram so that the candidates shrink as fast as possible
+        qsort(lists, trigramCount, sizeof(FLEXPostingList *), FLEXComparePostingListLengths);
+
+        uint32_t candidateCount = lists[0]->count;
+        candidates = malloc(candidateCount * sizeof(uint32_t));
+        for (uint32_t i = 0, offset = 0, document = 0; i < candidateCount; i++) {
+            document += FLEXReadVarint(lists[0]->bytes, &offset);
+            candidates[i] = document;
+        }
+
+        for (NSUInteger i = 1; i < trigramCount && candidateCount; i++) {
+            FLEXPostingList *list = lists[i];
+            uint32_t kept = 0, c = 0, offset = 0, document = 0;
+            for (uint32_t j = 0; j < list->count && c < candidateCount; j++) {
+                document += FLEXReadVarint(list->bytes, &offset);
+                while (c < candidateCount && candidates[c] < document) {
+                    c++;
+                }
+                if (c < candidateCount && candidates[c] == document) {
+                    candidates[kept++] = document;
+                    c++;
+                }
+            }
+
+            candidateCount = kept;
+        }
+
+        for (uint32_t i = 0; i < candidateCount; i++) {
+            id key = _keys[candidates[i]];
+            if (key != NSNull.null) {
+                [keys addObject:key];
+            }
+        }
+    }
+
+    [keys unionSet:_unindexedKeys];
+    os_unfair_lock_unlock(&_lock);
+    free(candidates);
+    free(lists);
+    free(trigrams);
+    return keys;
+}
+
++ (BOOL)text:(NSData *)UTF8Text containsText:(NSString *)query {
+    NSData *needleData = [query dataUsingEncoding:NSUTF8StringEncoding];
+    NSUInteger needleLength = needleData.length, length = UTF8Text.length;
+    if (!needleLength) {
+        return YES;
+    }
+    if (needleLength > length) {
+        return NO;
+    }
+
+    uint8_t *needle = malloc(needleLength);
+    const uint8_t *needleBytes = needleData.bytes;
+    for (NSUInteger i = 0; i < needleLength; i++) {
+        needle[i] = FLEXFoldByte(needleBytes[i]);
+    }
+
+    BOOL found = NO;
+    const uint8_t *bytes = UTF8Text.bytes;
+    for (NSUInteger i = 0; i + needleLength <= length && !found; i++) {
+        if (FLEXFoldByte(bytes[i]) != needle[0]) {
+            continue;
+        }
+
+        NSUInteger j = 1;
+        while (j < needleLength && FLEXFoldByte(bytes[i + j]) == needle[j]) {
+            j++;
+        }
+        found = j == needleLength;
+    }
+
+    free(needle);
+    return found;
+}
+
+#pragma mark Private, lock must be held
+
+- (FLEXPostingList *)postingListForTrigram:(uint32_t)trigram {
+    FLEXPostingList *list = (FLEXPostingList *)CFDictionaryGetValue(_postings, FLEXTrigramKey(trigram));
+    if (!list) {
+        list = calloc(1, sizeof(FLEXPostingList));
+        CFDictionarySetValue(_postings, FLEXTrigramKey(trigram), list);
+    }
+
+    return list;
+}
+
+- (uint32_t)sizeOfDocument:(NSUInteger)document {
+    return ((const uint32_t *)_documentSizes.bytes)[document];
+}
+
+/// Posting lists still reference the document until the next compaction
+- (void)removeDocumentForKey:(id<NSCopying>)key {
+    NSNumber *document = _documentsByKey[key];
+    if (!document) {
+        return;
+    }
+
+    uint32_t size = [self sizeOfDocument:document.unsignedIntegerValue];
+    _keys[document.unsignedIntegerValue] = NSNull.null;
+    [_documentsByKey removeObjectForKey:key];
+    _liveBytes -= size;
+    _deadBytes += size;
+}
+
+/// Once the posting lists hold more than the limit, drops the oldest documents until
+/// compacting leaves some room to spare. Dead bytes are then over a quarter of the limit,
+/// so inserts between two compactions add at least that much.
+- (void)enforceByteLimit {
+    if (_liveBytes + _deadBytes <= _byteLimit) {
+        return;
+    }
+
+    NSUInteger target = _byteLimit / 4 * 3;
+    while (_liveBytes > target && _oldestDocument < _keys.count) {
+        id key = _keys[_oldestDocument++];
+        if (key != NSNull.null) {
+            [self removeDocumentForKey:key];
+            [_unindexedKeys addObject:key];
+        }
+    }
+
+    [self compact];
+}
+
+- (void)compactIfNeeded {
+    if (_deadBytes >= kFLEXTextIndexMinCompactionBytes && _deadBytes > _liveBytes) {
+        [self compact];
+    }
+}
+
+/// Renumbers the remaining documents from 0 and rewrites
+/// every posting list without the removed documents
+- (void)compact {
+    NSUInteger documentCount = _keys.count;
+    uint32_t *renumbered = malloc(MAX(documentCount, 1) * sizeof(uint32_t));
+    NSMutableArray *keys = [NSMutableArray new];
+    for (NSUInteger i = 0; i < documentCount; i++) {
+        id key = _keys[i];
+        if (key == NSNull.null) {
+            renumbered[i] = UINT32_MAX;
+        } else {
+            renumbered[i] = (uint32_t)keys.count;
+            _documentsByKey[key] = @(keys.count);
+            [keys addObject:key];
+        }
+    }
+
+    uint32_t *sizes = calloc(MAX(keys.count, 1), sizeof(uint32_t));
+    NSUInteger listCount = CFDictionaryGetCount(_postings);
+    const void **trigramKeys = malloc(MAX(listCount, 1) * sizeof(void *));
+    const void **values = malloc(MAX(listCount, 1) * sizeof(void *));
+    CFDictionaryGetKeysAndValues(_postings, trigramKeys, values);
+
+    for (NSUInteger i = 0; i < listCount; i++) {
+        FLEXPostingList *list = (FLEXPostingList *)values[i];
+        FLEXPostingList compacted = { 0 };
+
+        uint32_t offset = 0, document = 0;
+        for (uint32_t j = 0; j < list->count; j++) {
+            document += FLEXReadVarint(list->bytes, &offset);
+            uint32_t newDocument = renumbered[document];
+            if (newDocument != UINT32_MAX) {
+                uint32_t overhead = compacted.count ? 0 : kFLEXTextIndexPostingListOverhead;
+                sizes[newDocument] += overhead + FLEXPostingListAppend(&compacted, newDocument);
+            }
+        }
+
+        free(list->bytes);
+        if (compacted.count) {
+            // Trim the spare capacity, since most lists will never grow much again
+            compacted.bytes = realloc(compacted.bytes, compacted.length);
+            compacted.capacity = compacted.length;
+            *list = compacted;
+        } else {
+            free(compacted.bytes);
+            free(list);
+            CFDictionaryRemoveValue(_postings, trigramKeys[i]);
+        }
+    }
+
+    _keys = keys;
+    _documentSizes = [NSMutableData dataWithBytes:sizes length:keys.count * sizeof(uint32_t)];
+    _oldestDocument = 0;
+    _deadBytes = 0;
+    _liveBytes = 0;
+    for (NSUInteger i = 0; i < keys.count; i++) {
+        _liveBytes += sizes[i];
+    }
+
+    free(values);
+    free(trigramKeys);
+    free(sizes);
+    free(renumbered);
+}
+
+- (void)freePostingLists {
+    NSUInteger listCount = CFDictionaryGetCount(_postings);
+    const void **values = malloc(MAX(listCount, 1) * sizeof(void *));
+    CFDictionaryGetKeysAndValues(_postings, NULL, values);
+    for (NSUInteger i = 0; i < listCount; i++) {
+        FLEXPostingList *list = (FLEXPostingList *)values[i];
+        free(list->bytes);
+        free(list);
+    }
+
+    free(values);
+}
+
+@end
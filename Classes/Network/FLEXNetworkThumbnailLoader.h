@@ -0,0 +1,54 @@
+//
+//  FLEXNetworkThumbnailLoader.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTransaction.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Returns the response body of a transaction, or \c nil if it is no longer available
+typedef NSData * _Nullable (^FLEXNetworkThumbnailBodyProvider)(FLEXHTTPTransaction *transaction);
+
+/// Decodes thumbnails of image responses only when a cell is about to show one.
+///
+/// Decoding happens on an operation queue that runs a few operations at a time, so a burst
+/// of images can't spawn a thread per image. A load can be cancelled when its cell goes off
+/// screen. Decoded thumbnails are kept in a cache bounded by their bitmap size.
+///
+/// Image bodies that the recorder does not keep in its response cache can be handed to the
+/// loader instead, which keeps them in a separate cost-bounded cache until they are needed.
+@interface FLEXNetworkThumbnailLoader : NSObject
+
+/// @param bodyProvider Called on the loader's queue for bodies not given to \c setImageData:forRequestID:
++ (instancetype)loaderWithBodyProvider:(FLEXNetworkThumbnailBodyProvider)bodyProvider;
+
+/// The most bytes of image data kept through \c setImageData:forRequestID:. Defaults to 8 MB.
+@property (nonatomic) NSUInteger imageDataByteLimit;
+/// The most bytes of decoded thumbnail bitmaps kept. Defaults to 2 MB.
+@property (nonatomic) NSUInteger thumbnailByteLimit;
+
+/// Whether the transaction's response is an image that can be thumbnailed
++ (BOOL)canLoadThumbnailForTransaction:(FLEXHTTPTransaction *)transaction;
+
+/// Keeps an image body that wouldn't otherwise be retrievable, until it is evicted
+- (void)setImageData:(NSData *)data forRequestID:(FLEXNetworkRequestID)requestID;
+- (void)removeImageDataForRequestID:(FLEXNetworkRequestID)requestID;
+/// Removes every kept image body and decoded thumbnail, and cancels every load
+- (void)removeAll;
+
+/// The thumbnail, if it has already been decoded and is still cached
+- (nullable UIImage *)cachedThumbnailForTransaction:(FLEXHTTPTransaction *)transaction;
+/// Queues the thumbnail to be decoded.
+/// @param completion Called on the main queue unless the load is cancelled first.
+/// The image is \c nil if the body is gone or could not be decoded.
+/// @return The operation to cancel if the thumbnail is no longer needed
+- (NSOperation *)loadThumbnailForTransaction:(FLEXHTTPTransaction *)transaction
+                                  completion:(void(^)(UIImage * _Nullable thumbnail))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,132 @@
+//
+//  FLEXNetworkThumbnailLoader.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkThumbnailLoader.h"
+#import "FLEXNetworkJournal.h"
+#import "FLEXUtility.h"
+
+/// Enough to keep up with scrolling without competing with the app for every core
+static const NSInteger kFLEXThumbnailLoaderConcurrency = 2;
+/// The size of the thumbnail view in a transaction cell, in points
+static const CGFloat kFLEXThumbnailLoaderPointSize = 32.0;
+
+@interface FLEXNetworkThumbnailLoader ()
+@property (nonatomic, readonly) FLEXNetworkThumbnailBodyProvider bodyProvider;
+@property (nonatomic, readonly) NSOperationQueue *queue;
+/// Request ID to image body
+@property (nonatomic, readonly) NSCache<NSNumber *, NSData *> *imageData;
+/// Transaction to thumbnail, or to NSNull if it could not be decoded. Keyed by transaction
+/// rather than request ID because journaled transactions reuse the request IDs of earlier launches.
+@property (nonatomic, readonly) NSCache<FLEXHTTPTransaction *, id> *thumbnails;
+@end
+
+@implementation FLEXNetworkThumbnailLoader
+
++ (instancetype)loaderWithBodyProvider:(FLEXNetworkThumbnailBodyProvider)bodyProvider {
+    FLEXNetworkThumbnailLoader *loader = [self new];
+    loader->_bodyProvider = bodyProvider;
+
+    loader->_queue = [NSOperationQueue new];
+    loader.queue.name = @"com.flex.FLEXNetworkThumbnailLoader";
+    loader.queue.maxConcurrentOperationCount = kFLEXThumbnailLoaderConcurrency;
+    loader.queue.qualityOfService = NSQualityOfServiceUserInitiated;
+
+    loader->_imageData = [NSCache new];
+    loader->_thumbnails = [NSCache new];
+    loader.imageDataByteLimit = 8 * 1024 * 1024;
+    loader.thumbnailByteLimit = 2 * 1024 * 1024;
+
+    return loader;
+}
+
+- (void)setImageDataByteLimit:(NSUInteger)imageDataByteLimit {
+    _imageDataByteLimit = imageDataByteLimit;
+    self.imageData.totalCostLimit = imageDataByteLimit;
+}
+
+- (void)setThumbnailByteLimit:(NSUInteger)thumbnailByteLimit {
+    _thumbnailByteLimit = thumbnailByteLimit;
+    self.thumbnails.totalCostLimit = thumbnailByteLimit;
+}
+
++ (BOOL)canLoadThumbnailForTransaction:(FLEXHTTPTransaction *)transaction {
+    return [transaction.response.MIMEType hasPrefix:@"image/"] &&
+        transaction.state == FLEXNetworkTransactionStateFinished;
+}
+
+#pragma mark Image Data
+
+- (void)setImageData:(NSData *)data forRequestID:(FLEXNetworkRequestID)requestID {
+    if (data.length && data.length <= self.imageDataByteLimit) {
+        [self.imageData setObject:data forKey:@(requestID) cost:data.length];
+    }
+}
+
+- (void)removeImageDataForRequestID:(FLEXNetworkRequestID)requestID {
+    [self.imageData removeObjectForKey:@(requestID)];
+}
+
+- (void)removeAll {
+    [self.queue cancelAllOperations];
+    [self.imageData removeAllObjects];
+    [self.thumbnails removeAllObjects];
+}
+
+#pragma mark Thumbnails
+
+- (UIImage *)cachedThumbnailForTransaction:(FLEXHTTPTransaction *)transaction {
+    id thumbnail = [self.thumbnails objectForKey:transaction];
+    return thumbnail == NSNull.null ? nil : thumbnail;
+}
+
+- (NSOperation *)loadThumbnailForTransaction:(FLEXHTTPTransaction *)transaction
+                                  completion:(void(^)(UIImage *))completion {
+    NSInteger maxPixelDimension = UIScreen.mainScreen.scale * kFLEXThumbnailLoaderPointSize;
+    NSBlockOperation *operation = [NSBlockOperation new];
+    __weak NSBlockOperation *weakOperation = operation;
+
+    [operation addExecutionBlock:^{
+        // Another cell may have decoded it while this one was waiting
+        id thumbnail = [self.thumbnails objectForKey:transaction];
+        if (!thumbnail) {
+            if (weakOperation.isCancelled) {
+                return;
+            }
+
+            // Request IDs start over every launch, so one from a previous session's
+            // journal may belong to a different request in this session's image data
+            NSData *body = nil;
+            if (![transaction isKindOfClass:[FLEXJournaledHTTPTransaction class]]) {
+                body = [self.imageData objectForKey:@(transaction.requestID)];
+            }
+            body = body ?: self.bodyProvider(transaction);
+            thumbnail = body ? [FLEXUtility
+                thumbnailedImageWithMaxPixelDimension:maxPixelDimension fromImageData:body
+            ] : nil;
+
+            if (thumbnail) {
+                CGSize pixels = [thumbnail size];
+                [self.thumbnails setObject:thumbnail forKey:transaction cost:pixels.width * pixels.height * 4];
+            } else if (body) {
+                // Don't try again for a body that can't be decoded
+                [self.thumbnails setObject:NSNull.null forKey:transaction cost:1];
+            }
+        }
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (!weakOperation.isCancelled) {
+                completion(thumbnail == NSNull.null ? nil : thumbnail);
+            }
+        });
+    }];
+
+    [self.queue addOperation:operation];
+    return operation;
+}
+
+@end
@@ -0,0 +1,92 @@
+//
+//  FLEXNetworkTimings.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The phases of a single request and response, in the order they happen
+typedef NS_ENUM(NSUInteger, FLEXNetworkPhase) {
+    /// Waiting for a connection to become available, or to be sent over a reused one
+    FLEXNetworkPhaseQueued,
+    FLEXNetworkPhaseDNS,
+    /// The TCP or QUIC handshake
+    FLEXNetworkPhaseConnect,
+    FLEXNetworkPhaseTLS,
+    /// Sending the headers and body
+    FLEXNetworkPhaseRequest,
+    /// Waiting for the first byte of the response
+    FLEXNetworkPhaseWait,
+    /// Receiving the response
+    FLEXNetworkPhaseResponse,
+    FLEXNetworkPhaseCount
+};
+
+/// The timing of one request and its response within a task. A task makes one of these
+/// per redirect it follows, plus one for the last request.
+@interface FLEXNetworkExchangeTimings : NSObject
+
++ (NSString *)nameOfPhase:(FLEXNetworkPhase)phase;
+
+@property (nonatomic, readonly) NSURL *URL;
+@property (nonatomic, readonly) NSString *HTTPMethod;
+/// 0 if there was no response
+@property (nonatomic, readonly) NSInteger statusCode;
+
+/// When the exchange started, relative to the start of the task
+@property (nonatomic, readonly) NSTimeInterval startOffset;
+/// When the exchange ended, relative to the start of the task
+@property (nonatomic, readonly) NSTimeInterval endOffset;
+
+/// Gets when a phase started and ended, relative to the start of the task
+/// @return \c NO if the phase did not happen, like the DNS lookup for a reused connection
+- (BOOL)getStart:(NSTimeInterval *)start end:(NSTimeInterval *)end ofPhase:(FLEXNetworkPhase)phase;
+
+/// Like h2, h3, or http/1.1. \c nil if it's not known.
+@property (nonatomic, readonly, nullable) NSString *networkProtocolName;
+@property (nonatomic, readonly) BOOL reusedConnection;
+@property (nonatomic, readonly) BOOL proxyConnection;
+/// Whether the response came from the network, a local cache, or a server push
+@property (nonatomic, readonly) NSURLSessionTaskMetricsResourceFetchType fetchType;
+/// The remote address and port, if known
+@property (nonatomic, readonly, nullable) NSString *remoteAddress;
+/// Like TLS 1.3. \c nil for plain connections.
+@property (nonatomic, readonly, nullable) NSString *TLSVersion;
+@property (nonatomic, readonly) BOOL cellular;
+@property (nonatomic, readonly) BOOL expensive;
+@property (nonatomic, readonly) BOOL constrained;
+
+@property (nonatomic, readonly) int64_t requestHeaderBytesSent;
+/// The request body as sent, after any content encoding
+@property (nonatomic, readonly) int64_t requestBodyBytesSent;
+@property (nonatomic, readonly) int64_t requestBodyBytesBeforeEncoding;
+@property (nonatomic, readonly) int64_t responseHeaderBytesReceived;
+/// The response body as received, before any content decoding
+@property (nonatomic, readonly) int64_t responseBodyBytesReceived;
+@property (nonatomic, readonly) int64_t responseBodyBytesAfterDecoding;
+
+@end
+
+/// A compact copy of the \c NSURLSessionTaskMetrics of a task.
+/// It keeps only dates and counts, not the requests and responses the metrics refer to.
+@interface FLEXNetworkTimings : NSObject
+
++ (instancetype)timingsWithMetrics:(NSURLSessionTaskMetrics *)metrics;
+
+@property (nonatomic, readonly) NSDate *startDate;
+@property (nonatomic, readonly) NSTimeInterval duration;
+@property (nonatomic, readonly) NSUInteger redirectCount;
+/// In the order they happened. Usually one per redirect, plus the final request.
+@property (nonatomic, readonly) NSArray<FLEXNetworkExchangeTimings *> *exchanges;
+
+/// The exchange that produced the response, if any
+@property (nonatomic, readonly, nullable) FLEXNetworkExchangeTimings *finalExchange;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,146 @@
+//
+//  FLEXNetworkTimings.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTimings.h"
+
+@implementation FLEXNetworkExchangeTimings {
+    /// Offsets from the start of the task, or NAN if the phase did not happen
+    NSTimeInterval _phaseStarts[FLEXNetworkPhaseCount];
+    NSTimeInterval _phaseEnds[FLEXNetworkPhaseCount];
+}
+
++ (NSString *)nameOfPhase:(FLEXNetworkPhase)phase {
+    switch (phase) {
+        case FLEXNetworkPhaseQueued: return @"Queued";
+        case FLEXNetworkPhaseDNS: return @"DNS Lookup";
+        case FLEXNetworkPhaseConnect: return @"Connect";
+        case FLEXNetworkPhaseTLS: return @"TLS Handshake";
+        case FLEXNetworkPhaseRequest: return @"Request";
+        case FLEXNetworkPhaseWait: return @"Waiting";
+        case FLEXNetworkPhaseResponse: return @"Response";
+        case FLEXNetworkPhaseCount: break;
+    }
+
+    return nil;
+}
+
++ (NSString *)nameOfTLSVersion:(NSNumber *)version {
+    switch (version.unsignedShortValue) {
+        case 0: return nil;
+        case 0x0301: return @"TLS 1.0";
+        case 0x0302: return @"TLS 1.1";
+        case 0x0303: return @"TLS 1.2";
+        case 0x0304: return @"TLS 1.3";
+        case 0xFEFF: return @"DTLS 1.0";
+        case 0xFEFD: return @"DTLS 1.2";
+        default: return [NSString stringWithFormat:@"0x%04X", version.unsignedShortValue];
+    }
+}
+
++ (instancetype)withMetrics:(NSURLSessionTaskTransactionMetrics *)metrics since:(NSDate *)taskStart {
+    FLEXNetworkExchangeTimings *exchange = [self new];
+    exchange->_URL = metrics.request.URL;
+    exchange->_HTTPMethod = metrics.request.HTTPMethod;
+    if ([metrics.response isKindOfClass:[NSHTTPURLResponse class]]) {
+        exchange->_statusCode = ((NSHTTPURLResponse *)metrics.response).statusCode;
+    }
+
+    // Phases only have dates if they happened; the first available start is when queueing ended
+    NSDate *dequeued = metrics.domainLookupStartDate ?: metrics.connectStartDate ?: metrics.requestStartDate;
+    NSDate *connected = metrics.secureConnectionStartDate ?: metrics.connectEndDate;
+    NSDate *phaseDates[FLEXNetworkPhaseCount][2] = {
+        [FLEXNetworkPhaseQueued] = { metrics.fetchStartDate, dequeued },
+        [FLEXNetworkPhaseDNS] = { metrics.domainLookupStartDate, metrics.domainLookupEndDate },
+        [FLEXNetworkPhaseConnect] = { metrics.connectStartDate, connected },
+        [FLEXNetworkPhaseTLS] = { metrics.secureConnectionStartDate, metrics.secureConnectionEndDate },
+        [FLEXNetworkPhaseRequest] = { metrics.requestStartDate, metrics.requestEndDate },
+        [FLEXNetworkPhaseWait] = { metrics.requestEndDate, metrics.responseStartDate },
+        [FLEXNetworkPhaseResponse] = { metrics.responseStartDate, metrics.responseEndDate },
+    };
+
+    for (NSUInteger phase = 0; phase < FLEXNetworkPhaseCount; phase++) {
+        NSDate *start = phaseDates[phase][0], *end = phaseDates[phase][1];
+        if (start && end) {
+            exchange->_phaseStarts[phase] = [start timeIntervalSinceDate:taskStart];
+            exchange->_phaseEnds[phase] = [end timeIntervalSinceDate:taskStart];
+        } else {
+            exchange->_phaseStarts[phase] = NAN;
+            exchange->_phaseEnds[phase] = NAN;
+        }
+    }
+
+    NSDate *start = metrics.fetchStartDate ?: taskStart;
+    NSDate *end = metrics.responseEndDate ?: metrics.requestEndDate ?: start;
+    exchange->_startOffset = [start timeIntervalSinceDate:taskStart];
+    exchange->_endOffset = MAX([end timeIntervalSinceDate:taskStart], exchange->_startOffset);
+
+    exchange->_networkProtocolName = metrics.networkProtocolName;
+    exchange->_reusedConnection = metrics.isReusedConnection;
+    exchange->_proxyConnection = metrics.isProxyConnection;
+    exchange->_fetchType = metrics.resourceFetchType;
+
+    // The rest is only reported since iOS 13, and left unset before it
+    if (@available(iOS 13.0, *)) {
+        if (metrics.remoteAddress) {
+            exchange->_remoteAddress = metrics.remotePort ? [NSString
+                stringWithFormat:@"%@:%@", metrics.remoteAddress, metrics.remotePort
+            ] : metrics.remoteAddress;
+        }
+        exchange->_TLSVersion = [self nameOfTLSVersion:metrics.negotiatedTLSProtocolVersion];
+        exchange->_cellular = metrics.isCellular;
+        exchange->_expensive = metrics.isExpensive;
+        exchange->_constrained = metrics.isConstrained;
+
+        exchange->_requestHeaderBytesSent = metrics.countOfRequestHeaderBytesSent;
+        exchange->_requestBodyBytesSent = metrics.countOfRequestBodyBytesSent;
+        exchange->_requestBodyBytesBeforeEncoding = metrics.countOfRequestBodyBytesBeforeEncoding;
+        exchange->_responseHeaderBytesReceived = metrics.countOfResponseHeaderBytesReceived;
+        exchange->_responseBodyBytesReceived = metrics.countOfResponseBodyBytesReceived;
+        exchange->_responseBodyBytesAfterDecoding = metrics.countOfResponseBodyBytesAfterDecoding;
+    }
+
+    return exchange;
+}
+
+- (BOOL)getStart:(NSTimeInterval *)start end:(NSTimeInterval *)end ofPhase:(FLEXNetworkPhase)phase {
+    if (phase >= FLEXNetworkPhaseCount || isnan(_phaseStarts[phase])) {
+        return NO;
+    }
+
+    if (start) *start = _phaseStarts[phase];
+    if (end) *end = MAX(_phaseEnds[phase], _phaseStarts[phase]);
+    return YES;
+}
+
+@end
+
+@implementation FLEXNetworkTimings
+
++ (instancetype)timingsWithMetrics:(NSURLSessionTaskMetrics *)metrics {
+    FLEXNetworkTimings *timings = [self new];
+    NSDateInterval *interval = metrics.taskInterval;
+    timings->_startDate = interval.startDate ?: NSDate.date;
+    timings->_duration = interval.duration;
+    timings->_redirectCount = metrics.redirectCount;
+
+    NSMutableArray<FLEXNetworkExchangeTimings *> *exchanges = [NSMutableArray new];
+    for (NSURLSessionTaskTransactionMetrics *transaction in metrics.transactionMetrics) {
+        [exchanges addObject:[FLEXNetworkExchangeTimings
+            withMetrics:transaction since:timings->_startDate
+        ]];
+    }
+    timings->_exchanges = exchanges.copy;
+
+    return timings;
+}
+
+- (FLEXNetworkExchangeTimings *)finalExchange {
+    return self.exchanges.lastObject;
+}
+
+@end
@@ -8,6 +8,9 @@
 
 #import <UIKit/UIKit.h>
 #import "Firestore.h"
+#import "FLEXNetworkTimings.h"
+
+@class FLEXWebsocketConversation;
 
 typedef NS_ENUM(NSInteger, FLEXNetworkTransactionState) {
     FLEXNetworkTransactionStateUnstarted = -1,
@@ -18,6 +21,14 @@ typedef NS_ENUM(NSInteger, FLEXNetworkTransactionState) {
     FLEXNetworkTransactionStateFailed
 };
 
+/// Identifies a request from the observer to the recorder. Assigned in increasing order, starting at 1.
+typedef uint64_t FLEXNetworkRequestID;
+
+/// For using a request ID as the key of a \c CFDictionary with \c NULL key callbacks
+NS_INLINE const void *FLEXNetworkRequestIDKey(FLEXNetworkRequestID requestID) {
+    return (const void *)(uintptr_t)requestID;
+}
+
 typedef NS_ENUM(NSUInteger, FLEXWebsocketMessageDirection) {
     FLEXWebsocketIncoming = 1,
     FLEXWebsocketOutgoing,
@@ -60,6 +71,9 @@ typedef NS_ENUM(NSUInteger, FLEXWebsocketMessageDirection) {
 
 /// Whether or not this request should show up when the user searches for a given string
 - (BOOL)matchesQuery:(NSString *)filterString;
+/// Whether a transaction matching a query is guaranteed to match every substring of that query.
+/// When YES, a narrowed search only has to test the results of the previous search. Defaults to YES.
+@property (nonatomic, readonly, class) BOOL matchesSubqueries;
 
 /// For internal use
 - (NSString *)timestampStringFromRequestDate:(NSDate *)date;
@@ -81,14 +95,19 @@ typedef NS_ENUM(NSUInteger, FLEXWebsocketMessageDirection) {
 
 @interface FLEXHTTPTransaction : FLEXURLTransaction
 
-+ (instancetype)request:(NSURLRequest *)request identifier:(NSString *)requestID;
++ (instancetype)request:(NSURLRequest *)request identifier:(FLEXNetworkRequestID)requestID;
+/// For transactions recorded earlier, such as those read back from a journal
++ (instancetype)request:(NSURLRequest *)request identifier:(FLEXNetworkRequestID)requestID startTime:(NSDate *)startTime;
 
-@property (nonatomic, readonly) NSString *requestID;
+@property (nonatomic, readonly) FLEXNetworkRequestID requestID;
 @property (nonatomic) NSURLResponse *response;
 @property (nonatomic, copy) NSString *requestMechanism;
 
 @property (nonatomic) NSTimeInterval latency;
 @property (nonatomic) NSTimeInterval duration;
+/// The per-phase breakdown of the task from \c NSURLSessionTaskMetrics, including any redirects.
+/// \c nil until the task finishes, and for requests not made through \c NSURLSession.
+@property (nonatomic) FLEXNetworkTimings *timings;
 
 /// Populated lazily, nullable. Handles both normal HTTPBody data and HTTPBodyStreams.
 @property (nonatomic, readonly) NSData *cachedRequestBody;
@@ -107,11 +126,25 @@ typedef NS_ENUM(NSUInteger, FLEXWebsocketMessageDirection) {
                   direction:(FLEXWebsocketMessageDirection)direction
                   startTime:(NSDate *)started API_AVAILABLE(ios(13.0));
 
+/// @param payloadLimit Messages with a longer payload are recorded with a copy of only the
+/// beginning of it, so that a chatty socket can't pin large payloads in memory. 0 means no limit.
++ (instancetype)withMessage:(NSURLSessionWebSocketMessage *)message
+                       task:(NSURLSessionWebSocketTask *)task
+                  direction:(FLEXWebsocketMessageDirection)direction
+                  startTime:(NSDate *)started
+               payloadLimit:(NSUInteger)payloadLimit API_AVAILABLE(ios(13.0));
+
 //@property (nonatomic, readonly) NSURLSessionWebSocketTask *task;
 @property (nonatomic, readonly) NSURLSessionWebSocketMessage *message API_AVAILABLE(ios(13.0));
 @property (nonatomic, readonly) FLEXWebsocketMessageDirection direction API_AVAILABLE(ios(13.0));
 
+/// The length of the whole payload, even if \c message was truncated
 @property (nonatomic, readonly) int64_t dataLength API_AVAILABLE(ios(13.0));
+/// Whether \c message only holds the beginning of the payload
+@property (nonatomic, readonly) BOOL payloadTruncated;
+
+/// The conversation of the task this message was sent or received on
+@property (nonatomic, weak) FLEXWebsocketConversation *conversation;
 
 @end
 
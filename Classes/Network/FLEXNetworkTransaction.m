@@ -67,6 +67,10 @@
     return NO;
 }
 
++ (BOOL)matchesSubqueries {
+    return YES;
+}
+
 @end
 
 
@@ -162,8 +166,12 @@
 
 @implementation FLEXHTTPTransaction
 
-+ (instancetype)request:(NSURLRequest *)request identifier:(NSString *)requestID {
-    FLEXHTTPTransaction *httpt = [self withRequest:request startTime:NSDate.date];
++ (instancetype)request:(NSURLRequest *)request identifier:(FLEXNetworkRequestID)requestID {
+    return [self request:request identifier:requestID startTime:NSDate.date];
+}
+
++ (instancetype)request:(NSURLRequest *)request identifier:(FLEXNetworkRequestID)requestID startTime:(NSDate *)startTime {
+    FLEXHTTPTransaction *httpt = [self withRequest:request startTime:startTime];
     httpt->_requestID = requestID;
     return httpt;
 }
@@ -171,7 +179,7 @@
 - (NSString *)description {
     NSString *description = [super description];
     
-    description = [description stringByAppendingFormat:@" id = %@;", self.requestID];
+    description = [description stringByAppendingFormat:@" id = %llu;", self.requestID];
     description = [description stringByAppendingFormat:@" url = %@;", self.request.URL];
     description = [description stringByAppendingFormat:@" duration = %f;", self.duration];
     description = [description stringByAppendingFormat:@" receivedDataLength = %lld", self.receivedDataLength];
@@ -237,10 +245,13 @@
 + (instancetype)withMessage:(NSURLSessionWebSocketMessage *)message
                        task:(NSURLSessionWebSocketTask *)task
                   direction:(FLEXWebsocketMessageDirection)direction
-                  startTime:(NSDate *)started {
+                  startTime:(NSDate *)started
+               payloadLimit:(NSUInteger)payloadLimit {
     FLEXWebsocketTransaction *wst = [self withRequest:task.originalRequest startTime:started];
-    wst->_message = message;
     wst->_direction = direction;
+    wst->_dataLength = [self lengthOfMessage:message];
+    wst->_payloadTruncated = payloadLimit && wst->_dataLength > payloadLimit;
+    wst->_message = wst->_payloadTruncated ? [self message:message truncatedToLength:payloadLimit] : message;
     
     // Populate receivedDataLength
     if (direction == FLEXWebsocketIncoming) {
@@ -258,32 +269,51 @@
     return wst;
 }
 
++ (instancetype)withMessage:(NSURLSessionWebSocketMessage *)message
+                       task:(NSURLSessionWebSocketTask *)task
+                  direction:(FLEXWebsocketMessageDirection)direction
+                  startTime:(NSDate *)started {
+    return [self withMessage:message task:task direction:direction startTime:started payloadLimit:0];
+}
+
 + (instancetype)withMessage:(NSURLSessionWebSocketMessage *)message
                        task:(NSURLSessionWebSocketTask *)task
                   direction:(FLEXWebsocketMessageDirection)direction {
     return [self withMessage:message task:task direction:direction startTime:NSDate.date];
 }
 
-- (NSArray<NSString *> *)details API_AVAILABLE(ios(13.0)) {
-    return @[
-        self.direction == FLEXWebsocketOutgoing ? @"SENT →" : @"→ RECEIVED",
-        [NSByteCountFormatter
-            stringFromByteCount:self.dataLength
-            countStyle:NSByteCountFormatterCountStyleBinary
-        ]
-    ];
++ (int64_t)lengthOfMessage:(NSURLSessionWebSocketMessage *)message API_AVAILABLE(ios(13.0)) {
+    if (message.type == NSURLSessionWebSocketMessageTypeString) {
+        return message.string.length;
+    }
+    
+    return message.data.length;
 }
 
-- (int64_t)dataLength {
-    if (self.message) {
-        if (self.message.type == NSURLSessionWebSocketMessageTypeString) {
-            return self.message.string.length;
-        }
-        
-        return self.message.data.length;
++ (NSURLSessionWebSocketMessage *)message:(NSURLSessionWebSocketMessage *)message
+                        truncatedToLength:(NSUInteger)length API_AVAILABLE(ios(13.0)) {
+    if (message.type == NSURLSessionWebSocketMessageTypeString) {
+        // Don't cut a composed character sequence in half
+        NSString *string = message.string;
+        NSUInteger end = [string rangeOfComposedCharacterSequenceAtIndex:length].location;
+        return [[NSURLSessionWebSocketMessage alloc] initWithString:[string substringToIndex:end]];
     }
     
-    return 0;
+    return [[NSURLSessionWebSocketMessage alloc]
+        initWithData:[message.data subdataWithRange:NSMakeRange(0, length)]
+    ];
+}
+
+- (NSArray<NSString *> *)details API_AVAILABLE(ios(13.0)) {
+    NSString *size = [NSByteCountFormatter
+        stringFromByteCount:self.dataLength
+        countStyle:NSByteCountFormatterCountStyleBinary
+    ];
+    
+    return @[
+        self.direction == FLEXWebsocketOutgoing ? @"SENT →" : @"→ RECEIVED",
+        self.payloadTruncated ? [size stringByAppendingString:@" (truncated)"] : size
+    ];
 }
 
 @end
@@ -12,8 +12,12 @@
 
 @interface FLEXNetworkTransactionCell : UITableViewCell
 
+/// Setting an HTTP transaction with an image response starts loading its thumbnail
 @property (nonatomic) FLEXNetworkTransaction *transaction;
 
+/// Call when the cell goes off screen, so that its thumbnail isn't decoded for nothing
+- (void)cancelThumbnailLoad;
+
 @property (nonatomic, readonly, class) NSString *reuseID;
 @property (nonatomic, readonly, class) CGFloat preferredCellHeight;
 
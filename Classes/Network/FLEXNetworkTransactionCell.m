@@ -9,6 +9,8 @@
 #import "FLEXColor.h"
 #import "FLEXNetworkTransactionCell.h"
 #import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkRecorder.h"
+#import "FLEXNetworkThumbnailLoader.h"
 #import "FLEXUtility.h"
 #import "FLEXResources.h"
 
@@ -21,6 +23,12 @@ NSString * const kFLEXNetworkTransactionCellIdentifier = @"kFLEXNetworkTransacti
 @property (nonatomic) UILabel *pathLabel;
 @property (nonatomic) UILabel *transactionDetailsLabel;
 
+/// The decoded image preview of \c transaction, for image responses
+@property (nonatomic) UIImage *loadedThumbnail;
+/// Whether loading \c loadedThumbnail has completed, even if it couldn't be decoded
+@property (nonatomic) BOOL thumbnailLoaded;
+@property (nonatomic) NSOperation *thumbnailOperation;
+
 @end
 
 @implementation FLEXNetworkTransactionCell
@@ -56,9 +64,57 @@ NSString * const kFLEXNetworkTransactionCellIdentifier = @"kFLEXNetworkTransacti
 
 - (void)setTransaction:(FLEXNetworkTransaction *)transaction {
     if (_transaction != transaction) {
+        [self cancelThumbnailLoad];
         _transaction = transaction;
+        self.loadedThumbnail = nil;
+        self.thumbnailLoaded = NO;
         [self setNeedsLayout];
     }
+
+    // An image may have finished loading since the cell was last configured with it
+    [self loadThumbnailIfNeeded];
+}
+
+- (void)prepareForReuse {
+    [super prepareForReuse];
+    [self cancelThumbnailLoad];
+}
+
+- (void)cancelThumbnailLoad {
+    [self.thumbnailOperation cancel];
+    self.thumbnailOperation = nil;
+}
+
+- (void)loadThumbnailIfNeeded {
+    if (self.thumbnailLoaded || self.thumbnailOperation || self.transaction.thumbnail ||
+        ![self.transaction isKindOfClass:[FLEXHTTPTransaction class]]) {
+        return;
+    }
+
+    FLEXHTTPTransaction *transaction = (id)self.transaction;
+    if (![FLEXNetworkThumbnailLoader canLoadThumbnailForTransaction:transaction]) {
+        return;
+    }
+
+    FLEXNetworkThumbnailLoader *loader = FLEXNetworkRecorder.defaultRecorder.thumbnailLoader;
+    self.loadedThumbnail = [loader cachedThumbnailForTransaction:transaction];
+    if (self.loadedThumbnail) {
+        self.thumbnailLoaded = YES;
+        return;
+    }
+
+    __weak __typeof(self) weakSelf = self;
+    self.thumbnailOperation = [loader loadThumbnailForTransaction:transaction completion:^(UIImage *thumbnail) {
+        __typeof(self) cell = weakSelf;
+        if (cell.transaction != transaction) {
+            return;
+        }
+
+        cell.thumbnailOperation = nil;
+        cell.thumbnailLoaded = YES;
+        cell.loadedThumbnail = thumbnail;
+        cell.thumbnailImageView.image = thumbnail;
+    }];
 }
 
 - (void)layoutSubviews {
@@ -70,7 +126,7 @@ NSString * const kFLEXNetworkTransactionCellIdentifier = @"kFLEXNetworkTransacti
 
     CGFloat thumbnailOriginY = round((self.contentView.bounds.size.height - kImageDimension) / 2.0);
     self.thumbnailImageView.frame = CGRectMake(kLeftPadding, thumbnailOriginY, kImageDimension, kImageDimension);
-    self.thumbnailImageView.image = self.transaction.thumbnail;
+    self.thumbnailImageView.image = self.transaction.thumbnail ?: self.loadedThumbnail;
 
     CGFloat textOriginX = CGRectGetMaxX(self.thumbnailImageView.frame) + kLeftPadding;
     CGFloat availableTextWidth = self.contentView.bounds.size.width - textOriginX;
@@ -0,0 +1,35 @@
+//
+//  FLEXNetworkTransactionCoalescer.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Called on the main queue with every transaction marked since the last delivery, in the order
+/// they were first marked. A transaction inserted and then updated within a single batch is only
+/// reported as inserted.
+typedef void (^FLEXNetworkTransactionBatchHandler)(NSArray *inserted, NSArray *updated);
+
+/// Collects dirty transactions from any thread and delivers them to the main queue in batches,
+/// at most once per display frame or once per \c interval.
+@interface FLEXNetworkTransactionCoalescer : NSObject
+
++ (instancetype)coalescerWithHandler:(FLEXNetworkTransactionBatchHandler)handler;
+
+/// The minimum time between two deliveries. When 0, batches are delivered once per display frame.
+@property (nonatomic) NSTimeInterval interval;
+
+- (void)markInserted:(id)transaction;
+- (void)markUpdated:(id)transaction;
+
+/// Drops any pending transactions without delivering them
+- (void)discardPending;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,134 @@
+//
+//  FLEXNetworkTransactionCoalescer.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTransactionCoalescer.h"
+#import <QuartzCore/QuartzCore.h>
+#import <os/lock.h>
+
+@interface FLEXNetworkTransactionCoalescer ()
+@property (nonatomic, readonly) FLEXNetworkTransactionBatchHandler handler;
+/// Only accessed on the main queue. Paused whenever there is nothing to deliver.
+@property (nonatomic) CADisplayLink *displayLink;
+- (void)displayLinkFired:(CADisplayLink *)link;
+@end
+
+/// A display link retains its target, so it targets this instead of the coalescer,
+/// which would otherwise never be deallocated and never invalidate the link
+@interface FLEXCoalescerDisplayLinkTarget : NSObject
+@property (nonatomic, weak) FLEXNetworkTransactionCoalescer *coalescer;
+@end
+
+@implementation FLEXCoalescerDisplayLinkTarget
+
+- (void)displayLinkFired:(CADisplayLink *)link {
+    [self.coalescer displayLinkFired:link];
+}
+
+@end
+
+@implementation FLEXNetworkTransactionCoalescer {
+    os_unfair_lock _lock;
+    NSMutableOrderedSet *_inserted;
+    NSMutableOrderedSet *_updated;
+    /// Whether a delivery has been scheduled for the current batch
+    BOOL _scheduled;
+}
+
++ (instancetype)coalescerWithHandler:(FLEXNetworkTransactionBatchHandler)handler {
+    FLEXNetworkTransactionCoalescer *coalescer = [self new];
+    coalescer->_handler = handler;
+    coalescer->_lock = OS_UNFAIR_LOCK_INIT;
+    coalescer->_inserted = [NSMutableOrderedSet new];
+    coalescer->_updated = [NSMutableOrderedSet new];
+    return coalescer;
+}
+
+- (void)dealloc {
+    [_displayLink invalidate];
+}
+
+#pragma mark Public
+
+- (void)markInserted:(id)transaction {
+    os_unfair_lock_lock(&_lock);
+    [_inserted addObject:transaction];
+    [_updated removeObject:transaction];
+    [self scheduleIfNeeded];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)markUpdated:(id)transaction {
+    os_unfair_lock_lock(&_lock);
+    if (![_inserted containsObject:transaction]) {
+        [_updated addObject:transaction];
+    }
+    [self scheduleIfNeeded];
+    os_unfair_lock_unlock(&_lock);
+}
+
+- (void)discardPending {
+    os_unfair_lock_lock(&_lock);
+    [_inserted removeAllObjects];
+    [_updated removeAllObjects];
+    os_unfair_lock_unlock(&_lock);
+}
+
+#pragma mark Private
+
+/// Caller must hold the lock
+- (void)scheduleIfNeeded {
+    if (_scheduled) {
+        return;
+    }
+
+    _scheduled = YES;
+    NSTimeInterval interval = self.interval;
+    if (interval > 0) {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)),
+            dispatch_get_main_queue(), ^{
+            [self deliver];
+        });
+    } else {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self resumeDisplayLink];
+        });
+    }
+}
+
+- (void)resumeDisplayLink {
+    if (!self.displayLink) {
+        FLEXCoalescerDisplayLinkTarget *target = [FLEXCoalescerDisplayLinkTarget new];
+        target.coalescer = self;
+        self.displayLink = [CADisplayLink displayLinkWithTarget:target selector:@selector(displayLinkFired:)];
+        [self.displayLink addToRunLoop:NSRunLoop.mainRunLoop forMode:NSRunLoopCommonModes];
+    }
+
+    self.displayLink.paused = NO;
+}
+
+- (void)displayLinkFired:(CADisplayLink *)link {
+    link.paused = YES;
+    [self deliver];
+}
+
+- (void)deliver {
+    os_unfair_lock_lock(&_lock);
+    // -array returns a live proxy, so it must be copied before we clear the sets
+    NSArray *inserted = _inserted.array.copy;
+    NSArray *updated = _updated.array.copy;
+    [_inserted removeAllObjects];
+    [_updated removeAllObjects];
+    _scheduled = NO;
+    os_unfair_lock_unlock(&_lock);
+
+    if (inserted.count || updated.count) {
+        self.handler(inserted, updated);
+    }
+}
+
+@end
@@ -0,0 +1,53 @@
+//
+//  FLEXNetworkTransactionStore.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A fixed-capacity ring buffer of transactions, ordered with the newest first.
+///
+/// Appending is O(1). Once the store is full, each append evicts the oldest object,
+/// which is returned to the caller so it can release anything associated with it.
+/// All methods are thread safe, but mutations are expected to come from a single
+/// queue (the recorder's). \c snapshot is cached until the next mutation, so
+/// repeatedly reading it from the UI is cheap.
+@interface FLEXNetworkTransactionStore<ObjectType> : NSObject
+
+/// @param capacity The maximum number of objects to retain. Must be greater than 0.
++ (instancetype)storeWithCapacity:(NSUInteger)capacity;
+
+@property (nonatomic, readonly) NSUInteger capacity;
+@property (nonatomic, readonly) NSUInteger count;
+
+/// An immutable copy of the contents of the store, newest first.
+@property (nonatomic, readonly) NSArray<ObjectType> *snapshot;
+
+/// @param idx 0 is the newest object
+/// @return \c nil if the index is out of bounds
+- (nullable ObjectType)objectAtIndex:(NSUInteger)idx;
+/// Copies only the objects in range, newest first, without building a snapshot.
+/// The range is clamped to the bounds of the store.
+- (NSArray<ObjectType> *)objectsInRange:(NSRange)range;
+
+/// Adds an object as the newest entry in the store.
+/// @return The oldest object in the store if it had to be evicted to make room, or \c nil.
+- (nullable ObjectType)push:(ObjectType)object;
+
+/// Changes the capacity of the store, evicting the oldest objects if needed.
+/// @return The objects that were evicted, oldest first.
+- (NSArray<ObjectType> *)resize:(NSUInteger)capacity;
+
+/// Removes all objects matching the given predicate, preserving the order of the rest.
+/// @return The objects that were removed.
+- (NSArray<ObjectType> *)removeObjectsPassingTest:(BOOL(^)(ObjectType obj))predicate;
+- (void)removeAllObjects;
+
+@end
+
+NS_ASSUME_NONNULL_END
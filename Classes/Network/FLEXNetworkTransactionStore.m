@@ -0,0 +1,207 @@
+//
+//  FLEXNetworkTransactionStore.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkTransactionStore.h"
+#import <os/lock.h>
+
+@implementation FLEXNetworkTransactionStore {
+    os_unfair_lock _lock;
+    /// Storage for the ring; \c _head is the slot the next object will be written to,
+    /// which is also the slot of the oldest object once the store is full.
+    __strong id *_slots;
+    NSUInteger _capacity;
+    NSUInteger _head;
+    NSUInteger _count;
+    /// Invalidated on every mutation
+    NSArray *_snapshot;
+}
+
++ (instancetype)storeWithCapacity:(NSUInteger)capacity {
+    NSParameterAssert(capacity > 0);
+
+    FLEXNetworkTransactionStore *store = [self new];
+    store->_lock = OS_UNFAIR_LOCK_INIT;
+    store->_capacity = MAX(capacity, 1);
+    store->_slots = (__strong id *)calloc(store->_capacity, sizeof(id));
+    return store;
+}
+
+- (void)dealloc {
+    [self clearSlots];
+    free(_slots);
+}
+
+#pragma mark Private
+
+/// Maps an index where 0 is the newest object to a slot in the ring
+- (NSUInteger)slotForIndex:(NSUInteger)idx {
+    return (_head + _capacity - 1 - idx) % _capacity;
+}
+
+/// Releases every object in the ring. Caller must hold the lock.
+- (void)clearSlots {
+    for (NSUInteger i = 0; i < _capacity; i++) {
+        _slots[i] = nil;
+    }
+
+    _head = 0;
+    _count = 0;
+    _snapshot = nil;
+}
+
+/// Caller must hold the lock.
+- (NSArray *)buildSnapshot {
+    if (!_count) {
+        return @[];
+    }
+
+    __unsafe_unretained id *objects = (__unsafe_unretained id *)malloc(_count * sizeof(id));
+    for (NSUInteger i = 0; i < _count; i++) {
+        objects[i] = _slots[[self slotForIndex:i]];
+    }
+
+    NSArray *snapshot = [NSArray arrayWithObjects:objects count:_count];
+    free(objects);
+    return snapshot;
+}
+
+/// Replaces the contents of the ring with the given objects. Caller must hold the lock.
+/// @param newestFirst Must not contain more than \c _capacity objects
+- (void)refillWithObjects:(NSArray *)newestFirst {
+    [self clearSlots];
+
+    for (id object in newestFirst.reverseObjectEnumerator) {
+        _slots[_head] = object;
+        _head = (_head + 1) % _capacity;
+    }
+
+    _count = newestFirst.count;
+}
+
+#pragma mark Public
+
+- (NSUInteger)capacity {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger capacity = _capacity;
+    os_unfair_lock_unlock(&_lock);
+    return capacity;
+}
+
+- (NSUInteger)count {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSArray *)snapshot {
+    os_unfair_lock_lock(&_lock);
+    if (!_snapshot) {
+        _snapshot = [self buildSnapshot];
+    }
+
+    NSArray *snapshot = _snapshot;
+    os_unfair_lock_unlock(&_lock);
+    return snapshot;
+}
+
+- (id)objectAtIndex:(NSUInteger)idx {
+    os_unfair_lock_lock(&_lock);
+    id object = idx < _count ? _slots[[self slotForIndex:idx]] : nil;
+    os_unfair_lock_unlock(&_lock);
+    return object;
+}
+
+- (NSArray *)objectsInRange:(NSRange)range {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger start = MIN(range.location, _count);
+    NSUInteger length = MIN(range.length, _count - start);
+    NSMutableArray *objects = [NSMutableArray arrayWithCapacity:length];
+    for (NSUInteger i = start; i < start + length; i++) {
+        [objects addObject:_slots[[self slotForIndex:i]]];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    return objects;
+}
+
+- (id)push:(id)object {
+    NSParameterAssert(object);
+
+    os_unfair_lock_lock(&_lock);
+    id evicted = nil;
+    if (_count == _capacity) {
+        evicted = _slots[_head];
+    } else {
+        _count++;
+    }
+
+    _slots[_head] = object;
+    _head = (_head + 1) % _capacity;
+    _snapshot = nil;
+    os_unfair_lock_unlock(&_lock);
+
+    return evicted;
+}
+
+- (NSArray *)resize:(NSUInteger)capacity {
+    NSParameterAssert(capacity > 0);
+    capacity = MAX(capacity, 1);
+
+    os_unfair_lock_lock(&_lock);
+    if (capacity == _capacity) {
+        os_unfair_lock_unlock(&_lock);
+        return @[];
+    }
+
+    NSArray *all = [self buildSnapshot];
+    NSArray *kept = all, *evicted = @[];
+    if (all.count > capacity) {
+        kept = [all subarrayWithRange:NSMakeRange(0, capacity)];
+        evicted = [all subarrayWithRange:NSMakeRange(capacity, all.count - capacity)];
+        evicted = evicted.reverseObjectEnumerator.allObjects;
+    }
+
+    [self clearSlots];
+    free(_slots);
+    _capacity = capacity;
+    _slots = (__strong id *)calloc(_capacity, sizeof(id));
+    [self refillWithObjects:kept];
+    os_unfair_lock_unlock(&_lock);
+
+    return evicted;
+}
+
+- (NSArray *)removeObjectsPassingTest:(BOOL (^)(id))predicate {
+    os_unfair_lock_lock(&_lock);
+    NSMutableArray *kept = [NSMutableArray arrayWithCapacity:_count];
+    NSMutableArray *removed = [NSMutableArray new];
+    for (NSUInteger i = 0; i < _count; i++) {
+        id object = _slots[[self slotForIndex:i]];
+        if (predicate(object)) {
+            [removed addObject:object];
+        } else {
+            [kept addObject:object];
+        }
+    }
+
+    if (removed.count) {
+        [self refillWithObjects:kept];
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    return removed;
+}
+
+- (void)removeAllObjects {
+    os_unfair_lock_lock(&_lock);
+    [self clearSlots];
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
@@ -0,0 +1,22 @@
+//
+//  FLEXNetworkWaterfallViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+@class FLEXNetworkTimings;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Shows each phase of a task as a bar on a timeline spanning the whole task,
+/// with one section per request, so redirects appear one after another.
+@interface FLEXNetworkWaterfallViewController : FLEXTableViewController
+
++ (instancetype)withTimings:(FLEXNetworkTimings *)timings;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,214 @@
+//
+//  FLEXNetworkWaterfallViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXNetworkWaterfallViewController.h"
+#import "FLEXNetworkTimings.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXUtility.h"
+
+static NSString * const kFLEXNetworkWaterfallCell = @"kFLEXNetworkWaterfallCell";
+
+/// Shows the name and duration of a phase above a bar marking when it happened
+@interface FLEXNetworkWaterfallCell : FLEXTableViewCell
+@property (nonatomic, readonly) UIView *barView;
+/// Where the bar starts and ends, as fractions of the cell's width
+@property (nonatomic) CGFloat barStart;
+@property (nonatomic) CGFloat barEnd;
+@end
+
+@implementation FLEXNetworkWaterfallCell
+
+- (id)initWithStyle:(UITableViewCellStyle)style reuseIdentifier:(NSString *)reuseIdentifier {
+    return [super initWithStyle:UITableViewCellStyleValue1 reuseIdentifier:reuseIdentifier];
+}
+
+- (void)postInit {
+    [super postInit];
+
+    _barView = [UIView new];
+    _barView.layer.cornerRadius = 2;
+    [self.contentView addSubview:_barView];
+    self.selectionStyle = UITableViewCellSelectionStyleNone;
+}
+
+- (void)layoutSubviews {
+    [super layoutSubviews];
+
+    // Leave room below the labels for the bar
+    CGRect bounds = self.contentView.bounds;
+    CGFloat inset = self.separatorInset.left;
+    CGFloat width = CGRectGetWidth(bounds) - inset * 2;
+    CGFloat start = inset + width * self.barStart;
+    CGFloat length = MAX(width * (self.barEnd - self.barStart), 2);
+    self.barView.frame = CGRectMake(start, CGRectGetMaxY(bounds) - 8, length, 4);
+
+    for (UILabel *label in @[self.titleLabel, self.subtitleLabel]) {
+        CGRect frame = label.frame;
+        frame.origin.y = MAX(CGRectGetMinY(frame) - 4, 0);
+        label.frame = frame;
+    }
+}
+
+@end
+
+@interface FLEXNetworkWaterfallViewController ()
+@property (nonatomic, readonly) FLEXNetworkTimings *timings;
+/// For each exchange, the phases that happened
+@property (nonatomic, readonly) NSArray<NSArray<NSNumber *> *> *phases;
+@end
+
+@implementation FLEXNetworkWaterfallViewController
+
++ (instancetype)withTimings:(FLEXNetworkTimings *)timings {
+    FLEXNetworkWaterfallViewController *controller = [self new];
+    controller->_timings = timings;
+
+    NSMutableArray *phases = [NSMutableArray new];
+    for (FLEXNetworkExchangeTimings *exchange in timings.exchanges) {
+        NSMutableArray<NSNumber *> *happened = [NSMutableArray new];
+        for (FLEXNetworkPhase phase = 0; phase < FLEXNetworkPhaseCount; phase++) {
+            if ([exchange getStart:nil end:nil ofPhase:phase]) {
+                [happened addObject:@(phase)];
+            }
+        }
+        [phases addObject:happened];
+    }
+    controller->_phases = phases;
+
+    return controller;
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStyleGrouped];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    self.title = @"Timing";
+    self.tableView.rowHeight = 52;
+    [self.tableView registerClass:[FLEXNetworkWaterfallCell class] forCellReuseIdentifier:kFLEXNetworkWaterfallCell];
+}
+
+#pragma mark Formatting
+
++ (UIColor *)colorOfPhase:(FLEXNetworkPhase)phase {
+    switch (phase) {
+        case FLEXNetworkPhaseQueued: return UIColor.systemGrayColor;
+        case FLEXNetworkPhaseDNS: return UIColor.systemTealColor;
+        case FLEXNetworkPhaseConnect: return UIColor.systemOrangeColor;
+        case FLEXNetworkPhaseTLS: return UIColor.systemPurpleColor;
+        case FLEXNetworkPhaseRequest: return UIColor.systemGreenColor;
+        case FLEXNetworkPhaseWait: return UIColor.systemYellowColor;
+        case FLEXNetworkPhaseResponse: return UIColor.systemBlueColor;
+        case FLEXNetworkPhaseCount: break;
+    }
+
+    return UIColor.systemGrayColor;
+}
+
++ (NSString *)stringFromByteCount:(int64_t)count {
+    return [NSByteCountFormatter stringFromByteCount:count countStyle:NSByteCountFormatterCountStyleBinary];
+}
+
+/// The connection, and the bytes on the wire compared to before encoding or after decoding
++ (NSString *)summaryOfExchange:(FLEXNetworkExchangeTimings *)exchange {
+    NSMutableArray<NSString *> *connection = [NSMutableArray new];
+    switch (exchange.fetchType) {
+        case NSURLSessionTaskMetricsResourceFetchTypeLocalCache:
+            return @"Loaded from the local cache";
+        case NSURLSessionTaskMetricsResourceFetchTypeServerPush:
+            [connection addObject:@"server push"];
+            break;
+        default:
+            break;
+    }
+
+    if (exchange.networkProtocolName) [connection addObject:exchange.networkProtocolName];
+    [connection addObject:exchange.reusedConnection ? @"reused connection" : @"new connection"];
+    if (exchange.proxyConnection) [connection addObject:@"proxy"];
+    if (exchange.TLSVersion) [connection addObject:exchange.TLSVersion];
+    if (exchange.remoteAddress) [connection addObject:exchange.remoteAddress];
+    if (exchange.cellular) [connection addObject:@"cellular"];
+    if (exchange.constrained) [connection addObject:@"low data mode"];
+
+    NSString *sent = [NSString stringWithFormat:@"Sent %@ of headers, %@ of body",
+        [self stringFromByteCount:exchange.requestHeaderBytesSent],
+        [self stringFromByteCount:exchange.requestBodyBytesSent]
+    ];
+    if (exchange.requestBodyBytesBeforeEncoding != exchange.requestBodyBytesSent) {
+        sent = [sent stringByAppendingFormat:@" (%@ before encoding)",
+            [self stringFromByteCount:exchange.requestBodyBytesBeforeEncoding]
+        ];
+    }
+
+    NSString *received = [NSString stringWithFormat:@"Received %@ of headers, %@ of body",
+        [self stringFromByteCount:exchange.responseHeaderBytesReceived],
+        [self stringFromByteCount:exchange.responseBodyBytesReceived]
+    ];
+    if (exchange.responseBodyBytesAfterDecoding != exchange.responseBodyBytesReceived) {
+        received = [received stringByAppendingFormat:@" (%@ decoded)",
+            [self stringFromByteCount:exchange.responseBodyBytesAfterDecoding]
+        ];
+    }
+
+    return [@[[connection componentsJoinedByString:@" · "], sent, received] componentsJoinedByString:@"\n"];
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+    return self.timings.exchanges.count;
+}
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return self.phases[section].count;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForHeaderInSection:(NSInteger)section {
+    FLEXNetworkExchangeTimings *exchange = self.timings.exchanges[section];
+    NSString *status = exchange.statusCode ? @(exchange.statusCode).stringValue : @"No response";
+    NSString *title = [NSString stringWithFormat:@"%@ %@ — %@",
+        exchange.HTTPMethod ?: @"", exchange.URL.path.length ? exchange.URL.path : @"/", status
+    ];
+
+    if (self.timings.exchanges.count > 1) {
+        BOOL redirect = section < self.timings.exchanges.count - 1;
+        return [NSString stringWithFormat:@"%@%@", title, redirect ? @" (redirected)" : @""];
+    }
+
+    return title;
+}
+
+- (NSString *)tableView:(UITableView *)tableView titleForFooterInSection:(NSInteger)section {
+    return [[self class] summaryOfExchange:self.timings.exchanges[section]];
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXNetworkWaterfallCell *cell = [tableView
+        dequeueReusableCellWithIdentifier:kFLEXNetworkWaterfallCell forIndexPath:indexPath
+    ];
+
+    FLEXNetworkExchangeTimings *exchange = self.timings.exchanges[indexPath.section];
+    FLEXNetworkPhase phase = self.phases[indexPath.section][indexPath.row].unsignedIntegerValue;
+    NSTimeInterval start = 0, end = 0;
+    [exchange getStart:&start end:&end ofPhase:phase];
+
+    // Bars are placed on a timeline spanning the whole task
+    NSTimeInterval total = MAX(self.timings.duration, exchange.endOffset);
+    cell.titleLabel.text = [FLEXNetworkExchangeTimings nameOfPhase:phase];
+    cell.subtitleLabel.text = [FLEXUtility stringFromRequestDuration:end - start];
+    cell.barView.backgroundColor = [[self class] colorOfPhase:phase];
+    cell.barStart = total > 0 ? MIN(MAX(start / total, 0), 1) : 0;
+    cell.barEnd = total > 0 ? MIN(MAX(end / total, 0), 1) : 1;
+    [cell setNeedsLayout];
+
+    return cell;
+}
+
+@end
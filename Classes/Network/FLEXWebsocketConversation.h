@@ -0,0 +1,74 @@
+//
+//  FLEXWebsocketConversation.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FLEXWebsocketTransaction;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Every message sent or received on one \c NSURLSessionWebSocketTask.
+///
+/// Only the newest \c frameLimit frames are kept, in a ring, but the counters include every frame.
+/// Outgoing frames are indexed by the message that was sent until the send completes, so that
+/// completing a send doesn't have to search. Frames can be read a page at a time without copying
+/// the whole conversation. Frames are added from the recorder's queue; everything else is thread safe.
+API_AVAILABLE(ios(13.0))
+@interface FLEXWebsocketConversation : NSObject
+
++ (instancetype)conversationWithTask:(NSURLSessionWebSocketTask *)task frameLimit:(NSUInteger)frameLimit;
+
+/// \c nil once the task is deallocated
+@property (nonatomic, readonly, weak, nullable) NSURLSessionWebSocketTask *task;
+@property (nonatomic, readonly) NSUInteger taskIdentifier;
+@property (nonatomic, readonly, nullable) NSURL *URL;
+@property (nonatomic, readonly) NSDate *startTime;
+
+#pragma mark Frames
+
+/// The maximum number of frames to retain; the oldest are discarded first. Must be greater than 0.
+@property (nonatomic) NSUInteger frameLimit;
+/// The number of frames currently retained
+@property (nonatomic, readonly) NSUInteger frameCount;
+
+/// @param idx 0 is the newest frame
+- (nullable FLEXWebsocketTransaction *)frameAtIndex:(NSUInteger)idx;
+/// Newest first. The range is clamped to \c frameCount.
+- (NSArray<FLEXWebsocketTransaction *> *)framesInRange:(NSRange)range;
+
+/// Adds the frame as the newest in the conversation and updates the counters.
+/// @param message The message as it was passed to the task, which identifies an outgoing
+/// frame until \c completeSendOfMessage: is called or it is deallocated. It is not retained.
+/// Ignored for incoming frames.
+/// @return The oldest frame if it was evicted to make room for this one
+- (nullable FLEXWebsocketTransaction *)addFrame:(FLEXWebsocketTransaction *)frame
+                                 sentAsMessage:(nullable NSURLSessionWebSocketMessage *)message;
+/// Removes the outgoing frame of the message from the index.
+/// @return The frame, or \c nil if it was never added to this conversation.
+- (nullable FLEXWebsocketTransaction *)completeSendOfMessage:(NSURLSessionWebSocketMessage *)message;
+
+/// @return The frames that were removed
+- (NSArray<FLEXWebsocketTransaction *> *)removeFramesPassingTest:(BOOL(^)(FLEXWebsocketTransaction *frame))predicate;
+
+#pragma mark Counters
+
+/// These include frames that have since been evicted or removed
+@property (nonatomic, readonly) NSUInteger framesSent;
+@property (nonatomic, readonly) NSUInteger framesReceived;
+@property (nonatomic, readonly) int64_t bytesSent;
+@property (nonatomic, readonly) int64_t bytesReceived;
+/// Nil until the first frame
+@property (nonatomic, readonly, nullable) NSDate *lastFrameTime;
+
+/// Averaged over the last few seconds, in both directions
+@property (nonatomic, readonly) double framesPerSecond;
+@property (nonatomic, readonly) double bytesPerSecond;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,191 @@
+//
+//  FLEXWebsocketConversation.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXWebsocketConversation.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkTransactionStore.h"
+#import <os/lock.h>
+
+/// The rates are averaged over this many one-second buckets
+#define kFLEXWebsocketRateWindow 10
+
+@implementation FLEXWebsocketConversation {
+    os_unfair_lock _lock;
+    FLEXNetworkTransactionStore<FLEXWebsocketTransaction *> *_frames;
+    /// Messages by identity to their frames, until their send completes. Both sides are weak,
+    /// so a send that never completes doesn't keep its message payload or frame alive.
+    NSMapTable<NSURLSessionWebSocketMessage *, FLEXWebsocketTransaction *> *_pendingSends;
+
+    NSUInteger _framesSent;
+    NSUInteger _framesReceived;
+    int64_t _bytesSent;
+    int64_t _bytesReceived;
+    NSDate *_lastFrameTime;
+
+    /// The second since the reference date each bucket is counting
+    int64_t _bucketSeconds[kFLEXWebsocketRateWindow];
+    NSUInteger _bucketFrames[kFLEXWebsocketRateWindow];
+    int64_t _bucketBytes[kFLEXWebsocketRateWindow];
+}
+
++ (instancetype)conversationWithTask:(NSURLSessionWebSocketTask *)task frameLimit:(NSUInteger)frameLimit {
+    FLEXWebsocketConversation *conversation = [self new];
+    conversation->_lock = OS_UNFAIR_LOCK_INIT;
+    conversation->_task = task;
+    conversation->_taskIdentifier = task.taskIdentifier;
+    conversation->_URL = task.originalRequest.URL;
+    conversation->_startTime = NSDate.date;
+    conversation->_frames = [FLEXNetworkTransactionStore storeWithCapacity:frameLimit];
+    conversation->_pendingSends = [[NSMapTable alloc]
+        initWithKeyOptions:NSPointerFunctionsWeakMemory | NSPointerFunctionsObjectPointerPersonality
+        valueOptions:NSPointerFunctionsWeakMemory
+        capacity:0
+    ];
+    return conversation;
+}
+
+#pragma mark Frames
+
+- (NSUInteger)frameLimit {
+    return _frames.capacity;
+}
+
+- (void)setFrameLimit:(NSUInteger)frameLimit {
+    [_frames resize:frameLimit];
+}
+
+- (NSUInteger)frameCount {
+    return _frames.count;
+}
+
+- (FLEXWebsocketTransaction *)frameAtIndex:(NSUInteger)idx {
+    return [_frames objectAtIndex:idx];
+}
+
+- (NSArray<FLEXWebsocketTransaction *> *)framesInRange:(NSRange)range {
+    return [_frames objectsInRange:range];
+}
+
+- (FLEXWebsocketTransaction *)addFrame:(FLEXWebsocketTransaction *)frame
+                         sentAsMessage:(NSURLSessionWebSocketMessage *)message {
+    frame.conversation = self;
+    BOOL outgoing = frame.direction == FLEXWebsocketOutgoing;
+    int64_t length = frame.dataLength;
+    int64_t second = (int64_t)floor(frame.startTime.timeIntervalSinceReferenceDate);
+    NSUInteger bucket = (NSUInteger)(second % kFLEXWebsocketRateWindow);
+
+    os_unfair_lock_lock(&_lock);
+    if (outgoing) {
+        _framesSent++;
+        _bytesSent += length;
+        if (message) {
+            [_pendingSends setObject:frame forKey:message];
+        }
+    } else {
+        _framesReceived++;
+        _bytesReceived += length;
+    }
+
+    if (_bucketSeconds[bucket] != second) {
+        _bucketSeconds[bucket] = second;
+        _bucketFrames[bucket] = 0;
+        _bucketBytes[bucket] = 0;
+    }
+    _bucketFrames[bucket]++;
+    _bucketBytes[bucket] += length;
+    _lastFrameTime = frame.startTime;
+    os_unfair_lock_unlock(&_lock);
+
+    return [_frames push:frame];
+}
+
+- (FLEXWebsocketTransaction *)completeSendOfMessage:(NSURLSessionWebSocketMessage *)message {
+    os_unfair_lock_lock(&_lock);
+    FLEXWebsocketTransaction *frame = [_pendingSends objectForKey:message];
+    [_pendingSends removeObjectForKey:message];
+    os_unfair_lock_unlock(&_lock);
+
+    return frame;
+}
+
+- (NSArray<FLEXWebsocketTransaction *> *)removeFramesPassingTest:(BOOL (^)(FLEXWebsocketTransaction *))predicate {
+    return [_frames removeObjectsPassingTest:predicate];
+}
+
+#pragma mark Counters
+
+- (NSUInteger)framesSent {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _framesSent;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (NSUInteger)framesReceived {
+    os_unfair_lock_lock(&_lock);
+    NSUInteger count = _framesReceived;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+- (int64_t)bytesSent {
+    os_unfair_lock_lock(&_lock);
+    int64_t bytes = _bytesSent;
+    os_unfair_lock_unlock(&_lock);
+    return bytes;
+}
+
+- (int64_t)bytesReceived {
+    os_unfair_lock_lock(&_lock);
+    int64_t bytes = _bytesReceived;
+    os_unfair_lock_unlock(&_lock);
+    return bytes;
+}
+
+- (NSDate *)lastFrameTime {
+    os_unfair_lock_lock(&_lock);
+    NSDate *date = _lastFrameTime;
+    os_unfair_lock_unlock(&_lock);
+    return date;
+}
+
+- (double)framesPerSecond {
+    double frames = 0;
+    [self getRecentFrames:&frames bytes:NULL];
+    return frames;
+}
+
+- (double)bytesPerSecond {
+    double bytes = 0;
+    [self getRecentFrames:NULL bytes:&bytes];
+    return bytes;
+}
+
+/// Sums the buckets still inside the window and averages them over the part
+/// of the window the conversation has existed for, so a new conversation isn't underrated
+- (void)getRecentFrames:(double *)framesPerSecond bytes:(double *)bytesPerSecond {
+    NSTimeInterval now = NSDate.timeIntervalSinceReferenceDate;
+    int64_t second = (int64_t)floor(now);
+    NSTimeInterval elapsed = MIN(kFLEXWebsocketRateWindow, MAX(1, now - _startTime.timeIntervalSinceReferenceDate));
+
+    NSUInteger frames = 0;
+    int64_t bytes = 0;
+    os_unfair_lock_lock(&_lock);
+    for (NSUInteger i = 0; i < kFLEXWebsocketRateWindow; i++) {
+        if (_bucketSeconds[i] > second - kFLEXWebsocketRateWindow && _bucketSeconds[i] <= second) {
+            frames += _bucketFrames[i];
+            bytes += _bucketBytes[i];
+        }
+    }
+    os_unfair_lock_unlock(&_lock);
+
+    if (framesPerSecond) *framesPerSecond = frames / elapsed;
+    if (bytesPerSecond) *bytesPerSecond = bytes / elapsed;
+}
+
+@end
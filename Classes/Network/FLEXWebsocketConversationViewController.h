@@ -0,0 +1,27 @@
+//
+//  FLEXWebsocketConversationViewController.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXTableViewController.h"
+
+@class FLEXWebsocketConversation, FLEXWebsocketTransaction;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The counters and frames of one websocket task, newest frame first.
+/// Frames are fetched from the conversation a page at a time as they scroll into view.
+API_AVAILABLE(ios(13.0))
+@interface FLEXWebsocketConversationViewController : FLEXTableViewController
+
++ (instancetype)withConversation:(FLEXWebsocketConversation *)conversation;
+
+/// Shows the payload of the frame: an object explorer for data, or a web view for text
++ (UIViewController *)viewControllerForFrame:(FLEXWebsocketTransaction *)frame;
+
+@end
+
+NS_ASSUME_NONNULL_END
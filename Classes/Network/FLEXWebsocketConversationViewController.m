@@ -0,0 +1,206 @@
+//
+//  FLEXWebsocketConversationViewController.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXWebsocketConversationViewController.h"
+#import "FLEXWebsocketConversation.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkTransactionCell.h"
+#import "FLEXNetworkRecorder.h"
+#import "FLEXObjectExplorerFactory.h"
+#import "FLEXWebViewController.h"
+#import "FLEXTableViewCell.h"
+#import "FLEXColor.h"
+
+/// Frames are fetched from the conversation this many at a time
+static const NSUInteger kFLEXWebsocketConversationPageSize = 64;
+/// The counters and frames are refreshed at most this often while messages are coming in
+static const NSTimeInterval kFLEXWebsocketConversationRefreshInterval = 0.5;
+
+@interface FLEXWebsocketConversationViewController ()
+@property (nonatomic, readonly) FLEXWebsocketConversation *conversation;
+/// The number of frames the conversation retained as of the last reload
+@property (nonatomic) NSUInteger frameCount;
+/// How many frames had been recorded as of the last reload. Frames are indexed from the newest,
+/// so until the next reload, pages are fetched this far behind the frames recorded since.
+@property (nonatomic) NSUInteger framesRecorded;
+@property (nonatomic, readonly) NSMutableDictionary<NSNumber *, NSArray<FLEXWebsocketTransaction *> *> *pages;
+@property (nonatomic) BOOL refreshScheduled;
+@end
+
+@implementation FLEXWebsocketConversationViewController
+
++ (instancetype)withConversation:(FLEXWebsocketConversation *)conversation {
+    FLEXWebsocketConversationViewController *controller = [self new];
+    controller->_conversation = conversation;
+    controller->_pages = [NSMutableDictionary new];
+    controller.title = conversation.URL.host ?: @"Websocket";
+    return controller;
+}
+
++ (UIViewController *)viewControllerForFrame:(FLEXWebsocketTransaction *)frame {
+    if (frame.message.type == NSURLSessionWebSocketMessageTypeData) {
+        return [FLEXObjectExplorerFactory explorerViewControllerForObject:frame.message.data];
+    }
+
+    return [[FLEXWebViewController alloc] initWithText:frame.message.string];
+}
+
+- (id)init {
+    return [self initWithStyle:UITableViewStylePlain];
+}
+
+- (void)viewDidLoad {
+    [super viewDidLoad];
+
+    [self.tableView
+        registerClass:FLEXNetworkTransactionCell.class
+        forCellReuseIdentifier:FLEXNetworkTransactionCell.reuseID
+    ];
+
+    [NSNotificationCenter.defaultCenter addObserver:self
+        selector:@selector(handleTransactionsChangedNotification:)
+        name:kFLEXNetworkRecorderTransactionsChangedNotification
+        object:nil
+    ];
+    [NSNotificationCenter.defaultCenter addObserver:self
+        selector:@selector(handleTransactionsClearedNotification:)
+        name:kFLEXNetworkRecorderTransactionsClearedNotification
+        object:nil
+    ];
+
+    [self reloadFrames];
+}
+
+- (void)dealloc {
+    [NSNotificationCenter.defaultCenter removeObserver:self];
+}
+
+#pragma mark Frames
+
+- (void)reloadFrames {
+    FLEXWebsocketConversation *conversation = self.conversation;
+    self.framesRecorded = conversation.framesSent + conversation.framesReceived;
+    self.frameCount = conversation.frameCount;
+    [self.pages removeAllObjects];
+    [self.tableView reloadData];
+}
+
+- (FLEXWebsocketTransaction *)frameAtRow:(NSUInteger)row {
+    NSNumber *page = @(row / kFLEXWebsocketConversationPageSize);
+    NSArray<FLEXWebsocketTransaction *> *frames = self.pages[page];
+    if (!frames) {
+        NSUInteger recordedSince = self.conversation.framesSent + self.conversation.framesReceived - self.framesRecorded;
+        NSUInteger start = page.unsignedIntegerValue * kFLEXWebsocketConversationPageSize;
+        frames = [self.conversation framesInRange:NSMakeRange(start + recordedSince, kFLEXWebsocketConversationPageSize)];
+        self.pages[page] = frames;
+    }
+
+    NSUInteger idx = row % kFLEXWebsocketConversationPageSize;
+    // The oldest frames may have been evicted since the last reload
+    return idx < frames.count ? frames[idx] : nil;
+}
+
+- (void)handleTransactionsChangedNotification:(NSNotification *)notification {
+    if (self.refreshScheduled) {
+        return;
+    }
+
+    NSArray *inserted = notification.userInfo[kFLEXNetworkRecorderUserInfoInsertedTransactionsKey];
+    NSArray *updated = notification.userInfo[kFLEXNetworkRecorderUserInfoUpdatedTransactionsKey];
+    BOOL changed = NO;
+    for (FLEXNetworkTransaction *transaction in [inserted ?: @[] arrayByAddingObjectsFromArray:updated ?: @[]]) {
+        if ([transaction isKindOfClass:[FLEXWebsocketTransaction class]] &&
+            [(FLEXWebsocketTransaction *)transaction conversation] == self.conversation) {
+            changed = YES;
+            break;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    self.refreshScheduled = YES;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kFLEXWebsocketConversationRefreshInterval * NSEC_PER_SEC),
+        dispatch_get_main_queue(), ^{
+        self.refreshScheduled = NO;
+        [self reloadFrames];
+    });
+}
+
+- (void)handleTransactionsClearedNotification:(NSNotification *)notification {
+    [self reloadFrames];
+}
+
+#pragma mark Formatting
+
++ (NSString *)stringFromByteCount:(int64_t)bytes {
+    return [NSByteCountFormatter stringFromByteCount:bytes countStyle:NSByteCountFormatterCountStyleBinary];
+}
+
+- (NSString *)summary {
+    FLEXWebsocketConversation *conversation = self.conversation;
+    Class cls = [self class];
+    return [NSString stringWithFormat:@"↑ %@ frames · %@   ↓ %@ frames · %@\n%.1f frames/s · %@/s · %@ of %@ frames kept",
+        @(conversation.framesSent), [cls stringFromByteCount:conversation.bytesSent],
+        @(conversation.framesReceived), [cls stringFromByteCount:conversation.bytesReceived],
+        conversation.framesPerSecond, [cls stringFromByteCount:(int64_t)conversation.bytesPerSecond],
+        @(self.frameCount), @(conversation.frameLimit)
+    ];
+}
+
+#pragma mark Table View Data Source
+
+- (NSInteger)numberOfSectionsInTableView:(UITableView *)tableView {
+    return 2;
+}
+
+- (NSInteger)tableView:(UITableView *)tableView numberOfRowsInSection:(NSInteger)section {
+    return section == 0 ? 1 : self.frameCount;
+}
+
+- (CGFloat)tableView:(UITableView *)tableView heightForRowAtIndexPath:(NSIndexPath *)indexPath {
+    return indexPath.section == 0 ? UITableViewAutomaticDimension : FLEXNetworkTransactionCell.preferredCellHeight;
+}
+
+- (UITableViewCell *)tableView:(UITableView *)tableView cellForRowAtIndexPath:(NSIndexPath *)indexPath {
+    if (indexPath.section == 0) {
+        FLEXTableViewCell *cell = [tableView dequeueReusableCellWithIdentifier:kFLEXDetailCell forIndexPath:indexPath];
+        cell.titleLabel.text = self.conversation.URL.absoluteString;
+        cell.subtitleLabel.text = [self summary];
+        cell.subtitleLabel.numberOfLines = 2;
+        cell.selectionStyle = UITableViewCellSelectionStyleNone;
+        return cell;
+    }
+
+    FLEXNetworkTransactionCell *cell = [tableView
+        dequeueReusableCellWithIdentifier:FLEXNetworkTransactionCell.reuseID
+        forIndexPath:indexPath
+    ];
+    cell.transaction = [self frameAtRow:indexPath.row];
+
+    // Assign background colors bottom up, as in the network screen
+    if ((self.frameCount - indexPath.row) % 2 == 0) {
+        cell.backgroundColor = FLEXColor.secondaryBackgroundColor;
+    } else {
+        cell.backgroundColor = FLEXColor.primaryBackgroundColor;
+    }
+
+    return cell;
+}
+
+#pragma mark Table View Delegate
+
+- (void)tableView:(UITableView *)tableView didSelectRowAtIndexPath:(NSIndexPath *)indexPath {
+    FLEXWebsocketTransaction *frame = indexPath.section == 1 ? [self frameAtRow:indexPath.row] : nil;
+    if (frame) {
+        [self.navigationController pushViewController:[[self class] viewControllerForFrame:frame] animated:YES];
+    }
+}
+
+@end
@@ -11,6 +11,8 @@
 //
 //  https://github.com/nicklockwood/OSCache
 //
+//  Altered by the FLEX Team: adds the cache:willEvictObject:forKey: delegate method.
+//
 //  This software is provided 'as-is', without any express or implied
 //  warranty.  In no event will the authors be held liable for any damages
 //  arising from the use of this software.
@@ -51,6 +53,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)cache:(OSCache *)cache shouldEvictObject:(id)entry;
 - (void)cache:(OSCache *)cache willEvictObject:(id)entry;
+/// Like \c cache:willEvictObject: but also passes the key the object was stored under
+- (void)cache:(OSCache *)cache willEvictObject:(id)entry forKey:(id)key;
 
 @end
 
@@ -11,6 +11,10 @@
 //
 //  https://github.com/nicklockwood/OSCache
 //
+//  Altered by the FLEX Team: storage is now a set of independently locked
+//  shards, each an intrusive LRU list plus hash map, so that lookups, inserts and
+//  evictions are O(1) rather than a scan over every entry.
+//
 //  This software is provided 'as-is', without any express or implied
 //  warranty.  In no event will the authors be held liable for any damages
 //  arising from the use of this software.
@@ -35,6 +39,8 @@
 #if TARGET_OS_IPHONE
 #import <UIKit/UIKit.h>
 #endif
+#import <os/lock.h>
+#import <stdatomic.h>
 
 
 #import <Availability.h>
@@ -48,18 +54,83 @@
 #pragma GCC diagnostic ignored "-Wgnu"
 
 
-@interface OSCacheEntry : NSObject
+//number of independently locked partitions; must match OSCacheShardBits
+#define OSCacheShardCount 8
+#define OSCacheShardBits 3
 
-@property (nonatomic, strong) NSObject *object;
-@property (nonatomic, assign) NSUInteger cost;
-@property (nonatomic, assign) NSInteger sequenceNumber;
+//upper bound on the number of freed nodes each shard keeps for reuse
+#define OSCacheMaxPooledNodes 256
 
-@end
+//the cache whose delegate this thread is currently notifying of an eviction, if any
+static __thread const void *OSCacheNotifyingDelegate = NULL;
 
 
-@implementation OSCacheEntry
+typedef struct OSCacheNode
+{
+    struct OSCacheNode *prev; //more recently used
+    struct OSCacheNode *next; //less recently used
+    CFTypeRef key;
+    CFTypeRef object;
+    NSUInteger cost;
+    uint64_t sequenceNumber;
+} OSCacheNode;
+
+typedef struct
+{
+    os_unfair_lock lock;
+    CFMutableDictionaryRef map; //key -> OSCacheNode *
+    OSCacheNode *head; //most recently used
+    OSCacheNode *tail; //least recently used
+    OSCacheNode *pool; //freed nodes, linked through next
+    NSUInteger pooledCount;
+} OSCacheShard;
 
-@end
+
+static inline void OSCacheUnlinkNode(OSCacheShard *shard, OSCacheNode *node)
+{
+    if (node->prev) node->prev->next = node->next; else shard->head = node->next;
+    if (node->next) node->next->prev = node->prev; else shard->tail = node->prev;
+    node->prev = node->next = NULL;
+}
+
+static inline void OSCacheInsertNodeAtHead(OSCacheShard *shard, OSCacheNode *node)
+{
+    node->prev = NULL;
+    node->next = shard->head;
+    if (shard->head) shard->head->prev = node; else shard->tail = node;
+    shard->head = node;
+}
+
+static inline OSCacheNode *OSCacheDequeueNode(OSCacheShard *shard)
+{
+    OSCacheNode *node = shard->pool;
+    if (node)
+    {
+        shard->pool = node->next;
+        shard->pooledCount--;
+        memset(node, 0, sizeof(OSCacheNode));
+        return node;
+    }
+    return calloc(1, sizeof(OSCacheNode));
+}
+
+static inline void OSCacheRecycleNode(OSCacheShard *shard, OSCacheNode *node)
+{
+    CFRelease(node->key);
+    CFRelease(node->object);
+    node->key = node->object = NULL;
+    if (shard->pooledCount < OSCacheMaxPooledNodes)
+    {
+        node->prev = NULL;
+        node->next = shard->pool;
+        shard->pool = node;
+        shard->pooledCount++;
+    }
+    else
+    {
+        free(node);
+    }
+}
 
 
 @interface OSCache_Private : NSObject
@@ -69,20 +140,18 @@
 @property (nonatomic, assign) NSUInteger totalCostLimit;
 @property (nonatomic, copy) NSString *name;
 
-@property (nonatomic, strong) NSMutableDictionary *cache;
-@property (nonatomic, assign) NSUInteger totalCost;
-@property (nonatomic, assign) NSInteger sequenceNumber;
-
 @end
 
 
 @implementation OSCache_Private
 {
     BOOL _delegateRespondsToWillEvictObject;
+    BOOL _delegateRespondsToWillEvictObjectForKey;
     BOOL _delegateRespondsToShouldEvictObject;
-    BOOL _currentlyCleaning;
-    NSMutableArray *_entryPool;
-    NSLock *_lock;
+    OSCacheShard _shards[OSCacheShardCount];
+    _Atomic(NSUInteger) _count;
+    _Atomic(NSUInteger) _totalCost;
+    _Atomic(uint64_t) _sequenceNumber;
 }
 
 - (instancetype)init
@@ -90,10 +159,11 @@
     if ((self = [super init]))
     {
         //create storage
-        _cache = [[NSMutableDictionary alloc] init];
-        _entryPool = [[NSMutableArray alloc] init];
-        _lock = [[NSLock alloc] init];
-        _totalCost = 0;
+        for (NSUInteger i = 0; i < OSCacheShardCount; i++)
+        {
+            _shards[i].lock = OS_UNFAIR_LOCK_INIT;
+            _shards[i].map = CFDictionaryCreateMutable(NULL, 0, &kCFTypeDictionaryKeyCallBacks, NULL);
+        }
         
 #if TARGET_OS_IPHONE
         
@@ -109,6 +179,24 @@
 - (void)dealloc
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+    
+    for (NSUInteger i = 0; i < OSCacheShardCount; i++)
+    {
+        OSCacheShard *shard = &_shards[i];
+        for (OSCacheNode *node = shard->head, *next; node; node = next)
+        {
+            next = node->next;
+            CFRelease(node->key);
+            CFRelease(node->object);
+            free(node);
+        }
+        for (OSCacheNode *node = shard->pool, *next; node; node = next)
+        {
+            next = node->next;
+            free(node);
+        }
+        CFRelease(shard->map);
+    }
 }
 
 - (void)setDelegate:(id<OSCacheDelegate>)delegate
@@ -116,148 +204,254 @@
     _delegate = delegate;
     _delegateRespondsToShouldEvictObject = [delegate respondsToSelector:@selector(cache:shouldEvictObject:)];
     _delegateRespondsToWillEvictObject = [delegate respondsToSelector:@selector(cache:willEvictObject:)];
+    _delegateRespondsToWillEvictObjectForKey = [delegate respondsToSelector:@selector(cache:willEvictObject:forKey:)];
 }
 
 - (void)setCountLimit:(NSUInteger)countLimit
 {
-    [_lock lock];
     _countLimit = countLimit;
-    [_lock unlock];
-    [self cleanUp:NO];
+    [self cleanUp];
 }
 
 - (void)setTotalCostLimit:(NSUInteger)totalCostLimit
 {
-    [_lock lock];
     _totalCostLimit = totalCostLimit;
-    [_lock unlock];
-    [self cleanUp:NO];
+    [self cleanUp];
 }
 
 - (NSUInteger)count
 {
-    return [_cache count];
+    return atomic_load_explicit(&_count, memory_order_relaxed);
 }
 
-- (void)cleanUp:(BOOL)keepEntries
+- (NSUInteger)totalCost
 {
-    [_lock lock];
-    NSUInteger maxCount = _countLimit ?: INT_MAX;
-    NSUInteger maxCost = _totalCostLimit ?: INT_MAX;
-    NSUInteger totalCount = _cache.count;
-    NSMutableArray *keys = [_cache.allKeys mutableCopy];
-    while (totalCount > maxCount || _totalCost > maxCost)
+    return atomic_load_explicit(&_totalCost, memory_order_relaxed);
+}
+
+#pragma mark Shards
+
+- (OSCacheShard *)shardForKey:(id)key
+{
+    //fibonacci hashing spreads poorly distributed hashes (eg. small integers) across shards
+    uint64_t hash = (uint64_t)[key hash] * 11400714819323198485ull;
+    return &_shards[hash >> (64 - OSCacheShardBits)];
+}
+
+- (uint64_t)nextSequenceNumber
+{
+    return atomic_fetch_add_explicit(&_sequenceNumber, 1, memory_order_relaxed);
+}
+
+//caller must hold the shard's lock
+- (void)touchNode:(OSCacheNode *)node inShard:(OSCacheShard *)shard
+{
+    node->sequenceNumber = [self nextSequenceNumber];
+    if (shard->head != node)
     {
-        NSInteger lowestSequenceNumber = INT_MAX;
-        OSCacheEntry *lowestEntry = nil;
-        id lowestKey = nil;
+        OSCacheUnlinkNode(shard, node);
+        OSCacheInsertNodeAtHead(shard, node);
+    }
+}
+
+//caller must hold the shard's lock
+- (void)removeNode:(OSCacheNode *)node fromShard:(OSCacheShard *)shard
+{
+    OSCacheUnlinkNode(shard, node);
+    CFDictionaryRemoveValue(shard->map, node->key);
+    atomic_fetch_sub_explicit(&_count, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&_totalCost, node->cost, memory_order_relaxed);
+    OSCacheRecycleNode(shard, node);
+}
 
-        //remove oldest items until within limit
-        for (id key in keys)
+//each shard is ordered, so the globally least recently used entry is one of the tails
+- (OSCacheShard *)shardWithOldestEntry
+{
+    OSCacheShard *oldest = NULL;
+    uint64_t lowestSequenceNumber = UINT64_MAX;
+    for (NSUInteger i = 0; i < OSCacheShardCount; i++)
+    {
+        OSCacheShard *shard = &_shards[i];
+        os_unfair_lock_lock(&shard->lock);
+        if (shard->tail && shard->tail->sequenceNumber < lowestSequenceNumber)
         {
-            OSCacheEntry *entry = _cache[key];
-            if (entry.sequenceNumber < lowestSequenceNumber)
-            {
-                lowestSequenceNumber = entry.sequenceNumber;
-                lowestEntry = entry;
-                lowestKey = key;
-            }
+            lowestSequenceNumber = shard->tail->sequenceNumber;
+            oldest = shard;
         }
+        os_unfair_lock_unlock(&shard->lock);
+    }
+    return oldest;
+}
+
+#pragma mark Eviction
+
+- (void)notifyWillEvictObject:(id)object forKey:(id)key
+{
+    //other threads may still modify the cache while this one is in the delegate,
+    //so the reentrancy guard is per thread; a delegate may modify other caches
+    const void *previous = OSCacheNotifyingDelegate;
+    OSCacheNotifyingDelegate = (__bridge const void *)self;
+    if (_delegateRespondsToWillEvictObject)
+    {
+        [_delegate cache:(OSCache *)self willEvictObject:object];
+    }
+    if (_delegateRespondsToWillEvictObjectForKey)
+    {
+        [_delegate cache:(OSCache *)self willEvictObject:object forKey:key];
+    }
+    OSCacheNotifyingDelegate = previous;
+}
+
+//removes the entry for key if it still holds object, which it may not
+//after the shard was unlocked to ask the delegate; returns YES if removed
+- (BOOL)removeObject:(id)object forKey:(id)key
+{
+    OSCacheShard *shard = [self shardForKey:key];
+    os_unfair_lock_lock(&shard->lock);
+    OSCacheNode *node = (OSCacheNode *)CFDictionaryGetValue(shard->map, (__bridge CFTypeRef)key);
+    BOOL removed = node && node->object == (__bridge CFTypeRef)object;
+    if (removed)
+    {
+        [self removeNode:node fromShard:shard];
+    }
+    os_unfair_lock_unlock(&shard->lock);
+    return removed;
+}
 
-        if (lowestKey)
+- (void)cleanUp
+{
+    NSUInteger maxCount = _countLimit ?: NSUIntegerMax;
+    NSUInteger maxCost = _totalCostLimit ?: NSUIntegerMax;
+    
+    //every entry the delegate refuses to evict is moved to the front, so
+    //after this many attempts we have offered up everything at least once
+    NSUInteger remainingAttempts = self.count;
+    while ((self.count > maxCount || self.totalCost > maxCost) && remainingAttempts-- > 0)
+    {
+        OSCacheShard *shard = [self shardWithOldestEntry];
+        if (!shard)
         {
-            [keys removeObject:lowestKey];
-            if (!_delegateRespondsToShouldEvictObject ||
-                [_delegate cache:(OSCache *)self shouldEvictObject:lowestEntry.object])
+            break;
+        }
+        
+        os_unfair_lock_lock(&shard->lock);
+        OSCacheNode *node = shard->tail;
+        if (!node)
+        {
+            //emptied by another thread in the meantime
+            os_unfair_lock_unlock(&shard->lock);
+            continue;
+        }
+        id key = (__bridge id)node->key;
+        id object = (__bridge id)node->object;
+        os_unfair_lock_unlock(&shard->lock);
+        
+        //the delegate is asked without the lock held, so that it may use the cache
+        if (_delegateRespondsToShouldEvictObject &&
+            ![_delegate cache:(OSCache *)self shouldEvictObject:object])
+        {
+            os_unfair_lock_lock(&shard->lock);
+            node = (OSCacheNode *)CFDictionaryGetValue(shard->map, (__bridge CFTypeRef)key);
+            if (node && node->object == (__bridge CFTypeRef)object)
             {
-                if (_delegateRespondsToWillEvictObject)
-                {
-                    _currentlyCleaning = YES;
-                    [self.delegate cache:(OSCache *)self willEvictObject:lowestEntry.object];
-                    _currentlyCleaning = NO;
-                }
-                [_cache removeObjectForKey:lowestKey];
-                _totalCost -= lowestEntry.cost;
-                totalCount --;
-                if (keepEntries)
-                {
-                    [_entryPool addObject:lowestEntry];
-                    lowestEntry.object = nil;
-                }
+                [self touchNode:node inShard:shard];
             }
+            os_unfair_lock_unlock(&shard->lock);
+            continue;
+        }
+        
+        if ([self removeObject:object forKey:key] &&
+            (_delegateRespondsToWillEvictObject || _delegateRespondsToWillEvictObjectForKey))
+        {
+            [self notifyWillEvictObject:object forKey:key];
         }
     }
-    [_lock unlock];
 }
 
 - (void)cleanUpAllObjects
 {
-    [_lock lock];
-    if (_delegateRespondsToShouldEvictObject || _delegateRespondsToWillEvictObject)
+    if (!(_delegateRespondsToShouldEvictObject || _delegateRespondsToWillEvictObject || _delegateRespondsToWillEvictObjectForKey))
     {
-        NSArray *keys = [_cache allKeys];
-        if (_delegateRespondsToShouldEvictObject)
-        {
-            //sort, oldest first (in case we want to use that information in our eviction test)
-            keys = [keys sortedArrayUsingComparator:^NSComparisonResult(id key1, id key2) {
-                OSCacheEntry *entry1 = self->_cache[key1];
-                OSCacheEntry *entry2 = self->_cache[key2];
-                return (NSComparisonResult)MIN(1, MAX(-1, entry1.sequenceNumber - entry2.sequenceNumber));
-            }];
-        }
-            
-        //remove all items individually
-        for (id key in keys)
+        [self removeAllObjects];
+        return;
+    }
+    
+    NSMutableArray *candidateKeys = [NSMutableArray array];
+    NSMutableArray *candidateObjects = [NSMutableArray array];
+    
+    //lock every shard (always in the same order) and merge their
+    //lists from the tail, so entries are offered up oldest first
+    OSCacheNode *cursors[OSCacheShardCount];
+    for (NSUInteger i = 0; i < OSCacheShardCount; i++)
+    {
+        os_unfair_lock_lock(&_shards[i].lock);
+        cursors[i] = _shards[i].tail;
+    }
+    
+    while (YES)
+    {
+        NSInteger oldest = -1;
+        for (NSUInteger i = 0; i < OSCacheShardCount; i++)
         {
-            OSCacheEntry *entry = _cache[key];
-            if (!_delegateRespondsToShouldEvictObject || [_delegate cache:(OSCache *)self shouldEvictObject:entry.object])
+            if (cursors[i] && (oldest < 0 || cursors[i]->sequenceNumber < cursors[oldest]->sequenceNumber))
             {
-                if (_delegateRespondsToWillEvictObject)
-                {
-                    _currentlyCleaning = YES;
-                    [_delegate cache:(OSCache *)self willEvictObject:entry.object];
-                    _currentlyCleaning = NO;
-                }
-                [_cache removeObjectForKey:key];
-                _totalCost -= entry.cost;
+                oldest = i;
             }
         }
+        if (oldest < 0)
+        {
+            break;
+        }
+        
+        OSCacheNode *node = cursors[oldest];
+        cursors[oldest] = node->prev;
+        [candidateKeys addObject:(__bridge id)node->key];
+        [candidateObjects addObject:(__bridge id)node->object];
     }
-    else
+    
+    for (NSUInteger i = OSCacheShardCount; i > 0; i--)
     {
-        _totalCost = 0;
-        [_cache removeAllObjects];
-        _sequenceNumber = 0;
+        os_unfair_lock_unlock(&_shards[i - 1].lock);
     }
-    [_lock unlock];
-}
-
-- (void)resequence
-{
-    //sort, oldest first
-    NSArray *entries = [[_cache allValues] sortedArrayUsingComparator:^NSComparisonResult(OSCacheEntry *entry1, OSCacheEntry *entry2) {
-        return (NSComparisonResult)MIN(1, MAX(-1, entry1.sequenceNumber - entry2.sequenceNumber));
-    }];
     
-    //renumber items
-    NSInteger index = 0;
-    for (OSCacheEntry *entry in entries)
+    //the delegate is asked without any lock held, so that it may use the cache,
+    //and entries changed in the meantime are left alone
+    for (NSUInteger i = 0; i < candidateKeys.count; i++)
     {
-        entry.sequenceNumber = index++;
+        id key = candidateKeys[i];
+        id object = candidateObjects[i];
+        if (_delegateRespondsToShouldEvictObject && ![_delegate cache:(OSCache *)self shouldEvictObject:object])
+        {
+            continue;
+        }
+        
+        if ([self removeObject:object forKey:key] &&
+            (_delegateRespondsToWillEvictObject || _delegateRespondsToWillEvictObjectForKey))
+        {
+            [self notifyWillEvictObject:object forKey:key];
+        }
     }
 }
 
+#pragma mark Access
+
 - (id)objectForKey:(id)key
 {
-    [_lock lock];
-    OSCacheEntry *entry = _cache[key];
-    entry.sequenceNumber = _sequenceNumber++;
-    if (_sequenceNumber < 0)
+    if (!key)
     {
-        [self resequence];
+        return nil;
     }
-    id object = entry.object;
-    [_lock unlock];
+    
+    OSCacheShard *shard = [self shardForKey:key];
+    os_unfair_lock_lock(&shard->lock);
+    OSCacheNode *node = (OSCacheNode *)CFDictionaryGetValue(shard->map, (__bridge CFTypeRef)key);
+    id object = nil;
+    if (node)
+    {
+        [self touchNode:node inShard:shard];
+        object = (__bridge id)node->object;
+    }
+    os_unfair_lock_unlock(&shard->lock);
     return object;
 }
 
@@ -283,75 +477,123 @@
         [self removeObjectForKey:key];
         return;
     }
-    NSAssert(!_currentlyCleaning, @"It is not possible to modify cache from within the implementation of this delegate method.");
-    [_lock lock];
-    _totalCost -= [_cache[key] cost];
-    _totalCost += g;
-    OSCacheEntry *entry = _cache[key];
-    if (!entry) {
-        entry = [[OSCacheEntry alloc] init];
-        _cache[key] = entry;
+    NSAssert(OSCacheNotifyingDelegate != (__bridge const void *)self, @"It is not possible to modify cache from within the implementation of this delegate method.");
+    
+    OSCacheShard *shard = [self shardForKey:key];
+    os_unfair_lock_lock(&shard->lock);
+    OSCacheNode *node = (OSCacheNode *)CFDictionaryGetValue(shard->map, (__bridge CFTypeRef)key);
+    if (node)
+    {
+        CFRelease(node->object);
+        atomic_fetch_sub_explicit(&_totalCost, node->cost, memory_order_relaxed);
     }
-    entry.object = obj;
-    entry.cost = g;
-    entry.sequenceNumber = _sequenceNumber++;
-    if (_sequenceNumber < 0)
+    else
     {
-        [self resequence];
+        //copy the key like NSMutableDictionary did, so later mutation can't corrupt the map
+        id copiedKey = [key copyWithZone:nil];
+        node = OSCacheDequeueNode(shard);
+        node->key = CFBridgingRetain(copiedKey);
+        CFDictionarySetValue(shard->map, node->key, node);
+        atomic_fetch_add_explicit(&_count, 1, memory_order_relaxed);
     }
-    [_lock unlock];
-    [self cleanUp:YES];
+    node->object = CFBridgingRetain(obj);
+    node->cost = g;
+    atomic_fetch_add_explicit(&_totalCost, g, memory_order_relaxed);
+    [self touchNode:node inShard:shard];
+    os_unfair_lock_unlock(&shard->lock);
+    
+    [self cleanUp];
 }
 
 - (void)removeObjectForKey:(id)key
 {
-    NSAssert(!_currentlyCleaning, @"It is not possible to modify cache from within the implementation of this delegate method.");
-    [_lock lock];
-    OSCacheEntry *entry = _cache[key];
-    if (entry) {
-        _totalCost -= entry.cost;
-        entry.object = nil;
-        [_entryPool addObject:entry];
-        [_cache removeObjectForKey:key];
+    NSAssert(OSCacheNotifyingDelegate != (__bridge const void *)self, @"It is not possible to modify cache from within the implementation of this delegate method.");
+    if (!key)
+    {
+        return;
+    }
+    
+    OSCacheShard *shard = [self shardForKey:key];
+    os_unfair_lock_lock(&shard->lock);
+    OSCacheNode *node = (OSCacheNode *)CFDictionaryGetValue(shard->map, (__bridge CFTypeRef)key);
+    if (node)
+    {
+        [self removeNode:node fromShard:shard];
     }
-    [_lock unlock];
+    os_unfair_lock_unlock(&shard->lock);
 }
 
 - (void)removeAllObjects
 {
-    NSAssert(!_currentlyCleaning, @"It is not possible to modify cache from within the implementation of this delegate method.");
-    [_lock lock];
-    _totalCost = 0;
-    _sequenceNumber = 0;
-    for (OSCacheEntry *entry in _cache.allValues)
+    NSAssert(OSCacheNotifyingDelegate != (__bridge const void *)self, @"It is not possible to modify cache from within the implementation of this delegate method.");
+    for (NSUInteger i = 0; i < OSCacheShardCount; i++)
     {
-        entry.object = nil;
-        [_entryPool addObject:entry];
+        OSCacheShard *shard = &_shards[i];
+        os_unfair_lock_lock(&shard->lock);
+        while (shard->head)
+        {
+            [self removeNode:shard->head fromShard:shard];
+        }
+        os_unfair_lock_unlock(&shard->lock);
+    }
+}
+
+#pragma mark Enumeration
+
+//most recently used first within each shard
+- (void)getKeys:(NSMutableArray *)keys objects:(NSMutableArray *)objects
+{
+    for (NSUInteger i = 0; i < OSCacheShardCount; i++)
+    {
+        OSCacheShard *shard = &_shards[i];
+        os_unfair_lock_lock(&shard->lock);
+        for (OSCacheNode *node = shard->head; node; node = node->next)
+        {
+            [keys addObject:(__bridge id)node->key];
+            [objects addObject:(__bridge id)node->object];
+        }
+        os_unfair_lock_unlock(&shard->lock);
     }
-    [_cache removeAllObjects];
-    [_lock unlock];
 }
 
 - (NSUInteger)countByEnumeratingWithState:(NSFastEnumerationState *)state
                                   objects:(id __unsafe_unretained [])buffer
                                     count:(NSUInteger)len
 {
-    [_lock lock];
-    NSUInteger count = [_cache countByEnumeratingWithState:state objects:buffer count:len];
-    [_lock unlock];
+    //enumerate a snapshot of the keys, which lives as long as the enclosing autorelease pool
+    if (state->state == 0)
+    {
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:self.count];
+        [self getKeys:keys objects:nil];
+        state->extra[0] = (unsigned long)CFAutorelease(CFBridgingRetain(keys));
+        state->mutationsPtr = &state->extra[1];
+        state->state = 1;
+    }
+    
+    NSArray *keys = (__bridge NSArray *)(CFTypeRef)state->extra[0];
+    NSUInteger index = state->state - 1;
+    NSUInteger count = MIN(len, keys.count - index);
+    [keys getObjects:buffer range:NSMakeRange(index, count)];
+    state->itemsPtr = buffer;
+    state->state += count;
     return count;
 }
 
 - (void)enumerateKeysAndObjectsUsingBlock:(void (^)(id key, id obj, BOOL *stop))block
 {
-  if (block)
-  {
-      [_lock lock];
-      [_cache enumerateKeysAndObjectsUsingBlock:^(id key, OSCacheEntry *entry, BOOL *stop) {
-         block(key, entry.object, stop);
-      }];
-      [_lock unlock];
-  }
+    if (block)
+    {
+        //call the block outside of the locks so that it may access the cache
+        NSMutableArray *keys = [NSMutableArray arrayWithCapacity:self.count];
+        NSMutableArray *objects = [NSMutableArray arrayWithCapacity:self.count];
+        [self getKeys:keys objects:objects];
+        
+        BOOL stop = NO;
+        for (NSUInteger i = 0; i < keys.count && !stop; i++)
+        {
+            block(keys[i], objects[i], &stop);
+        }
+    }
 }
 
 //handle unimplemented methods
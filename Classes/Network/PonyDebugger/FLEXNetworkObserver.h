@@ -15,6 +15,9 @@
 #import <Foundation/Foundation.h>
 
 FOUNDATION_EXTERN NSString *const kFLEXNetworkObserverEnabledStateChangedNotification;
+/// Tasks whose request has this \c NSURLProtocol property, with any value, are not recorded.
+/// FLEX sets it on the requests it sends itself, like the ones \c FLEXNetworkReplayer replays.
+FOUNDATION_EXTERN NSString *const kFLEXNetworkObserverIgnoredRequestKey;
 
 /// This class swizzles NSURLConnection and NSURLSession delegate methods to observe events in the URL loading system.
 /// High level network events are sent to the default FLEXNetworkRecorder instance which maintains the request history and caches response bodies.
@@ -17,6 +17,7 @@
 
 #import "FLEXNetworkObserver.h"
 #import "FLEXNetworkRecorder.h"
+#import "FLEXNetworkBodyAccumulator.h"
 #import "FLEXUtility.h"
 #import "NSUserDefaults+FLEX.h"
 #import "NSObject+FLEX_Reflection.h"
@@ -27,9 +28,11 @@
 #import <objc/runtime.h>
 #import <objc/message.h>
 #import <dispatch/queue.h>
+#include <stdatomic.h>
 #include <dlfcn.h>
 
 NSString *const kFLEXNetworkObserverEnabledStateChangedNotification = @"kFLEXNetworkObserverEnabledStateChangedNotification";
+NSString *const kFLEXNetworkObserverIgnoredRequestKey = @"com.flex.FLEXNetworkObserver.ignored";
 
 typedef void (^NSURLSessionAsyncCompletion)(id fileURLOrData, NSURLResponse *response, NSError *error);
 typedef NSURLSessionTask * (^NSURLSessionNewTaskMethod)(NSURLSession *, id, NSURLSessionAsyncCompletion);
@@ -37,12 +40,21 @@ typedef NSURLSessionTask * (^NSURLSessionNewTaskMethod)(NSURLSession *, id, NSUR
 @interface FLEXInternalRequestState : NSObject
 
 @property (nonatomic, copy) NSURLRequest *request;
-@property (nonatomic) NSMutableData *dataAccumulator;
+@property (nonatomic) FLEXNetworkBodyAccumulator *dataAccumulator;
+
+/// Replaces the accumulator with an empty one, capped at what the recorder can cache
+- (void)resetDataAccumulator;
 
 @end
 
 @implementation FLEXInternalRequestState
 
+- (void)resetDataAccumulator {
+    self.dataAccumulator = [FLEXNetworkBodyAccumulator
+        accumulatorWithCaptureLimit:FLEXNetworkRecorder.defaultRecorder.responseBodyCaptureLimit
+    ];
+}
+
 @end
 
 @interface FLEXNetworkObserver (NSURLConnectionHelpers)
@@ -68,6 +80,7 @@ typedef NSURLSessionTask * (^NSURLSessionNewTaskMethod)(NSURLSession *, id, NSUR
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask
 didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask delegate:(id<NSURLSessionDelegate>)delegate;
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error delegate:(id<NSURLSessionDelegate>)delegate;
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics delegate:(id<NSURLSessionDelegate>)delegate;
 - (void)URLSession:(NSURLSession *)session downloadTask:(NSURLSessionDownloadTask *)downloadTask didWriteData:(int64_t)bytesWritten totalBytesWritten:(int64_t)totalBytesWritten totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite delegate:(id<NSURLSessionDelegate>)delegate;
 - (void)URLSession:(NSURLSession *)session task:(NSURLSessionDownloadTask *)downloadTask didFinishDownloadingToURL:(NSURL *)location data:(NSData *)data delegate:(id<NSURLSessionDelegate>)delegate;
 
@@ -75,8 +88,9 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask delegate:(id<NSUR
 
 - (void)websocketTask:(NSURLSessionWebSocketTask *)task
         sendMessagage:(NSURLSessionWebSocketMessage *)message API_AVAILABLE(ios(13.0));
-- (void)websocketTaskMessageSendCompletion:(NSURLSessionWebSocketMessage *)message
-                                     error:(NSError *)error API_AVAILABLE(ios(13.0));
+- (void)websocketTask:(NSURLSessionWebSocketTask *)task
+messageSendCompletion:(NSURLSessionWebSocketMessage *)message
+                error:(NSError *)error API_AVAILABLE(ios(13.0));
 
 - (void)websocketTask:(NSURLSessionWebSocketTask *)task
      receiveMessagage:(NSURLSessionWebSocketMessage *)message
@@ -84,14 +98,17 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask delegate:(id<NSUR
 
 @end
 
-@interface FLEXNetworkObserver ()
+/// The observer is the task delegate of tasks with completion handlers, so that their metrics are collected too
+@interface FLEXNetworkObserver () <NSURLSessionTaskDelegate>
 
-@property (nonatomic) NSMutableDictionary<NSString *, FLEXInternalRequestState *> *requestStatesForRequestIDs;
 @property (nonatomic) dispatch_queue_t queue;
 
 @end
 
-@implementation FLEXNetworkObserver
+@implementation FLEXNetworkObserver {
+    /// Request ID to FLEXInternalRequestState. Only accessed on the queue.
+    CFMutableDictionaryRef _requestStatesByRequestID;
+}
 
 #pragma mark - Public Methods
 
@@ -138,8 +155,9 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask delegate:(id<NSUR
     return sharedObserver;
 }
 
-+ (NSString *)nextRequestID {
-    return NSUUID.UUID.UUIDString;
++ (FLEXNetworkRequestID)nextRequestID {
+    static _Atomic(FLEXNetworkRequestID) lastRequestID = 0;
+    return atomic_fetch_add_explicit(&lastRequestID, 1, memory_order_relaxed) + 1;
 }
 
 #pragma mark Delegate Injection Convenience Methods
@@ -230,7 +248,7 @@ static void _logos_method$_ungrouped$FIRDocumentReference$getDocumentWithComplet
     _LOGOS_SELF_TYPE_NORMAL FIRDocumentReference * _LOGOS_SELF_CONST self, SEL _cmd, FIRDocumentSnapshotBlock completion) {
     
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder recordFIRDocumentWillFetch:self withTransactionID:requestID];
@@ -251,7 +269,7 @@ static void _logos_method$_ungrouped$FIRQuery$getDocumentsWithCompletion$(
     _LOGOS_SELF_TYPE_NORMAL FIRQuery * _LOGOS_SELF_CONST self, SEL _cmd, FIRQuerySnapshotBlock completion) {
     
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder recordFIRQueryWillFetch:self withTransactionID:requestID];
@@ -275,7 +293,7 @@ static void _logos_method$_ungrouped$FIRDocumentReference$setData$merge$completi
     SEL __unused _cmd, NSDictionary<NSString *, id> * documentData, BOOL merge, void (^completion)(NSError *)) {
 
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder
@@ -305,7 +323,7 @@ static void _logos_method$_ungrouped$FIRDocumentReference$setData$mergeFields$co
     NSArray * mergeFields, void (^completion)(NSError *)) {
 
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder
@@ -334,7 +352,7 @@ static void _logos_method$_ungrouped$FIRDocumentReference$updateData$completion$
     SEL __unused _cmd, NSDictionary<id, id> * fields, void (^completion)(NSError *)) {
 
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder recordFIRWillUpdateData:self fields:fields transactionID:requestID];
@@ -356,7 +374,7 @@ static void _logos_method$_ungrouped$FIRDocumentReference$deleteDocumentWithComp
     SEL __unused _cmd, void (^completion)(NSError *)) {
 
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
     
     // Record transaction start
     [FLEXNetworkRecorder.defaultRecorder recordFIRWillDeleteDocument:self transactionID:requestID];
@@ -378,7 +396,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
     SEL __unused _cmd, NSDictionary<NSString *, id> * data, void (^completion)(NSError *error)) {
 
     // Generate transaction ID
-    NSString *requestID = [FLEXNetworkObserver nextRequestID];
+    FLEXNetworkRequestID requestID = [FLEXNetworkObserver nextRequestID];
 
     // Hook callback
     void (^orig)(NSError *) = completion;
@@ -480,6 +498,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
             @selector(URLSession:dataTask:didReceiveData:),
             @selector(URLSession:dataTask:didReceiveResponse:completionHandler:),
             @selector(URLSession:task:didCompleteWithError:),
+            @selector(URLSession:task:didFinishCollectingMetrics:),
             @selector(URLSession:dataTask:didBecomeDownloadTask:),
             @selector(URLSession:downloadTask:didWriteData:totalBytesWritten:totalBytesExpectedToWrite:),
             @selector(URLSession:downloadTask:didFinishDownloadingToURL:)
@@ -493,11 +512,14 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
         unsigned int numClasses = 0;
         Class *classes = objc_copyClassList(&numClasses);
 
+        // Replays are not recorded, and their delegate records nothing
+        Class replayRunClass = objc_lookUpClass("FLEXNetworkReplayRun");
+
         if (numClasses > 0 && classes != NULL) {
             for (unsigned int classIndex = 0; classIndex < numClasses; ++classIndex) {
                 Class class = classes[classIndex];
 
-                if (class == NULL || class == [FLEXNetworkObserver class]) {
+                if (class == NULL || class == [FLEXNetworkObserver class] || class == replayRunClass) {
                     continue;
                 }
 
@@ -585,6 +607,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
     [self injectTaskDidReceiveDataIntoDelegateClass:cls];
     [self injectTaskDidReceiveResponseIntoDelegateClass:cls];
     [self injectTaskDidCompleteWithErrorIntoDelegateClass:cls];
+    [self injectTaskDidFinishCollectingMetricsIntoDelegateClass:cls];
     [self injectRespondsToSelectorIntoDelegateClass:cls];
 
     // Data tasks
@@ -727,7 +750,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                                                NSOperationQueue *queue,
                                                AsyncCompletion completion) {
             if (FLEXNetworkObserver.isEnabled) {
-                NSString *requestID = [self nextRequestID];
+                FLEXNetworkRequestID requestID = [self nextRequestID];
                 [FLEXNetworkRecorder.defaultRecorder
                      recordRequestWillBeSentWithRequestID:requestID
                      request:request
@@ -793,7 +816,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                                                  NSError **error) {
             NSData *data = nil;
             if (FLEXNetworkObserver.isEnabled) {
-                NSString *requestID = [self nextRequestID];
+                FLEXNetworkRequestID requestID = [self nextRequestID];
                 [FLEXNetworkRecorder.defaultRecorder
                     recordRequestWillBeSentWithRequestID:requestID
                     request:request
@@ -886,7 +909,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                 NSURLSessionTask *task = nil;
                 // Check if network observing is on and a callback was provided
                 if (FLEXNetworkObserver.isEnabled && completion) {
-                    NSString *requestID = [self nextRequestID];
+                    FLEXNetworkRequestID requestID = [self nextRequestID];
                     NSString *mechanism = [self mechanismFromClassMethod:selector onClass:class];
                     // "Hook" the completion block
                     NSURLSessionAsyncCompletion completionWrapper = [self
@@ -900,6 +923,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                         slf, swizzledSelector, argument, completionWrapper
                     );
                     [self setRequestID:requestID forConnectionOrTask:task];
+                    [self collectMetricsOfTask:task inSession:slf];
                 } else {
                     // Network observer disabled or no callback provided,
                     // just pass through to the original method
@@ -952,7 +976,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                                                                       NSURLSessionAsyncCompletion completion) {
                 NSURLSessionUploadTask *task = nil;
                 if (FLEXNetworkObserver.isEnabled && completion) {
-                    NSString *requestID = [self nextRequestID];
+                    FLEXNetworkRequestID requestID = [self nextRequestID];
                     NSString *mechanism = [self mechanismFromClassMethod:selector onClass:class];
                     NSURLSessionAsyncCompletion completionWrapper = [self
                         asyncCompletionWrapperForRequestID:requestID
@@ -964,6 +988,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                         slf, swizzledSelector, request, argument, completionWrapper
                     );
                     [self setRequestID:requestID forConnectionOrTask:task];
+                    [self collectMetricsOfTask:task inSession:slf];
                 } else {
                     task = ((id(*)(id, SEL, id, id, id))objc_msgSend)(
                         slf, swizzledSelector, request, argument, completion
@@ -979,11 +1004,41 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
     });
 }
 
+/// Tasks with completion handlers only report their metrics to a delegate, which they may not have
++ (void)collectMetricsOfTask:(NSURLSessionTask *)task inSession:(NSURLSession *)session {
+    // A task delegate takes precedence over the session delegate, so
+    // only step in if neither of them would receive the metrics already
+    // Task delegates are new in iOS 15; before that these tasks go without timings
+    if (@available(iOS 15.0, *)) {
+        SEL selector = @selector(URLSession:task:didFinishCollectingMetrics:);
+        if (!task.delegate && ![session.delegate respondsToSelector:selector]) {
+            task.delegate = FLEXNetworkObserver.sharedObserver;
+        }
+    }
+}
+
 + (NSString *)mechanismFromClassMethod:(SEL)selector onClass:(Class)class {
     return [NSString stringWithFormat:@"+[%@ %@]", NSStringFromClass(class), NSStringFromSelector(selector)];
 }
 
-+ (NSURLSessionAsyncCompletion)asyncCompletionWrapperForRequestID:(NSString *)requestID
+/// Reads a finished download unless it is larger than the recorder will keep,
+/// the same limit data tasks stop accumulating their body at
+/// @param length Set to the size of the file, whether or not it was read
++ (NSData *)capturableContentsOfDownloadAtURL:(NSURL *)location length:(NSUInteger *)length {
+    NSNumber *fileSize = nil;
+    [location getResourceValue:&fileSize forKey:NSURLFileSizeKey error:nil];
+    if (length) {
+        *length = fileSize.unsignedIntegerValue;
+    }
+
+    if (!fileSize || fileSize.unsignedIntegerValue > FLEXNetworkRecorder.defaultRecorder.responseBodyCaptureLimit) {
+        return nil;
+    }
+
+    return [NSData dataWithContentsOfURL:location];
+}
+
++ (NSURLSessionAsyncCompletion)asyncCompletionWrapperForRequestID:(FLEXNetworkRequestID)requestID
                                                         mechanism:(NSString *)mechanism
                                                        completion:(NSURLSessionAsyncCompletion)completion {
     NSURLSessionAsyncCompletion completionWrapper = ^(id fileURLOrData, NSURLResponse *response, NSError *error) {
@@ -994,15 +1049,17 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
         ];
         
         NSData *data = nil;
+        NSUInteger dataLength = 0;
         if ([fileURLOrData isKindOfClass:[NSURL class]]) {
-            data = [NSData dataWithContentsOfURL:fileURLOrData];
+            data = [self capturableContentsOfDownloadAtURL:fileURLOrData length:&dataLength];
         } else if ([fileURLOrData isKindOfClass:[NSData class]]) {
             data = fileURLOrData;
+            dataLength = data.length;
         }
         
         [FLEXNetworkRecorder.defaultRecorder
             recordDataReceivedWithRequestID:requestID
-            dataLength:data.length
+            dataLength:dataLength
         ];
         
         if (error) {
@@ -1017,6 +1074,13 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
             ];
         }
 
+        // Tasks with a completion handler don't tell their delegate they completed,
+        // so this is the last chance to drop the state made for them when they resumed
+        FLEXNetworkObserver *observer = FLEXNetworkObserver.sharedObserver;
+        [observer performBlock:^{
+            [observer removeRequestStateForRequestID:requestID];
+        }];
+
         // Call through to the original completion handler
         if (completion) {
             completion(fileURLOrData, response, error);
@@ -1488,6 +1552,50 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
     ];
 }
 
++ (void)injectTaskDidFinishCollectingMetricsIntoDelegateClass:(Class)cls {
+    SEL selector = @selector(URLSession:task:didFinishCollectingMetrics:);
+    SEL swizzledSelector = [FLEXUtility swizzledSelectorForSelector:selector];
+
+    struct objc_method_description description = protocol_getMethodDescription(
+        @protocol(NSURLSessionTaskDelegate), selector, NO, YES
+    );
+
+    typedef void (^DidFinishCollectingMetricsBlock)(id<NSURLSessionTaskDelegate> slf,
+                                                    NSURLSession *session,
+                                                    NSURLSessionTask *task,
+                                                    NSURLSessionTaskMetrics *metrics);
+
+    DidFinishCollectingMetricsBlock undefinedBlock = ^(id<NSURLSessionTaskDelegate> slf,
+                                                       NSURLSession *session,
+                                                       NSURLSessionTask *task,
+                                                       NSURLSessionTaskMetrics *metrics) {
+        [FLEXNetworkObserver.sharedObserver URLSession:session
+            task:task didFinishCollectingMetrics:metrics delegate:slf
+        ];
+    };
+
+    DidFinishCollectingMetricsBlock implementationBlock = ^(id<NSURLSessionTaskDelegate> slf,
+                                                            NSURLSession *session,
+                                                            NSURLSessionTask *task,
+                                                            NSURLSessionTaskMetrics *metrics) {
+        [self sniffWithoutDuplicationForObject:session selector:selector sniffingBlock:^{
+            undefinedBlock(slf, session, task, metrics);
+        } originalImplementationBlock:^{
+            ((void(*)(id, SEL, id, id, id))objc_msgSend)(
+                slf, swizzledSelector, session, task, metrics
+            );
+        }];
+    };
+
+    [FLEXUtility replaceImplementationOfSelector:selector
+        withSelector:swizzledSelector
+        forClass:cls
+        withMethodDescription:description
+        implementationBlock:implementationBlock
+        undefinedBlock:undefinedBlock
+    ];
+}
+
 // Used for overriding AFNetworking behavior
 + (void)injectRespondsToSelectorIntoDelegateClass:(Class)cls {
     SEL selector = @selector(respondsToSelector:);
@@ -1535,7 +1643,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
                                                  NSURLSession *session,
                                                  NSURLSessionDownloadTask *task,
                                                  NSURL *location) {
-        NSData *data = [NSData dataWithContentsOfFile:location.relativePath];
+        NSData *data = [FLEXNetworkObserver capturableContentsOfDownloadAtURL:location length:nil];
         [FLEXNetworkObserver.sharedObserver URLSession:session
             task:task didFinishDownloadingToURL:location data:data delegate:slf
         ];
@@ -1641,7 +1749,7 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
         
         id completionHook = ^(NSError *error) {
             [FLEXNetworkObserver.sharedObserver
-                websocketTaskMessageSendCompletion:message
+                websocketTask:slf messageSendCompletion:message
                 error:error
             ];
             if (completion) {
@@ -1696,18 +1804,20 @@ static FIRDocumentReference * _logos_method$_ungrouped$FIRCollectionReference$ad
 
 static char const * const kFLEXRequestIDKey = "kFLEXRequestIDKey";
 
-+ (NSString *)requestIDForConnectionOrTask:(id)connectionOrTask {
-    NSString *requestID = objc_getAssociatedObject(connectionOrTask, kFLEXRequestIDKey);
++ (FLEXNetworkRequestID)requestIDForConnectionOrTask:(id)connectionOrTask {
+    NSNumber *requestID = objc_getAssociatedObject(connectionOrTask, kFLEXRequestIDKey);
     if (!requestID) {
-        requestID = [self nextRequestID];
-        [self setRequestID:requestID forConnectionOrTask:connectionOrTask];
+        FLEXNetworkRequestID newRequestID = [self nextRequestID];
+        [self setRequestID:newRequestID forConnectionOrTask:connectionOrTask];
+        return newRequestID;
     }
-    return requestID;
+    return requestID.unsignedLongLongValue;
 }
 
-+ (void)setRequestID:(NSString *)requestID forConnectionOrTask:(id)connectionOrTask {
++ (void)setRequestID:(FLEXNetworkRequestID)requestID forConnectionOrTask:(id)connectionOrTask {
+    // Boxed once per task; small integers are tagged pointers, so this doesn't allocate
     objc_setAssociatedObject(
-        connectionOrTask, kFLEXRequestIDKey, requestID, OBJC_ASSOCIATION_RETAIN_NONATOMIC
+        connectionOrTask, kFLEXRequestIDKey, @(requestID), OBJC_ASSOCIATION_RETAIN_NONATOMIC
     );
 }
 
@@ -1716,7 +1826,7 @@ static char const * const kFLEXRequestIDKey = "kFLEXRequestIDKey";
 - (id)init {
     self = [super init];
     if (self) {
-        self.requestStatesForRequestIDs = [NSMutableDictionary new];
+        _requestStatesByRequestID = CFDictionaryCreateMutable(NULL, 0, NULL, &kCFTypeDictionaryValueCallBacks);
         self.queue = dispatch_queue_create(
             "com.flex.FLEXNetworkObserver", DISPATCH_QUEUE_SERIAL
         );
@@ -1733,18 +1843,27 @@ static char const * const kFLEXRequestIDKey = "kFLEXRequestIDKey";
     }
 }
 
-- (FLEXInternalRequestState *)requestStateForRequestID:(NSString *)requestID {
-    FLEXInternalRequestState *requestState = self.requestStatesForRequestIDs[requestID];
+- (FLEXInternalRequestState *)requestStateForRequestID:(FLEXNetworkRequestID)requestID {
+    const void *key = FLEXNetworkRequestIDKey(requestID);
+    FLEXInternalRequestState *requestState = (__bridge id)CFDictionaryGetValue(_requestStatesByRequestID, key);
     if (!requestState) {
         requestState = [FLEXInternalRequestState new];
-        [self.requestStatesForRequestIDs setObject:requestState forKey:requestID];
+        CFDictionarySetValue(_requestStatesByRequestID, key, (__bridge const void *)requestState);
     }
     
     return requestState;
 }
 
-- (void)removeRequestStateForRequestID:(NSString *)requestID {
-    [self.requestStatesForRequestIDs removeObjectForKey:requestID];
+- (void)removeRequestStateForRequestID:(FLEXNetworkRequestID)requestID {
+    CFDictionaryRemoveValue(_requestStatesByRequestID, FLEXNetworkRequestIDKey(requestID));
+}
+
+#pragma mark - NSURLSessionTaskDelegate
+
+- (void)URLSession:(NSURLSession *)session
+              task:(NSURLSessionTask *)task
+didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics {
+    [self URLSession:session task:task didFinishCollectingMetrics:metrics delegate:nil];
 }
 
 @end
@@ -1757,7 +1876,7 @@ static char const * const kFLEXRequestIDKey = "kFLEXRequestIDKey";
   redirectResponse:(NSURLResponse *)response
           delegate:(id<NSURLConnectionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:connection];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:connection];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
         requestState.request = request;
         
@@ -1778,9 +1897,9 @@ static char const * const kFLEXRequestIDKey = "kFLEXRequestIDKey";
 didReceiveResponse:(NSURLResponse *)response
           delegate:(id<NSURLConnectionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:connection];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:connection];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
-        requestState.dataAccumulator = [NSMutableData new];
+        [requestState resetDataAccumulator];
 
         [FLEXNetworkRecorder.defaultRecorder
             recordResponseReceivedWithRequestID:requestID
@@ -1792,10 +1911,11 @@ didReceiveResponse:(NSURLResponse *)response
 - (void)connection:(NSURLConnection *)connection
     didReceiveData:(NSData *)data
           delegate:(id<NSURLConnectionDelegate>)delegate {
-    // Just to be safe since we're doing this async
+    // Just to be safe since we're doing this async. The data we're
+    // handed is almost always immutable, in which case this only retains it.
     data = [data copy];
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:connection];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:connection];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
         [requestState.dataAccumulator appendData:data];
         
@@ -1809,11 +1929,11 @@ didReceiveResponse:(NSURLResponse *)response
 - (void)connectionDidFinishLoading:(NSURLConnection *)connection
                           delegate:(id<NSURLConnectionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:connection];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:connection];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
         [FLEXNetworkRecorder.defaultRecorder
             recordLoadingFinishedWithRequestID:requestID
-            responseBody:requestState.dataAccumulator
+            responseBody:requestState.dataAccumulator.data
         ];
         [self removeRequestStateForRequestID:requestID];
     }];
@@ -1823,7 +1943,7 @@ didReceiveResponse:(NSURLResponse *)response
   didFailWithError:(NSError *)error
           delegate:(id<NSURLConnectionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:connection];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:connection];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
 
         // Cancellations can occur prior to the willSendRequest:...
@@ -1863,7 +1983,7 @@ willPerformHTTPRedirection:(NSHTTPURLResponse *)response
  completionHandler:(void (^)(NSURLRequest *))completionHandler
           delegate:(id<NSURLSessionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:task];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:task];
         [FLEXNetworkRecorder.defaultRecorder
             recordRequestWillBeSentWithRequestID:requestID
             request:request
@@ -1878,9 +1998,9 @@ didReceiveResponse:(NSURLResponse *)response
  completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
           delegate:(id<NSURLSessionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:dataTask];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:dataTask];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
-        requestState.dataAccumulator = [NSMutableData new];
+        [requestState resetDataAccumulator];
 
         NSString *requestMechanism = [NSString stringWithFormat:
             @"NSURLSessionDataTask (delegate: %@)", [delegate class]
@@ -1904,7 +2024,7 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask
     [self performBlock:^{
         // By setting the request ID of the download task to match the data task,
         // it can pick up where the data task left off.
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:dataTask];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:dataTask];
         [[self class] setRequestID:requestID forConnectionOrTask:downloadTask];
     }];
 }
@@ -1913,17 +2033,18 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask
           dataTask:(NSURLSessionDataTask *)dataTask
     didReceiveData:(NSData *)data
           delegate:(id<NSURLSessionDelegate>)delegate {
-    // Just to be safe since we're doing this async
+    // Just to be safe since we're doing this async. The data we're
+    // handed is almost always immutable, in which case this only retains it.
     data = [data copy];
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:dataTask];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:dataTask];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
 
         // Fix for "Response body not in cache" issue reported by developers
         // See this github comment for detailed explanation on why this happens
         // https://github.com/FLEXTool/FLEX/issues/568#issuecomment-1141015572
         if (requestState.dataAccumulator == nil) {
-            requestState.dataAccumulator = [NSMutableData new];
+            [requestState resetDataAccumulator];
         }
         [requestState.dataAccumulator appendData:data];
 
@@ -1939,7 +2060,7 @@ didBecomeDownloadTask:(NSURLSessionDownloadTask *)downloadTask
 didCompleteWithError:(NSError *)error
           delegate:(id<NSURLSessionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:task];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:task];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
 
         if (error) {
@@ -1949,7 +2070,7 @@ didCompleteWithError:(NSError *)error
         } else {
             [FLEXNetworkRecorder.defaultRecorder
                 recordLoadingFinishedWithRequestID:requestID 
-                responseBody:requestState.dataAccumulator
+                responseBody:requestState.dataAccumulator.data
             ];
         }
 
@@ -1957,6 +2078,16 @@ didCompleteWithError:(NSError *)error
     }];
 }
 
+- (void)URLSession:(NSURLSession *)session
+              task:(NSURLSessionTask *)task
+didFinishCollectingMetrics:(NSURLSessionTaskMetrics *)metrics
+          delegate:(id<NSURLSessionDelegate>)delegate {
+    [self performBlock:^{
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:task];
+        [FLEXNetworkRecorder.defaultRecorder recordMetrics:metrics forRequestID:requestID];
+    }];
+}
+
 - (void)URLSession:(NSURLSession *)session
       downloadTask:(NSURLSessionDownloadTask *)downloadTask
       didWriteData:(int64_t)bytesWritten
@@ -1964,11 +2095,11 @@ didCompleteWithError:(NSError *)error
 totalBytesExpectedToWrite:(int64_t)totalBytesExpectedToWrite
           delegate:(id<NSURLSessionDelegate>)delegate {
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:downloadTask];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:downloadTask];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
 
         if (!requestState.dataAccumulator) {
-            requestState.dataAccumulator = [NSMutableData new];
+            [requestState resetDataAccumulator];
             [FLEXNetworkRecorder.defaultRecorder
                 recordResponseReceivedWithRequestID:requestID
                 response:downloadTask.response
@@ -1996,7 +2127,7 @@ didFinishDownloadingToURL:(NSURL *)location data:(NSData *)data
           delegate:(id<NSURLSessionDelegate>)delegate {
     data = [data copy];
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:downloadTask];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:downloadTask];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
         [requestState.dataAccumulator appendData:data];
     }];
@@ -2011,10 +2142,14 @@ didFinishDownloadingToURL:(NSURL *)location data:(NSData *)data
         }
     }
 
+    if ([NSURLProtocol propertyForKey:kFLEXNetworkObserverIgnoredRequestKey inRequest:task.currentRequest]) {
+        return;
+    }
+
     // Since resume can be called multiple times on the same task, only treat the first resume as
     // the equivalent to connection:willSendRequest:...
     [self performBlock:^{
-        NSString *requestID = [[self class] requestIDForConnectionOrTask:task];
+        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:task];
         FLEXInternalRequestState *requestState = [self requestStateForRequestID:requestID];
         if (!requestState.request) {
             requestState.request = task.currentRequest;
@@ -2031,16 +2166,18 @@ didFinishDownloadingToURL:(NSURL *)location data:(NSData *)data
 - (void)websocketTask:(NSURLSessionWebSocketTask *)task
         sendMessagage:(NSURLSessionWebSocketMessage *)message {
     [self performBlock:^{
-//        NSString *requestID = [[self class] requestIDForConnectionOrTask:task];
+//        FLEXNetworkRequestID requestID = [[self class] requestIDForConnectionOrTask:task];
         [FLEXNetworkRecorder.defaultRecorder recordWebsocketMessageSend:message task:task];
     }];
 }
 
-- (void)websocketTaskMessageSendCompletion:(NSURLSessionWebSocketMessage *)message
-                                     error:(NSError *)error {
+- (void)websocketTask:(NSURLSessionWebSocketTask *)task
+messageSendCompletion:(NSURLSessionWebSocketMessage *)message
+                error:(NSError *)error {
     [self performBlock:^{
         [FLEXNetworkRecorder.defaultRecorder
             recordWebsocketMessageSendCompletion:message
+            task:task
             error:error
         ];
     }];
@@ -16,6 +16,7 @@
 #import "FLEXFieldEditorViewController.h"
 #import "FLEXMethodCallingViewController.h"
 #import "FLEXObjectListViewController.h"
+#import "FLEXRetainCyclesViewController.h"
 #import "FLEXTabsViewController.h"
 #import "FLEXBookmarkManager.h"
 #import "FLEXTableView.h"
@@ -199,6 +200,17 @@
         [host.navigationController pushViewController:references animated:YES];
     };
 
+    FLEXSingleRowSection *cyclesSection = [FLEXSingleRowSection
+        title:@"Retain Cycles" reuse:kFLEXDefaultCell cell:^(FLEXTableViewCell *cell) {
+            cell.titleLabel.text = @"Find Retain Cycles Through This Object";
+            cell.accessoryType = UITableViewCellAccessoryDisclosureIndicator;
+        }
+    ];
+    cyclesSection.selectionAction = ^(UIViewController *host) {
+        UIViewController *cycles = [FLEXRetainCyclesViewController cyclesThroughObject:explorer.object];
+        [host.navigationController pushViewController:cycles animated:YES];
+    };
+
     NSMutableArray *sections = [NSMutableArray arrayWithArray:@[
         [FLEXMetadataSection explorer:self.explorer kind:FLEXMetadataKindProperties],
         [FLEXMetadataSection explorer:self.explorer kind:FLEXMetadataKindClassProperties],
@@ -211,6 +223,11 @@
         referencesSection
     ]];
 
+    // Classes can't be part of a cycle on the heap
+    if (explorer.objectIsInstance) {
+        [sections addObject:cyclesSection];
+    }
+
     if (self.customSections) {
         [sections insertObjects:self.customSections atIndexes:[NSIndexSet
             indexSetWithIndexesInRange:NSMakeRange(0, self.customSections.count)
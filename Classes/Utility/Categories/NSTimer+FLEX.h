@@ -12,6 +12,8 @@ typedef void (^VoidBlock)(void);
 @interface NSTimer (Blocks)
 
 + (instancetype)flex_fireSecondsFromNow:(NSTimeInterval)delay block:(VoidBlock)block;
+/// Fires until invalidated
++ (instancetype)flex_fireEverySeconds:(NSTimeInterval)interval block:(VoidBlock)block;
 
 // Forward declaration
 //+ (NSTimer *)scheduledTimerWithTimeInterval:(NSTimeInterval)interval repeats:(BOOL)repeats block:(void (^)(NSTimer *timer))block;
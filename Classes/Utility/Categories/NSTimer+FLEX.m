@@ -22,4 +22,12 @@
     }
 }
 
++ (instancetype)flex_fireEverySeconds:(NSTimeInterval)interval block:(VoidBlock)block {
+    if (@available(iOS 10, *)) {
+        return [self scheduledTimerWithTimeInterval:interval repeats:YES block:(id)block];
+    } else {
+        return [self scheduledTimerWithTimeInterval:interval target:block selector:@selector(invoke) userInfo:nil repeats:YES];
+    }
+}
+
 @end
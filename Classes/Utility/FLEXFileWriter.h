@@ -0,0 +1,39 @@
+//
+//  FLEXFileWriter.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Streams an export to a file through a fixed-size buffer, so the file is never held in memory.
+///
+/// The first failed write is remembered and nothing is written after it, so callers
+/// can write freely and only check \c failed where it is worth stopping early.
+@interface FLEXFileWriter : NSObject
+
+/// Creates or truncates the file at \c path, readable only by the app.
+/// @return \c nil if the file could not be opened or the buffer could not be allocated
++ (nullable instancetype)writerToFile:(NSString *)path
+                           bufferSize:(size_t)bufferSize
+                                error:(NSError **)error;
+
+- (void)writeBytes:(const void *)bytes length:(size_t)length;
+/// Writes the string as UTF-8, without a terminator
+- (void)writeString:(NSString *)string;
+
+/// Whether a write has failed
+@property (nonatomic, readonly) BOOL failed;
+
+/// Flushes and closes the file, then deletes it unless the export finished.
+/// @param error Why the export stopped before it finished, if it did
+/// @return The first failed write, otherwise \c error, otherwise a failed close
+- (nullable NSError *)closeWithError:(nullable NSError *)error;
+
+@end
+
+NS_ASSUME_NONNULL_END
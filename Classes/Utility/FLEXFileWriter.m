@@ -0,0 +1,120 @@
+//
+//  FLEXFileWriter.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXFileWriter.h"
+#include <fcntl.h>
+#include <unistd.h>
+
+@implementation FLEXFileWriter {
+    NSString *_path;
+    int _fd;
+    uint8_t *_buffer;
+    size_t _bufferSize;
+    size_t _bufferLength;
+    /// The errno of the first failed write, after which nothing more is written
+    int _writeError;
+}
+
++ (instancetype)writerToFile:(NSString *)path bufferSize:(size_t)bufferSize error:(NSError **)error {
+    uint8_t *buffer = malloc(bufferSize);
+    if (!buffer) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+        }
+        return nil;
+    }
+
+    int fd = open(path.fileSystemRepresentation, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        if (error) {
+            *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+        }
+        free(buffer);
+        return nil;
+    }
+
+    FLEXFileWriter *writer = [self new];
+    writer->_path = path.copy;
+    writer->_fd = fd;
+    writer->_buffer = buffer;
+    writer->_bufferSize = bufferSize;
+    return writer;
+}
+
+- (void)dealloc {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+    free(_buffer);
+}
+
+- (BOOL)failed {
+    return _writeError != 0;
+}
+
+- (void)writeString:(NSString *)string {
+    const char *utf8 = string.UTF8String;
+    [self writeBytes:utf8 length:strlen(utf8)];
+}
+
+- (void)writeBytes:(const void *)bytes length:(size_t)length {
+    if (length > _bufferSize - _bufferLength) {
+        [self flush];
+        if (length > _bufferSize) {
+            [self writeToFile:bytes length:length];
+            return;
+        }
+    }
+
+    memcpy(_buffer + _bufferLength, bytes, length);
+    _bufferLength += length;
+}
+
+- (void)flush {
+    [self writeToFile:_buffer length:_bufferLength];
+    _bufferLength = 0;
+}
+
+- (void)writeToFile:(const uint8_t *)bytes length:(size_t)length {
+    while (length && !_writeError) {
+        ssize_t written = write(_fd, bytes, length);
+        if (written < 0) {
+            if (errno != EINTR) {
+                _writeError = errno;
+            }
+            continue;
+        }
+
+        bytes += written;
+        length -= written;
+    }
+}
+
+- (NSError *)closeWithError:(NSError *)error {
+    if (_fd < 0) {
+        return error;
+    }
+
+    [self flush];
+    if (_writeError) {
+        error = [NSError errorWithDomain:NSPOSIXErrorDomain code:_writeError userInfo:nil];
+    }
+
+    if (close(_fd) != 0 && !error) {
+        error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:nil];
+    }
+    _fd = -1;
+
+    if (error) {
+        unlink(_path.fileSystemRepresentation);
+    }
+
+    return error;
+}
+
+@end
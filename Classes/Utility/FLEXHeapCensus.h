@@ -0,0 +1,81 @@
+//
+//  FLEXHeapCensus.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The instances of one class found by a census
+typedef struct {
+    __unsafe_unretained Class cls;
+    /// The class's index in the census's class table, stable until the class list changes
+    uint32_t slot;
+    uint32_t count;
+    /// The sum of the malloc sizes of the instances, which includes any extra bytes and padding
+    uint64_t bytes;
+} FLEXHeapCensusEntry;
+
+/// Only classes with at least one instance have an entry.
+/// Free the entries with \c FLEXHeapCensusResultFree when done.
+typedef struct {
+    FLEXHeapCensusEntry *_Nullable entries;
+    uint32_t entryCount;
+    /// The number of classes in the runtime when the census was taken
+    uint32_t classCount;
+    /// Changes whenever the class table is rebuilt, which invalidates the \c slot of earlier entries
+    uint32_t generation;
+    uint64_t objectCount;
+    uint64_t byteCount;
+} FLEXHeapCensusResult;
+
+extern void FLEXHeapCensusResultFree(FLEXHeapCensusResult *result);
+
+/// One instance on the heap
+typedef struct {
+    uintptr_t address;
+    /// Index into \c FLEXHeapObjectList.classes
+    uint32_t slot;
+    /// The malloc size
+    uint32_t size;
+} FLEXHeapObject;
+
+/// Every instance on the heap, in no particular order.
+/// Free the arrays with \c FLEXHeapObjectListFree when done.
+typedef struct {
+    FLEXHeapObject *_Nullable objects;
+    uint64_t count;
+    Class __unsafe_unretained *_Nullable classes;
+    uint32_t classCount;
+} FLEXHeapObjectList;
+
+extern void FLEXHeapObjectListFree(FLEXHeapObjectList *list);
+
+/// Counts the instances of every class on the heap, much faster than counting
+/// them through \c FLEXHeapEnumerator.enumerateLiveObjectsUsingBlock:
+///
+/// Classes are kept in a preallocated open-addressing table keyed by class pointer,
+/// which is only rebuilt when the number of classes in the runtime changes. Each slot
+/// has its own counters in a dense array. Every zone stays locked while all of its ranges
+/// are counted in one pass, with no callbacks per object and no allocations until it is unlocked.
+@interface FLEXHeapCensus : NSObject
+
+@property (nonatomic, readonly, class) FLEXHeapCensus *sharedCensus;
+
+/// Safe to call from any thread; concurrent calls take turns.
+- (FLEXHeapCensusResult)takeCensus;
+
+/// Lists the address, class and size of every instance on the heap. The list is
+/// allocated up front from the size of a census, and taken again if the heap outgrew it.
+- (FLEXHeapObjectList)collectObjects;
+
+/// The class in a slot of the current class table, or \c Nil
+- (nullable Class)classAtSlot:(uint32_t)slot generation:(uint32_t)generation;
+
+@end
+
+NS_ASSUME_NONNULL_END
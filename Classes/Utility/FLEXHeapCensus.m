@@ -0,0 +1,345 @@
+//
+//  FLEXHeapCensus.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapCensus.h"
+#import "FLEXObjcInternal.h"
+#import <malloc/malloc.h>
+#import <mach/mach.h>
+#import <objc/runtime.h>
+#import <os/lock.h>
+
+/// One bucket of the class table. A zero key is an empty bucket.
+typedef struct {
+    uintptr_t cls;
+    uint32_t slot;
+} FLEXClassBucket;
+
+/// Per-class counters, next to each other so a hit touches one cache line
+typedef struct {
+    uint64_t count;
+    uint64_t bytes;
+} FLEXClassCounter;
+
+/// Everything the range callback reads and writes. It must not allocate.
+typedef struct {
+    const FLEXClassBucket *buckets;
+    uintptr_t mask;
+    unsigned shift;
+    /// Any pointer outside these bounds cannot be a class, which skips the table for most ranges
+    uintptr_t minClass;
+    uintptr_t maxClass;
+    uintptr_t isaMask;
+    FLEXClassCounter *counters;
+    /// Only used when collecting objects. \c objectCount keeps counting past \c objectCapacity.
+    FLEXHeapObject *objects;
+    uint64_t objectCapacity;
+    uint64_t objectCount;
+} FLEXCensusContext;
+
+static inline size_t FLEXClassBucketIndex(uintptr_t cls, unsigned shift) {
+    // Fibonacci hashing spreads the aligned, clustered class pointers over the table
+    return (size_t)((cls * 0x9E3779B97F4A7C15ULL) >> shift);
+}
+
+static void FLEXCensusRangeCallback(task_t task, void *context, unsigned type, vm_range_t *ranges, unsigned rangeCount) {
+    FLEXCensusContext *census = (FLEXCensusContext *)context;
+    const FLEXClassBucket *buckets = census->buckets;
+    const uintptr_t mask = census->mask, minClass = census->minClass, maxClass = census->maxClass;
+    const uintptr_t isaMask = census->isaMask;
+    const unsigned shift = census->shift;
+
+    for (unsigned i = 0; i < rangeCount; i++) {
+        vm_range_t range = ranges[i];
+        if (range.size < sizeof(uintptr_t)) {
+            continue;
+        }
+
+        uintptr_t cls = *(uintptr_t *)range.address & isaMask;
+        if (cls < minClass || cls > maxClass) {
+            continue;
+        }
+
+        for (size_t b = FLEXClassBucketIndex(cls, shift); buckets[b].cls; b = (b + 1) & mask) {
+            if (buckets[b].cls == cls) {
+                FLEXClassCounter *counter = &census->counters[buckets[b].slot];
+                counter->count++;
+                counter->bytes += range.size;
+                break;
+            }
+        }
+    }
+}
+
+/// The same lookup as \c FLEXCensusRangeCallback, appending each object instead of counting it
+static void FLEXCollectRangeCallback(task_t task, void *context, unsigned type, vm_range_t *ranges, unsigned rangeCount) {
+    FLEXCensusContext *census = (FLEXCensusContext *)context;
+    const FLEXClassBucket *buckets = census->buckets;
+    const uintptr_t mask = census->mask, minClass = census->minClass, maxClass = census->maxClass;
+    const uintptr_t isaMask = census->isaMask;
+    const unsigned shift = census->shift;
+
+    for (unsigned i = 0; i < rangeCount; i++) {
+        vm_range_t range = ranges[i];
+        if (range.size < sizeof(uintptr_t)) {
+            continue;
+        }
+
+        uintptr_t cls = *(uintptr_t *)range.address & isaMask;
+        if (cls < minClass || cls > maxClass) {
+            continue;
+        }
+
+        for (size_t b = FLEXClassBucketIndex(cls, shift); buckets[b].cls; b = (b + 1) & mask) {
+            if (buckets[b].cls == cls) {
+                if (census->objectCount < census->objectCapacity) {
+                    census->objects[census->objectCount] = (FLEXHeapObject){
+                        range.address, buckets[b].slot, (uint32_t)MIN(range.size, UINT32_MAX)
+                    };
+                }
+                census->objectCount++;
+                break;
+            }
+        }
+    }
+}
+
+static kern_return_t FLEXCensusMemoryReader(task_t task, vm_address_t address, vm_size_t size, void **local) {
+    *local = (void *)address;
+    return KERN_SUCCESS;
+}
+
+void FLEXHeapCensusResultFree(FLEXHeapCensusResult *result) {
+    free(result->entries);
+    result->entries = NULL;
+    result->entryCount = 0;
+}
+
+void FLEXHeapObjectListFree(FLEXHeapObjectList *list) {
+    free(list->objects);
+    free(list->classes);
+    list->objects = NULL;
+    list->classes = NULL;
+    list->count = 0;
+    list->classCount = 0;
+}
+
+@implementation FLEXHeapCensus {
+    os_unfair_lock _lock;
+    uint32_t _generation;
+
+    /// The runtime's classes in slot order
+    Class __unsafe_unretained *_classes;
+    uint32_t _classCount;
+    uint32_t _classCapacity;
+
+    FLEXClassBucket *_buckets;
+    size_t _bucketCount;
+    FLEXClassCounter *_counters;
+    FLEXCensusContext _context;
+}
+
++ (FLEXHeapCensus *)sharedCensus {
+    static FLEXHeapCensus *shared = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        shared = [self new];
+    });
+
+    return shared;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+#ifdef __arm64__
+        // See http://www.sealiesoftware.com/blog/archive/2013/09/24/objc_explain_Non-pointer_isa.html
+        extern uint64_t objc_debug_isa_class_mask WEAK_IMPORT_ATTRIBUTE;
+        _context.isaMask = (uintptr_t)objc_debug_isa_class_mask;
+#else
+        _context.isaMask = UINTPTR_MAX;
+#endif
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_classes);
+    free(_buckets);
+    free(_counters);
+}
+
+#pragma mark Class Table
+
+/// Rebuilds the class table if classes were added or removed since the last census
+- (void)updateClassTable {
+    int count = objc_getClassList(NULL, 0);
+    if (count == (int)_classCount && _buckets) {
+        return;
+    }
+
+    // Leave room for classes registered between the two calls
+    if ((uint32_t)count > _classCapacity) {
+        _classCapacity = (uint32_t)count + (uint32_t)count / 8 + 64;
+        free(_classes);
+        free(_counters);
+        _classes = (Class __unsafe_unretained *)calloc(_classCapacity, sizeof(Class));
+        _counters = calloc(_classCapacity, sizeof(FLEXClassCounter));
+    }
+    _classCount = (uint32_t)MIN(objc_getClassList(_classes, (int)_classCapacity), (int)_classCapacity);
+
+    // At most half full, so probe sequences stay short
+    size_t bucketCount = 64;
+    unsigned bits = 6;
+    while (bucketCount < (size_t)_classCount * 2) {
+        bucketCount <<= 1;
+        bits++;
+    }
+    if (bucketCount != _bucketCount) {
+        free(_buckets);
+        _buckets = malloc(bucketCount * sizeof(FLEXClassBucket));
+        _bucketCount = bucketCount;
+    }
+    memset(_buckets, 0, bucketCount * sizeof(FLEXClassBucket));
+
+    uintptr_t minClass = UINTPTR_MAX, maxClass = 0;
+    const unsigned shift = 64 - bits;
+    for (uint32_t slot = 0; slot < _classCount; slot++) {
+        uintptr_t cls = (uintptr_t)(__bridge void *)_classes[slot];
+        size_t b = FLEXClassBucketIndex(cls, shift);
+        while (_buckets[b].cls) {
+            b = (b + 1) & (bucketCount - 1);
+        }
+        _buckets[b] = (FLEXClassBucket){ cls, slot };
+        minClass = MIN(minClass, cls);
+        maxClass = MAX(maxClass, cls);
+    }
+
+    _context.buckets = _buckets;
+    _context.mask = bucketCount - 1;
+    _context.shift = shift;
+    _context.minClass = minClass;
+    _context.maxClass = maxClass;
+    _context.counters = _counters;
+    _generation++;
+}
+
+- (Class)classAtSlot:(uint32_t)slot generation:(uint32_t)generation {
+    os_unfair_lock_lock(&_lock);
+    Class cls = generation == _generation && slot < _classCount ? _classes[slot] : Nil;
+    os_unfair_lock_unlock(&_lock);
+    return cls;
+}
+
+#pragma mark Census
+
+/// Call with the lock held and the class table up to date
+- (void)enumerateZones:(vm_address_t *)zones count:(unsigned)zoneCount recorder:(vm_range_recorder_t)recorder {
+    for (unsigned i = 0; i < zoneCount; i++) {
+        malloc_zone_t *zone = (malloc_zone_t *)zones[i];
+        malloc_introspection_t *introspection = zone->introspect;
+
+        // See enumerateLiveObjectsUsingBlock: for why each of these is checked
+        if (!introspection || !introspection->enumerator ||
+            !FLEXPointerIsReadable(introspection->force_lock) ||
+            !FLEXPointerIsReadable(introspection->force_unlock)) {
+            continue;
+        }
+
+        introspection->force_lock(zone);
+        introspection->enumerator(
+            TASK_NULL, &_context, MALLOC_PTR_IN_USE_RANGE_TYPE,
+            (vm_address_t)zone, FLEXCensusMemoryReader, recorder
+        );
+        introspection->force_unlock(zone);
+    }
+}
+
+- (FLEXHeapCensusResult)takeCensus {
+    FLEXHeapCensusResult result = { 0 };
+
+    vm_address_t *zones = NULL;
+    unsigned zoneCount = 0;
+    if (malloc_get_all_zones(TASK_NULL, FLEXCensusMemoryReader, &zones, &zoneCount) != KERN_SUCCESS) {
+        return result;
+    }
+
+    os_unfair_lock_lock(&_lock);
+    // Anything that allocates has to happen before the first zone is locked
+    [self updateClassTable];
+    memset(_counters, 0, _classCount * sizeof(FLEXClassCounter));
+
+    [self enumerateZones:zones count:zoneCount recorder:FLEXCensusRangeCallback];
+
+    uint32_t entryCount = 0;
+    for (uint32_t slot = 0; slot < _classCount; slot++) {
+        entryCount += _counters[slot].count > 0;
+    }
+
+    result.entries = malloc(MAX(entryCount, 1) * sizeof(FLEXHeapCensusEntry));
+    result.classCount = _classCount;
+    result.generation = _generation;
+    for (uint32_t slot = 0; slot < _classCount; slot++) {
+        FLEXClassCounter counter = _counters[slot];
+        if (counter.count) {
+            result.entries[result.entryCount++] = (FLEXHeapCensusEntry){
+                _classes[slot], slot, (uint32_t)MIN(counter.count, UINT32_MAX), counter.bytes
+            };
+            result.objectCount += counter.count;
+            result.byteCount += counter.bytes;
+        }
+    }
+
+    os_unfair_lock_unlock(&_lock);
+    return result;
+}
+
+- (FLEXHeapObjectList)collectObjects {
+    FLEXHeapObjectList list = { 0 };
+
+    vm_address_t *zones = NULL;
+    unsigned zoneCount = 0;
+    if (malloc_get_all_zones(TASK_NULL, FLEXCensusMemoryReader, &zones, &zoneCount) != KERN_SUCCESS) {
+        return list;
+    }
+
+    FLEXHeapCensusResult census = [self takeCensus];
+    uint64_t capacity = census.objectCount + census.objectCount / 8 + 4096;
+    FLEXHeapCensusResultFree(&census);
+
+    os_unfair_lock_lock(&_lock);
+    [self updateClassTable];
+
+    // A few tries at most, in case the heap keeps growing faster than the list
+    for (int attempt = 0; attempt < 4; attempt++) {
+        free(list.objects);
+        list.objects = malloc(capacity * sizeof(FLEXHeapObject));
+        _context.objects = list.objects;
+        _context.objectCapacity = capacity;
+        _context.objectCount = 0;
+
+        [self enumerateZones:zones count:zoneCount recorder:FLEXCollectRangeCallback];
+        if (_context.objectCount <= capacity) {
+            break;
+        }
+        capacity = _context.objectCount + _context.objectCount / 4;
+    }
+
+    list.count = MIN(_context.objectCount, _context.objectCapacity);
+    list.classCount = _classCount;
+    list.classes = (Class __unsafe_unretained *)malloc(MAX(_classCount, 1) * sizeof(Class));
+    memcpy(list.classes, _classes, _classCount * sizeof(Class));
+    _context.objects = NULL;
+    _context.objectCapacity = 0;
+
+    os_unfair_lock_unlock(&_lock);
+    return list;
+}
+
+@end
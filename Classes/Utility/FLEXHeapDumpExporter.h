@@ -0,0 +1,29 @@
+//
+//  FLEXHeapDumpExporter.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Writes every object on the heap and the references between them to a compact binary file,
+/// described in \c FLEXHeapDumpFormat.h, for the \c flexheap tool in \c Tools/flexheap to analyze.
+///
+/// The references come from a \c FLEXHeapGraph. Records are then streamed to disk through a
+/// small write buffer, with no Objective-C objects created per heap object.
+@interface FLEXHeapDumpExporter : NSObject
+
+/// Writes a dump of the heap to \c path in the background.
+///
+/// @param completion Called on the main queue when the export stops. Cancelling the returned progress
+/// stops the export with \c NSUserCancelledError. The file is deleted if the export did not finish.
+/// @return The progress of the export. Cancellable.
++ (NSProgress *)exportHeapToFile:(NSString *)path completion:(void(^)(NSError *_Nullable error))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,160 @@
+//
+//  FLEXHeapDumpExporter.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapDumpExporter.h"
+#import "FLEXHeapDumpFormat.h"
+#import "FLEXHeapGraph.h"
+#import "FLEXFileWriter.h"
+#import <objc/runtime.h>
+
+/// Output is collected in a buffer of this size before it is written to the file
+static const size_t kFLEXHeapDumpWriteBufferSize = 256 * 1024;
+/// How often the export checks for cancellation and reports progress, in objects
+static const uint32_t kFLEXHeapDumpProgressInterval = 1 << 16;
+static const int64_t kFLEXHeapDumpGraphUnits = 50;
+static const int64_t kFLEXHeapDumpWriteUnits = 50;
+
+_Static_assert(__LITTLE_ENDIAN__, "Heap dumps are written in native byte order");
+
+/// Copies a field into a record being assembled, returning where the next field goes
+static inline uint8_t *FLEXHeapDumpPut(uint8_t *cursor, const void *value, size_t length) {
+    memcpy(cursor, value, length);
+    return cursor + length;
+}
+
+@implementation FLEXHeapDumpExporter
+
++ (NSProgress *)exportHeapToFile:(NSString *)path completion:(void (^)(NSError *))completion {
+    NSProgress *progress = [NSProgress progressWithTotalUnitCount:kFLEXHeapDumpGraphUnits + kFLEXHeapDumpWriteUnits];
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        NSError *error = [self writeHeapToFile:path progress:progress];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(error);
+        });
+    });
+
+    return progress;
+}
+
++ (NSError *)writeHeapToFile:(NSString *)path progress:(NSProgress *)progress {
+    NSError *cancelled = [NSError errorWithDomain:NSCocoaErrorDomain code:NSUserCancelledError userInfo:nil];
+
+    NSProgress *graphProgress = [NSProgress
+        progressWithTotalUnitCount:-1 parent:progress pendingUnitCount:kFLEXHeapDumpGraphUnits
+    ];
+    FLEXHeapGraph *graph = [FLEXHeapGraph graphOfLiveObjectsWithProgress:graphProgress];
+    if (!graph) {
+        return progress.isCancelled ? cancelled : [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+    }
+    if (graph.objectCount & kFLEXHeapDumpEdgeUnowned) {
+        // Object positions would collide with the unowned bit of edges
+        return [NSError errorWithDomain:NSPOSIXErrorDomain code:EFBIG userInfo:nil];
+    }
+
+    // Only classes with instances get an id, numbered in class table order
+    uint32_t classCount = graph.classCount;
+    uint32_t *classIds = malloc(MAX(classCount, 1) * sizeof(uint32_t));
+    if (!classIds) {
+        return [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:nil];
+    }
+    memset(classIds, 0xFF, classCount * sizeof(uint32_t));
+    const FLEXHeapObject *objects = graph.objects;
+    uint32_t objectCount = graph.objectCount;
+    for (uint32_t i = 0; i < objectCount; i++) {
+        classIds[objects[i].slot] = 0;
+    }
+
+    uint32_t usedClassCount = 0;
+    for (uint32_t slot = 0; slot < classCount; slot++) {
+        if (classIds[slot] == 0) {
+            classIds[slot] = usedClassCount++;
+        }
+    }
+
+    NSError *error = nil;
+    FLEXFileWriter *writer = [FLEXFileWriter
+        writerToFile:path bufferSize:kFLEXHeapDumpWriteBufferSize error:&error
+    ];
+    if (!writer) {
+        free(classIds);
+        return error;
+    }
+
+    uint32_t version = kFLEXHeapDumpVersion;
+    uint64_t objectCount64 = objectCount, edgeCount = graph.edgeCount;
+    uint64_t timestamp = (uint64_t)(graph.date.timeIntervalSince1970 * 1000);
+    uint8_t header[kFLEXHeapDumpHeaderSize];
+    uint8_t *cursor = FLEXHeapDumpPut(header, kFLEXHeapDumpMagic, kFLEXHeapDumpMagicLength);
+    cursor = FLEXHeapDumpPut(cursor, &version, sizeof(version));
+    cursor = FLEXHeapDumpPut(cursor, &usedClassCount, sizeof(usedClassCount));
+    cursor = FLEXHeapDumpPut(cursor, &objectCount64, sizeof(objectCount64));
+    cursor = FLEXHeapDumpPut(cursor, &edgeCount, sizeof(edgeCount));
+    FLEXHeapDumpPut(cursor, &timestamp, sizeof(timestamp));
+    [writer writeBytes:header length:sizeof(header)];
+
+    Class __unsafe_unretained const *classes = graph.classes;
+    for (uint32_t slot = 0; slot < classCount; slot++) {
+        if (classIds[slot] != UINT32_MAX) {
+            const char *name = class_getName(classes[slot]);
+            uint16_t length = (uint16_t)MIN(strlen(name), UINT16_MAX);
+            [writer writeBytes:&length length:sizeof(length)];
+            [writer writeBytes:name length:length];
+        }
+    }
+
+    // Graph edges already refer to objects by their position in address order.
+    // Each record is assembled here first, so that it takes one write instead of one per field.
+    const uint32_t *edgeStarts = graph.edgeStarts;
+    const FLEXHeapEdge *edges = graph.edges;
+    uint8_t record[kFLEXHeapDumpObjectHeaderSize];
+    uint32_t targets[256];
+    for (uint32_t i = 0; i < objectCount && !writer.failed; i++) {
+        if (i % kFLEXHeapDumpProgressInterval == 0) {
+            if (progress.isCancelled) {
+                break;
+            }
+            progress.completedUnitCount = kFLEXHeapDumpGraphUnits +
+                kFLEXHeapDumpWriteUnits * (int64_t)i / objectCount;
+        }
+
+        FLEXHeapObject object = objects[i];
+        uint64_t address = object.address;
+        uint32_t referenceCount = edgeStarts[i + 1] - edgeStarts[i];
+        cursor = FLEXHeapDumpPut(record, &address, sizeof(address));
+        cursor = FLEXHeapDumpPut(cursor, &classIds[object.slot], sizeof(uint32_t));
+        cursor = FLEXHeapDumpPut(cursor, &object.size, sizeof(object.size));
+        FLEXHeapDumpPut(cursor, &referenceCount, sizeof(referenceCount));
+        [writer writeBytes:record length:sizeof(record)];
+
+        uint32_t count = 0;
+        for (uint32_t e = edgeStarts[i]; e < edgeStarts[i + 1]; e++) {
+            uint32_t flags = edges[e].label & kFLEXHeapEdgeUnowned ? kFLEXHeapDumpEdgeUnowned : 0;
+            targets[count++] = edges[e].target | flags;
+            if (count == sizeof(targets) / sizeof(targets[0])) {
+                [writer writeBytes:targets length:sizeof(targets)];
+                count = 0;
+            }
+        }
+        [writer writeBytes:targets length:count * sizeof(uint32_t)];
+    }
+    free(classIds);
+
+    if (progress.isCancelled) {
+        error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSUserCancelledError userInfo:nil];
+    }
+
+    error = [writer closeWithError:error];
+    if (!error) {
+        progress.completedUnitCount = progress.totalUnitCount;
+    }
+
+    return error;
+}
+
+@end
@@ -0,0 +1,52 @@
+//
+//  FLEXHeapDumpFormat.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+// The layout of heap dump files, shared by FLEXHeapDumpExporter and the flexheap
+// command-line tool in Tools/flexheap. Plain C, so that both can include it.
+//
+// Every integer is little-endian, and nothing is padded or aligned.
+//
+// Header, kFLEXHeapDumpHeaderSize bytes:
+//   char     magic[8]       "FLEXHEAP"
+//   uint32   version        kFLEXHeapDumpVersion
+//   uint32   classCount
+//   uint64   objectCount
+//   uint64   edgeCount      The total number of edges in every object record
+//   uint64   timestamp      Milliseconds since 1970
+//
+// Class names, classCount times. A class's id is its position in this table.
+//   uint16   length
+//   char     name[length]   UTF-8, not terminated
+//
+// Objects, objectCount times, in ascending order of address:
+//   uint64   address
+//   uint32   classId
+//   uint32   size           The malloc size of the object
+//   uint32   edgeCount
+//   uint32   edges[edgeCount]
+//
+// Each edge is the position of the referenced object among the object records. Edges
+// with kFLEXHeapDumpEdgeUnowned set are weak or unretained references.
+
+#ifndef FLEXHeapDumpFormat_h
+#define FLEXHeapDumpFormat_h
+
+#include <stdint.h>
+
+#define kFLEXHeapDumpMagic "FLEXHEAP"
+#define kFLEXHeapDumpMagicLength 8
+
+enum {
+    kFLEXHeapDumpVersion = 1,
+    kFLEXHeapDumpHeaderSize = 40,
+    kFLEXHeapDumpObjectHeaderSize = 20,
+};
+
+static const uint32_t kFLEXHeapDumpEdgeUnowned = 1u << 31;
+
+#endif /* FLEXHeapDumpFormat_h */
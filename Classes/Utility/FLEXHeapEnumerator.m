@@ -7,10 +7,11 @@
 //
 
 #import "FLEXHeapEnumerator.h"
+#import "FLEXHeapCensus.h"
+#import "FLEXHeapGraph.h"
+#import "FLEXHeapReferenceIndex.h"
 #import "FLEXObjcInternal.h"
 #import "FLEXObjectRef.h"
-#import "NSObject+FLEX_Reflection.h"
-#import "NSString+FLEX.h"
 #import <malloc/malloc.h>
 #import <mach/mach.h>
 #import <objc/runtime.h>
@@ -151,86 +152,83 @@ static kern_return_t reader(__unused task_t remote_task, vm_address_t remote_add
 }
 
 + (NSArray<FLEXObjectRef *> *)objectsWithReferencesToObject:(id)object retained:(BOOL)retain {
-    NSMutableArray<FLEXObjectRef *> *instances = [NSMutableArray new];
+    // The index only has edges to malloc'd objects. Classes, constant strings and
+    // tagged pointers are never in it, so rebuilding it for them would be wasted.
+    if (malloc_size((__bridge const void *)object) == 0) {
+        return [self objectsWithIvarsReferencingObject:object retained:retain];
+    }
+
+    // One pass over the heap answers every query until the index is invalidated.
+    // An object newer than the index has no referrers in it, so rebuild once for it.
+    FLEXHeapReferenceIndex *index = FLEXHeapReferenceIndex.sharedIndex;
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    if ([index.graph indexOfAddress:address] == UINT32_MAX) {
+        [FLEXHeapReferenceIndex invalidate];
+        index = FLEXHeapReferenceIndex.sharedIndex;
+    }
+
+    // Still missing if its class was not registered when the heap was walked
+    if (!index || [index.graph indexOfAddress:address] == UINT32_MAX) {
+        return [self objectsWithIvarsReferencingObject:object retained:retain];
+    }
+
+    return [index referencesToObject:object retained:retain] ?: @[];
+}
+
+/// One pass over the heap that checks the object ivars of every object for \c object.
+/// Each referrer is listed once, under the first matching ivar.
++ (NSArray<FLEXObjectRef *> *)objectsWithIvarsReferencingObject:(id)object retained:(BOOL)retain {
+    NSMutableArray<FLEXObjectRef *> *references = [NSMutableArray new];
+    uintptr_t target = (uintptr_t)(__bridge void *)object;
     [FLEXHeapEnumerator enumerateLiveObjectsUsingBlock:^(__unsafe_unretained id tryObject, __unsafe_unretained Class actualClass) {
         // Skip known-invalid objects
         if (!FLEXPointerIsValidObjcObject((__bridge void *)tryObject)) {
             return;
         }
-        
-        // Get all the ivars on the object. Start with the class and and travel up the
-        // inheritance chain. Once we find a match, record it and move on to the next object.
-        // There's no reason to find multiple matches within the same object.
-        Class tryClass = actualClass;
-        while (tryClass) {
+
+        for (Class tryClass = actualClass; tryClass; tryClass = class_getSuperclass(tryClass)) {
             unsigned int ivarCount = 0;
             Ivar *ivars = class_copyIvarList(tryClass, &ivarCount);
+            const char *match = NULL;
 
-            for (unsigned int ivarIndex = 0; ivarIndex < ivarCount; ivarIndex++) {
-                Ivar ivar = ivars[ivarIndex];
-                NSString *typeEncoding = @(ivar_getTypeEncoding(ivar) ?: "");
-
-                if (typeEncoding.flex_typeIsObjectOrClass) {
-                    ptrdiff_t offset = ivar_getOffset(ivar);
-                    uintptr_t *fieldPointer = (__bridge void *)tryObject + offset;
+            for (unsigned int i = 0; i < ivarCount && !match; i++) {
+                const char *type = ivar_getTypeEncoding(ivars[i]);
+                if (!type || (type[0] != '@' && type[0] != '#')) {
+                    continue;
+                }
 
-                    if (*fieldPointer == (uintptr_t)(__bridge void *)object) {
-                        NSString *ivarName = @(ivar_getName(ivar) ?: "???");
-                        id ref = [FLEXObjectRef referencing:tryObject ivar:ivarName retained:retain];
-                        [instances addObject:ref];
-                        return;
-                    }
+                uintptr_t *field = (uintptr_t *)((uint8_t *)(__bridge void *)tryObject + ivar_getOffset(ivars[i]));
+                if (*field == target) {
+                    match = ivar_getName(ivars[i]) ?: "???";
                 }
             }
 
+            NSString *ivarName = match ? @(match) : nil;
             free(ivars);
-            tryClass = class_getSuperclass(tryClass);
+            if (ivarName) {
+                [references addObject:[FLEXObjectRef referencing:tryObject ivar:ivarName retained:retain]];
+                return;
+            }
         }
     }];
 
-    return instances;
+    return references;
 }
 
 + (FLEXHeapSnapshot *)generateHeapSnapshot {
-    // Set up a CFMutableDictionary with class pointer keys and NSUInteger values.
-    // We abuse CFMutableDictionary a little to have primitive keys through judicious casting, but it gets the job done.
-    // The dictionary is intialized with a 0 count for each class so that it doesn't have to expand during enumeration.
-    // While it might be a little cleaner to populate an NSMutableDictionary with class name string keys to NSNumber
-    // counts, we choose the CF/primitives approach because it lets us enumerate the objects in the heap without
-    // allocating any memory during enumeration. The alternative of creating one NSString/NSNumber per object
-    // on the heap ends up polluting the count of live objects quite a bit.
-    unsigned int classCount = 0;
-    Class *classes = objc_copyClassList(&classCount);
-    CFMutableDictionaryRef mutableCountsForClasses = CFDictionaryCreateMutable(NULL, classCount, NULL, NULL);
-    for (unsigned int i = 0; i < classCount; i++) {
-        CFDictionarySetValue(mutableCountsForClasses, (__bridge const void *)classes[i], (const void *)0);
-    }
-    
-    // Enumerate all objects on the heap to build the counts of instances for each class
-    [FLEXHeapEnumerator enumerateLiveObjectsUsingBlock:^(__unsafe_unretained id object, __unsafe_unretained Class cls) {
-        NSUInteger instanceCount = (NSUInteger)CFDictionaryGetValue(
-            mutableCountsForClasses, (__bridge const void *)cls
-        );
-        instanceCount++;
-        CFDictionarySetValue(
-            mutableCountsForClasses, (__bridge const void *)cls, (const void *)instanceCount
-        );
-    }];
-    
-    // Convert our CF primitive dictionary into a nicer mapping of class name strings to instance counts
+    // The census counts without allocating anything while the heap is locked,
+    // so the snapshot does not count its own bookkeeping
+    FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+
     NSMutableDictionary<NSString *, NSNumber *> *countsForClassNames = [NSMutableDictionary new];
     NSMutableDictionary<NSString *, NSNumber *> *sizesForClassNames = [NSMutableDictionary new];
-    for (unsigned int i = 0; i < classCount; i++) {
-        Class class = classes[i];
-        NSUInteger instanceCount = (NSUInteger)CFDictionaryGetValue(mutableCountsForClasses, (__bridge const void *)(class));
-        NSString *className = @(class_getName(class));
-        
-        if (instanceCount > 0) {
-            countsForClassNames[className] = @(instanceCount);
-            sizesForClassNames[className] = @(class_getInstanceSize(class));
-        }
+    for (uint32_t i = 0; i < census.entryCount; i++) {
+        FLEXHeapCensusEntry entry = census.entries[i];
+        NSString *className = @(class_getName(entry.cls));
+        countsForClassNames[className] = @(entry.count);
+        sizesForClassNames[className] = @(class_getInstanceSize(entry.cls));
     }
-    free(classes);
+    FLEXHeapCensusResultFree(&census);
     
     return [FLEXHeapSnapshot snapshotWithCounts:countsForClassNames sizes:sizesForClassNames];
 }
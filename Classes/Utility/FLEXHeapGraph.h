@@ -0,0 +1,80 @@
+//
+//  FLEXHeapGraph.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "FLEXHeapCensus.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A reference from one object in the graph to another
+typedef struct {
+    /// The index of the referenced object
+    uint32_t target;
+    /// Describes the reference; see \c -[FLEXHeapGraph nameOfLabel:]
+    uint32_t label;
+} FLEXHeapEdge;
+
+/// Set on the label of references that do not keep their target alive,
+/// such as weak or \c __unsafe_unretained ivars and weak block captures
+static const uint32_t kFLEXHeapEdgeUnowned = 1u << 31;
+
+typedef NS_OPTIONS(NSUInteger, FLEXHeapGraphOptions) {
+    FLEXHeapGraphOptionsNone = 0,
+    /// Leaves out references flagged \c kFLEXHeapEdgeUnowned
+    FLEXHeapGraphOptionsOwnedReferencesOnly = 1 << 0,
+};
+
+/// Every object on the heap and the references between them, as of when it was built.
+///
+/// Objects are sorted by address and their outgoing references stored in one compressed
+/// array, so the graph costs 16 bytes per object and 8 bytes per reference. References are
+/// read from object ivars, the contents of Foundation collections, and block captures.
+/// Ivars are found through a layout table computed once per class; only pointers to
+/// the start of another object in the graph are kept.
+///
+/// Objects freed after the graph was built are not removed from it. Validate an object
+/// with \c FLEXPointerIsValidObjcObject before messaging it.
+@interface FLEXHeapGraph : NSObject
+
+/// Builds the graph of the live heap. Call from a background queue; this reads every object.
+/// @param progress Optional, counted in objects. When cancelled, the build stops and returns \c nil.
++ (nullable instancetype)graphOfLiveObjectsWithProgress:(nullable NSProgress *)progress;
+/// @param byteLimit The most memory the graph may use, or 0 for no limit. The build
+/// stops and returns \c nil as soon as the graph would grow past it.
++ (nullable instancetype)graphOfLiveObjectsWithOptions:(FLEXHeapGraphOptions)options
+                                             byteLimit:(size_t)byteLimit
+                                              progress:(nullable NSProgress *)progress;
+
+@property (nonatomic, readonly) NSDate *date;
+@property (nonatomic, readonly) uint32_t objectCount;
+@property (nonatomic, readonly) uint32_t edgeCount;
+/// The memory used by the graph's arrays
+@property (nonatomic, readonly) size_t byteCount;
+
+/// Sorted by address. \c slot indexes \c classes.
+@property (nonatomic, readonly) const FLEXHeapObject *objects;
+@property (nonatomic, readonly) Class __unsafe_unretained const *classes;
+@property (nonatomic, readonly) uint32_t classCount;
+
+/// The edges of object \c i are \c edges[edgeStarts[i]] up to \c edges[edgeStarts[i + 1]]
+@property (nonatomic, readonly) const uint32_t *edgeStarts;
+@property (nonatomic, readonly) const FLEXHeapEdge *edges;
+
+/// @return \c UINT32_MAX if no object in the graph starts at the address
+- (uint32_t)indexOfAddress:(uintptr_t)address;
+- (Class)classOfObjectAtIndex:(uint32_t)index;
+
+/// The ivar name of a reference, or a description like "[element]" for collection contents
+/// and block captures. The unowned bit of the label is ignored.
+- (const char *)nameOfLabel:(uint32_t)label;
+/// The offset of the ivar within its object, or -1 for references that are not ivars
+- (ptrdiff_t)offsetOfLabel:(uint32_t)label;
+
+@end
+
+NS_ASSUME_NONNULL_END
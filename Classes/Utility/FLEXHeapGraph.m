@@ -0,0 +1,556 @@
+//
+//  FLEXHeapGraph.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapGraph.h"
+#import <objc/runtime.h>
+#import <malloc/malloc.h>
+
+/// How often the build checks for cancellation and reports progress, in objects
+static const uint32_t kFLEXHeapGraphProgressInterval = 1 << 16;
+/// Captures past this many in one block are ignored
+static const unsigned kFLEXHeapGraphMaxCaptures = 64;
+
+typedef NS_ENUM(uint8_t, FLEXHeapObjectKind) {
+    FLEXHeapObjectKindPlain = 1,
+    FLEXHeapObjectKindArray,
+    FLEXHeapObjectKindDictionary,
+    FLEXHeapObjectKindSet,
+    FLEXHeapObjectKindBlock,
+};
+
+/// Labels with fixed meanings; ivar labels follow
+typedef NS_ENUM(uint32_t, FLEXHeapLabel) {
+    FLEXHeapLabelElement,
+    FLEXHeapLabelKey,
+    FLEXHeapLabelValue,
+    FLEXHeapLabelMember,
+    FLEXHeapLabelCaptured,
+    FLEXHeapLabelFirstIvar,
+};
+
+/// The object references in instances of one class, as a range of \c _references
+typedef struct {
+    uint32_t first;
+    uint16_t count;
+    FLEXHeapObjectKind kind;
+} FLEXClassLayout;
+
+typedef struct {
+    int32_t offset;
+    /// Including \c kFLEXHeapEdgeUnowned
+    uint32_t label;
+} FLEXLayoutReference;
+
+typedef struct {
+    const char *name;
+    int32_t offset;
+} FLEXLabelInfo;
+
+#pragma mark Block ABI
+
+// From https://clang.llvm.org/docs/Block-ABI-Apple.html and Block_private.h
+enum {
+    FLEXBlockHasCopyDispose = 1 << 25,
+    FLEXBlockHasSignature = 1 << 30,
+    FLEXBlockHasExtendedLayout = 1 << 31,
+};
+
+typedef struct {
+    uintptr_t reserved;
+    uintptr_t size;
+    // void (*copy)(void *dst, const void *src) and void (*dispose)(const void *) with copy/dispose
+    // const char *signature and const char *layout with a signature
+} FLEXBlockDescriptor;
+
+typedef struct {
+    void *isa;
+    int32_t flags;
+    int32_t reserved;
+    void *invoke;
+    FLEXBlockDescriptor *descriptor;
+} FLEXBlockLiteral;
+
+/// Finds the words of a block's captures that may point to objects.
+/// @return The number of captures written to \c offsets and \c owned
+static unsigned FLEXBlockObjectCaptures(const FLEXBlockLiteral *block, size_t mallocSize,
+                                        uint32_t *offsets, BOOL *owned) {
+    const FLEXBlockDescriptor *descriptor = block->descriptor;
+    int32_t flags = block->flags;
+    if (!descriptor || !(flags & FLEXBlockHasCopyDispose)) {
+        // Without copy/dispose helpers a block captures no objects
+        return 0;
+    }
+
+    size_t size = MIN(descriptor->size, mallocSize);
+    uint32_t offset = sizeof(FLEXBlockLiteral);
+    unsigned count = 0;
+
+    const char *layout = NULL;
+    if ((flags & FLEXBlockHasSignature) && (flags & FLEXBlockHasExtendedLayout)) {
+        const void *const *extra = (const void *const *)(descriptor + 1);
+        layout = extra[2 + 1];
+    }
+
+    // Appends n words starting at offset, then moves past them
+    #define FLEXAppendCaptureWords(n, isOwned) \
+        for (unsigned w = 0; w < (n) && offset + sizeof(void *) <= size; w++, offset += sizeof(void *)) { \
+            if (count < kFLEXHeapGraphMaxCaptures) { \
+                offsets[count] = offset; owned[count] = (isOwned); count++; \
+            } \
+        }
+
+    if (!layout) {
+        // No layout to go by, so every word might be a retained object
+        FLEXAppendCaptureWords((size - offset) / sizeof(void *), YES);
+    } else if ((uintptr_t)layout < 0x1000) {
+        // Inline layout 0xXYZ: X strong words, then Y __block variables, then Z weak words
+        uintptr_t inlineLayout = (uintptr_t)layout;
+        FLEXAppendCaptureWords((inlineLayout >> 8) & 0xF, YES);
+        offset += ((inlineLayout >> 4) & 0xF) * sizeof(void *);
+        FLEXAppendCaptureWords(inlineLayout & 0xF, NO);
+    } else {
+        for (const uint8_t *op = (const uint8_t *)layout; *op && offset < size; op++) {
+            unsigned n = (*op & 0xF) + 1;
+            switch (*op >> 4) {
+                case 0x1: offset += n; break;                           // Non-object bytes
+                case 0x2: offset += n * sizeof(void *); break;          // Non-object words
+                case 0x3: FLEXAppendCaptureWords(n, YES); break;        // Strong
+                case 0x4: offset += n * sizeof(void *); break;          // __block variables
+                case 0x5: case 0x6: FLEXAppendCaptureWords(n, NO); break; // Weak, unretained
+                default: return count;
+            }
+        }
+    }
+
+    #undef FLEXAppendCaptureWords
+    return count;
+}
+
+#pragma mark Ivar Layouts
+
+/// Whether the word at an index is included in a class's ivar layout bitmap, as in objc4's \c isScanned
+static BOOL FLEXIvarLayoutIncludesWord(const uint8_t *layout, ptrdiff_t wordIndex) {
+    if (!layout) {
+        return NO;
+    }
+
+    ptrdiff_t index = 0;
+    for (uint8_t byte; (byte = *layout++); ) {
+        index += byte >> 4;
+        if (index > wordIndex) {
+            return NO;
+        }
+        index += byte & 0xF;
+        if (index > wordIndex) {
+            return YES;
+        }
+    }
+
+    return NO;
+}
+
+static FLEXHeapObjectKind FLEXKindOfClass(Class cls) {
+    // Only Foundation's own concrete classes, whose contents can be read without side effects
+    static NSDictionary<NSString *, NSNumber *> *collections = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        NSNumber *array = @(FLEXHeapObjectKindArray);
+        NSNumber *dictionary = @(FLEXHeapObjectKindDictionary);
+        NSNumber *set = @(FLEXHeapObjectKindSet);
+        collections = @{
+            @"__NSArrayI": array, @"__NSArrayM": array, @"__NSSingleObjectArrayI": array,
+            @"__NSFrozenArrayM": array, @"__NSCFArray": array, @"__NSArrayI_Transfer": array,
+            @"__NSDictionaryI": dictionary, @"__NSDictionaryM": dictionary,
+            @"__NSSingleEntryDictionaryI": dictionary, @"__NSFrozenDictionaryM": dictionary,
+            @"__NSCFDictionary": dictionary,
+            @"__NSSetI": set, @"__NSSetM": set, @"__NSSingleObjectSetI": set,
+            @"__NSFrozenSetM": set, @"__NSCFSet": set,
+            @"__NSMallocBlock__": @(FLEXHeapObjectKindBlock),
+        };
+    });
+
+    return collections[@(class_getName(cls))].unsignedCharValue ?: FLEXHeapObjectKindPlain;
+}
+
+#pragma mark - FLEXHeapGraph
+
+@implementation FLEXHeapGraph {
+    FLEXHeapObjectList _list;
+    uint32_t *_edgeStarts;
+    FLEXHeapEdge *_edges;
+    uint32_t _edgeCapacity;
+    uintptr_t _isaMask;
+    FLEXHeapGraphOptions _options;
+    size_t _byteLimit;
+    BOOL _exceededByteLimit;
+
+    /// Indexed by class slot; a zero kind is not computed yet
+    FLEXClassLayout *_layouts;
+    FLEXLayoutReference *_references;
+    uint32_t _referenceCount, _referenceCapacity;
+    FLEXLabelInfo *_labels;
+    uint32_t _labelCount, _labelCapacity;
+    /// Ivar to label
+    CFMutableDictionaryRef _ivarLabels;
+
+    /// Reused for the contents of each collection
+    const void **_contents;
+    CFIndex _contentsCapacity;
+}
+
++ (instancetype)graphOfLiveObjectsWithProgress:(NSProgress *)progress {
+    return [self graphOfLiveObjectsWithOptions:FLEXHeapGraphOptionsNone byteLimit:0 progress:progress];
+}
+
++ (instancetype)graphOfLiveObjectsWithOptions:(FLEXHeapGraphOptions)options
+                                    byteLimit:(size_t)byteLimit
+                                     progress:(NSProgress *)progress {
+    FLEXHeapGraph *graph = [self new];
+    graph->_options = options;
+    graph->_byteLimit = byteLimit ?: SIZE_MAX;
+    return [graph buildWithProgress:progress] ? graph : nil;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _date = [NSDate date];
+        _ivarLabels = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+#ifdef __arm64__
+        extern uint64_t objc_debug_isa_class_mask WEAK_IMPORT_ATTRIBUTE;
+        _isaMask = (uintptr_t)objc_debug_isa_class_mask;
+#else
+        _isaMask = UINTPTR_MAX;
+#endif
+
+        const char *fixedLabels[] = { "[element]", "[key]", "[value]", "[member]", "[captured]" };
+        for (uint32_t i = 0; i < FLEXHeapLabelFirstIvar; i++) {
+            [self addLabel:fixedLabels[i] offset:-1];
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    FLEXHeapObjectListFree(&_list);
+    free(_edgeStarts);
+    free(_edges);
+    free(_layouts);
+    free(_references);
+    free(_labels);
+    free(_contents);
+    CFRelease(_ivarLabels);
+}
+
+#pragma mark Accessors
+
+- (uint32_t)objectCount {
+    return (uint32_t)_list.count;
+}
+
+- (const FLEXHeapObject *)objects {
+    return _list.objects;
+}
+
+- (Class __unsafe_unretained const *)classes {
+    return _list.classes;
+}
+
+- (uint32_t)classCount {
+    return _list.classCount;
+}
+
+- (const uint32_t *)edgeStarts {
+    return _edgeStarts;
+}
+
+- (const FLEXHeapEdge *)edges {
+    return _edges;
+}
+
+- (size_t)byteCount {
+    return [self byteCountWithEdgeCapacity:_edgeCapacity];
+}
+
+- (size_t)byteCountWithEdgeCapacity:(uint32_t)edgeCapacity {
+    return (size_t)_list.count * (sizeof(FLEXHeapObject) + sizeof(uint32_t))
+        + (size_t)_list.classCount * sizeof(Class)
+        + (size_t)_labelCapacity * sizeof(FLEXLabelInfo)
+        + (size_t)edgeCapacity * sizeof(FLEXHeapEdge);
+}
+
+- (uint32_t)indexOfAddress:(uintptr_t)address {
+    const FLEXHeapObject *objects = _list.objects;
+    uint32_t low = 0, high = (uint32_t)_list.count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (objects[mid].address < address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low < _list.count && objects[low].address == address ? low : UINT32_MAX;
+}
+
+- (Class)classOfObjectAtIndex:(uint32_t)index {
+    return _list.classes[_list.objects[index].slot];
+}
+
+- (const char *)nameOfLabel:(uint32_t)label {
+    return _labels[label & ~kFLEXHeapEdgeUnowned].name;
+}
+
+- (ptrdiff_t)offsetOfLabel:(uint32_t)label {
+    return _labels[label & ~kFLEXHeapEdgeUnowned].offset;
+}
+
+#pragma mark Layouts
+
+- (uint32_t)addLabel:(const char *)name offset:(int32_t)offset {
+    if (_labelCount == _labelCapacity) {
+        _labelCapacity = MAX(_labelCapacity * 2, 256);
+        _labels = realloc(_labels, _labelCapacity * sizeof(FLEXLabelInfo));
+    }
+
+    _labels[_labelCount] = (FLEXLabelInfo){ name, offset };
+    return _labelCount++;
+}
+
+- (void)addReference:(FLEXLayoutReference)reference {
+    if (_referenceCount == _referenceCapacity) {
+        _referenceCapacity = MAX(_referenceCapacity * 2, 1024);
+        _references = realloc(_references, _referenceCapacity * sizeof(FLEXLayoutReference));
+    }
+
+    _references[_referenceCount++] = reference;
+}
+
+/// Every object ivar of the class and its superclasses, computed once per class
+- (const FLEXClassLayout *)layoutForSlot:(uint32_t)slot {
+    FLEXClassLayout *layout = &_layouts[slot];
+    if (layout->kind) {
+        return layout;
+    }
+
+    Class cls = _list.classes[slot];
+    layout->first = _referenceCount;
+    layout->kind = FLEXKindOfClass(cls);
+
+    for (Class current = cls; current; current = class_getSuperclass(current)) {
+        unsigned int ivarCount = 0;
+        Ivar *ivars = class_copyIvarList(current, &ivarCount);
+        if (!ivars) {
+            continue;
+        }
+
+        // Layout bitmaps start at the end of the superclass's ivars
+        Class superclass = class_getSuperclass(current);
+        ptrdiff_t start = superclass ? class_getInstanceSize(superclass) : 0;
+        const uint8_t *strongLayout = class_getIvarLayout(current);
+        const uint8_t *weakLayout = class_getWeakIvarLayout(current);
+
+        for (unsigned int i = 0; i < ivarCount; i++) {
+            const char *type = ivar_getTypeEncoding(ivars[i]);
+            ptrdiff_t offset = ivar_getOffset(ivars[i]);
+            if (!type || (type[0] != '@' && type[0] != '#') || offset < 0 || offset % sizeof(void *)) {
+                continue;
+            }
+
+            // Classes without layouts are not ARC, so treat their object ivars as retained
+            ptrdiff_t word = (offset - start) / (ptrdiff_t)sizeof(void *);
+            BOOL owned = (!strongLayout && !weakLayout) || FLEXIvarLayoutIncludesWord(strongLayout, word);
+
+            uintptr_t label = (uintptr_t)CFDictionaryGetValue(_ivarLabels, ivars[i]);
+            if (!label) {
+                label = [self addLabel:ivar_getName(ivars[i]) ?: "???" offset:(int32_t)offset];
+                CFDictionarySetValue(_ivarLabels, ivars[i], (const void *)label);
+            }
+
+            [self addReference:(FLEXLayoutReference){
+                (int32_t)offset, (uint32_t)label | (owned ? 0 : kFLEXHeapEdgeUnowned)
+            }];
+        }
+
+        free(ivars);
+    }
+
+    layout->count = (uint16_t)MIN(_referenceCount - layout->first, UINT16_MAX);
+    return layout;
+}
+
+#pragma mark Building
+
+- (void)addEdgeTo:(uintptr_t)value label:(uint32_t)label {
+    if ((label & kFLEXHeapEdgeUnowned) && (_options & FLEXHeapGraphOptionsOwnedReferencesOnly)) {
+        return;
+    }
+
+    // Cheap checks first; most words are not pointers to objects
+    const FLEXHeapObject *objects = _list.objects;
+    if (value < objects[0].address || value > objects[_list.count - 1].address || value % 16) {
+        return;
+    }
+
+    uint32_t target = [self indexOfAddress:value];
+    if (target == UINT32_MAX || _edgeCount == UINT32_MAX || _exceededByteLimit) {
+        return;
+    }
+
+    if (_edgeCount == _edgeCapacity) {
+        uint32_t capacity = _edgeCapacity < UINT32_MAX / 2 ? _edgeCapacity * 2 : UINT32_MAX;
+        if ([self byteCountWithEdgeCapacity:capacity] > _byteLimit) {
+            // Use whatever is left before giving up
+            size_t used = [self byteCountWithEdgeCapacity:_edgeCapacity];
+            size_t remaining = used < _byteLimit ? _byteLimit - used : 0;
+            capacity = _edgeCapacity + (uint32_t)MIN(remaining / sizeof(FLEXHeapEdge), capacity - _edgeCapacity);
+            if (capacity == _edgeCapacity) {
+                _exceededByteLimit = YES;
+                return;
+            }
+        }
+
+        _edgeCapacity = capacity;
+        _edges = realloc(_edges, (size_t)_edgeCapacity * sizeof(FLEXHeapEdge));
+    }
+
+    _edges[_edgeCount++] = (FLEXHeapEdge){ target, label };
+}
+
+- (void)reserveContents:(CFIndex)count {
+    if (count > _contentsCapacity) {
+        _contentsCapacity = MAX(count, _contentsCapacity * 2);
+        free(_contents);
+        _contents = malloc(_contentsCapacity * 2 * sizeof(void *));
+    }
+}
+
+- (void)addEdgesOfCollection:(CFTypeRef)collection kind:(FLEXHeapObjectKind)kind {
+    switch (kind) {
+        case FLEXHeapObjectKindArray: {
+            CFIndex count = CFArrayGetCount(collection);
+            [self reserveContents:count];
+            CFArrayGetValues(collection, CFRangeMake(0, count), _contents);
+            for (CFIndex i = 0; i < count; i++) {
+                [self addEdgeTo:(uintptr_t)_contents[i] label:FLEXHeapLabelElement];
+            }
+            break;
+        }
+        case FLEXHeapObjectKindDictionary: {
+            CFIndex count = CFDictionaryGetCount(collection);
+            [self reserveContents:count];
+            CFDictionaryGetKeysAndValues(collection, _contents, _contents + count);
+            for (CFIndex i = 0; i < count; i++) {
+                [self addEdgeTo:(uintptr_t)_contents[i] label:FLEXHeapLabelKey];
+                [self addEdgeTo:(uintptr_t)_contents[count + i] label:FLEXHeapLabelValue];
+            }
+            break;
+        }
+        case FLEXHeapObjectKindSet: {
+            CFIndex count = CFSetGetCount(collection);
+            [self reserveContents:count];
+            CFSetGetValues(collection, _contents);
+            for (CFIndex i = 0; i < count; i++) {
+                [self addEdgeTo:(uintptr_t)_contents[i] label:FLEXHeapLabelMember];
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+- (BOOL)buildWithProgress:(NSProgress *)progress {
+    _list = [FLEXHeapCensus.sharedCensus collectObjects];
+    if (!_list.count) {
+        return NO;
+    }
+
+    qsort_b(_list.objects, _list.count, sizeof(FLEXHeapObject), ^int(const void *a, const void *b) {
+        uintptr_t x = ((const FLEXHeapObject *)a)->address, y = ((const FLEXHeapObject *)b)->address;
+        return x < y ? -1 : x > y;
+    });
+
+    uint32_t objectCount = (uint32_t)MIN(_list.count, UINT32_MAX - 1);
+    _list.count = objectCount;
+    progress.totalUnitCount = objectCount;
+
+    if ([self byteCountWithEdgeCapacity:0] > _byteLimit) {
+        return NO;
+    }
+
+    // Start with room for a couple of references per object, within the limit
+    size_t remaining = _byteLimit - [self byteCountWithEdgeCapacity:0];
+    _edgeCapacity = (uint32_t)MIN(MIN((size_t)objectCount * 2, remaining / sizeof(FLEXHeapEdge)), UINT32_MAX);
+    _edgeCapacity = MAX(_edgeCapacity, 1);
+
+    _layouts = calloc(MAX(_list.classCount, 1), sizeof(FLEXClassLayout));
+    _edgeStarts = malloc(((size_t)objectCount + 1) * sizeof(uint32_t));
+    _edges = malloc((size_t)_edgeCapacity * sizeof(FLEXHeapEdge));
+
+    uint32_t captureOffsets[kFLEXHeapGraphMaxCaptures];
+    BOOL captureOwned[kFLEXHeapGraphMaxCaptures];
+
+    for (uint32_t i = 0; i < objectCount; i++) {
+        if (_exceededByteLimit) {
+            return NO;
+        }
+        if (i % kFLEXHeapGraphProgressInterval == 0) {
+            if (progress.isCancelled) {
+                return NO;
+            }
+            progress.completedUnitCount = i;
+        }
+
+        _edgeStarts[i] = _edgeCount;
+        FLEXHeapObject object = _list.objects[i];
+        const uint8_t *bytes = (const uint8_t *)object.address;
+
+        // Skip objects that were freed or reused since they were listed
+        if ((*(const uintptr_t *)bytes & _isaMask) != (uintptr_t)(__bridge void *)_list.classes[object.slot]) {
+            continue;
+        }
+
+        const FLEXClassLayout *layout = [self layoutForSlot:object.slot];
+        for (uint32_t r = layout->first; r < layout->first + layout->count; r++) {
+            FLEXLayoutReference reference = _references[r];
+            if (reference.offset + sizeof(void *) <= object.size) {
+                [self addEdgeTo:*(const uintptr_t *)(bytes + reference.offset) label:reference.label];
+            }
+        }
+
+        if (layout->kind == FLEXHeapObjectKindBlock) {
+            unsigned count = FLEXBlockObjectCaptures(
+                (const FLEXBlockLiteral *)bytes, object.size, captureOffsets, captureOwned
+            );
+            for (unsigned c = 0; c < count; c++) {
+                uint32_t label = FLEXHeapLabelCaptured | (captureOwned[c] ? 0 : kFLEXHeapEdgeUnowned);
+                [self addEdgeTo:*(const uintptr_t *)(bytes + captureOffsets[c]) label:label];
+            }
+        } else if (layout->kind != FLEXHeapObjectKindPlain) {
+            [self addEdgesOfCollection:(CFTypeRef)bytes kind:layout->kind];
+        }
+    }
+
+    if (_exceededByteLimit) {
+        return NO;
+    }
+
+    _edgeStarts[objectCount] = _edgeCount;
+    progress.completedUnitCount = objectCount;
+
+    // Layouts are only needed while building
+    free(_layouts); _layouts = NULL;
+    free(_references); _references = NULL;
+    free(_contents); _contents = NULL;
+    return YES;
+}
+
+@end
@@ -0,0 +1,44 @@
+//
+//  FLEXHeapReferenceIndex.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+@class FLEXHeapGraph, FLEXObjectRef;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Answers "which objects reference this one" from a single pass over the heap.
+///
+/// The references of a \c FLEXHeapGraph are inverted into one compressed array of
+/// referrers per object, so each query is a binary search and a short walk instead
+/// of another pass over the heap. The index reflects the heap as of when it was built.
+@interface FLEXHeapReferenceIndex : NSObject
+
+/// Built on first use, and again after \c invalidate. It is discarded 30 seconds
+/// after it was built, so it neither answers from nor keeps an old heap for long.
+@property (nonatomic, readonly, class) FLEXHeapReferenceIndex *sharedIndex;
+/// Discards the shared index, so that the next query sees the current heap
++ (void)invalidate;
+
++ (instancetype)indexWithGraph:(FLEXHeapGraph *)graph;
+
+@property (nonatomic, readonly) FLEXHeapGraph *graph;
+
+/// The indexes of the objects in \c graph that reference the object at an index
+/// @param count The number of referrers, which may include the same object more than once
+- (const uint32_t *)referrersOfObjectAtIndex:(uint32_t)index count:(uint32_t *)count;
+/// The label of each referrer, parallel to \c referrersOfObjectAtIndex:count:
+- (const uint32_t *)labelsOfReferrersOfObjectAtIndex:(uint32_t)index;
+
+/// One reference per object still referencing \c object, named after the ivar or
+/// collection role of the first reference found. Referrers are validated with
+/// \c FLEXPointerIsValidObjcObject, and ivar references are checked against the current heap.
+- (NSArray<FLEXObjectRef *> *)referencesToObject:(id)object retained:(BOOL)retain;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,168 @@
+//
+//  FLEXHeapReferenceIndex.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapReferenceIndex.h"
+#import "FLEXHeapGraph.h"
+#import "FLEXObjcInternal.h"
+#import "FLEXObjectRef.h"
+#import <os/lock.h>
+
+static FLEXHeapReferenceIndex *sharedIndex = nil;
+static os_unfair_lock sharedIndexLock = OS_UNFAIR_LOCK_INIT;
+/// Long enough to follow a chain of referrers, short enough not to hold on to a stale heap
+static const NSTimeInterval kFLEXSharedIndexLifetime = 30;
+
+@implementation FLEXHeapReferenceIndex {
+    /// The referrers of object \c i are \c _referrers[_referrerStarts[i]] up to \c _referrerStarts[i + 1]
+    uint32_t *_referrerStarts;
+    uint32_t *_referrers;
+    uint32_t *_labels;
+}
+
++ (FLEXHeapReferenceIndex *)sharedIndex {
+    os_unfair_lock_lock(&sharedIndexLock);
+    if (!sharedIndex) {
+        FLEXHeapGraph *graph = [FLEXHeapGraph graphOfLiveObjectsWithProgress:nil];
+        if (graph) {
+            sharedIndex = [self indexWithGraph:graph];
+
+            __weak FLEXHeapReferenceIndex *built = sharedIndex;
+            dispatch_after(
+                dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kFLEXSharedIndexLifetime * NSEC_PER_SEC)),
+                dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+                    [self invalidateIndex:built];
+                }
+            );
+        }
+    }
+    FLEXHeapReferenceIndex *index = sharedIndex;
+    os_unfair_lock_unlock(&sharedIndexLock);
+
+    return index;
+}
+
++ (void)invalidate {
+    os_unfair_lock_lock(&sharedIndexLock);
+    FLEXHeapReferenceIndex *index = sharedIndex;
+    sharedIndex = nil;
+    os_unfair_lock_unlock(&sharedIndexLock);
+
+    // Released outside the lock, since freeing a large graph takes a moment
+    index = nil;
+}
+
+/// Discards the shared index only if it is still \c index, and not one built since
++ (void)invalidateIndex:(FLEXHeapReferenceIndex *)index {
+    os_unfair_lock_lock(&sharedIndexLock);
+    FLEXHeapReferenceIndex *discarded = nil;
+    if (index && sharedIndex == index) {
+        discarded = sharedIndex;
+        sharedIndex = nil;
+    }
+    os_unfair_lock_unlock(&sharedIndexLock);
+
+    discarded = nil;
+}
+
++ (instancetype)indexWithGraph:(FLEXHeapGraph *)graph {
+    return [[self alloc] initWithGraph:graph];
+}
+
+- (instancetype)initWithGraph:(FLEXHeapGraph *)graph {
+    self = [super init];
+    if (self) {
+        _graph = graph;
+
+        uint32_t objectCount = graph.objectCount;
+        uint32_t edgeCount = graph.edgeCount;
+        const uint32_t *edgeStarts = graph.edgeStarts;
+        const FLEXHeapEdge *edges = graph.edges;
+
+        // Counting sort of the edges by target. Sources are visited in order,
+        // so each object's referrers end up sorted by address.
+        _referrerStarts = calloc((size_t)objectCount + 1, sizeof(uint32_t));
+        _referrers = malloc(MAX(edgeCount, 1) * sizeof(uint32_t));
+        _labels = malloc(MAX(edgeCount, 1) * sizeof(uint32_t));
+
+        for (uint32_t e = 0; e < edgeCount; e++) {
+            _referrerStarts[edges[e].target + 1]++;
+        }
+        for (uint32_t i = 0; i < objectCount; i++) {
+            _referrerStarts[i + 1] += _referrerStarts[i];
+        }
+
+        uint32_t *next = malloc(MAX(objectCount, 1) * sizeof(uint32_t));
+        memcpy(next, _referrerStarts, objectCount * sizeof(uint32_t));
+        for (uint32_t source = 0; source < objectCount; source++) {
+            for (uint32_t e = edgeStarts[source]; e < edgeStarts[source + 1]; e++) {
+                uint32_t slot = next[edges[e].target]++;
+                _referrers[slot] = source;
+                _labels[slot] = edges[e].label;
+            }
+        }
+        free(next);
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_referrerStarts);
+    free(_referrers);
+    free(_labels);
+}
+
+- (const uint32_t *)referrersOfObjectAtIndex:(uint32_t)index count:(uint32_t *)count {
+    *count = _referrerStarts[index + 1] - _referrerStarts[index];
+    return _referrers + _referrerStarts[index];
+}
+
+- (const uint32_t *)labelsOfReferrersOfObjectAtIndex:(uint32_t)index {
+    return _labels + _referrerStarts[index];
+}
+
+- (NSArray<FLEXObjectRef *> *)referencesToObject:(id)object retained:(BOOL)retain {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    uint32_t index = [self.graph indexOfAddress:address];
+    if (index == UINT32_MAX) {
+        return @[];
+    }
+
+    uint32_t count = 0;
+    const uint32_t *referrers = [self referrersOfObjectAtIndex:index count:&count];
+    const uint32_t *labels = [self labelsOfReferrersOfObjectAtIndex:index];
+    const FLEXHeapObject *objects = self.graph.objects;
+
+    NSMutableArray<FLEXObjectRef *> *references = [NSMutableArray new];
+    for (uint32_t i = 0; i < count; i++) {
+        // Referrers are sorted, so repeat references from the same object are adjacent
+        if (i > 0 && referrers[i] == referrers[i - 1]) {
+            continue;
+        }
+
+        void *referrer = (void *)objects[referrers[i]].address;
+        if (!FLEXPointerIsValidObjcObject(referrer)) {
+            continue;
+        }
+
+        // The referrer may have let go of the object since the index was built
+        ptrdiff_t offset = [self.graph offsetOfLabel:labels[i]];
+        if (offset >= 0 && *(uintptr_t *)((uint8_t *)referrer + offset) != address) {
+            continue;
+        }
+
+        NSString *name = @([self.graph nameOfLabel:labels[i]]);
+        [references addObject:[FLEXObjectRef
+            referencing:(__bridge id)referrer ivar:name retained:retain
+        ]];
+    }
+
+    return references;
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+//  FLEXHeapSnapshotStore.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The instance counts of every class at one point in time, from \c FLEXHeapCensus.
+///
+/// Only classes with instances are kept, as a sorted array of 16-byte
+/// {class index, count, bytes} records, so a snapshot of a large app is a few hundred KB.
+@interface FLEXHeapCensusSnapshot : NSObject
+
+@property (nonatomic, readonly) NSString *name;
+@property (nonatomic, readonly) NSDate *date;
+@property (nonatomic, readonly) uint64_t objectCount;
+@property (nonatomic, readonly) uint64_t byteCount;
+/// The number of classes with at least one instance
+@property (nonatomic, readonly) NSUInteger classCount;
+
+@end
+
+/// How one class changed between two snapshots
+@interface FLEXHeapClassDelta : NSObject
+
+@property (nonatomic, readonly) NSString *className;
+@property (nonatomic, readonly) uint64_t countBefore;
+@property (nonatomic, readonly) uint64_t countAfter;
+@property (nonatomic, readonly) uint64_t bytesBefore;
+@property (nonatomic, readonly) uint64_t bytesAfter;
+
+@property (nonatomic, readonly) int64_t countDelta;
+@property (nonatomic, readonly) int64_t bytesDelta;
+
+@end
+
+/// Keeps named heap snapshots and compares them to find what grew.
+@interface FLEXHeapSnapshotStore : NSObject
+
+@property (nonatomic, readonly, class) FLEXHeapSnapshotStore *sharedStore;
+
+/// Oldest first. Only access from the main thread.
+@property (nonatomic, readonly) NSArray<FLEXHeapCensusSnapshot *> *snapshots;
+
+/// Takes a census in the background and adds it to \c snapshots
+/// @param completion Called on the main queue
+- (void)captureSnapshotNamed:(NSString *)name completion:(nullable void(^)(FLEXHeapCensusSnapshot *snapshot))completion;
+- (void)removeSnapshot:(FLEXHeapCensusSnapshot *)snapshot;
+- (void)removeAllSnapshots;
+
+/// Every class whose count or size changed, in no particular order
+- (NSArray<FLEXHeapClassDelta *> *)diffFromSnapshot:(FLEXHeapCensusSnapshot *)before
+                                         toSnapshot:(FLEXHeapCensusSnapshot *)after;
+
+/// Classes whose count never went down from one snapshot to the next and grew
+/// by at least one instance per step overall, which is what a leak looks like when
+/// the same action is repeated between snapshots.
+///
+/// @param snapshots Oldest first; at least two
+/// @return Deltas between the first and last snapshot
+- (NSArray<FLEXHeapClassDelta *> *)monotonicGrowersInSnapshots:(NSArray<FLEXHeapCensusSnapshot *> *)snapshots;
+
+/// Takes a baseline snapshot, then runs the action \c times times with a snapshot after each
+/// run, and reports the classes that grew every time. Everything is added to \c snapshots.
+///
+/// @param action Called on the main queue. Call \c done when the action has finished,
+/// such as after a screen was presented and dismissed again.
+/// @param completion Called on the main queue with the new snapshots, oldest first,
+/// and the result of \c monotonicGrowersInSnapshots: for them
+- (void)repeatActionNamed:(NSString *)name
+                    times:(NSUInteger)times
+                   action:(void(^)(dispatch_block_t done))action
+               completion:(void(^)(NSArray<FLEXHeapCensusSnapshot *> *snapshots,
+                                   NSArray<FLEXHeapClassDelta *> *growers))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
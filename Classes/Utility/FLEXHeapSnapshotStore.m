@@ -0,0 +1,329 @@
+//
+//  FLEXHeapSnapshotStore.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXHeapSnapshotStore.h"
+#import "FLEXHeapCensus.h"
+#import <objc/runtime.h>
+#import <os/lock.h>
+
+/// Lets autorelease pools drain and animations finish after a repeated action before counting
+static const NSTimeInterval kFLEXHeapGrowthSettleDelay = 1.0;
+
+/// One class in a snapshot. Class indexes belong to the store and never change,
+/// unlike census slots, which are reassigned whenever the runtime's class list changes.
+typedef struct {
+    uint32_t classIndex;
+    uint32_t count;
+    uint64_t bytes;
+} FLEXHeapSnapshotEntry;
+
+#pragma mark - FLEXHeapCensusSnapshot
+
+@interface FLEXHeapCensusSnapshot () {
+    @package
+    /// Sorted by class index
+    FLEXHeapSnapshotEntry *_entries;
+}
+@property (nonatomic, readwrite) NSString *name;
+@property (nonatomic, readwrite) NSDate *date;
+@property (nonatomic, readwrite) uint64_t objectCount;
+@property (nonatomic, readwrite) uint64_t byteCount;
+@property (nonatomic, readwrite) NSUInteger classCount;
+@end
+
+@implementation FLEXHeapCensusSnapshot
+
+- (void)dealloc {
+    free(_entries);
+}
+
+@end
+
+#pragma mark - FLEXHeapClassDelta
+
+@interface FLEXHeapClassDelta ()
+@property (nonatomic, readwrite) NSString *className;
+@property (nonatomic, readwrite) uint64_t countBefore;
+@property (nonatomic, readwrite) uint64_t countAfter;
+@property (nonatomic, readwrite) uint64_t bytesBefore;
+@property (nonatomic, readwrite) uint64_t bytesAfter;
+@end
+
+@implementation FLEXHeapClassDelta
+
+- (int64_t)countDelta {
+    return (int64_t)self.countAfter - (int64_t)self.countBefore;
+}
+
+- (int64_t)bytesDelta {
+    return (int64_t)self.bytesAfter - (int64_t)self.bytesBefore;
+}
+
+@end
+
+#pragma mark - FLEXHeapSnapshotStore
+
+static int FLEXCompareSnapshotEntries(const void *a, const void *b) {
+    uint32_t x = ((const FLEXHeapSnapshotEntry *)a)->classIndex;
+    uint32_t y = ((const FLEXHeapSnapshotEntry *)b)->classIndex;
+    return x < y ? -1 : x > y;
+}
+
+@interface FLEXHeapSnapshotStore ()
+@property (nonatomic) NSMutableArray<FLEXHeapCensusSnapshot *> *mutableSnapshots;
+@end
+
+@implementation FLEXHeapSnapshotStore {
+    /// Guards the class registry, which is filled in from the background
+    os_unfair_lock _lock;
+    /// Class to index + 1, so that a missing class reads as 0
+    CFMutableDictionaryRef _classIndexes;
+    /// Names are copied when a class is registered, since its bundle may be unloaded later
+    NSMutableArray<NSString *> *_classNames;
+}
+
++ (FLEXHeapSnapshotStore *)sharedStore {
+    static FLEXHeapSnapshotStore *shared = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        shared = [self new];
+    });
+
+    return shared;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+        _classIndexes = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+        _classNames = [NSMutableArray new];
+        _mutableSnapshots = [NSMutableArray new];
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    CFRelease(_classIndexes);
+}
+
+- (NSArray<FLEXHeapCensusSnapshot *> *)snapshots {
+    return self.mutableSnapshots.copy;
+}
+
+#pragma mark Class Registry
+
+/// Call with the lock held
+- (uint32_t)indexOfClass:(Class)cls {
+    uintptr_t index = (uintptr_t)CFDictionaryGetValue(_classIndexes, (__bridge const void *)cls);
+    if (index) {
+        return (uint32_t)(index - 1);
+    }
+
+    uint32_t count = (uint32_t)_classNames.count;
+    [_classNames addObject:@(class_getName(cls))];
+    CFDictionarySetValue(_classIndexes, (__bridge const void *)cls, (const void *)(uintptr_t)(count + 1));
+    return count;
+}
+
+- (NSString *)nameOfClassAtIndex:(uint32_t)index {
+    os_unfair_lock_lock(&_lock);
+    NSString *name = _classNames[index];
+    os_unfair_lock_unlock(&_lock);
+    return name;
+}
+
+- (uint32_t)classCount {
+    os_unfair_lock_lock(&_lock);
+    uint32_t count = (uint32_t)_classNames.count;
+    os_unfair_lock_unlock(&_lock);
+    return count;
+}
+
+#pragma mark Capturing
+
+/// Call from a background queue
+- (FLEXHeapCensusSnapshot *)snapshotNamed:(NSString *)name {
+    FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+
+    FLEXHeapCensusSnapshot *snapshot = [FLEXHeapCensusSnapshot new];
+    snapshot.name = name;
+    snapshot.date = [NSDate date];
+    snapshot.objectCount = census.objectCount;
+    snapshot.byteCount = census.byteCount;
+    snapshot.classCount = census.entryCount;
+    snapshot->_entries = malloc(MAX(census.entryCount, 1) * sizeof(FLEXHeapSnapshotEntry));
+
+    os_unfair_lock_lock(&_lock);
+    for (uint32_t i = 0; i < census.entryCount; i++) {
+        FLEXHeapCensusEntry entry = census.entries[i];
+        snapshot->_entries[i] = (FLEXHeapSnapshotEntry){ [self indexOfClass:entry.cls], entry.count, entry.bytes };
+    }
+    os_unfair_lock_unlock(&_lock);
+    FLEXHeapCensusResultFree(&census);
+
+    qsort(snapshot->_entries, snapshot.classCount, sizeof(FLEXHeapSnapshotEntry), FLEXCompareSnapshotEntries);
+    return snapshot;
+}
+
+- (void)captureSnapshotNamed:(NSString *)name completion:(void (^)(FLEXHeapCensusSnapshot *))completion {
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        FLEXHeapCensusSnapshot *snapshot = [self snapshotNamed:name];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self.mutableSnapshots addObject:snapshot];
+            if (completion) completion(snapshot);
+        });
+    });
+}
+
+- (void)removeSnapshot:(FLEXHeapCensusSnapshot *)snapshot {
+    [self.mutableSnapshots removeObject:snapshot];
+}
+
+- (void)removeAllSnapshots {
+    [self.mutableSnapshots removeAllObjects];
+}
+
+#pragma mark Comparing
+
+- (FLEXHeapClassDelta *)deltaForClassAtIndex:(uint32_t)index
+                                      before:(const FLEXHeapSnapshotEntry *)before
+                                       after:(const FLEXHeapSnapshotEntry *)after {
+    FLEXHeapClassDelta *delta = [FLEXHeapClassDelta new];
+    delta.className = [self nameOfClassAtIndex:index];
+    delta.countBefore = before ? before->count : 0;
+    delta.bytesBefore = before ? before->bytes : 0;
+    delta.countAfter = after ? after->count : 0;
+    delta.bytesAfter = after ? after->bytes : 0;
+    return delta;
+}
+
+- (NSArray<FLEXHeapClassDelta *> *)diffFromSnapshot:(FLEXHeapCensusSnapshot *)before
+                                         toSnapshot:(FLEXHeapCensusSnapshot *)after {
+    NSMutableArray<FLEXHeapClassDelta *> *deltas = [NSMutableArray new];
+    const FLEXHeapSnapshotEntry *a = before->_entries, *b = after->_entries;
+    NSUInteger i = 0, j = 0, countA = before.classCount, countB = after.classCount;
+
+    // Both are sorted by class index, so one merge pass finds every change
+    while (i < countA || j < countB) {
+        if (j == countB || (i < countA && a[i].classIndex < b[j].classIndex)) {
+            [deltas addObject:[self deltaForClassAtIndex:a[i].classIndex before:&a[i] after:NULL]];
+            i++;
+        } else if (i == countA || b[j].classIndex < a[i].classIndex) {
+            [deltas addObject:[self deltaForClassAtIndex:b[j].classIndex before:NULL after:&b[j]]];
+            j++;
+        } else {
+            if (a[i].count != b[j].count || a[i].bytes != b[j].bytes) {
+                [deltas addObject:[self deltaForClassAtIndex:a[i].classIndex before:&a[i] after:&b[j]]];
+            }
+            i++, j++;
+        }
+    }
+
+    return deltas;
+}
+
+- (NSArray<FLEXHeapClassDelta *> *)monotonicGrowersInSnapshots:(NSArray<FLEXHeapCensusSnapshot *> *)snapshots {
+    if (snapshots.count < 2) {
+        return @[];
+    }
+
+    // Counts are spread into dense arrays indexed by class, one snapshot at a time
+    uint32_t classCount = self.classCount;
+    uint32_t *previous = calloc(classCount, sizeof(uint32_t));
+    uint32_t *current = calloc(classCount, sizeof(uint32_t));
+    uint32_t *first = calloc(classCount, sizeof(uint32_t));
+    BOOL *shrank = calloc(classCount, sizeof(BOOL));
+
+    for (NSUInteger s = 0; s < snapshots.count; s++) {
+        FLEXHeapCensusSnapshot *snapshot = snapshots[s];
+        memset(current, 0, classCount * sizeof(uint32_t));
+        for (NSUInteger e = 0; e < snapshot.classCount; e++) {
+            current[snapshot->_entries[e].classIndex] = snapshot->_entries[e].count;
+        }
+
+        if (s == 0) {
+            memcpy(first, current, classCount * sizeof(uint32_t));
+        } else {
+            for (uint32_t c = 0; c < classCount; c++) {
+                shrank[c] |= current[c] < previous[c];
+            }
+        }
+
+        uint32_t *swap = previous;
+        previous = current;
+        current = swap;
+    }
+
+    // Entries of the last snapshot, by class index
+    FLEXHeapCensusSnapshot *firstSnapshot = snapshots.firstObject, *lastSnapshot = snapshots.lastObject;
+    NSUInteger steps = snapshots.count - 1;
+    NSMutableArray<FLEXHeapClassDelta *> *growers = [NSMutableArray new];
+    for (NSUInteger e = 0; e < lastSnapshot.classCount; e++) {
+        const FLEXHeapSnapshotEntry *after = &lastSnapshot->_entries[e];
+        uint32_t c = after->classIndex;
+        if (shrank[c] || after->count < (uint64_t)first[c] + steps) {
+            continue;
+        }
+
+        const FLEXHeapSnapshotEntry *before = bsearch(
+            &(FLEXHeapSnapshotEntry){ .classIndex = c }, firstSnapshot->_entries,
+            firstSnapshot.classCount, sizeof(FLEXHeapSnapshotEntry), FLEXCompareSnapshotEntries
+        );
+        [growers addObject:[self deltaForClassAtIndex:c before:before after:after]];
+    }
+
+    free(previous);
+    free(current);
+    free(first);
+    free(shrank);
+    return growers;
+}
+
+#pragma mark Repeating
+
+- (void)repeatActionNamed:(NSString *)name
+                    times:(NSUInteger)times
+                   action:(void(^)(dispatch_block_t))action
+               completion:(void(^)(NSArray<FLEXHeapCensusSnapshot *> *, NSArray<FLEXHeapClassDelta *> *))completion {
+    NSMutableArray<FLEXHeapCensusSnapshot *> *snapshots = [NSMutableArray new];
+    NSString *baselineName = [NSString stringWithFormat:@"%@: baseline", name];
+
+    __block void (^runIteration)(NSUInteger);
+    void (^capture)(NSString *, dispatch_block_t) = ^(NSString *snapshotName, dispatch_block_t next) {
+        [self captureSnapshotNamed:snapshotName completion:^(FLEXHeapCensusSnapshot *snapshot) {
+            [snapshots addObject:snapshot];
+            next();
+        }];
+    };
+
+    runIteration = ^(NSUInteger iteration) {
+        if (iteration > times) {
+            completion(snapshots, [self monotonicGrowersInSnapshots:snapshots]);
+            runIteration = nil;
+            return;
+        }
+
+        action(^{
+            dispatch_after(dispatch_time(DISPATCH_TIME_NOW, kFLEXHeapGrowthSettleDelay * NSEC_PER_SEC),
+                dispatch_get_main_queue(), ^{
+                NSString *snapshotName = [NSString stringWithFormat:@"%@: %@ of %@", name, @(iteration), @(times)];
+                capture(snapshotName, ^{
+                    runIteration(iteration + 1);
+                });
+            });
+        });
+    };
+
+    capture(baselineName, ^{
+        runIteration(1);
+    });
+}
+
+@end
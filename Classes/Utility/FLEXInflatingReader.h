@@ -0,0 +1,43 @@
+//
+//  FLEXInflatingReader.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Inflates gzip or zlib compressed data one chunk at a time, so that consumers
+/// which only need to look at the inflated bytes in order never hold all of them.
+///
+/// Chunks start small and double in size up to a megabyte, so small bodies stay
+/// cheap while large ones take few calls.
+@interface FLEXInflatingReader : NSObject
+
+/// 64 MB. Anything that inflates to more than this is likely not meant to be read by a person.
+@property (nonatomic, readonly, class) NSUInteger defaultByteLimit;
+
+/// @param byteLimit Reading fails once more than this many bytes have been inflated
++ (instancetype)readerWithCompressedData:(NSData *)data byteLimit:(NSUInteger)byteLimit;
+
+/// Inflates the whole stream, for consumers that need all of it at once. The chunks are copied
+/// into a buffer of the final size, so it is allocated once rather than grown as it fills.
+/// @return \c nil if the data is corrupt or inflates to more than \c byteLimit bytes
++ (nullable NSData *)inflatedDataFromCompressedData:(NSData *)data byteLimit:(NSUInteger)byteLimit;
+
+/// @return The next chunk of inflated bytes, or \c nil once the stream has ended or failed
+- (nullable NSData *)readChunk;
+
+/// The number of inflated bytes returned so far
+@property (nonatomic, readonly) NSUInteger totalBytesRead;
+/// Whether the whole stream has been inflated and read successfully
+@property (nonatomic, readonly) BOOL atEnd;
+/// Whether the data was corrupt, truncated, or inflated past the byte limit
+@property (nonatomic, readonly) BOOL failed;
+
+@end
+
+NS_ASSUME_NONNULL_END
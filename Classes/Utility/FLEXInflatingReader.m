@@ -0,0 +1,122 @@
+//
+//  FLEXInflatingReader.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXInflatingReader.h"
+#import <zlib.h>
+
+static const NSUInteger kFLEXInflatingReaderMinChunkSize = 16 * 1024;
+static const NSUInteger kFLEXInflatingReaderMaxChunkSize = 1024 * 1024;
+
+@implementation FLEXInflatingReader {
+    /// Retained for the sake of the stream's input pointer
+    NSData *_compressedData;
+    z_stream _stream;
+    BOOL _streamOpen;
+    NSUInteger _byteLimit;
+    NSUInteger _chunkSize;
+}
+
++ (NSUInteger)defaultByteLimit {
+    return 64 * 1024 * 1024;
+}
+
++ (instancetype)readerWithCompressedData:(NSData *)data byteLimit:(NSUInteger)byteLimit {
+    FLEXInflatingReader *reader = [self new];
+    reader->_compressedData = data;
+    reader->_byteLimit = byteLimit;
+    reader->_chunkSize = kFLEXInflatingReaderMinChunkSize;
+
+    if (!data.length || data.length > UINT_MAX) {
+        reader->_failed = YES;
+        return reader;
+    }
+
+    reader->_stream.next_in = (Bytef *)data.bytes;
+    reader->_stream.avail_in = (uInt)data.length;
+
+    // Detect either a gzip or a zlib header
+    if (inflateInit2(&reader->_stream, 15 + 32) == Z_OK) {
+        reader->_streamOpen = YES;
+    } else {
+        reader->_failed = YES;
+    }
+
+    return reader;
+}
+
++ (NSData *)inflatedDataFromCompressedData:(NSData *)data byteLimit:(NSUInteger)byteLimit {
+    FLEXInflatingReader *reader = [self readerWithCompressedData:data byteLimit:byteLimit];
+
+    NSMutableArray<NSData *> *chunks = [NSMutableArray new];
+    for (NSData *chunk = reader.readChunk; chunk; chunk = reader.readChunk) {
+        [chunks addObject:chunk];
+    }
+    if (!reader.atEnd) {
+        return nil;
+    }
+
+    // Copied into one buffer once the size is known, so that it is never regrown, and
+    // so that consumers reading its bytes don't flatten a chain of chunks all over again.
+    // Each chunk is let go as soon as it is copied.
+    NSMutableData *inflated = [NSMutableData dataWithLength:reader.totalBytesRead];
+    uint8_t *cursor = inflated.mutableBytes;
+    while (chunks.count) {
+        NSData *chunk = chunks.firstObject;
+        memcpy(cursor, chunk.bytes, chunk.length);
+        cursor += chunk.length;
+        [chunks removeObjectAtIndex:0];
+    }
+
+    return inflated;
+}
+
+- (void)dealloc {
+    [self closeStream];
+}
+
+- (NSData *)readChunk {
+    if (!_streamOpen) {
+        return nil;
+    }
+
+    NSMutableData *chunk = [NSMutableData dataWithLength:_chunkSize];
+    _stream.next_out = chunk.mutableBytes;
+    _stream.avail_out = (uInt)chunk.length;
+
+    int status = Z_OK;
+    while (status == Z_OK && _stream.avail_out > 0) {
+        status = inflate(&_stream, Z_NO_FLUSH);
+    }
+
+    chunk.length -= _stream.avail_out;
+    _totalBytesRead += chunk.length;
+    _chunkSize = MIN(_chunkSize * 2, kFLEXInflatingReaderMaxChunkSize);
+
+    if (_totalBytesRead > _byteLimit || (status != Z_OK && status != Z_STREAM_END)) {
+        // Z_BUF_ERROR here means the input ended early
+        _failed = YES;
+        [self closeStream];
+        return nil;
+    }
+
+    if (status == Z_STREAM_END) {
+        _atEnd = YES;
+        [self closeStream];
+    }
+
+    return chunk.length ? chunk : nil;
+}
+
+- (void)closeStream {
+    if (_streamOpen) {
+        inflateEnd(&_stream);
+        _streamOpen = NO;
+    }
+}
+
+@end
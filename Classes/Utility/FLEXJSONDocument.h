@@ -0,0 +1,47 @@
+//
+//  FLEXJSONDocument.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A pretty-printed view of JSON data that formats one line at a time.
+///
+/// The data is tokenized in a single pass straight from its bytes, without building any objects.
+/// The pass records where each line of the pretty-printed output begins in the data, its depth,
+/// and for each line that opens an object or array, the line that closes it. Lines are only
+/// formatted when asked for, so showing part of a large document costs little more than the pass.
+///
+/// Keys keep their original order, and string values are shown as they appear in the data,
+/// except that \c \\/ is unescaped to \c /
+@interface FLEXJSONDocument : NSObject
+
+/// @return \c nil unless the data is a valid JSON object or array
++ (nullable instancetype)documentWithData:(NSData *)data;
+
+@property (nonatomic, readonly) NSData *data;
+@property (nonatomic, readonly) NSUInteger lineCount;
+
+/// The line, indented two spaces per level. Very long values are truncated.
+/// @param collapsed Whether to show a line that opens an object or array with its
+/// contents elided, as in \c "key" : { … }. Ignored for other lines.
+- (NSString *)textOfLine:(NSUInteger)line collapsed:(BOOL)collapsed;
+
+/// The nesting depth of the line, where the root object's braces are at 0
+- (NSUInteger)depthOfLine:(NSUInteger)line;
+
+/// @return The line closing the object or array opened by this line,
+/// or \c NSNotFound if the line doesn't open a non-empty object or array.
+- (NSUInteger)closingLineOfLine:(NSUInteger)line;
+
+/// The whole document, pretty-printed without truncation
+- (NSString *)prettyString;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,512 @@
+//
+//  FLEXJSONDocument.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXJSONDocument.h"
+
+/// Marks a line without a key, or a line that doesn't open anything
+static const uint32_t kFLEXJSONNone = UINT32_MAX;
+/// Anything nested deeper than this is rejected rather than indexed
+static const size_t kFLEXJSONMaxDepth = 4096;
+/// Values longer than this many bytes are truncated by textOfLine:collapsed:
+static const size_t kFLEXJSONMaxValueLength = 8 * 1024;
+
+typedef NS_OPTIONS(uint8_t, FLEXJSONLineFlags) {
+    FLEXJSONLineComma = 1 << 0,
+    /// The line holds an empty object or array, shown as {} or []
+    FLEXJSONLineEmptyContainer = 1 << 1,
+};
+
+/// One line of pretty-printed output
+typedef struct {
+    /// Offset of the key's opening quote, or kFLEXJSONNone
+    uint32_t key;
+    /// Offset of the value's first byte. For a line that
+    /// closes an object or array, the offset of its } or ]
+    uint32_t value;
+    uint16_t depth;
+    FLEXJSONLineFlags flags;
+} FLEXJSONLine;
+
+/// Links a line that opens a non-empty object or array to the line that closes it.
+/// These are kept apart from the lines since only a fraction of lines open something.
+typedef struct {
+    uint32_t line;
+    uint32_t closingLine;
+} FLEXJSONContainer;
+
+typedef struct {
+    FLEXJSONLine *lines;
+    size_t count;
+    size_t capacity;
+    /// Sorted by line
+    FLEXJSONContainer *containers;
+    size_t containerCount;
+    size_t containerCapacity;
+} FLEXJSONLineList;
+
+typedef NS_ENUM(uint8_t, FLEXJSONState) {
+    FLEXJSONStateValue,
+    /// Just after a {, so either a key or }
+    FLEXJSONStateFirstMember,
+    /// Just after a [, so either a value or ]
+    FLEXJSONStateFirstElement,
+    FLEXJSONStateKey,
+    FLEXJSONStateAfterValue,
+};
+
+#pragma mark Tokenizing
+
+static inline BOOL FLEXJSONIsSpace(uint8_t c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static inline BOOL FLEXJSONIsDigit(uint8_t c) {
+    return c >= '0' && c <= '9';
+}
+
+static inline BOOL FLEXJSONIsHexDigit(uint8_t c) {
+    return FLEXJSONIsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+/// The scanners below return the offset just past the token starting
+/// at \c start, or 0 if it is malformed or runs past \c length
+
+static size_t FLEXJSONScanString(const uint8_t *bytes, size_t length, size_t start) {
+    size_t i = start + 1;
+    while (i < length) {
+        uint8_t c = bytes[i];
+        if (c == '"') {
+            return i + 1;
+        }
+        if (c < 0x20) {
+            return 0;
+        }
+        if (c != '\\') {
+            i++;
+            continue;
+        }
+
+        if (i + 1 >= length) {
+            return 0;
+        }
+        uint8_t escaped = bytes[i + 1];
+        if (escaped == 'u') {
+            if (i + 5 >= length) {
+                return 0;
+            }
+            for (size_t h = i + 2; h < i + 6; h++) {
+                if (!FLEXJSONIsHexDigit(bytes[h])) {
+                    return 0;
+                }
+            }
+            i += 6;
+        } else if (escaped && strchr("\"\\/bfnrt", escaped)) {
+            i += 2;
+        } else {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+static size_t FLEXJSONScanDigits(const uint8_t *bytes, size_t length, size_t start) {
+    size_t i = start;
+    while (i < length && FLEXJSONIsDigit(bytes[i])) {
+        i++;
+    }
+    return i;
+}
+
+static size_t FLEXJSONScanNumber(const uint8_t *bytes, size_t length, size_t start) {
+    size_t i = start;
+    if (i < length && bytes[i] == '-') {
+        i++;
+    }
+
+    // No leading zeros
+    if (i < length && bytes[i] == '0') {
+        i++;
+    } else if (i < length && FLEXJSONIsDigit(bytes[i])) {
+        i = FLEXJSONScanDigits(bytes, length, i);
+    } else {
+        return 0;
+    }
+
+    if (i < length && bytes[i] == '.') {
+        size_t fraction = i + 1;
+        i = FLEXJSONScanDigits(bytes, length, fraction);
+        if (i == fraction) {
+            return 0;
+        }
+    }
+
+    if (i < length && (bytes[i] == 'e' || bytes[i] == 'E')) {
+        i++;
+        if (i < length && (bytes[i] == '+' || bytes[i] == '-')) {
+            i++;
+        }
+
+        size_t exponent = i;
+        i = FLEXJSONScanDigits(bytes, length, exponent);
+        if (i == exponent) {
+            return 0;
+        }
+    }
+
+    return i;
+}
+
+static size_t FLEXJSONScanLiteral(const uint8_t *bytes, size_t length, size_t start, const char *literal) {
+    size_t literalLength = strlen(literal);
+    if (length - start < literalLength || memcmp(bytes + start, literal, literalLength) != 0) {
+        return 0;
+    }
+
+    return start + literalLength;
+}
+
+/// Scans a string, number, or literal
+static size_t FLEXJSONScanScalar(const uint8_t *bytes, size_t length, size_t start) {
+    switch (bytes[start]) {
+        case '"': return FLEXJSONScanString(bytes, length, start);
+        case 't': return FLEXJSONScanLiteral(bytes, length, start, "true");
+        case 'f': return FLEXJSONScanLiteral(bytes, length, start, "false");
+        case 'n': return FLEXJSONScanLiteral(bytes, length, start, "null");
+        default: return FLEXJSONScanNumber(bytes, length, start);
+    }
+}
+
+/// Makes room for one more element in a growable array
+static BOOL FLEXJSONReserve(void **elements, size_t count, size_t *capacity, size_t elementSize) {
+    if (count < *capacity) {
+        return YES;
+    }
+
+    size_t newCapacity = MAX(*capacity * 2, 256);
+    void *newElements = realloc(*elements, newCapacity * elementSize);
+    if (!newElements) {
+        return NO;
+    }
+
+    *elements = newElements;
+    *capacity = newCapacity;
+    return YES;
+}
+
+static BOOL FLEXJSONAppendLine(FLEXJSONLineList *list, uint32_t key, size_t value, size_t depth) {
+    if (!FLEXJSONReserve((void **)&list->lines, list->count, &list->capacity, sizeof(FLEXJSONLine))) {
+        return NO;
+    }
+
+    list->lines[list->count++] = (FLEXJSONLine){
+        .key = key,
+        .value = (uint32_t)value,
+        .depth = (uint16_t)depth,
+        .flags = 0,
+    };
+    return YES;
+}
+
+/// Registers the last line as opening a container that isn't closed yet
+static BOOL FLEXJSONAppendContainer(FLEXJSONLineList *list) {
+    if (!FLEXJSONReserve((void **)&list->containers, list->containerCount,
+                         &list->containerCapacity, sizeof(FLEXJSONContainer))) {
+        return NO;
+    }
+
+    list->containers[list->containerCount++] = (FLEXJSONContainer){
+        .line = (uint32_t)(list->count - 1),
+        .closingLine = kFLEXJSONNone,
+    };
+    return YES;
+}
+
+/// Tokenizes the whole document in one pass, appending every line of its pretty-printed form.
+/// @param stack Room for \c kFLEXJSONMaxDepth indexes of open containers
+/// @return Whether the document is a valid JSON object or array
+static BOOL FLEXJSONIndexLines(const uint8_t *bytes, size_t length, FLEXJSONLineList *list, uint32_t *stack) {
+    size_t i = 0;
+    if (length >= 3 && memcmp(bytes, "\xEF\xBB\xBF", 3) == 0) {
+        // Byte order mark
+        i = 3;
+    }
+    while (i < length && FLEXJSONIsSpace(bytes[i])) {
+        i++;
+    }
+    if (i >= length || (bytes[i] != '{' && bytes[i] != '[')) {
+        return NO;
+    }
+
+    FLEXJSONState state = FLEXJSONStateValue;
+    uint32_t key = kFLEXJSONNone;
+    size_t depth = 0;
+
+    while (YES) {
+        while (i < length && FLEXJSONIsSpace(bytes[i])) {
+            i++;
+        }
+        if (i >= length) {
+            return depth == 0 && state == FLEXJSONStateAfterValue;
+        }
+
+        uint8_t c = bytes[i];
+        if ((state == FLEXJSONStateFirstMember && c == '}') || (state == FLEXJSONStateFirstElement && c == ']')) {
+            // The opening line is the last one, and the last container
+            list->lines[list->count - 1].flags |= FLEXJSONLineEmptyContainer;
+            list->containerCount--;
+            depth--;
+            i++;
+            state = FLEXJSONStateAfterValue;
+            continue;
+        }
+
+        switch (state) {
+            case FLEXJSONStateFirstMember:
+            case FLEXJSONStateKey: {
+                size_t end = c == '"' ? FLEXJSONScanString(bytes, length, i) : 0;
+                if (!end) {
+                    return NO;
+                }
+
+                key = (uint32_t)i;
+                i = end;
+                while (i < length && FLEXJSONIsSpace(bytes[i])) {
+                    i++;
+                }
+                if (i >= length || bytes[i] != ':') {
+                    return NO;
+                }
+
+                i++;
+                state = FLEXJSONStateValue;
+                break;
+            }
+            case FLEXJSONStateFirstElement:
+            case FLEXJSONStateValue: {
+                if (!FLEXJSONAppendLine(list, key, i, depth)) {
+                    return NO;
+                }
+
+                key = kFLEXJSONNone;
+                if (c == '{' || c == '[') {
+                    if (depth == kFLEXJSONMaxDepth || !FLEXJSONAppendContainer(list)) {
+                        return NO;
+                    }
+
+                    stack[depth++] = (uint32_t)(list->containerCount - 1);
+                    state = c == '{' ? FLEXJSONStateFirstMember : FLEXJSONStateFirstElement;
+                    i++;
+                } else {
+                    size_t end = FLEXJSONScanScalar(bytes, length, i);
+                    if (!end) {
+                        return NO;
+                    }
+
+                    i = end;
+                    state = FLEXJSONStateAfterValue;
+                }
+                break;
+            }
+            case FLEXJSONStateAfterValue: {
+                // Anything but whitespace after the root value is an error
+                if (!depth) {
+                    return NO;
+                }
+
+                uint8_t container = bytes[list->lines[list->containers[stack[depth - 1]].line].value];
+                if (c == ',') {
+                    // The value that just ended is always on the last line
+                    list->lines[list->count - 1].flags |= FLEXJSONLineComma;
+                    state = container == '{' ? FLEXJSONStateKey : FLEXJSONStateValue;
+                    i++;
+                } else if (c == (container == '{' ? '}' : ']')) {
+                    uint32_t closed = stack[--depth];
+                    if (!FLEXJSONAppendLine(list, kFLEXJSONNone, i, depth)) {
+                        return NO;
+                    }
+
+                    list->containers[closed].closingLine = (uint32_t)(list->count - 1);
+                    i++;
+                } else {
+                    return NO;
+                }
+                break;
+            }
+        }
+    }
+}
+
+#pragma mark -
+
+@implementation FLEXJSONDocument {
+    FLEXJSONLine *_lines;
+    FLEXJSONContainer *_containers;
+    NSUInteger _containerCount;
+}
+
++ (instancetype)documentWithData:(NSData *)data {
+    // Offsets are 32 bits
+    if (!data.length || data.length >= kFLEXJSONNone) {
+        return nil;
+    }
+
+    FLEXJSONLineList list = { 0 };
+    uint32_t *stack = malloc(kFLEXJSONMaxDepth * sizeof(uint32_t));
+    BOOL valid = FLEXJSONIndexLines(data.bytes, data.length, &list, stack);
+    free(stack);
+
+    if (!valid) {
+        free(list.lines);
+        free(list.containers);
+        return nil;
+    }
+
+    FLEXJSONDocument *document = [self new];
+    document->_data = data;
+    document->_lines = realloc(list.lines, list.count * sizeof(FLEXJSONLine)) ?: list.lines;
+    document->_lineCount = list.count;
+    document->_containers = list.containers;
+    document->_containerCount = list.containerCount;
+    return document;
+}
+
+- (void)dealloc {
+    free(_lines);
+    free(_containers);
+}
+
+#pragma mark Public
+
+- (NSString *)textOfLine:(NSUInteger)line collapsed:(BOOL)collapsed {
+    NSMutableData *text = [NSMutableData new];
+    [self appendLine:line collapsed:collapsed truncating:YES to:text];
+
+    // Strings may contain invalid UTF-8
+    return [[NSString alloc] initWithData:text encoding:NSUTF8StringEncoding]
+        ?: [[NSString alloc] initWithData:text encoding:NSISOLatin1StringEncoding];
+}
+
+- (NSUInteger)depthOfLine:(NSUInteger)line {
+    return _lines[line].depth;
+}
+
+- (NSUInteger)closingLineOfLine:(NSUInteger)line {
+    NSUInteger low = 0, high = _containerCount;
+    while (low < high) {
+        NSUInteger mid = low + (high - low) / 2;
+        if (_containers[mid].line < line) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low < _containerCount && _containers[low].line == line) {
+        return _containers[low].closingLine;
+    }
+    return NSNotFound;
+}
+
+- (NSString *)prettyString {
+    NSMutableData *text = [NSMutableData dataWithCapacity:self.data.length * 2];
+    for (NSUInteger line = 0; line < self.lineCount; line++) {
+        if (line > 0) {
+            [text appendBytes:"\n" length:1];
+        }
+        [self appendLine:line collapsed:NO truncating:NO to:text];
+    }
+
+    return [[NSString alloc] initWithData:text encoding:NSUTF8StringEncoding] ?: @"";
+}
+
+#pragma mark Private
+
+- (void)appendLine:(NSUInteger)index collapsed:(BOOL)collapsed truncating:(BOOL)truncate to:(NSMutableData *)text {
+    FLEXJSONLine line = _lines[index];
+    for (NSUInteger level = 0; level < line.depth; level++) {
+        [text appendBytes:"  " length:2];
+    }
+
+    if (line.key != kFLEXJSONNone) {
+        [self appendScalarAt:line.key truncating:truncate to:text];
+        [text appendBytes:" : " length:3];
+    }
+
+    const uint8_t *value = (const uint8_t *)self.data.bytes + line.value;
+    BOOL comma = line.flags & FLEXJSONLineComma;
+    switch (*value) {
+        case '{':
+        case '[': {
+            const char *closer = *value == '{' ? "}" : "]";
+            [text appendBytes:value length:1];
+            if (line.flags & FLEXJSONLineEmptyContainer) {
+                [text appendBytes:closer length:1];
+            } else if (collapsed) {
+                [text appendBytes:" … " length:strlen(" … ")];
+                [text appendBytes:closer length:1];
+                comma = _lines[[self closingLineOfLine:index]].flags & FLEXJSONLineComma;
+            }
+            break;
+        }
+        case '}':
+        case ']':
+            [text appendBytes:value length:1];
+            break;
+        default:
+            [self appendScalarAt:line.value truncating:truncate to:text];
+            break;
+    }
+
+    if (comma) {
+        [text appendBytes:"," length:1];
+    }
+}
+
+/// Copies the string, number, or literal at the offset, unescaping \/ in strings
+- (void)appendScalarAt:(uint32_t)offset truncating:(BOOL)truncate to:(NSMutableData *)text {
+    const uint8_t *bytes = self.data.bytes;
+    size_t length = self.data.length;
+    if (truncate) {
+        length = MIN(length, offset + kFLEXJSONMaxValueLength);
+    }
+
+    // The document was validated, so a value only fails to scan if it runs past the truncation
+    size_t end = FLEXJSONScanScalar(bytes, length, offset);
+    BOOL truncated = end == 0;
+    if (truncated) {
+        end = length;
+        // Don't cut a UTF-8 sequence in half
+        while (end > offset && (bytes[end] & 0xC0) == 0x80) {
+            end--;
+        }
+    }
+
+    size_t start = offset;
+    if (bytes[offset] == '"') {
+        for (size_t i = offset + 1; i + 1 < end; i++) {
+            if (bytes[i] != '\\') {
+                continue;
+            }
+
+            if (bytes[i + 1] == '/') {
+                // Skip the backslash
+                [text appendBytes:bytes + start length:i - start];
+                start = i + 1;
+            }
+            i++;
+        }
+    }
+
+    [text appendBytes:bytes + start length:end - start];
+    if (truncated) {
+        [text appendBytes:"…" length:strlen("…")];
+    }
+}
+
+@end
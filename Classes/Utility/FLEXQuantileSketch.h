@@ -0,0 +1,39 @@
+//
+//  FLEXQuantileSketch.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// Estimates quantiles of a stream of positive values, like durations in seconds, in bounded memory.
+///
+/// This is a DDSketch: values are counted in logarithmically sized buckets, so any quantile
+/// is within 2% of the true value between 0.1 ms and 10,000 s. Values outside that range are
+/// clamped to it. Sketches of different streams can be merged without losing accuracy.
+///
+/// Only the buckets between the smallest and largest value are allocated, which is a few hundred
+/// bytes for values within two orders of magnitude of each other and under 2 KB at most.
+@interface FLEXQuantileSketch : NSObject <NSCopying>
+
+- (void)addValue:(double)value;
+/// Adds the other sketch's values to this one
+- (void)mergeSketch:(FLEXQuantileSketch *)other;
+
+/// @param quantile Between 0 and 1, like 0.9 for the 90th percentile
+/// @return \c NAN if no values were added
+- (double)valueAtQuantile:(double)quantile;
+
+@property (nonatomic, readonly) uint64_t count;
+/// \c NAN if no values were added
+@property (nonatomic, readonly) double minValue;
+/// \c NAN if no values were added
+@property (nonatomic, readonly) double maxValue;
+
+@end
+
+NS_ASSUME_NONNULL_END
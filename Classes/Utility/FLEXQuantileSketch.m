@@ -0,0 +1,153 @@
+//
+//  FLEXQuantileSketch.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXQuantileSketch.h"
+#include <math.h>
+
+static const double kFLEXSketchRelativeAccuracy = 0.02;
+static const double kFLEXSketchMinValue = 1e-4;
+/// Enough buckets to span kFLEXSketchMinValue to 10,000: ceil(log(1e8) / log(gamma)) + 1
+static const NSUInteger kFLEXSketchBucketCount = 462;
+
+/// The ratio between the bounds of a bucket
+static double FLEXSketchGamma(void) {
+    return (1 + kFLEXSketchRelativeAccuracy) / (1 - kFLEXSketchRelativeAccuracy);
+}
+
+static NSUInteger FLEXSketchBucketOfValue(double value, double logGamma) {
+    if (!(value > kFLEXSketchMinValue)) {
+        return 0;
+    }
+
+    // Bucket i holds values in (min * gamma^(i-1), min * gamma^i]
+    double bucket = ceil(log(value / kFLEXSketchMinValue) / logGamma);
+    return (NSUInteger)MIN(bucket, kFLEXSketchBucketCount - 1);
+}
+
+static double FLEXSketchValueOfBucket(NSUInteger bucket) {
+    if (bucket == 0) {
+        return kFLEXSketchMinValue;
+    }
+
+    // The point with the same relative error to both bounds of the bucket
+    double gamma = FLEXSketchGamma();
+    return kFLEXSketchMinValue * 2 * pow(gamma, bucket) / (gamma + 1);
+}
+
+@implementation FLEXQuantileSketch {
+    /// The counts of buckets \c _firstBucket and up. Only the range between
+    /// the lowest and highest bucket used so far is allocated.
+    uint32_t *_counts;
+    NSUInteger _firstBucket;
+    NSUInteger _bucketCount;
+    double _logGamma;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _logGamma = log(FLEXSketchGamma());
+        _minValue = NAN;
+        _maxValue = NAN;
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_counts);
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+    FLEXQuantileSketch *copy = [FLEXQuantileSketch new];
+    [copy mergeSketch:self];
+    return copy;
+}
+
+/// Widens the allocated range of buckets to include \c first through \c last
+/// @return \c NO if the wider range could not be allocated
+- (BOOL)coverBucketsFrom:(NSUInteger)first to:(NSUInteger)last {
+    NSUInteger end = _firstBucket + _bucketCount;
+    if (_bucketCount && first >= _firstBucket && last < end) {
+        return YES;
+    }
+
+    NSUInteger newFirst = _bucketCount ? MIN(first, _firstBucket) : first;
+    NSUInteger newEnd = _bucketCount ? MAX(last + 1, end) : last + 1;
+    uint32_t *counts = calloc(newEnd - newFirst, sizeof(uint32_t));
+    if (!counts) {
+        return NO;
+    }
+
+    if (_bucketCount) {
+        memcpy(counts + (_firstBucket - newFirst), _counts, _bucketCount * sizeof(uint32_t));
+    }
+    free(_counts);
+    _counts = counts;
+    _firstBucket = newFirst;
+    _bucketCount = newEnd - newFirst;
+    return YES;
+}
+
+- (void)addValue:(double)value {
+    if (isnan(value)) {
+        return;
+    }
+
+    NSUInteger bucket = FLEXSketchBucketOfValue(value, _logGamma);
+    if (![self coverBucketsFrom:bucket to:bucket] || _counts[bucket - _firstBucket] == UINT32_MAX) {
+        return;
+    }
+
+    _counts[bucket - _firstBucket]++;
+    _count++;
+    _minValue = isnan(_minValue) ? value : MIN(_minValue, value);
+    _maxValue = isnan(_maxValue) ? value : MAX(_maxValue, value);
+}
+
+- (void)mergeSketch:(FLEXQuantileSketch *)other {
+    if (!other.count) {
+        return;
+    }
+
+    NSUInteger otherFirst = other->_firstBucket;
+    if (![self coverBucketsFrom:otherFirst to:otherFirst + other->_bucketCount - 1]) {
+        return;
+    }
+
+    uint32_t *counts = _counts + (otherFirst - _firstBucket);
+    for (NSUInteger i = 0; i < other->_bucketCount; i++) {
+        uint64_t sum = (uint64_t)counts[i] + other->_counts[i];
+        counts[i] = (uint32_t)MIN(sum, UINT32_MAX);
+    }
+
+    _count += other.count;
+    _minValue = isnan(_minValue) ? other.minValue : MIN(_minValue, other.minValue);
+    _maxValue = isnan(_maxValue) ? other.maxValue : MAX(_maxValue, other.maxValue);
+}
+
+- (double)valueAtQuantile:(double)quantile {
+    if (!_count) {
+        return NAN;
+    }
+
+    // The zero-based rank of the value we want
+    uint64_t rank = (uint64_t)(MIN(MAX(quantile, 0), 1) * (_count - 1));
+    uint64_t seen = 0;
+    for (NSUInteger i = 0; i < _bucketCount; i++) {
+        seen += _counts[i];
+        if (seen > rank) {
+            // The exact extremes are known, so don't estimate past them
+            return MIN(MAX(FLEXSketchValueOfBucket(_firstBucket + i), _minValue), _maxValue);
+        }
+    }
+
+    return _maxValue;
+}
+
+@end
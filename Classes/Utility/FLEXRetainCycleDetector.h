@@ -0,0 +1,70 @@
+//
+//  FLEXRetainCycleDetector.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// A loop of strong references that starts and ends at the same object
+@interface FLEXRetainCycle : NSObject
+
+/// The number of objects in the cycle
+@property (nonatomic, readonly) NSUInteger length;
+/// The number of objects that strongly reference each other along with the cycle.
+/// Larger than \c length when the cycle is one of several through the same objects.
+@property (nonatomic, readonly) NSUInteger componentSize;
+
+/// The address of each object, starting with the one the search was rooted at
+@property (nonatomic, readonly) NSArray<NSNumber *> *addresses;
+@property (nonatomic, readonly) NSArray<NSString *> *classNames;
+/// How each object references the next one, such as an ivar name or "[element]".
+/// The last label is the reference back to the first object.
+@property (nonatomic, readonly) NSArray<NSString *> *labels;
+
+/// The object at an index of the cycle, or \c nil if it no longer exists. Not retained.
+- (nullable id)objectAtIndex:(NSUInteger)index;
+
+/// For example, "MyController → _timer → NSTimer → _target → MyController"
+@property (nonatomic, readonly) NSString *summary;
+
+@end
+
+/// Finds retain cycles in the strong reference graph of the live heap.
+///
+/// The graph is built with \c FLEXHeapGraph from ivar layouts, Foundation collection
+/// contents and block capture layouts, leaving out weak and unretained references.
+/// Tarjan's algorithm then finds the strongly connected components reachable from the
+/// chosen objects. It runs without recursion, using arrays of 20 bytes per object that are
+/// allocated once up front, and checks for cancellation as it goes. Each component with a cycle
+/// through a chosen object is reported as the shortest such cycle, found by a breadth-first search.
+@interface FLEXRetainCycleDetector : NSObject
+
+/// The most memory a search may use for the graph and its own arrays.
+/// Searches that would need more fail with \c ENOMEM instead.
+/// Defaults to a quarter of physical memory, up to 1 GB.
+@property (nonatomic) size_t memoryBudget;
+/// Searches stop after finding this many cycles. Defaults to 100.
+@property (nonatomic) NSUInteger maximumCycleCount;
+
+/// Finds the cycles that pass through an object, in the background.
+/// @param completion Called on the main queue. Cancelling the returned progress
+/// stops the search with \c NSUserCancelledError.
+/// @return The progress of the search. Cancellable.
+- (NSProgress *)findCyclesThroughObject:(id)object
+                             completion:(void(^)(NSArray<FLEXRetainCycle *> *_Nullable cycles,
+                                                 NSError *_Nullable error))completion;
+
+/// Finds the cycles that pass through any instance of a class, not including subclasses,
+/// reporting one cycle per group of objects that strongly reference each other.
+- (NSProgress *)findCyclesThroughInstancesOfClass:(Class)cls
+                                       completion:(void(^)(NSArray<FLEXRetainCycle *> *_Nullable cycles,
+                                                           NSError *_Nullable error))completion;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,435 @@
+//
+//  FLEXRetainCycleDetector.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXRetainCycleDetector.h"
+#import "FLEXHeapGraph.h"
+#import "FLEXObjcInternal.h"
+#import <objc/runtime.h>
+
+static const int64_t kFLEXRetainCycleGraphUnits = 80;
+static const int64_t kFLEXRetainCycleSearchUnits = 20;
+/// How often the search checks for cancellation and reports progress, in objects
+static const uint32_t kFLEXRetainCycleProgressInterval = 1 << 16;
+/// Set in \c _low once an object's component is known; the rest of the bits are its size
+static const uint32_t kFLEXTarjanDone = 1u << 31;
+
+typedef struct {
+    uint32_t node;
+    /// The next edge of \c node to follow
+    uint32_t edge;
+} FLEXTarjanFrame;
+
+#pragma mark - FLEXRetainCycle
+
+@interface FLEXRetainCycle ()
+@property (nonatomic, readwrite) NSUInteger componentSize;
+@property (nonatomic, readwrite) NSArray<NSNumber *> *addresses;
+@property (nonatomic, readwrite) NSArray<NSString *> *classNames;
+@property (nonatomic, readwrite) NSArray<NSString *> *labels;
+@end
+
+@implementation FLEXRetainCycle
+
+- (NSUInteger)length {
+    return self.addresses.count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+    void *object = (void *)self.addresses[index].unsignedLongValue;
+    if (!FLEXPointerIsValidObjcObject(object)) {
+        return nil;
+    }
+
+    // The address may have been reused by an unrelated object
+    if (strcmp(object_getClassName((__bridge id)object), self.classNames[index].UTF8String) != 0) {
+        return nil;
+    }
+
+    return (__bridge id)object;
+}
+
+- (NSString *)summary {
+    NSMutableString *summary = [NSMutableString new];
+    for (NSUInteger i = 0; i < self.length; i++) {
+        [summary appendFormat:@"%@ → %@ → ", self.classNames[i], self.labels[i]];
+    }
+    [summary appendString:self.classNames.firstObject];
+
+    return summary;
+}
+
+- (NSString *)description {
+    return [NSString stringWithFormat:@"<%@: %@>", NSStringFromClass([self class]), self.summary];
+}
+
+@end
+
+#pragma mark - FLEXRetainCycleSearch
+
+/// Tarjan's algorithm over a \c FLEXHeapGraph, plus the shortest cycle through an object.
+/// All of the memory it needs is allocated when it is created.
+@interface FLEXRetainCycleSearch : NSObject
++ (size_t)byteCountForObjectCount:(uint32_t)objectCount;
+- (instancetype)initWithGraph:(FLEXHeapGraph *)graph;
+/// @return \c NO if cancelled
+- (BOOL)visitFrom:(uint32_t)root progress:(NSProgress *)progress;
+/// The shortest cycle through an object already visited, or \c nil if it is in no cycle
+- (FLEXRetainCycle *)shortestCycleThrough:(uint32_t)root;
+/// Nonzero once the object has been visited
+- (uint32_t)componentOfObject:(uint32_t)index;
+@end
+
+@implementation FLEXRetainCycleSearch {
+    FLEXHeapGraph *_graph;
+    uint32_t _objectCount;
+
+    /// The visit order of each object, then its component once that is known
+    uint32_t *_index;
+    /// The lowest visit order reachable from each object, then its component size and \c kFLEXTarjanDone
+    uint32_t *_low;
+    /// Visited objects whose components are not known yet
+    uint32_t *_stack;
+    uint32_t _stackCount;
+    /// The path of the depth-first search. Reused by the breadth-first search once that is over.
+    FLEXTarjanFrame *_frames;
+
+    uint32_t _visitCount;
+    uint32_t _componentCount;
+
+    /// Inside \c _frames: the edge each object was reached through, then the queue
+    uint32_t *_parentEdges;
+    uint32_t *_queue;
+}
+
++ (size_t)byteCountForObjectCount:(uint32_t)objectCount {
+    return (size_t)objectCount * (3 * sizeof(uint32_t) + sizeof(FLEXTarjanFrame));
+}
+
+- (instancetype)initWithGraph:(FLEXHeapGraph *)graph {
+    self = [super init];
+    if (self) {
+        _graph = graph;
+        _objectCount = graph.objectCount;
+        _index = calloc(_objectCount, sizeof(uint32_t));
+        _low = malloc(_objectCount * sizeof(uint32_t));
+        _stack = malloc(_objectCount * sizeof(uint32_t));
+        _frames = malloc(_objectCount * sizeof(FLEXTarjanFrame));
+    }
+
+    return self;
+}
+
+- (void)dealloc {
+    free(_index);
+    free(_low);
+    free(_stack);
+    free(_frames);
+}
+
+- (uint32_t)componentOfObject:(uint32_t)index {
+    return _low[index] & kFLEXTarjanDone ? _index[index] : 0;
+}
+
+#pragma mark Tarjan
+
+- (BOOL)visitFrom:(uint32_t)root progress:(NSProgress *)progress {
+    if (_index[root]) {
+        return YES;
+    }
+
+    const uint32_t *starts = _graph.edgeStarts;
+    const FLEXHeapEdge *edges = _graph.edges;
+
+    uint32_t depth = 0;
+    _index[root] = _low[root] = ++_visitCount;
+    _stack[_stackCount++] = root;
+    _frames[depth++] = (FLEXTarjanFrame){ root, starts[root] };
+
+    while (depth) {
+        FLEXTarjanFrame *frame = &_frames[depth - 1];
+        uint32_t v = frame->node;
+
+        if (frame->edge < starts[v + 1]) {
+            uint32_t w = edges[frame->edge++].target;
+            if (!_index[w]) {
+                if (_visitCount % kFLEXRetainCycleProgressInterval == 0) {
+                    if (progress.isCancelled) {
+                        return NO;
+                    }
+                    progress.completedUnitCount = kFLEXRetainCycleGraphUnits +
+                        kFLEXRetainCycleSearchUnits * _visitCount / _objectCount;
+                }
+
+                _index[w] = _low[w] = ++_visitCount;
+                _stack[_stackCount++] = w;
+                _frames[depth++] = (FLEXTarjanFrame){ w, starts[w] };
+            } else if (!(_low[w] & kFLEXTarjanDone)) {
+                // Still on the stack, so in the same component as v or one above it
+                _low[v] = MIN(_low[v], _index[w]);
+            }
+            continue;
+        }
+
+        // Every edge of v has been followed
+        depth--;
+        uint32_t low = _low[v];
+        if (low == _index[v]) {
+            // v is the first object visited in its component, which is everything above it on the stack
+            uint32_t start = _stackCount;
+            do {
+                start--;
+            } while (_stack[start] != v);
+
+            uint32_t component = ++_componentCount;
+            uint32_t size = _stackCount - start;
+            for (uint32_t i = start; i < _stackCount; i++) {
+                _index[_stack[i]] = component;
+                _low[_stack[i]] = kFLEXTarjanDone | size;
+            }
+            _stackCount = start;
+        } else {
+            uint32_t parent = _frames[depth - 1].node;
+            _low[parent] = MIN(_low[parent], low);
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark Cycles
+
+/// The object an edge comes from
+- (uint32_t)sourceOfEdge:(uint32_t)edge {
+    // The last object whose edges start at or before this one
+    const uint32_t *starts = _graph.edgeStarts;
+    uint32_t low = 0, high = _objectCount;
+    while (high - low > 1) {
+        uint32_t mid = low + (high - low) / 2;
+        if (starts[mid] <= edge) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+- (FLEXRetainCycle *)shortestCycleThrough:(uint32_t)root {
+    uint32_t component = [self componentOfObject:root];
+    uint32_t componentSize = _low[root] & ~kFLEXTarjanDone;
+    if (!component) {
+        return nil;
+    }
+
+    if (!_parentEdges) {
+        // The depth-first search is over, so its frames are free for the breadth-first search
+        _parentEdges = (uint32_t *)_frames;
+        _queue = _parentEdges + _objectCount;
+        memset(_parentEdges, 0xFF, _objectCount * sizeof(uint32_t));
+    }
+
+    const uint32_t *starts = _graph.edgeStarts;
+    const FLEXHeapEdge *edges = _graph.edges;
+
+    // Breadth-first within the component, until an edge leads back to the root
+    uint32_t head = 0, tail = 0;
+    uint32_t closingEdge = UINT32_MAX;
+    _queue[tail++] = root;
+    while (head < tail && closingEdge == UINT32_MAX) {
+        uint32_t v = _queue[head++];
+        for (uint32_t e = starts[v]; e < starts[v + 1]; e++) {
+            uint32_t w = edges[e].target;
+            if (w == root) {
+                closingEdge = e;
+                break;
+            }
+            if (_index[w] != component || _parentEdges[w] != UINT32_MAX) {
+                continue;
+            }
+
+            _parentEdges[w] = e;
+            _queue[tail++] = w;
+        }
+    }
+
+    // Walk back from the closing edge to the root
+    NSMutableArray<NSNumber *> *path = [NSMutableArray new];
+    if (closingEdge != UINT32_MAX) {
+        [path addObject:@(closingEdge)];
+        for (uint32_t v = [self sourceOfEdge:closingEdge]; v != root; ) {
+            uint32_t e = _parentEdges[v];
+            [path addObject:@(e)];
+            v = [self sourceOfEdge:e];
+        }
+    }
+
+    // Leave the parent edges as they were for the next search
+    for (uint32_t i = 0; i < tail; i++) {
+        _parentEdges[_queue[i]] = UINT32_MAX;
+    }
+
+    if (!path.count) {
+        return nil;
+    }
+
+    NSMutableArray<NSNumber *> *addresses = [NSMutableArray new];
+    NSMutableArray<NSString *> *classNames = [NSMutableArray new];
+    NSMutableArray<NSString *> *labels = [NSMutableArray new];
+    uint32_t v = root;
+    for (NSNumber *e in path.reverseObjectEnumerator) {
+        FLEXHeapEdge edge = edges[e.unsignedIntValue];
+        [addresses addObject:@(_graph.objects[v].address)];
+        [classNames addObject:@(class_getName([_graph classOfObjectAtIndex:v]))];
+        [labels addObject:@([_graph nameOfLabel:edge.label])];
+        v = edge.target;
+    }
+
+    FLEXRetainCycle *cycle = [FLEXRetainCycle new];
+    cycle.componentSize = componentSize;
+    cycle.addresses = addresses;
+    cycle.classNames = classNames;
+    cycle.labels = labels;
+    return cycle;
+}
+
+@end
+
+#pragma mark - FLEXRetainCycleDetector
+
+@implementation FLEXRetainCycleDetector
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _memoryBudget = (size_t)MIN(NSProcessInfo.processInfo.physicalMemory / 4, 1ull << 30);
+        _maximumCycleCount = 100;
+    }
+
+    return self;
+}
+
+- (NSProgress *)findCyclesThroughObject:(id)object
+                             completion:(void (^)(NSArray<FLEXRetainCycle *> *, NSError *))completion {
+    uintptr_t address = (uintptr_t)(__bridge void *)object;
+    return [self findCyclesWithRoots:^(FLEXHeapGraph *graph, NSMutableData *roots) {
+        uint32_t index = [graph indexOfAddress:address];
+        if (index != UINT32_MAX) {
+            [roots appendBytes:&index length:sizeof(index)];
+        }
+    } completion:completion];
+}
+
+- (NSProgress *)findCyclesThroughInstancesOfClass:(Class)cls
+                                       completion:(void (^)(NSArray<FLEXRetainCycle *> *, NSError *))completion {
+    return [self findCyclesWithRoots:^(FLEXHeapGraph *graph, NSMutableData *roots) {
+        const FLEXHeapObject *objects = graph.objects;
+        Class __unsafe_unretained const *classes = graph.classes;
+        for (uint32_t i = 0; i < graph.objectCount; i++) {
+            if (classes[objects[i].slot] == cls) {
+                [roots appendBytes:&i length:sizeof(i)];
+            }
+        }
+    } completion:completion];
+}
+
+/// @param findRoots Appends the \c uint32_t index of each object to search from
+- (NSProgress *)findCyclesWithRoots:(void(^)(FLEXHeapGraph *graph, NSMutableData *roots))findRoots
+                         completion:(void (^)(NSArray<FLEXRetainCycle *> *, NSError *))completion {
+    NSProgress *progress = [NSProgress progressWithTotalUnitCount:kFLEXRetainCycleGraphUnits + kFLEXRetainCycleSearchUnits];
+    size_t budget = self.memoryBudget;
+    NSUInteger maximumCycleCount = self.maximumCycleCount;
+
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        NSError *error = nil;
+        NSArray<FLEXRetainCycle *> *cycles = [self
+            findCyclesWithRoots:findRoots
+            memoryBudget:budget
+            maximumCycleCount:maximumCycleCount
+            progress:progress
+            error:&error
+        ];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(cycles, error);
+        });
+    });
+
+    return progress;
+}
+
+- (NSArray<FLEXRetainCycle *> *)findCyclesWithRoots:(void(^)(FLEXHeapGraph *graph, NSMutableData *roots))findRoots
+                                       memoryBudget:(size_t)budget
+                                  maximumCycleCount:(NSUInteger)maximumCycleCount
+                                           progress:(NSProgress *)progress
+                                              error:(NSError **)error {
+    NSError *cancelled = [NSError errorWithDomain:NSCocoaErrorDomain code:NSUserCancelledError userInfo:nil];
+    NSError *overBudget = [NSError errorWithDomain:NSPOSIXErrorDomain code:ENOMEM userInfo:@{
+        NSLocalizedDescriptionKey: @"The heap is too large to search within the memory budget"
+    }];
+
+    NSProgress *graphProgress = [NSProgress
+        progressWithTotalUnitCount:-1 parent:progress pendingUnitCount:kFLEXRetainCycleGraphUnits
+    ];
+    FLEXHeapGraph *graph = [FLEXHeapGraph
+        graphOfLiveObjectsWithOptions:FLEXHeapGraphOptionsOwnedReferencesOnly
+        byteLimit:budget
+        progress:graphProgress
+    ];
+
+    if (progress.isCancelled) {
+        *error = cancelled;
+        return nil;
+    }
+    if (!graph) {
+        *error = overBudget;
+        return nil;
+    }
+
+    // Visit orders and component sizes share their bits with kFLEXTarjanDone
+    uint32_t objectCount = graph.objectCount;
+    size_t searchBytes = [FLEXRetainCycleSearch byteCountForObjectCount:objectCount];
+    if (objectCount >= kFLEXTarjanDone || graph.byteCount + searchBytes > budget) {
+        *error = overBudget;
+        return nil;
+    }
+
+    NSMutableData *rootData = [NSMutableData new];
+    findRoots(graph, rootData);
+    const uint32_t *roots = rootData.bytes;
+    NSUInteger rootCount = rootData.length / sizeof(uint32_t);
+
+    FLEXRetainCycleSearch *search = [[FLEXRetainCycleSearch alloc] initWithGraph:graph];
+    for (NSUInteger i = 0; i < rootCount; i++) {
+        if (![search visitFrom:roots[i] progress:progress]) {
+            *error = cancelled;
+            return nil;
+        }
+    }
+
+    // One cycle per component, since the rest go through the same objects
+    NSMutableArray<FLEXRetainCycle *> *cycles = [NSMutableArray new];
+    NSMutableIndexSet *reportedComponents = [NSMutableIndexSet new];
+    for (NSUInteger i = 0; i < rootCount && cycles.count < maximumCycleCount; i++) {
+        uint32_t component = [search componentOfObject:roots[i]];
+        if ([reportedComponents containsIndex:component]) {
+            continue;
+        }
+
+        FLEXRetainCycle *cycle = [search shortestCycleThrough:roots[i]];
+        if (cycle) {
+            [cycles addObject:cycle];
+            [reportedComponents addIndex:component];
+        }
+    }
+
+    progress.completedUnitCount = progress.totalUnitCount;
+    return cycles;
+}
+
+@end
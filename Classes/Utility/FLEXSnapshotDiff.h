@@ -0,0 +1,36 @@
+//
+//  FLEXSnapshotDiff.h
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/// The changes between two snapshots of a list, in the form \c UITableView batch updates expect.
+///
+/// Objects are matched by identity, not \c isEqual:, and must appear at most once in each
+/// snapshot. The diff takes linear time: each snapshot is indexed once, and an object that
+/// is in both is only reported as moved if its position changed by more than the inserts
+/// and deletes before it account for.
+@interface FLEXSnapshotDiff : NSObject
+
++ (instancetype)diffFromSnapshot:(NSArray *)oldSnapshot toSnapshot:(NSArray *)newSnapshot;
+
+/// Indexes into the old snapshot
+@property (nonatomic, readonly) NSIndexSet *deletedIndexes;
+/// Indexes into the new snapshot
+@property (nonatomic, readonly) NSIndexSet *insertedIndexes;
+/// Old indexes of moved objects, in the same order as \c movedToIndexes
+@property (nonatomic, readonly) NSArray<NSNumber *> *movedFromIndexes;
+/// New indexes of moved objects, in the same order as \c movedFromIndexes
+@property (nonatomic, readonly) NSArray<NSNumber *> *movedToIndexes;
+
+@property (nonatomic, readonly) BOOL hasChanges;
+
+@end
+
+NS_ASSUME_NONNULL_END
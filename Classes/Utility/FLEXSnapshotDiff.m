@@ -0,0 +1,80 @@
+//
+//  FLEXSnapshotDiff.m
+//  FLEX
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import "FLEXSnapshotDiff.h"
+
+@implementation FLEXSnapshotDiff
+
+/// Object pointer to its index in the snapshot. Indexes are stored plus one, since 0 means absent.
+static CFMutableDictionaryRef FLEXSnapshotDiffIndexSnapshot(NSArray *snapshot) {
+    CFMutableDictionaryRef indexes = CFDictionaryCreateMutable(NULL, snapshot.count, NULL, NULL);
+    [snapshot enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
+        CFDictionarySetValue(indexes, (__bridge const void *)obj, (const void *)(uintptr_t)(idx + 1));
+    }];
+
+    return indexes;
+}
+
+static NSInteger FLEXSnapshotDiffIndexOf(CFDictionaryRef indexes, id obj) {
+    return (NSInteger)(uintptr_t)CFDictionaryGetValue(indexes, (__bridge const void *)obj) - 1;
+}
+
++ (instancetype)diffFromSnapshot:(NSArray *)oldSnapshot toSnapshot:(NSArray *)newSnapshot {
+    FLEXSnapshotDiff *diff = [self new];
+    NSUInteger oldCount = oldSnapshot.count, newCount = newSnapshot.count;
+
+    CFMutableDictionaryRef oldIndexes = FLEXSnapshotDiffIndexSnapshot(oldSnapshot);
+    CFMutableDictionaryRef newIndexes = FLEXSnapshotDiffIndexSnapshot(newSnapshot);
+
+    // deletesBefore[i] is the number of deleted objects before old index i
+    NSMutableIndexSet *deleted = [NSMutableIndexSet new];
+    NSInteger *deletesBefore = calloc(oldCount + 1, sizeof(NSInteger));
+    for (NSUInteger i = 0; i < oldCount; i++) {
+        deletesBefore[i + 1] = deletesBefore[i];
+        if (FLEXSnapshotDiffIndexOf(newIndexes, oldSnapshot[i]) < 0) {
+            [deleted addIndex:i];
+            deletesBefore[i + 1]++;
+        }
+    }
+
+    NSMutableIndexSet *inserted = [NSMutableIndexSet new];
+    NSMutableArray<NSNumber *> *movedFrom = [NSMutableArray new];
+    NSMutableArray<NSNumber *> *movedTo = [NSMutableArray new];
+    NSInteger insertsBefore = 0;
+    for (NSUInteger j = 0; j < newCount; j++) {
+        NSInteger i = FLEXSnapshotDiffIndexOf(oldIndexes, newSnapshot[j]);
+        if (i < 0) {
+            [inserted addIndex:j];
+            insertsBefore++;
+            continue;
+        }
+
+        // Where it would end up if only the inserts and deletes were applied
+        NSInteger expected = i - deletesBefore[i] + insertsBefore;
+        if (expected != (NSInteger)j) {
+            [movedFrom addObject:@(i)];
+            [movedTo addObject:@(j)];
+        }
+    }
+
+    free(deletesBefore);
+    CFRelease(oldIndexes);
+    CFRelease(newIndexes);
+
+    diff->_deletedIndexes = deleted;
+    diff->_insertedIndexes = inserted;
+    diff->_movedFromIndexes = movedFrom;
+    diff->_movedToIndexes = movedTo;
+    return diff;
+}
+
+- (BOOL)hasChanges {
+    return self.deletedIndexes.count || self.insertedIndexes.count || self.movedFromIndexes.count;
+}
+
+@end
@@ -50,6 +50,8 @@
 + (NSArray<NSURLQueryItem *> *)itemsFromQueryString:(NSString *)query;
 + (NSString *)prettyJSONStringFromData:(NSData *)data;
 + (BOOL)isValidJSONData:(NSData *)data;
+/// Inflates gzip or zlib compressed data. Use \c FLEXInflatingReader instead when the bytes can be read in order.
+/// @return \c nil if the data is corrupt or inflates to more than \c FLEXInflatingReader.defaultByteLimit
 + (NSData *)inflatedDataFromCompressedData:(NSData *)compressedData;
 + (BOOL)hasCompressedContentEncoding:(NSURLRequest *)request;
 
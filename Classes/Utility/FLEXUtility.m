@@ -12,9 +12,10 @@
 #import "FLEXWindow.h"
 #import "FLEXSwiftUISupport.h"
 #import "FLEXSwiftNameDemangler.h"
+#import "FLEXJSONDocument.h"
+#import "FLEXInflatingReader.h"
 #import <ImageIO/ImageIO.h>
 #import <objc/runtime.h>
-#import <zlib.h>
 
 BOOL FLEXConstructorsShouldRun(void) {
     #if FLEX_DISABLE_CTORS
@@ -407,66 +408,24 @@ BOOL FLEXConstructorsShouldRun(void) {
 }
 
 + (NSString *)prettyJSONStringFromData:(NSData *)data {
-    NSString *prettyString = nil;
-    
-    id jsonObject = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
-    if ([NSJSONSerialization isValidJSONObject:jsonObject]) {
-        // Thanks RaziPour1993
-        prettyString = [[NSString alloc]
-            initWithData:[NSJSONSerialization
-                dataWithJSONObject:jsonObject options:NSJSONWritingPrettyPrinted error:NULL
-            ]
-            encoding:NSUTF8StringEncoding
-        ];
-        // NSJSONSerialization escapes forward slashes.
-        // We want pretty json, so run through and unescape the slashes.
-        prettyString = [prettyString stringByReplacingOccurrencesOfString:@"\\/" withString:@"/"];
-    } else {
-        prettyString = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
-    }
-    
-    return prettyString;
+    // Reformats the bytes directly instead of parsing and re-serializing them
+    NSString *prettyString = [FLEXJSONDocument documentWithData:data].prettyString;
+    return prettyString ?: [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
 }
 
 + (BOOL)isValidJSONData:(NSData *)data {
     return [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL] ? YES : NO;
 }
 
-// Thanks to the following links for help with this method
-// https://www.cocoanetics.com/2012/02/decompressing-files-into-memory/
-// https://github.com/nicklockwood/GZIP
 + (NSData *)inflatedDataFromCompressedData:(NSData *)compressedData {
-    NSData *inflatedData = nil;
-    NSUInteger compressedDataLength = compressedData.length;
-    if (compressedDataLength > 0) {
-        z_stream stream;
-        stream.zalloc = Z_NULL;
-        stream.zfree = Z_NULL;
-        stream.avail_in = (uInt)compressedDataLength;
-        stream.next_in = (void *)compressedData.bytes;
-        stream.total_out = 0;
-        stream.avail_out = 0;
-
-        NSMutableData *mutableData = [NSMutableData dataWithLength:compressedDataLength * 1.5];
-        if (inflateInit2(&stream, 15 + 32) == Z_OK) {
-            int status = Z_OK;
-            while (status == Z_OK) {
-                if (stream.total_out >= mutableData.length) {
-                    mutableData.length += compressedDataLength / 2;
-                }
-                stream.next_out = (uint8_t *)[mutableData mutableBytes] + stream.total_out;
-                stream.avail_out = (uInt)(mutableData.length - stream.total_out);
-                status = inflate(&stream, Z_SYNC_FLUSH);
-            }
-            if (inflateEnd(&stream) == Z_OK) {
-                if (status == Z_STREAM_END) {
-                    mutableData.length = stream.total_out;
-                    inflatedData = [mutableData copy];
-                }
-            }
-        }
+    if (!compressedData.length) {
+        return nil;
     }
-    return inflatedData;
+
+    return [FLEXInflatingReader
+        inflatedDataFromCompressedData:compressedData
+        byteLimit:FLEXInflatingReader.defaultByteLimit
+    ];
 }
 
 + (BOOL)hasCompressedContentEncoding:(NSURLRequest *)request {
@@ -0,0 +1,144 @@
+//
+//  FLEXHeapCensusBenchmarks.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXHeapCensus.h"
+#import "FLEXHeapEnumerator.h"
+#import <objc/runtime.h>
+#include <mach/mach_time.h>
+
+/// Roughly the heap of a large app after some use
+static const NSUInteger kObjectCount = 2000000;
+enum { kSyntheticClassCount = 64 };
+
+@interface FLEXHeapCensusBenchmarks : XCTestCase
+@end
+
+@implementation FLEXHeapCensusBenchmarks {
+    __unsafe_unretained Class _classes[kSyntheticClassCount];
+    /// Retained instances, kept in a malloc'd array so the array itself is not an object
+    CFTypeRef *_objects;
+}
+
+- (void)setUp {
+    [super setUp];
+
+    for (NSUInteger i = 0; i < kSyntheticClassCount; i++) {
+        NSString *name = [NSString stringWithFormat:@"FLEXCensusBenchmarkObject%@", @(i)];
+        Class cls = NSClassFromString(name);
+        if (!cls) {
+            cls = objc_allocateClassPair(NSObject.class, name.UTF8String, 0);
+            objc_registerClassPair(cls);
+        }
+        _classes[i] = cls;
+    }
+
+    _objects = malloc(kObjectCount * sizeof(CFTypeRef));
+    for (NSUInteger i = 0; i < kObjectCount; i++) {
+        _objects[i] = CFBridgingRetain([_classes[i % kSyntheticClassCount] new]);
+    }
+}
+
+- (void)tearDown {
+    for (NSUInteger i = 0; i < kObjectCount; i++) {
+        CFRelease(_objects[i]);
+    }
+    free(_objects);
+
+    [super tearDown];
+}
+
+/// How the live objects list and heap snapshots counted before the census engine
+- (CFMutableDictionaryRef)legacyCensus {
+    unsigned int classCount = 0;
+    Class *classes = objc_copyClassList(&classCount);
+    CFMutableDictionaryRef counts = CFDictionaryCreateMutable(NULL, classCount, NULL, NULL);
+    for (unsigned int i = 0; i < classCount; i++) {
+        CFDictionarySetValue(counts, (__bridge const void *)classes[i], (const void *)0);
+    }
+    free(classes);
+
+    [FLEXHeapEnumerator enumerateLiveObjectsUsingBlock:^(__unsafe_unretained id object, __unsafe_unretained Class cls) {
+        NSUInteger count = (NSUInteger)CFDictionaryGetValue(counts, (__bridge const void *)cls);
+        CFDictionarySetValue(counts, (__bridge const void *)cls, (const void *)(count + 1));
+    }];
+
+    return counts;
+}
+
+- (NSTimeInterval)time:(void(^)(void))block {
+    uint64_t start = mach_absolute_time();
+    block();
+    uint64_t end = mach_absolute_time();
+
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    return (double)(end - start) * timebase.numer / timebase.denom / NSEC_PER_SEC;
+}
+
+#pragma mark Speed
+
+- (void)testCensus {
+    [self measureBlock:^{
+        FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+        FLEXHeapCensusResultFree(&census);
+    }];
+}
+
+- (void)testLegacyCensus {
+    [self measureBlock:^{
+        CFRelease([self legacyCensus]);
+    }];
+}
+
+- (void)testCensusSpeedup {
+    // Once to build the class table and fault in the heap
+    FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+    FLEXHeapCensusResultFree(&census);
+
+    NSTimeInterval after = [self time:^{
+        FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+        FLEXHeapCensusResultFree(&census);
+    }];
+    NSTimeInterval before = [self time:^{
+        CFRelease([self legacyCensus]);
+    }];
+
+    NSLog(@"Census of %@ synthetic objects: %.0f ms before, %.0f ms after (%.1fx)",
+        @(kObjectCount), before * 1000, after * 1000, before / after
+    );
+}
+
+#pragma mark Correctness
+
+- (void)testCountsMatchLegacyCensus {
+    CFMutableDictionaryRef legacy = [self legacyCensus];
+    FLEXHeapCensusResult census = [FLEXHeapCensus.sharedCensus takeCensus];
+
+    NSUInteger found = 0;
+    for (uint32_t i = 0; i < census.entryCount; i++) {
+        FLEXHeapCensusEntry entry = census.entries[i];
+        for (NSUInteger c = 0; c < kSyntheticClassCount; c++) {
+            if (entry.cls == _classes[c]) {
+                NSUInteger legacyCount = (NSUInteger)CFDictionaryGetValue(legacy, (__bridge const void *)entry.cls);
+                XCTAssertEqual((NSUInteger)entry.count, kObjectCount / kSyntheticClassCount);
+                XCTAssertEqual((NSUInteger)entry.count, legacyCount);
+                XCTAssertGreaterThanOrEqual(entry.bytes, entry.count * class_getInstanceSize(entry.cls));
+                XCTAssertEqual([FLEXHeapCensus.sharedCensus classAtSlot:entry.slot generation:census.generation], entry.cls);
+                found++;
+            }
+        }
+    }
+
+    XCTAssertEqual(found, kSyntheticClassCount);
+    XCTAssertGreaterThanOrEqual(census.objectCount, kObjectCount);
+    FLEXHeapCensusResultFree(&census);
+    CFRelease(legacy);
+}
+
+@end
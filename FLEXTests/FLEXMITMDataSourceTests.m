@@ -0,0 +1,166 @@
+//
+//  FLEXMITMDataSourceTests.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXMITMDataSource.h"
+#import "FLEXNetworkTransaction.h"
+
+@interface FLEXMITMDataSourceTests : XCTestCase
+/// What the data source's provider returns, newest first like the recorder
+@property (nonatomic) NSArray<FLEXHTTPTransaction *> *recorded;
+@property (nonatomic) FLEXMITMDataSource<FLEXHTTPTransaction *> *dataSource;
+/// Every transaction the data source tested and found not matching by URL
+@property (nonatomic) NSMutableArray<FLEXHTTPTransaction *> *tested;
+/// Transactions the content matcher reports as matching any query
+@property (nonatomic) NSMutableSet<FLEXHTTPTransaction *> *contentMatches;
+@end
+
+@implementation FLEXMITMDataSourceTests
+
+- (void)setUp {
+    [super setUp];
+
+    self.recorded = @[];
+    self.tested = [NSMutableArray new];
+    self.contentMatches = [NSMutableSet new];
+
+    __weak __typeof(self) weakSelf = self;
+    self.dataSource = [FLEXMITMDataSource dataSourceWithProvider:^NSArray *{
+        return weakSelf.recorded;
+    }];
+    self.dataSource.contentMatcher = ^BOOL(FLEXHTTPTransaction *transaction, NSString *query) {
+        [weakSelf.tested addObject:transaction];
+        return [weakSelf.contentMatches containsObject:transaction];
+    };
+}
+
+- (FLEXHTTPTransaction *)transactionWithPath:(NSString *)path length:(int64_t)length {
+    static FLEXNetworkRequestID nextID = 1;
+    NSURL *url = [NSURL URLWithString:[@"https://example.com" stringByAppendingString:path]];
+    FLEXHTTPTransaction *transaction = [FLEXHTTPTransaction
+        request:[NSURLRequest requestWithURL:url] identifier:nextID++
+    ];
+    transaction.receivedDataLength = length;
+    return transaction;
+}
+
+- (void)filter:(NSString *)query {
+    XCTestExpectation *filtered = [self expectationWithDescription:@"filter"];
+    [self.dataSource filter:query completion:^(FLEXMITMDataSource *dataSource) {
+        [filtered fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testUnfilteredReloadCountsBytes {
+    FLEXHTTPTransaction *first = [self transactionWithPath:@"/users" length:10];
+    FLEXHTTPTransaction *second = [self transactionWithPath:@"/posts" length:20];
+    self.recorded = @[second, first];
+    [self.dataSource reloadData:nil];
+
+    XCTAssertFalse(self.dataSource.isFiltered);
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[second, first]));
+    XCTAssertEqual(self.dataSource.totalBytesReceived, 30);
+    XCTAssertEqual(self.dataSource.bytesReceived, 30);
+}
+
+- (void)testReloadOnlyTestsInsertedTransactions {
+    FLEXHTTPTransaction *oldUser = [self transactionWithPath:@"/users/1" length:10];
+    FLEXHTTPTransaction *post = [self transactionWithPath:@"/posts/1" length:20];
+    FLEXHTTPTransaction *user = [self transactionWithPath:@"/users/2" length:30];
+    self.recorded = @[user, post, oldUser];
+    [self.dataSource reloadData:nil];
+
+    [self filter:@"users"];
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[user, oldUser]));
+    XCTAssertEqual(self.dataSource.bytesReceived, 40);
+
+    // Two new transactions arrive and the oldest is dropped from the end
+    FLEXHTTPTransaction *newUser = [self transactionWithPath:@"/users/3" length:40];
+    FLEXHTTPTransaction *newPost = [self transactionWithPath:@"/posts/2" length:50];
+    self.recorded = @[newPost, newUser, user, post];
+    [self.tested removeAllObjects];
+    [self.dataSource reloadData:nil];
+
+    XCTAssertEqualObjects(self.tested, @[newPost]);
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[newUser, user]));
+    XCTAssertEqual(self.dataSource.bytesReceived, 70);
+    XCTAssertEqual(self.dataSource.totalBytesReceived, 140);
+}
+
+- (void)testReloadAfterRemovalFromTheMiddle {
+    FLEXHTTPTransaction *first = [self transactionWithPath:@"/users/1" length:10];
+    FLEXHTTPTransaction *second = [self transactionWithPath:@"/posts/1" length:20];
+    FLEXHTTPTransaction *third = [self transactionWithPath:@"/users/2" length:30];
+    self.recorded = @[third, second, first];
+    [self.dataSource reloadData:nil];
+    [self filter:@"users"];
+
+    // Surviving transactions keep their verdicts, only new ones are tested
+    FLEXHTTPTransaction *fourth = [self transactionWithPath:@"/posts/2" length:40];
+    self.recorded = @[fourth, first];
+    [self.tested removeAllObjects];
+    [self.dataSource reloadData:nil];
+
+    XCTAssertEqualObjects(self.tested, @[fourth]);
+    XCTAssertEqualObjects(self.dataSource.transactions, @[first]);
+    XCTAssertEqual(self.dataSource.bytesReceived, 10);
+    XCTAssertEqual(self.dataSource.totalBytesReceived, 50);
+}
+
+- (void)testNarrowingAndWideningTheQuery {
+    FLEXHTTPTransaction *user = [self transactionWithPath:@"/users/1" length:10];
+    FLEXHTTPTransaction *otherUser = [self transactionWithPath:@"/users/2" length:20];
+    FLEXHTTPTransaction *post = [self transactionWithPath:@"/posts/1" length:30];
+    self.recorded = @[post, otherUser, user];
+    [self.dataSource reloadData:nil];
+
+    [self filter:@"users"];
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[otherUser, user]));
+
+    [self filter:@"users/2"];
+    XCTAssertEqualObjects(self.dataSource.transactions, @[otherUser]);
+    XCTAssertEqual(self.dataSource.bytesReceived, 20);
+
+    [self filter:@"1"];
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[post, user]));
+    XCTAssertEqual(self.dataSource.bytesReceived, 40);
+
+    [self filter:@""];
+    XCTAssertFalse(self.dataSource.isFiltered);
+    XCTAssertEqualObjects(self.dataSource.transactions, self.recorded);
+    XCTAssertEqual(self.dataSource.bytesReceived, 60);
+}
+
+- (void)testUpdatedTransactions {
+    FLEXHTTPTransaction *user = [self transactionWithPath:@"/users/1" length:10];
+    FLEXHTTPTransaction *post = [self transactionWithPath:@"/posts/1" length:20];
+    self.recorded = @[post, user];
+    [self.dataSource reloadData:nil];
+    [self filter:@"users"];
+
+    // More of a body arriving changes the byte counts but not the results
+    user.receivedDataLength = 15;
+    XCTAssertFalse([self.dataSource didUpdateTransactions:@[user]]);
+    XCTAssertEqual(self.dataSource.bytesReceived, 15);
+    XCTAssertEqual(self.dataSource.totalBytesReceived, 35);
+
+    // A transaction whose content now matches joins the results in order
+    [self.contentMatches addObject:post];
+    XCTAssertTrue([self.dataSource didUpdateTransactions:@[post]]);
+    XCTAssertEqualObjects(self.dataSource.transactions, (@[post, user]));
+    XCTAssertEqual(self.dataSource.bytesReceived, 35);
+
+    // Transactions the data source never saw are ignored
+    FLEXHTTPTransaction *unknown = [self transactionWithPath:@"/users/2" length:100];
+    XCTAssertFalse([self.dataSource didUpdateTransactions:@[unknown]]);
+    XCTAssertEqual(self.dataSource.totalBytesReceived, 35);
+}
+
+@end
@@ -0,0 +1,190 @@
+//
+//  FLEXNetworkEventRingBenchmarks.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXNetworkEventRing.h"
+#include <mach/mach_time.h>
+
+/// Roughly the number of URLSession delegate queues in an app with several sessions
+static const NSUInteger kProducerCount = 32;
+static const NSUInteger kEventsPerProducer = 20000;
+static const NSUInteger kRequestCount = 512;
+
+/// Stands in for the recorder's bookkeeping: look up the request and update it
+@interface FLEXEventSink : NSObject
+@property (nonatomic, readonly) NSUInteger handled;
+@property (nonatomic, readonly) BOOL outOfOrder;
+- (void)handle:(const FLEXNetworkEvent *)event;
+@end
+
+@implementation FLEXEventSink {
+    int64_t _bytesByRequest[kRequestCount];
+    /// The last sequence number handled from each producer
+    int64_t _lastByProducer[kProducerCount];
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        for (NSUInteger i = 0; i < kProducerCount; i++) {
+            _lastByProducer[i] = -1;
+        }
+    }
+    return self;
+}
+
+/// The producer is in the kind, and its sequence number in the length
+- (void)handle:(const FLEXNetworkEvent *)event {
+    _bytesByRequest[event->requestID % kRequestCount] += event->length;
+    if (event->length <= _lastByProducer[event->kind]) {
+        _outOfOrder = YES;
+    }
+    _lastByProducer[event->kind] = event->length;
+    _handled++;
+}
+
+@end
+
+@interface FLEXNetworkEventRingBenchmarks : XCTestCase
+@property (nonatomic, readonly) NSArray<dispatch_queue_t> *producers;
+@end
+
+@implementation FLEXNetworkEventRingBenchmarks
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableArray *producers = [NSMutableArray new];
+    for (NSUInteger i = 0; i < kProducerCount; i++) {
+        [producers addObject:dispatch_queue_create("com.flex.tests.producer", DISPATCH_QUEUE_SERIAL)];
+    }
+    _producers = producers;
+}
+
+/// Runs \c post on every producer queue at once, then waits for \c queue to handle everything
+- (NSTimeInterval)produceOnto:(dispatch_queue_t)queue with:(void(^)(uint32_t producer, int64_t sequence))post {
+    dispatch_group_t group = dispatch_group_create();
+    uint64_t start = mach_absolute_time();
+    for (uint32_t p = 0; p < kProducerCount; p++) {
+        dispatch_group_async(group, self.producers[p], ^{
+            for (int64_t i = 0; i < kEventsPerProducer; i++) {
+                post(p, i);
+            }
+        });
+    }
+
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    dispatch_sync(queue, ^{ });
+    uint64_t end = mach_absolute_time();
+
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    return (double)(end - start) * timebase.numer / timebase.denom / NSEC_PER_SEC;
+}
+
+- (NSTimeInterval)runRingWithCapacity:(NSUInteger)capacity sink:(FLEXEventSink *)sink {
+    dispatch_queue_t queue = dispatch_queue_create("com.flex.tests.consumer", DISPATCH_QUEUE_SERIAL);
+    FLEXNetworkEventRing *ring = [FLEXNetworkEventRing
+        ringWithCapacity:capacity
+        queue:queue
+        handler:^(const FLEXNetworkEvent *events, NSUInteger count) {
+            for (NSUInteger i = 0; i < count; i++) {
+                [sink handle:&events[i]];
+            }
+        }
+    ];
+
+    return [self produceOnto:queue with:^(uint32_t producer, int64_t sequence) {
+        [ring post:producer requestID:producer * kEventsPerProducer + sequence length:sequence object:nil];
+    }];
+}
+
+/// What every record... method did before the ring: one block per event
+- (NSTimeInterval)runDispatchWithSink:(FLEXEventSink *)sink {
+    dispatch_queue_t queue = dispatch_queue_create("com.flex.tests.consumer", DISPATCH_QUEUE_SERIAL);
+    return [self produceOnto:queue with:^(uint32_t producer, int64_t sequence) {
+        FLEXNetworkEvent event = {
+            .requestID = producer * kEventsPerProducer + sequence,
+            .timestamp = mach_absolute_time(),
+            .length = sequence,
+            .kind = producer,
+        };
+        dispatch_async(queue, ^{
+            [sink handle:&event];
+        });
+    }];
+}
+
+#pragma mark Throughput
+
+- (void)testRing {
+    [self measureBlock:^{
+        [self runRingWithCapacity:4096 sink:[FLEXEventSink new]];
+    }];
+}
+
+- (void)testDispatch {
+    [self measureBlock:^{
+        [self runDispatchWithSink:[FLEXEventSink new]];
+    }];
+}
+
+- (void)testEventsPerSecond {
+    double events = kProducerCount * kEventsPerProducer;
+    NSTimeInterval ring = [self runRingWithCapacity:4096 sink:[FLEXEventSink new]];
+    NSTimeInterval dispatch = [self runDispatchWithSink:[FLEXEventSink new]];
+    NSLog(@"%@ producers: ring %.0f events/s, dispatch_async %.0f events/s (%.1fx)",
+        @(kProducerCount), events / ring, events / dispatch, dispatch / ring
+    );
+}
+
+#pragma mark Correctness
+
+- (void)testHandlesEveryEventInOrder {
+    FLEXEventSink *sink = [FLEXEventSink new];
+    [self runRingWithCapacity:4096 sink:sink];
+    XCTAssertEqual(sink.handled, kProducerCount * kEventsPerProducer);
+    XCTAssertFalse(sink.outOfOrder);
+}
+
+- (void)testFullRingWaitsInOrder {
+    // Small enough that producers wait on the consumer constantly
+    FLEXEventSink *sink = [FLEXEventSink new];
+    [self runRingWithCapacity:8 sink:sink];
+    XCTAssertEqual(sink.handled, kProducerCount * kEventsPerProducer);
+    XCTAssertFalse(sink.outOfOrder);
+}
+
+- (void)testReleasesObjects {
+    dispatch_queue_t queue = dispatch_queue_create("com.flex.tests.consumer", DISPATCH_QUEUE_SERIAL);
+    __block NSUInteger seen = 0;
+    FLEXNetworkEventRing *ring = [FLEXNetworkEventRing
+        ringWithCapacity:16
+        queue:queue
+        handler:^(const FLEXNetworkEvent *events, NSUInteger count) {
+            for (NSUInteger i = 0; i < count; i++) {
+                seen += [events[i].object length];
+            }
+        }
+    ];
+
+    __weak NSData *weakBody = nil;
+    @autoreleasepool {
+        NSData *body = [NSMutableData dataWithLength:10];
+        weakBody = body;
+        for (NSUInteger i = 0; i < 100; i++) {
+            [ring post:0 requestID:i length:0 object:body];
+        }
+    }
+
+    dispatch_sync(queue, ^{ });
+    XCTAssertEqual(seen, 1000);
+    XCTAssertNil(weakBody);
+}
+
+@end
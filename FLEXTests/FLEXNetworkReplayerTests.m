@@ -0,0 +1,161 @@
+//
+//  FLEXNetworkReplayerTests.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXNetworkReplayer.h"
+#import "FLEXNetworkTransaction.h"
+#import "FLEXNetworkObserver.h"
+
+static NSString *const kFLEXReplayStubHost = @"replay.test";
+static const NSTimeInterval kFLEXReplayStubSlowDelay = 0.2;
+
+/// Answers every request to the stub host: paths under /slow take a while,
+/// paths under /missing are a 404, and everything else is a 200 right away
+@interface FLEXReplayStubProtocol : NSURLProtocol
+@end
+
+@implementation FLEXReplayStubProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request {
+    return [request.URL.host isEqualToString:kFLEXReplayStubHost];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request {
+    return request;
+}
+
+- (void)startLoading {
+    // Responses must be sent on the thread loading started on
+    NSTimeInterval delay = [self.request.URL.path hasPrefix:@"/slow/"] ? kFLEXReplayStubSlowDelay : 0;
+    [self performSelector:@selector(respond) withObject:nil afterDelay:delay];
+}
+
+- (void)stopLoading {
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+}
+
+- (void)respond {
+    NSInteger status = [self.request.URL.path hasPrefix:@"/missing/"] ? 404 : 200;
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc]
+        initWithURL:self.request.URL statusCode:status HTTPVersion:@"HTTP/1.1" headerFields:nil
+    ];
+
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [self.client URLProtocol:self didLoadData:[@"ok" dataUsingEncoding:NSUTF8StringEncoding]];
+    [self.client URLProtocolDidFinishLoading:self];
+}
+
+@end
+
+@interface FLEXNetworkReplayerTests : XCTestCase
+@end
+
+@implementation FLEXNetworkReplayerTests
+
+- (FLEXHTTPTransaction *)recordedGET:(NSString *)path duration:(NSTimeInterval)duration {
+    static FLEXNetworkRequestID nextID = 1;
+    NSURL *url = [NSURL URLWithString:[@"https://api.example.com" stringByAppendingString:path]];
+    FLEXHTTPTransaction *transaction = [FLEXHTTPTransaction
+        request:[NSURLRequest requestWithURL:url] identifier:nextID++
+    ];
+    transaction.response = [[NSHTTPURLResponse alloc]
+        initWithURL:url statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil
+    ];
+    transaction.duration = duration;
+    transaction.state = FLEXNetworkTransactionStateFinished;
+    return transaction;
+}
+
+- (FLEXNetworkReplayEndpointDelta *)endpoint:(NSString *)pathTemplate inReport:(FLEXNetworkReplayReport *)report {
+    for (FLEXNetworkReplayEndpointDelta *endpoint in report.endpoints) {
+        if ([endpoint.pathTemplate isEqualToString:pathTemplate]) {
+            return endpoint;
+        }
+    }
+
+    return nil;
+}
+
+- (void)testReplayAgainstStub {
+    NSArray<FLEXHTTPTransaction *> *recorded = @[
+        [self recordedGET:@"/users/1" duration:0.05],
+        [self recordedGET:@"/users/2" duration:0.05],
+        [self recordedGET:@"/slow/1" duration:0.01],
+        [self recordedGET:@"/missing/1" duration:0.01],
+    ];
+
+    FLEXNetworkReplayer *replayer = [FLEXNetworkReplayer replayerWithTransactions:recorded];
+    replayer.baseURL = [NSURL URLWithString:[@"http://" stringByAppendingString:kFLEXReplayStubHost]];
+    replayer.pacing = FLEXNetworkReplayPacingMaximumConcurrency;
+    replayer.sessionConfiguration.protocolClasses = @[FLEXReplayStubProtocol.class];
+
+    // Replays are kept out of the live recorder
+    NSURLRequest *request = [replayer replayRequestForTransaction:recorded.firstObject];
+    XCTAssertEqualObjects(request.URL.absoluteString, @"http://replay.test/users/1");
+    XCTAssertNotNil([NSURLProtocol propertyForKey:kFLEXNetworkObserverIgnoredRequestKey inRequest:request]);
+
+    XCTestExpectation *replayed = [self expectationWithDescription:@"replay"];
+    __block FLEXNetworkReplayReport *report = nil;
+    NSProgress *progress = [replayer replayWithCompletion:^(FLEXNetworkReplayReport *result, NSError *error) {
+        XCTAssertNil(error);
+        report = result;
+        [replayed fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:10 handler:nil];
+    XCTAssertEqual(progress.completedUnitCount, 4);
+    XCTAssertEqual(report.replayedTransactions.count, 4);
+    XCTAssertEqual(report.endpoints.count, 3);
+    for (FLEXHTTPTransaction *transaction in report.replayedTransactions) {
+        XCTAssertEqualObjects(transaction.requestMechanism, @"FLEXNetworkReplayer");
+        XCTAssertEqual(transaction.receivedDataLength, 2);
+    }
+
+    // The slow endpoint regressed the most, and is the only one that did
+    FLEXNetworkReplayEndpointDelta *slow = [self endpoint:@"/slow/{id}" inReport:report];
+    XCTAssertEqual(report.endpoints.firstObject, slow);
+    XCTAssertEqual(slow.baselineCount, 1);
+    XCTAssertEqual(slow.replayCount, 1);
+    XCTAssertEqualWithAccuracy(slow.baselineP50, 0.01, 0.01 * 0.02);
+    XCTAssertGreaterThanOrEqual(slow.replayP50, kFLEXReplayStubSlowDelay * 0.98);
+    XCTAssertGreaterThan(slow.p50Delta, 0);
+    XCTAssertEqualObjects([report endpointsSlowerByMoreThan:1], @[slow]);
+
+    FLEXNetworkReplayEndpointDelta *users = [self endpoint:@"/users/{id}" inReport:report];
+    XCTAssertEqualObjects(users.HTTPMethod, @"GET");
+    XCTAssertEqual(users.baselineCount, 2);
+    XCTAssertEqual(users.replayCount, 2);
+    XCTAssertEqual(users.replayErrorCount, 0);
+
+    FLEXNetworkReplayEndpointDelta *missing = [self endpoint:@"/missing/{id}" inReport:report];
+    XCTAssertEqual(missing.baselineErrorCount, 0);
+    XCTAssertEqual(missing.replayErrorCount, 1);
+
+    XCTAssertTrue([report.summary containsString:@"GET /slow/{id}"]);
+}
+
+- (void)testCancelling {
+    FLEXNetworkReplayer *replayer = [FLEXNetworkReplayer replayerWithTransactions:@[
+        [self recordedGET:@"/slow/1" duration:0.01],
+    ]];
+    replayer.baseURL = [NSURL URLWithString:[@"http://" stringByAppendingString:kFLEXReplayStubHost]];
+    replayer.sessionConfiguration.protocolClasses = @[FLEXReplayStubProtocol.class];
+
+    XCTestExpectation *cancelled = [self expectationWithDescription:@"cancel"];
+    NSProgress *progress = [replayer replayWithCompletion:^(FLEXNetworkReplayReport *report, NSError *error) {
+        XCTAssertNil(report);
+        XCTAssertEqualObjects(error.domain, NSCocoaErrorDomain);
+        XCTAssertEqual(error.code, NSUserCancelledError);
+        [cancelled fulfill];
+    }];
+    [progress cancel];
+
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+@end
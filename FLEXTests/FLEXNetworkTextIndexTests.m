@@ -0,0 +1,122 @@
+//
+//  FLEXNetworkTextIndexTests.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXNetworkTextIndex.h"
+
+@interface FLEXNetworkTextIndexTests : XCTestCase
+@end
+
+@implementation FLEXNetworkTextIndexTests
+
+- (NSData *)UTF8:(NSString *)text {
+    return [text dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+- (void)testQuery {
+    FLEXNetworkTextIndex *index = [FLEXNetworkTextIndex indexWithByteLimit:1024 * 1024];
+    [index setText:[self UTF8:@"{\"greeting\": \"Hello World\"}"] forKey:@1];
+    [index setText:[self UTF8:@"goodbye, world"] forKey:@2];
+    [index setText:[self UTF8:@"héllo wörld"] forKey:@3];
+
+    XCTAssertEqual(index.count, 3);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"world"], ([NSSet setWithObjects:@1, @2, nil]));
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"WORLD"], ([NSSet setWithObjects:@1, @2, nil]));
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"hello"], [NSSet setWithObject:@1]);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"wörld"], [NSSet setWithObject:@3]);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"missing"], [NSSet set]);
+
+    // Too short to look up
+    XCTAssertEqual(FLEXNetworkTextIndex.minimumQueryLength, 3);
+    XCTAssertNil([index keysOfCandidatesContainingText:@"wo"]);
+}
+
+- (void)testCandidatesMustBeVerified {
+    FLEXNetworkTextIndex *index = [FLEXNetworkTextIndex indexWithByteLimit:1024 * 1024];
+    NSData *text = [self UTF8:@"abc-bcd"];
+    [index setText:text forKey:@1];
+
+    // Every trigram of the query is in the text, but the query isn't
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"abcd"], [NSSet setWithObject:@1]);
+    XCTAssertFalse([FLEXNetworkTextIndex text:text containsText:@"abcd"]);
+    XCTAssertTrue([FLEXNetworkTextIndex text:text containsText:@"C-B"]);
+    XCTAssertTrue([FLEXNetworkTextIndex text:text containsText:@""]);
+    XCTAssertFalse([FLEXNetworkTextIndex text:[self UTF8:@"ab"] containsText:@"abc"]);
+}
+
+- (void)testReplaceAndRemove {
+    FLEXNetworkTextIndex *index = [FLEXNetworkTextIndex indexWithByteLimit:1024 * 1024];
+    [index setText:[self UTF8:@"alpha"] forKey:@1];
+    [index setText:[self UTF8:@"beta"] forKey:@1];
+
+    XCTAssertEqual(index.count, 1);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"alpha"], [NSSet set]);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"beta"], [NSSet setWithObject:@1]);
+
+    [index removeTextForKey:@1];
+    XCTAssertEqual(index.count, 0);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"beta"], [NSSet set]);
+
+    [index setText:[self UTF8:@"gamma"] forKey:@2];
+    [index removeAllText];
+    XCTAssertEqual(index.count, 0);
+    XCTAssertEqual(index.byteCount, 0);
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"gamma"], [NSSet set]);
+}
+
+- (void)testEviction {
+    const NSUInteger limit = 16 * 1024;
+    FLEXNetworkTextIndex *index = [FLEXNetworkTextIndex indexWithByteLimit:limit];
+
+    NSUInteger compactions = 0, previousByteCount = 0;
+    for (NSUInteger i = 0; i < 500; i++) {
+        NSString *text = [NSString stringWithFormat:@"document %@ %@", @(i), NSUUID.UUID.UUIDString];
+        [index setText:[self UTF8:text] forKey:@(i)];
+        XCTAssertLessThanOrEqual(index.byteCount, limit);
+
+        compactions += index.byteCount < previousByteCount;
+        previousByteCount = index.byteCount;
+    }
+
+    // The oldest documents were dropped, and each compaction made room for many more
+    XCTAssertLessThan(index.count, 500);
+    XCTAssertGreaterThan(compactions, 0);
+    XCTAssertLessThan(compactions, 50);
+
+    // A dropped document can't be ruled out until its key is removed
+    XCTAssertTrue([[index keysOfCandidatesContainingText:@"document 0 "] containsObject:@0]);
+    XCTAssertTrue([[index keysOfCandidatesContainingText:@"document 499 "] containsObject:@499]);
+    [index removeTextForKey:@0];
+    XCTAssertFalse([[index keysOfCandidatesContainingText:@"document 0 "] containsObject:@0]);
+
+    // Raising the limit keeps what is left, lowering it drops more
+    NSUInteger count = index.count;
+    index.byteLimit = limit * 2;
+    XCTAssertEqual(index.count, count);
+    index.byteLimit = limit / 4;
+    XCTAssertLessThan(index.count, count);
+    XCTAssertLessThanOrEqual(index.byteCount, limit / 4);
+}
+
+- (void)testLongDocumentsAreAlwaysCandidates {
+    FLEXNetworkTextIndex *index = [FLEXNetworkTextIndex indexWithByteLimit:64 * 1024 * 1024];
+    NSMutableData *text = [NSMutableData dataWithLength:2 * 1024 * 1024];
+    memset(text.mutableBytes, 'x', text.length);
+    memcpy((uint8_t *)text.mutableBytes + text.length - 6, "needle", 6);
+    [index setText:text forKey:@1];
+    [index setText:[self UTF8:@"no match here"] forKey:@2];
+
+    // Only the start of the long document was indexed
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"needle"], [NSSet setWithObject:@1]);
+    XCTAssertTrue([FLEXNetworkTextIndex text:text containsText:@"needle"]);
+
+    [index setText:[self UTF8:@"short now"] forKey:@1];
+    XCTAssertEqualObjects([index keysOfCandidatesContainingText:@"needle"], [NSSet set]);
+}
+
+@end
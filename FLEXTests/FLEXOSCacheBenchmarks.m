@@ -0,0 +1,144 @@
+//
+//  FLEXOSCacheBenchmarks.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "OSCache.h"
+#import "FLEXLegacyOSCache.h"
+
+/// Roughly the number of response bodies a busy session keeps in memory
+static const NSUInteger kEntryCount = 5000;
+static const NSUInteger kCostPerEntry = 100;
+
+@interface FLEXOSCacheBenchmarks : XCTestCase
+@property (nonatomic, readonly) NSArray<NSString *> *keys;
+@property (nonatomic, readonly) NSData *value;
+@end
+
+@implementation FLEXOSCacheBenchmarks
+
+- (void)setUp {
+    [super setUp];
+
+    NSMutableArray *keys = [NSMutableArray arrayWithCapacity:kEntryCount * 2];
+    for (NSUInteger i = 0; i < kEntryCount * 2; i++) {
+        [keys addObject:[NSString stringWithFormat:@"request-%@", @(i)]];
+    }
+
+    _keys = keys;
+    _value = [NSMutableData dataWithLength:kCostPerEntry];
+}
+
+/// Fills the cache to its limit, then inserts as many more entries, each of which evicts one
+- (void)insertOverLimitInto:(NSCache *)cache {
+    cache.totalCostLimit = kEntryCount * kCostPerEntry;
+    for (NSString *key in self.keys) {
+        [cache setObject:self.value forKey:key cost:kCostPerEntry];
+    }
+}
+
+- (void)readAllFrom:(NSCache *)cache {
+    for (NSUInteger pass = 0; pass < 10; pass++) {
+        for (NSUInteger i = 0; i < kEntryCount; i++) {
+            [cache objectForKey:self.keys[i]];
+        }
+    }
+}
+
+- (void)readConcurrentlyFrom:(NSCache *)cache {
+    NSArray *keys = self.keys;
+    dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t worker) {
+        for (NSUInteger i = 0; i < kEntryCount * 2; i++) {
+            [cache objectForKey:keys[(i * 7 + worker) % kEntryCount]];
+        }
+    });
+}
+
+- (NSCache *)filledCache:(NSCache *)cache {
+    for (NSUInteger i = 0; i < kEntryCount; i++) {
+        [cache setObject:self.value forKey:self.keys[i] cost:kCostPerEntry];
+    }
+    return cache;
+}
+
+#pragma mark Eviction
+
+- (void)testInsertOverLimit {
+    [self measureBlock:^{
+        [self insertOverLimitInto:[OSCache new]];
+    }];
+}
+
+- (void)testInsertOverLimitLegacy {
+    [self measureBlock:^{
+        [self insertOverLimitInto:[FLEXLegacyOSCache new]];
+    }];
+}
+
+#pragma mark Lookup
+
+- (void)testRead {
+    NSCache *cache = [self filledCache:[OSCache new]];
+    [self measureBlock:^{
+        [self readAllFrom:cache];
+    }];
+}
+
+- (void)testReadLegacy {
+    NSCache *cache = [self filledCache:[FLEXLegacyOSCache new]];
+    [self measureBlock:^{
+        [self readAllFrom:cache];
+    }];
+}
+
+- (void)testConcurrentRead {
+    NSCache *cache = [self filledCache:[OSCache new]];
+    [self measureBlock:^{
+        [self readConcurrentlyFrom:cache];
+    }];
+}
+
+- (void)testConcurrentReadLegacy {
+    NSCache *cache = [self filledCache:[FLEXLegacyOSCache new]];
+    [self measureBlock:^{
+        [self readConcurrentlyFrom:cache];
+    }];
+}
+
+#pragma mark Correctness
+
+- (void)testEvictsLeastRecentlyUsed {
+    OSCache *cache = [OSCache new];
+    cache.countLimit = 3;
+    cache[@"a"] = @1;
+    cache[@"b"] = @2;
+    cache[@"c"] = @3;
+
+    // Touch "a" so that "b" becomes the oldest
+    XCTAssertEqualObjects(cache[@"a"], @1);
+    cache[@"d"] = @4;
+
+    XCTAssertNil(cache[@"b"]);
+    XCTAssertEqualObjects(cache[@"a"], @1);
+    XCTAssertEqualObjects(cache[@"c"], @3);
+    XCTAssertEqualObjects(cache[@"d"], @4);
+    XCTAssertEqual(cache.count, 3);
+}
+
+- (void)testTotalCostTracksReplacement {
+    OSCache *cache = [OSCache new];
+    [cache setObject:@1 forKey:@"a" cost:10];
+    [cache setObject:@2 forKey:@"a" cost:4];
+    [cache setObject:@3 forKey:@"b" cost:6];
+    XCTAssertEqual(cache.totalCost, 10);
+
+    [cache removeObjectForKey:@"a"];
+    XCTAssertEqual(cache.totalCost, 6);
+    XCTAssertEqual(cache.count, 1);
+}
+
+@end
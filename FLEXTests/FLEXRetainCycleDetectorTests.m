@@ -0,0 +1,65 @@
+//
+//  FLEXRetainCycleDetectorTests.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXRetainCycleDetector.h"
+
+@interface FLEXRetainCycleDetectorTests : XCTestCase
+@end
+
+@implementation FLEXRetainCycleDetectorTests
+
+- (NSArray<FLEXRetainCycle *> *)cyclesThroughObject:(id)object {
+    XCTestExpectation *done = [self expectationWithDescription:@"search"];
+    __block NSArray<FLEXRetainCycle *> *result = nil;
+    [[FLEXRetainCycleDetector new] findCyclesThroughObject:object completion:^(NSArray *cycles, NSError *error) {
+        XCTAssertNil(error);
+        result = cycles;
+        [done fulfill];
+    }];
+
+    [self waitForExpectationsWithTimeout:60 handler:nil];
+    return result;
+}
+
+- (void)testCollectionCycle {
+    NSMutableDictionary *first = [NSMutableDictionary new];
+    NSMutableDictionary *second = [NSMutableDictionary new];
+    first[@"next"] = second;
+    second[@"next"] = first;
+
+    NSArray<FLEXRetainCycle *> *cycles = [self cyclesThroughObject:first];
+    XCTAssertEqual(cycles.count, 1);
+    XCTAssertEqual(cycles.firstObject.length, 2);
+    XCTAssertEqualObjects(cycles.firstObject.addresses.firstObject, @((uintptr_t)(__bridge void *)first));
+    XCTAssertEqualObjects(cycles.firstObject.labels, (@[@"[value]", @"[value]"]));
+
+    [first removeAllObjects];
+    [second removeAllObjects];
+}
+
+- (void)testBlockCaptures {
+    NSMutableArray *strongHolder = [NSMutableArray new];
+    NSMutableArray *weakHolder = [NSMutableArray new];
+
+    // The array retains the block, which retains the array
+    [strongHolder addObject:[^{ (void)strongHolder.count; } copy]];
+    // The block only has a weak reference back, so there is no cycle
+    __weak NSMutableArray *weakArray = weakHolder;
+    [weakHolder addObject:[^{ (void)weakArray.count; } copy]];
+
+    NSArray<FLEXRetainCycle *> *cycles = [self cyclesThroughObject:strongHolder];
+    XCTAssertEqual(cycles.count, 1);
+    XCTAssertEqualObjects(cycles.firstObject.labels, (@[@"[element]", @"[captured]"]));
+    XCTAssertEqual([self cyclesThroughObject:weakHolder].count, 0);
+
+    [strongHolder removeAllObjects];
+    [weakHolder removeAllObjects];
+}
+
+@end
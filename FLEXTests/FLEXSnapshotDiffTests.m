@@ -0,0 +1,113 @@
+//
+//  FLEXSnapshotDiffTests.m
+//  FLEXTests
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#import <XCTest/XCTest.h>
+#import "FLEXSnapshotDiff.h"
+
+@interface FLEXSnapshotDiffTests : XCTestCase
+@end
+
+@implementation FLEXSnapshotDiffTests
+
+/// Applies the diff the way UITableView does: objects that were neither deleted nor moved keep
+/// their relative order and fill the slots that were neither inserted into nor moved into.
+- (NSArray *)apply:(FLEXSnapshotDiff *)diff to:(NSArray *)old inserting:(NSArray *)new {
+    NSMutableIndexSet *movedFrom = [NSMutableIndexSet new];
+    NSMutableDictionary<NSNumber *, id> *movedTo = [NSMutableDictionary new];
+    [diff.movedFromIndexes enumerateObjectsUsingBlock:^(NSNumber *from, NSUInteger idx, BOOL *stop) {
+        [movedFrom addIndex:from.unsignedIntegerValue];
+        movedTo[diff.movedToIndexes[idx]] = old[from.unsignedIntegerValue];
+    }];
+
+    NSMutableArray *stayed = [NSMutableArray new];
+    [old enumerateObjectsUsingBlock:^(id obj, NSUInteger idx, BOOL *stop) {
+        if (![diff.deletedIndexes containsIndex:idx] && ![movedFrom containsIndex:idx]) {
+            [stayed addObject:obj];
+        }
+    }];
+
+    NSMutableArray *result = [NSMutableArray new];
+    NSUInteger next = 0;
+    for (NSUInteger j = 0; j < new.count; j++) {
+        if ([diff.insertedIndexes containsIndex:j]) {
+            [result addObject:new[j]];
+        } else if (movedTo[@(j)]) {
+            [result addObject:movedTo[@(j)]];
+        } else if (next < stayed.count) {
+            [result addObject:stayed[next++]];
+        }
+    }
+
+    XCTAssertEqual(next, stayed.count);
+    return result;
+}
+
+- (void)assertDiffFrom:(NSArray *)old to:(NSArray *)new {
+    FLEXSnapshotDiff *diff = [FLEXSnapshotDiff diffFromSnapshot:old toSnapshot:new];
+    XCTAssertEqualObjects([self apply:diff to:old inserting:new], new);
+}
+
+- (void)testNoChanges {
+    NSArray *rows = @[@"a", @"b", @"c"];
+    FLEXSnapshotDiff *diff = [FLEXSnapshotDiff diffFromSnapshot:rows toSnapshot:rows.copy];
+    XCTAssertFalse(diff.hasChanges);
+}
+
+- (void)testInsertsAtTopAndEvictionsAtBottom {
+    NSArray *old = @[@"c", @"b", @"a"];
+    NSArray *new = @[@"e", @"d", @"c", @"b"];
+    FLEXSnapshotDiff *diff = [FLEXSnapshotDiff diffFromSnapshot:old toSnapshot:new];
+
+    XCTAssertEqualObjects(diff.insertedIndexes, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+    XCTAssertEqualObjects(diff.deletedIndexes, [NSIndexSet indexSetWithIndex:2]);
+    // The common case must not be reported as moves
+    XCTAssertEqual(diff.movedFromIndexes.count, 0);
+    [self assertDiffFrom:old to:new];
+}
+
+- (void)testFilteringOut {
+    [self assertDiffFrom:@[@"a", @"b", @"c", @"d", @"e"] to:@[@"b", @"d"]];
+}
+
+- (void)testMoves {
+    [self assertDiffFrom:@[@"a", @"b", @"c"] to:@[@"c", @"a", @"b"]];
+    [self assertDiffFrom:@[@"a", @"b", @"c", @"d"] to:@[@"x", @"d", @"b", @"y"]];
+}
+
+- (void)testMatchesByIdentity {
+    NSString *a = [NSMutableString stringWithString:@"same"];
+    NSString *b = [NSMutableString stringWithString:@"same"];
+    FLEXSnapshotDiff *diff = [FLEXSnapshotDiff diffFromSnapshot:@[a] toSnapshot:@[b]];
+
+    XCTAssertEqualObjects(diff.deletedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.insertedIndexes, [NSIndexSet indexSetWithIndex:0]);
+}
+
+- (void)testRandomShuffles {
+    NSMutableArray *pool = [NSMutableArray new];
+    for (NSUInteger i = 0; i < 200; i++) {
+        [pool addObject:[NSObject new]];
+    }
+
+    for (NSUInteger round = 0; round < 100; round++) {
+        NSMutableArray *old = [NSMutableArray new], *new = [NSMutableArray new];
+        for (id obj in pool) {
+            if (arc4random_uniform(3)) [old addObject:obj];
+            if (arc4random_uniform(3)) [new addObject:obj];
+        }
+        for (NSUInteger i = new.count; i > 1; i--) {
+            if (arc4random_uniform(10) == 0) {
+                [new exchangeObjectAtIndex:i - 1 withObjectAtIndex:arc4random_uniform((uint32_t)i)];
+            }
+        }
+
+        [self assertDiffFrom:old to:new];
+    }
+}
+
+@end
@@ -0,0 +1,121 @@
+//
+//  Analysis.cpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#include "Analysis.hpp"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace flexheap {
+
+std::vector<ClassStats> classStats(const HeapDump &dump, const DominatorTree &tree) {
+    const std::vector<std::string_view> &names = dump.classNames();
+    std::vector<ClassStats> stats(names.size());
+    for (size_t i = 0; i < names.size(); i++) {
+        stats[i].name = names[i];
+    }
+
+    const std::vector<uint64_t> &retained = tree.retainedSizes();
+    const std::vector<uint32_t> &childStarts = tree.childStarts();
+    const std::vector<uint32_t> &children = tree.children();
+
+    // Walk the dominator tree, counting an instance's retained size only when
+    // no instance of the same class dominates it
+    std::vector<uint32_t> activeInstances(names.size(), 0);
+    struct Frame {
+        uint32_t node;
+        uint32_t nextChild;
+    };
+    std::vector<Frame> stack;
+    stack.push_back({tree.root(), childStarts[tree.root()]});
+
+    while (!stack.empty()) {
+        Frame &frame = stack.back();
+        if (frame.nextChild == childStarts[frame.node + 1]) {
+            if (frame.node != tree.root()) {
+                activeInstances[dump.classId(frame.node)]--;
+            }
+            stack.pop_back();
+            continue;
+        }
+
+        uint32_t v = children[frame.nextChild++];
+        ClassStats &cls = stats[dump.classId(v)];
+        cls.count++;
+        cls.shallowBytes += dump.size(v);
+        if (activeInstances[dump.classId(v)]++ == 0) {
+            cls.retainedBytes += retained[v];
+        }
+        stack.push_back({v, childStarts[v]});
+    }
+
+    return stats;
+}
+
+static void accumulate(ClassStats &into, const ClassStats &stats) {
+    into.name = stats.name;
+    into.count += stats.count;
+    into.shallowBytes += stats.shallowBytes;
+    into.retainedBytes += stats.retainedBytes;
+}
+
+std::vector<ClassDelta> diffClasses(const std::vector<ClassStats> &before, const std::vector<ClassStats> &after) {
+    // Different classes can share a name, such as those from different images
+    std::vector<ClassDelta> deltas;
+    std::unordered_map<std::string_view, size_t> indexes;
+    auto deltaNamed = [&](std::string_view name) -> ClassDelta & {
+        auto inserted = indexes.emplace(name, deltas.size());
+        if (inserted.second) {
+            deltas.push_back({std::string(name), ClassStats(), ClassStats()});
+        }
+        return deltas[inserted.first->second];
+    };
+
+    for (const ClassStats &stats : before) {
+        accumulate(deltaNamed(stats.name).before, stats);
+    }
+    for (const ClassStats &stats : after) {
+        accumulate(deltaNamed(stats.name).after, stats);
+    }
+
+    std::vector<ClassDelta> changed;
+    for (ClassDelta &delta : deltas) {
+        if (delta.countDelta() || delta.shallowDelta() || delta.retainedDelta()) {
+            changed.push_back(std::move(delta));
+        }
+    }
+
+    return changed;
+}
+
+std::string formatBytes(uint64_t bytes) {
+    static const char *const units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1000 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+        value /= 1000;
+        unit++;
+    }
+
+    char buffer[32];
+    if (unit == 0) {
+        std::snprintf(buffer, sizeof(buffer), "%" PRIu64 " B", bytes);
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.1f %s", value, units[unit]);
+    }
+    return buffer;
+}
+
+std::string formatByteDelta(int64_t delta) {
+    std::string magnitude = formatBytes(static_cast<uint64_t>(std::llabs(delta)));
+    return (delta < 0 ? "-" : "+") + magnitude;
+}
+
+} // namespace flexheap
@@ -0,0 +1,52 @@
+//
+//  Analysis.hpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#pragma once
+
+#include "Dominators.hpp"
+#include "HeapDump.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace flexheap {
+
+struct ClassStats {
+    std::string_view name;
+    uint64_t count = 0;
+    /// The sum of the malloc sizes of the instances
+    uint64_t shallowBytes = 0;
+    /// The memory that would be freed along with every instance. Instances dominated
+    /// by another instance of the class are only counted once, as part of that one.
+    uint64_t retainedBytes = 0;
+};
+
+/// Indexed by class id
+std::vector<ClassStats> classStats(const HeapDump &dump, const DominatorTree &tree);
+
+struct ClassDelta {
+    std::string name;
+    ClassStats before;
+    ClassStats after;
+
+    int64_t countDelta() const { return static_cast<int64_t>(after.count - before.count); }
+    int64_t shallowDelta() const { return static_cast<int64_t>(after.shallowBytes - before.shallowBytes); }
+    int64_t retainedDelta() const { return static_cast<int64_t>(after.retainedBytes - before.retainedBytes); }
+};
+
+/// Matches classes by name. Classes that only exist in one of the dumps have zeroed stats in the other.
+/// Classes with no change at all are left out.
+std::vector<ClassDelta> diffClasses(const std::vector<ClassStats> &before, const std::vector<ClassStats> &after);
+
+/// For example, "1.5 MB"
+std::string formatBytes(uint64_t bytes);
+std::string formatByteDelta(int64_t delta);
+
+} // namespace flexheap
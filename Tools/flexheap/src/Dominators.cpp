@@ -0,0 +1,226 @@
+//
+//  Dominators.cpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#include "Dominators.hpp"
+
+namespace flexheap {
+
+namespace {
+
+constexpr uint32_t kNone = UINT32_MAX;
+
+/// Adjacency in compressed form: the neighbors of \c v are \c targets[starts[v]] up to \c targets[starts[v + 1]]
+struct Adjacency {
+    std::vector<uint64_t> starts;
+    std::vector<uint32_t> targets;
+};
+
+Adjacency successorsOf(const HeapDump &dump, bool includeUnowned) {
+    uint32_t n = dump.objectCount();
+    Adjacency successors;
+    successors.starts.resize(static_cast<size_t>(n) + 1);
+    successors.targets.reserve(dump.edgeCount());
+
+    for (uint32_t v = 0; v < n; v++) {
+        successors.starts[v] = successors.targets.size();
+        EdgeRange edges = dump.edges(v);
+        for (uint32_t e = 0; e < edges.size(); e++) {
+            uint32_t edge = edges[e];
+            if (includeUnowned || !HeapDump::isUnowned(edge)) {
+                successors.targets.push_back(HeapDump::targetOf(edge));
+            }
+        }
+    }
+    successors.starts[n] = successors.targets.size();
+
+    return successors;
+}
+
+Adjacency reversed(const Adjacency &successors, uint32_t n) {
+    // Counting sort of the edges by target
+    Adjacency predecessors;
+    predecessors.starts.assign(static_cast<size_t>(n) + 1, 0);
+    predecessors.targets.resize(successors.targets.size());
+
+    for (uint32_t target : successors.targets) {
+        predecessors.starts[target + 1]++;
+    }
+    for (uint32_t v = 0; v < n; v++) {
+        predecessors.starts[v + 1] += predecessors.starts[v];
+    }
+
+    std::vector<uint64_t> next(predecessors.starts.begin(), predecessors.starts.end() - 1);
+    for (uint32_t v = 0; v < n; v++) {
+        for (uint64_t e = successors.starts[v]; e < successors.starts[v + 1]; e++) {
+            predecessors.targets[next[successors.targets[e]]++] = v;
+        }
+    }
+
+    return predecessors;
+}
+
+} // namespace
+
+// Lengauer and Tarjan's algorithm with path compression, without recursion.
+// Vertices are numbered in depth-first order from the root, which is number 0.
+DominatorTree::DominatorTree(const HeapDump &dump, bool includeUnowned) {
+    uint32_t n = dump.objectCount();
+    root_ = n;
+    uint32_t count = n + 1;
+
+    Adjacency successors = successorsOf(dump, includeUnowned);
+    Adjacency predecessors = reversed(successors, n);
+
+    // Depth-first numbering. The root's edges are added as the search goes: first to
+    // every object without predecessors, then to every object not reached from those.
+    std::vector<uint32_t> number(count, kNone);
+    std::vector<uint32_t> vertex(count);
+    std::vector<uint32_t> parent(count, 0);
+    rootChild_.assign(n, 0);
+
+    uint32_t visited = 0;
+    number[root_] = visited;
+    vertex[visited++] = root_;
+
+    struct Frame {
+        uint32_t node;
+        uint64_t edge;
+    };
+    std::vector<Frame> stack;
+    auto searchFrom = [&](uint32_t start) {
+        rootChild_[start] = 1;
+        number[start] = visited;
+        vertex[visited++] = start;
+        stack.push_back({start, successors.starts[start]});
+
+        while (!stack.empty()) {
+            Frame &frame = stack.back();
+            if (frame.edge == successors.starts[frame.node + 1]) {
+                stack.pop_back();
+                continue;
+            }
+
+            uint32_t w = successors.targets[frame.edge++];
+            if (number[w] == kNone) {
+                number[w] = visited;
+                parent[visited] = number[frame.node];
+                vertex[visited++] = w;
+                stack.push_back({w, successors.starts[w]});
+            }
+        }
+    };
+
+    for (uint32_t v = 0; v < n; v++) {
+        if (predecessors.starts[v] == predecessors.starts[v + 1]) {
+            searchFrom(v);
+        }
+    }
+    for (uint32_t v = 0; v < n; v++) {
+        if (number[v] == kNone) {
+            searchFrom(v);
+        }
+    }
+    std::vector<Frame>().swap(stack);
+
+    // Semidominators, in reverse depth-first order. Everything below is indexed by number.
+    std::vector<uint32_t> semi(count), label(count), ancestor(count, kNone), idom(count, 0);
+    std::vector<uint32_t> bucketHead(count, kNone), bucketNext(count, kNone);
+    std::vector<uint32_t> path;
+    for (uint32_t i = 0; i < count; i++) {
+        semi[i] = label[i] = i;
+    }
+
+    // The vertex with the smallest semidominator on the path to v in the forest built so far
+    auto eval = [&](uint32_t v) {
+        if (ancestor[v] == kNone) {
+            return v;
+        }
+
+        // Compress the path to just below the forest's root, from the top down
+        for (uint32_t u = v; ancestor[ancestor[u]] != kNone; u = ancestor[u]) {
+            path.push_back(u);
+        }
+        while (!path.empty()) {
+            uint32_t u = path.back();
+            path.pop_back();
+            uint32_t a = ancestor[u];
+            if (semi[label[a]] < semi[label[u]]) {
+                label[u] = label[a];
+            }
+            ancestor[u] = ancestor[a];
+        }
+
+        return label[v];
+    };
+
+    for (uint32_t i = count - 1; i > 0; i--) {
+        uint32_t w = vertex[i];
+
+        auto consider = [&](uint32_t predecessorNumber) {
+            uint32_t u = eval(predecessorNumber);
+            if (semi[u] < semi[i]) {
+                semi[i] = semi[u];
+            }
+        };
+        if (rootChild_[w]) {
+            consider(0);
+        }
+        for (uint64_t e = predecessors.starts[w]; e < predecessors.starts[w + 1]; e++) {
+            consider(number[predecessors.targets[e]]);
+        }
+
+        bucketNext[i] = bucketHead[semi[i]];
+        bucketHead[semi[i]] = i;
+        ancestor[i] = parent[i];
+
+        // Every vertex whose semidominator is the parent now has its dominator, or one to defer to
+        uint32_t p = parent[i];
+        for (uint32_t v = bucketHead[p]; v != kNone; v = bucketNext[v]) {
+            uint32_t u = eval(v);
+            idom[v] = semi[u] < semi[v] ? u : p;
+        }
+        bucketHead[p] = kNone;
+    }
+
+    for (uint32_t i = 1; i < count; i++) {
+        if (idom[i] != semi[i]) {
+            idom[i] = idom[idom[i]];
+        }
+    }
+
+    // Back to object indexes
+    idom_.resize(count);
+    idom_[root_] = root_;
+    for (uint32_t i = 1; i < count; i++) {
+        idom_[vertex[i]] = vertex[idom[i]];
+    }
+
+    // Dominators come before everything they dominate in depth-first order,
+    // so one pass in reverse order adds each subtree up
+    retained_.assign(count, 0);
+    for (uint32_t i = count - 1; i > 0; i--) {
+        uint32_t v = vertex[i];
+        retained_[v] += dump.size(v);
+        retained_[idom_[v]] += retained_[v];
+    }
+
+    childStarts_.assign(static_cast<size_t>(count) + 1, 0);
+    children_.resize(n);
+    for (uint32_t v = 0; v < n; v++) {
+        childStarts_[idom_[v] + 1]++;
+    }
+    for (uint32_t v = 0; v < count; v++) {
+        childStarts_[v + 1] += childStarts_[v];
+    }
+    std::vector<uint32_t> next(childStarts_.begin(), childStarts_.end() - 1);
+    for (uint32_t v = 0; v < n; v++) {
+        children_[next[idom_[v]]++] = v;
+    }
+}
+
+} // namespace flexheap
@@ -0,0 +1,54 @@
+//
+//  Dominators.hpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#pragma once
+
+#include "HeapDump.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace flexheap {
+
+/// The dominator tree of a heap dump and the retained size of every object.
+///
+/// A dump has no stacks or globals, so a virtual root stands in for them. It references every
+/// object that nothing else references, then any object still unreachable from those, which
+/// only happens to objects that are all part of cycles. An object's retained size is the memory
+/// that would be freed along with it: its own size plus that of every object it dominates.
+class DominatorTree {
+public:
+    /// @param includeUnowned Whether weak and unretained references keep objects alive
+    explicit DominatorTree(const HeapDump &dump, bool includeUnowned = false);
+
+    /// The index of the virtual root, one past the last object
+    uint32_t root() const { return root_; }
+
+    /// The immediate dominator of an object, which may be the root
+    uint32_t immediateDominator(uint32_t object) const { return idom_[object]; }
+    /// Whether the object is referenced by the root, having no owning references of its own
+    bool isRootChild(uint32_t object) const { return rootChild_[object]; }
+
+    /// Indexed by object, plus the root, whose retained size is that of the whole heap
+    const std::vector<uint64_t> &retainedSizes() const { return retained_; }
+
+    /// The objects immediately dominated by each object or the root, in compressed form:
+    /// the children of \c v are \c children()[childStarts()[v]] up to \c childStarts()[v + 1]
+    const std::vector<uint32_t> &childStarts() const { return childStarts_; }
+    const std::vector<uint32_t> &children() const { return children_; }
+
+private:
+    uint32_t root_;
+    std::vector<uint32_t> idom_;
+    std::vector<uint8_t> rootChild_;
+    std::vector<uint64_t> retained_;
+    std::vector<uint32_t> childStarts_;
+    std::vector<uint32_t> children_;
+};
+
+} // namespace flexheap
@@ -0,0 +1,173 @@
+//
+//  HeapDump.cpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#include "HeapDump.hpp"
+#include "FLEXHeapDumpFormat.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "Heap dumps are little-endian and read in native byte order"
+#endif
+
+namespace flexheap {
+
+static_assert(kFLEXHeapDumpObjectHeaderSize == 20, "Object record accessors assume 20 byte headers");
+
+std::unique_ptr<HeapDump> HeapDump::open(const std::string &path, std::string &error) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": " + std::strerror(errno);
+        return nullptr;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        error = path + ": " + std::strerror(errno);
+        ::close(fd);
+        return nullptr;
+    }
+
+    std::unique_ptr<HeapDump> dump(new HeapDump());
+    dump->length_ = static_cast<size_t>(info.st_size);
+    if (dump->length_) {
+        void *base = mmap(nullptr, dump->length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) {
+            error = path + ": " + std::strerror(errno);
+            ::close(fd);
+            dump->length_ = 0;
+            return nullptr;
+        }
+        dump->base_ = static_cast<const uint8_t *>(base);
+        // Records are read once in order to index them, then at random
+        madvise(base, dump->length_, MADV_WILLNEED);
+    }
+    ::close(fd);
+
+    if (!dump->parse(error)) {
+        error = path + ": " + error;
+        return nullptr;
+    }
+
+    return dump;
+}
+
+HeapDump::~HeapDump() {
+    if (base_) {
+        munmap(const_cast<uint8_t *>(base_), length_);
+    }
+}
+
+bool HeapDump::isUnowned(uint32_t edge) {
+    return edge & kFLEXHeapDumpEdgeUnowned;
+}
+
+uint32_t HeapDump::targetOf(uint32_t edge) {
+    return edge & ~kFLEXHeapDumpEdgeUnowned;
+}
+
+bool HeapDump::parse(std::string &error) {
+    const uint8_t *cursor = base_;
+    const uint8_t *end = base_ + length_;
+    auto remaining = [&]() { return static_cast<size_t>(end - cursor); };
+
+    if (length_ < kFLEXHeapDumpHeaderSize || std::memcmp(base_, kFLEXHeapDumpMagic, kFLEXHeapDumpMagicLength) != 0) {
+        error = "not a FLEX heap dump";
+        return false;
+    }
+
+    uint32_t version = read<uint32_t>(base_ + 8);
+    if (version != kFLEXHeapDumpVersion) {
+        error = "unsupported heap dump version " + std::to_string(version);
+        return false;
+    }
+
+    uint32_t classCount = read<uint32_t>(base_ + 12);
+    uint64_t objectCount = read<uint64_t>(base_ + 16);
+    edgeCount_ = read<uint64_t>(base_ + 24);
+    timestamp_ = read<uint64_t>(base_ + 32);
+    cursor += kFLEXHeapDumpHeaderSize;
+
+    // Sanity checks before reserving anything, so a corrupt count can't exhaust memory
+    if (objectCount >= kFLEXHeapDumpEdgeUnowned ||
+        objectCount > remaining() / kFLEXHeapDumpObjectHeaderSize ||
+        classCount > remaining() / sizeof(uint16_t)) {
+        error = "truncated or corrupt header";
+        return false;
+    }
+
+    classNames_.reserve(classCount);
+    for (uint32_t i = 0; i < classCount; i++) {
+        if (remaining() < sizeof(uint16_t)) {
+            error = "truncated class table";
+            return false;
+        }
+        uint16_t nameLength = read<uint16_t>(cursor);
+        cursor += sizeof(uint16_t);
+        if (remaining() < nameLength) {
+            error = "truncated class table";
+            return false;
+        }
+        classNames_.emplace_back(reinterpret_cast<const char *>(cursor), nameLength);
+        cursor += nameLength;
+    }
+
+    records_.reserve(objectCount);
+    uint64_t edgeTotal = 0;
+    uint64_t previousAddress = 0;
+    for (uint64_t i = 0; i < objectCount; i++) {
+        if (remaining() < kFLEXHeapDumpObjectHeaderSize) {
+            error = "truncated at object " + std::to_string(i);
+            return false;
+        }
+
+        const uint8_t *record = cursor;
+        uint64_t address = read<uint64_t>(record);
+        uint32_t classId = read<uint32_t>(record + 8);
+        uint32_t edgeCount = read<uint32_t>(record + 16);
+        cursor += kFLEXHeapDumpObjectHeaderSize;
+
+        if (classId >= classCount) {
+            error = "object " + std::to_string(i) + " has an unknown class id";
+            return false;
+        }
+        if (i && address <= previousAddress) {
+            error = "objects are not in address order at object " + std::to_string(i);
+            return false;
+        }
+        if (remaining() / sizeof(uint32_t) < edgeCount) {
+            error = "truncated edges at object " + std::to_string(i);
+            return false;
+        }
+
+        for (uint32_t e = 0; e < edgeCount; e++) {
+            if (targetOf(read<uint32_t>(cursor + e * sizeof(uint32_t))) >= objectCount) {
+                error = "object " + std::to_string(i) + " references an object out of range";
+                return false;
+            }
+        }
+
+        records_.push_back(record);
+        cursor += edgeCount * sizeof(uint32_t);
+        edgeTotal += edgeCount;
+        previousAddress = address;
+    }
+
+    if (edgeTotal != edgeCount_) {
+        error = "edge count does not match the header";
+        return false;
+    }
+
+    return true;
+}
+
+} // namespace flexheap
@@ -0,0 +1,90 @@
+//
+//  HeapDump.hpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace flexheap {
+
+/// The outgoing references of one object, read straight from the mapped file
+class EdgeRange {
+public:
+    EdgeRange(const uint8_t *bytes, uint32_t count) : bytes_(bytes), count_(count) {}
+
+    uint32_t size() const { return count_; }
+
+    /// The raw edge, including the unowned bit
+    uint32_t operator[](uint32_t i) const {
+        uint32_t edge;
+        std::memcpy(&edge, bytes_ + i * sizeof(uint32_t), sizeof(edge));
+        return edge;
+    }
+
+private:
+    const uint8_t *bytes_;
+    uint32_t count_;
+};
+
+/// A heap dump written by FLEXHeapDumpExporter, memory-mapped and validated when opened.
+/// See FLEXHeapDumpFormat.h for the layout.
+class HeapDump {
+public:
+    /// @return nullptr if the file cannot be read or is not a valid dump, with a reason in \c error
+    static std::unique_ptr<HeapDump> open(const std::string &path, std::string &error);
+    ~HeapDump();
+
+    HeapDump(const HeapDump &) = delete;
+    HeapDump &operator=(const HeapDump &) = delete;
+
+    uint32_t objectCount() const { return static_cast<uint32_t>(records_.size()); }
+    uint64_t edgeCount() const { return edgeCount_; }
+    /// Milliseconds since 1970
+    uint64_t timestamp() const { return timestamp_; }
+
+    const std::vector<std::string_view> &classNames() const { return classNames_; }
+
+    uint64_t address(uint32_t object) const { return read<uint64_t>(records_[object]); }
+    uint32_t classId(uint32_t object) const { return read<uint32_t>(records_[object] + 8); }
+    /// The malloc size of the object
+    uint32_t size(uint32_t object) const { return read<uint32_t>(records_[object] + 12); }
+    EdgeRange edges(uint32_t object) const {
+        const uint8_t *record = records_[object];
+        return EdgeRange(record + 20, read<uint32_t>(record + 16));
+    }
+
+    static bool isUnowned(uint32_t edge);
+    static uint32_t targetOf(uint32_t edge);
+
+private:
+    HeapDump() = default;
+    bool parse(std::string &error);
+
+    template <typename T>
+    static T read(const uint8_t *bytes) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    const uint8_t *base_ = nullptr;
+    size_t length_ = 0;
+
+    uint64_t edgeCount_ = 0;
+    uint64_t timestamp_ = 0;
+    std::vector<std::string_view> classNames_;
+    /// The start of each object record
+    std::vector<const uint8_t *> records_;
+};
+
+} // namespace flexheap
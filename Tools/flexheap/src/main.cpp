@@ -0,0 +1,261 @@
+//
+//  main.cpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#include "Analysis.hpp"
+#include "Dominators.hpp"
+#include "HeapDump.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace flexheap;
+
+namespace {
+
+const char kUsage[] =
+    "usage: flexheap <command> [options] <dump> [<dump>]\n"
+    "\n"
+    "Analyzes heap dumps exported from FLEX's Heap Objects screen.\n"
+    "\n"
+    "commands:\n"
+    "  summary <dump>            Totals of objects, classes, references and bytes\n"
+    "  top <dump>                Classes by the memory their instances retain\n"
+    "  dominators <dump>         Objects by retained size, with what retains each one\n"
+    "  diff <before> <after>     The change in each class between two dumps\n"
+    "\n"
+    "options:\n"
+    "  -n <count>                Rows to print (default 20, 0 for all)\n"
+    "  --sort <key>              top and diff: retained (default), shallow or count\n"
+    "  --all-references          Let weak and unretained references keep objects alive\n";
+
+enum class SortKey { retained, shallow, count };
+
+struct Options {
+    std::string command;
+    std::vector<std::string> paths;
+    size_t rows = 20;
+    SortKey sort = SortKey::retained;
+    bool includeUnowned = false;
+};
+
+bool parseOptions(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-n" && i + 1 < argc) {
+            options.rows = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--sort" && i + 1 < argc) {
+            std::string key = argv[++i];
+            if (key == "retained") {
+                options.sort = SortKey::retained;
+            } else if (key == "shallow") {
+                options.sort = SortKey::shallow;
+            } else if (key == "count") {
+                options.sort = SortKey::count;
+            } else {
+                return false;
+            }
+        } else if (arg == "--all-references") {
+            options.includeUnowned = true;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return false;
+        } else if (options.command.empty()) {
+            options.command = arg;
+        } else {
+            options.paths.push_back(arg);
+        }
+    }
+
+    size_t expectedPaths = options.command == "diff" ? 2 : 1;
+    return options.paths.size() == expectedPaths;
+}
+
+size_t rowCount(const Options &options, size_t available) {
+    return options.rows ? std::min(options.rows, available) : available;
+}
+
+std::unique_ptr<HeapDump> openDump(const std::string &path) {
+    std::string error;
+    std::unique_ptr<HeapDump> dump = HeapDump::open(path, error);
+    if (!dump) {
+        std::fprintf(stderr, "flexheap: %s\n", error.c_str());
+    }
+    return dump;
+}
+
+std::string formatTimestamp(uint64_t milliseconds) {
+    std::time_t seconds = static_cast<std::time_t>(milliseconds / 1000);
+    char buffer[64];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&seconds));
+    return buffer;
+}
+
+int summary(const Options &options) {
+    std::unique_ptr<HeapDump> dump = openDump(options.paths[0]);
+    if (!dump) {
+        return 1;
+    }
+
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < dump->objectCount(); i++) {
+        bytes += dump->size(i);
+    }
+
+    DominatorTree tree(*dump, options.includeUnowned);
+    uint32_t roots = 0;
+    for (uint32_t i = 0; i < dump->objectCount(); i++) {
+        roots += tree.isRootChild(i);
+    }
+
+    std::printf("Captured     %s\n", formatTimestamp(dump->timestamp()).c_str());
+    std::printf("Objects      %" PRIu32 "\n", dump->objectCount());
+    std::printf("Classes      %zu\n", dump->classNames().size());
+    std::printf("References   %" PRIu64 "\n", dump->edgeCount());
+    std::printf("Size         %s\n", formatBytes(bytes).c_str());
+    std::printf("Roots        %" PRIu32 ", retained by nothing on the heap\n", roots);
+    return 0;
+}
+
+uint64_t sortValue(const ClassStats &stats, SortKey key) {
+    switch (key) {
+        case SortKey::retained: return stats.retainedBytes;
+        case SortKey::shallow: return stats.shallowBytes;
+        case SortKey::count: return stats.count;
+    }
+    return 0;
+}
+
+int64_t sortValue(const ClassDelta &delta, SortKey key) {
+    switch (key) {
+        case SortKey::retained: return delta.retainedDelta();
+        case SortKey::shallow: return delta.shallowDelta();
+        case SortKey::count: return delta.countDelta();
+    }
+    return 0;
+}
+
+int top(const Options &options) {
+    std::unique_ptr<HeapDump> dump = openDump(options.paths[0]);
+    if (!dump) {
+        return 1;
+    }
+
+    DominatorTree tree(*dump, options.includeUnowned);
+    std::vector<ClassStats> stats = classStats(*dump, tree);
+    stats.erase(std::remove_if(stats.begin(), stats.end(), [](const ClassStats &s) { return !s.count; }), stats.end());
+    std::sort(stats.begin(), stats.end(), [&](const ClassStats &a, const ClassStats &b) {
+        return sortValue(a, options.sort) > sortValue(b, options.sort);
+    });
+
+    std::printf("%12s %12s %12s  %s\n", "Retained", "Shallow", "Count", "Class");
+    for (size_t i = 0; i < rowCount(options, stats.size()); i++) {
+        const ClassStats &s = stats[i];
+        std::printf("%12s %12s %12" PRIu64 "  %.*s\n",
+            formatBytes(s.retainedBytes).c_str(), formatBytes(s.shallowBytes).c_str(), s.count,
+            static_cast<int>(s.name.size()), s.name.data());
+    }
+    return 0;
+}
+
+int dominators(const Options &options) {
+    std::unique_ptr<HeapDump> dump = openDump(options.paths[0]);
+    if (!dump) {
+        return 1;
+    }
+
+    DominatorTree tree(*dump, options.includeUnowned);
+    const std::vector<uint64_t> &retained = tree.retainedSizes();
+    std::vector<uint32_t> objects(dump->objectCount());
+    for (uint32_t i = 0; i < dump->objectCount(); i++) {
+        objects[i] = i;
+    }
+
+    size_t rows = rowCount(options, objects.size());
+    auto larger = [&](uint32_t a, uint32_t b) { return retained[a] > retained[b]; };
+    std::partial_sort(objects.begin(), objects.begin() + rows, objects.end(), larger);
+
+    auto className = [&](uint32_t object) {
+        std::string_view name = dump->classNames()[dump->classId(object)];
+        return std::string(name);
+    };
+
+    std::printf("%12s %12s  %-18s %-40s %s\n", "Retained", "Shallow", "Address", "Class", "Retained By");
+    for (size_t i = 0; i < rows; i++) {
+        uint32_t v = objects[i];
+        uint32_t dominator = tree.immediateDominator(v);
+        char address[32], retainer[160];
+        std::snprintf(address, sizeof(address), "0x%" PRIx64, dump->address(v));
+        if (dominator == tree.root()) {
+            std::snprintf(retainer, sizeof(retainer), "-");
+        } else {
+            std::snprintf(retainer, sizeof(retainer), "%s 0x%" PRIx64,
+                className(dominator).c_str(), dump->address(dominator));
+        }
+
+        std::printf("%12s %12s  %-18s %-40s %s\n",
+            formatBytes(retained[v]).c_str(), formatBytes(dump->size(v)).c_str(),
+            address, className(v).c_str(), retainer);
+    }
+    return 0;
+}
+
+int diff(const Options &options) {
+    std::unique_ptr<HeapDump> before = openDump(options.paths[0]);
+    std::unique_ptr<HeapDump> after = openDump(options.paths[1]);
+    if (!before || !after) {
+        return 1;
+    }
+
+    DominatorTree beforeTree(*before, options.includeUnowned);
+    DominatorTree afterTree(*after, options.includeUnowned);
+    std::vector<ClassDelta> deltas = diffClasses(classStats(*before, beforeTree), classStats(*after, afterTree));
+
+    // Largest growth first
+    std::sort(deltas.begin(), deltas.end(), [&](const ClassDelta &a, const ClassDelta &b) {
+        return sortValue(a, options.sort) > sortValue(b, options.sort);
+    });
+
+    std::printf("%12s %12s %12s %18s  %s\n", "Retained", "Shallow", "Count", "Before → After", "Class");
+    for (size_t i = 0; i < rowCount(options, deltas.size()); i++) {
+        const ClassDelta &d = deltas[i];
+        char counts[48];
+        std::snprintf(counts, sizeof(counts), "%" PRIu64 " → %" PRIu64, d.before.count, d.after.count);
+        std::printf("%12s %12s %+12" PRId64 " %18s  %s\n",
+            formatByteDelta(d.retainedDelta()).c_str(), formatByteDelta(d.shallowDelta()).c_str(),
+            d.countDelta(), counts, d.name.c_str());
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fputs(kUsage, stderr);
+        return 2;
+    }
+
+    if (options.command == "summary") {
+        return summary(options);
+    } else if (options.command == "top") {
+        return top(options);
+    } else if (options.command == "dominators") {
+        return dominators(options);
+    } else if (options.command == "diff") {
+        return diff(options);
+    }
+
+    std::fputs(kUsage, stderr);
+    return 2;
+}
@@ -0,0 +1,338 @@
+//
+//  flexheap_tests.cpp
+//  flexheap
+//
+//  Created by FLEX Team on 10/16/26.
+//  Copyright © 2026 FLEX Team. All rights reserved.
+//
+
+#include "Analysis.hpp"
+#include "Dominators.hpp"
+#include "HeapDump.hpp"
+#include "FLEXHeapDumpFormat.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace flexheap;
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+        failures++; \
+    } \
+} while (0)
+
+/// Writes dumps the way FLEXHeapDumpExporter does
+class DumpBuilder {
+public:
+    struct Object {
+        uint32_t classId;
+        uint32_t size;
+        std::vector<uint32_t> edges;
+    };
+
+    std::vector<std::string> classes;
+    std::vector<Object> objects;
+
+    uint32_t add(uint32_t classId, uint32_t size) {
+        objects.push_back({classId, size, {}});
+        return static_cast<uint32_t>(objects.size() - 1);
+    }
+
+    void link(uint32_t from, uint32_t to, bool unowned = false) {
+        objects[from].edges.push_back(to | (unowned ? kFLEXHeapDumpEdgeUnowned : 0));
+    }
+
+    std::string write(const std::string &name) const {
+        std::string bytes(kFLEXHeapDumpMagic, kFLEXHeapDumpMagicLength);
+        uint64_t edgeCount = 0;
+        for (const Object &object : objects) {
+            edgeCount += object.edges.size();
+        }
+
+        append32(bytes, kFLEXHeapDumpVersion);
+        append32(bytes, static_cast<uint32_t>(classes.size()));
+        append64(bytes, objects.size());
+        append64(bytes, edgeCount);
+        append64(bytes, 1760000000000);
+        for (const std::string &cls : classes) {
+            uint16_t length = static_cast<uint16_t>(cls.size());
+            bytes.append(reinterpret_cast<const char *>(&length), sizeof(length));
+            bytes.append(cls);
+        }
+
+        uint64_t address = 0x100000000;
+        for (const Object &object : objects) {
+            append64(bytes, address += 0x40);
+            append32(bytes, object.classId);
+            append32(bytes, object.size);
+            append32(bytes, static_cast<uint32_t>(object.edges.size()));
+            for (uint32_t edge : object.edges) {
+                append32(bytes, edge);
+            }
+        }
+
+        std::string path = std::string("flexheap_test_") + name + ".flexheap";
+        std::ofstream(path, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        return path;
+    }
+
+private:
+    static void append32(std::string &bytes, uint32_t value) {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    static void append64(std::string &bytes, uint64_t value) {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+};
+
+static std::unique_ptr<HeapDump> load(const DumpBuilder &builder, const std::string &name) {
+    std::string error;
+    std::unique_ptr<HeapDump> dump = HeapDump::open(builder.write(name), error);
+    if (!dump) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+    }
+    return dump;
+}
+
+static void testDiamond() {
+    // a → b → c and a → d → c: only a dominates c
+    DumpBuilder builder;
+    builder.classes = {"Node"};
+    uint32_t a = builder.add(0, 10), b = builder.add(0, 20), c = builder.add(0, 30), d = builder.add(0, 40);
+    builder.link(a, b);
+    builder.link(b, c);
+    builder.link(a, d);
+    builder.link(d, c);
+
+    std::unique_ptr<HeapDump> dump = load(builder, "diamond");
+    CHECK(dump);
+    if (!dump) {
+        return;
+    }
+
+    DominatorTree tree(*dump);
+    CHECK(tree.immediateDominator(a) == tree.root());
+    CHECK(tree.immediateDominator(b) == a);
+    CHECK(tree.immediateDominator(c) == a);
+    CHECK(tree.immediateDominator(d) == a);
+    CHECK(tree.retainedSizes()[a] == 100);
+    CHECK(tree.retainedSizes()[b] == 20);
+    CHECK(tree.retainedSizes()[d] == 40);
+    CHECK(tree.retainedSizes()[tree.root()] == 100);
+}
+
+static void testUnownedReferences() {
+    DumpBuilder builder;
+    builder.classes = {"Owner", "Delegate"};
+    uint32_t owner = builder.add(0, 16);
+    uint32_t delegate = builder.add(1, 32);
+    builder.link(owner, delegate, true);
+
+    std::unique_ptr<HeapDump> dump = load(builder, "unowned");
+    CHECK(dump);
+    if (!dump) {
+        return;
+    }
+
+    DominatorTree strong(*dump);
+    CHECK(strong.isRootChild(delegate));
+    CHECK(strong.retainedSizes()[owner] == 16);
+
+    DominatorTree all(*dump, true);
+    CHECK(all.immediateDominator(delegate) == owner);
+    CHECK(all.retainedSizes()[owner] == 48);
+}
+
+static void testUnreachableCycle() {
+    // A leaked cycle has no object without predecessors to start from
+    DumpBuilder builder;
+    builder.classes = {"Parent", "Child"};
+    uint32_t parent = builder.add(0, 64);
+    uint32_t child = builder.add(1, 32);
+    uint32_t leaf = builder.add(1, 8);
+    builder.link(parent, child);
+    builder.link(child, parent);
+    builder.link(child, leaf);
+
+    std::unique_ptr<HeapDump> dump = load(builder, "cycle");
+    CHECK(dump);
+    if (!dump) {
+        return;
+    }
+
+    DominatorTree tree(*dump);
+    CHECK(tree.isRootChild(parent));
+    CHECK(tree.immediateDominator(child) == parent);
+    CHECK(tree.immediateDominator(leaf) == child);
+    CHECK(tree.retainedSizes()[parent] == 104);
+
+    // Child's retained size counts once, since the leaf is inside the child
+    std::vector<ClassStats> stats = classStats(*dump, tree);
+    CHECK(stats[0].count == 1 && stats[0].retainedBytes == 104);
+    CHECK(stats[1].count == 2 && stats[1].shallowBytes == 40 && stats[1].retainedBytes == 40);
+}
+
+static void testDiff() {
+    DumpBuilder before;
+    before.classes = {"Cache", "Entry"};
+    uint32_t cache = before.add(0, 48);
+    before.link(cache, before.add(1, 16));
+
+    DumpBuilder after = before;
+    after.classes.push_back("Image");
+    after.link(cache, after.add(1, 16));
+    after.add(2, 1024);
+
+    std::unique_ptr<HeapDump> beforeDump = load(before, "before");
+    std::unique_ptr<HeapDump> afterDump = load(after, "after");
+    CHECK(beforeDump && afterDump);
+    if (!beforeDump || !afterDump) {
+        return;
+    }
+
+    std::vector<ClassDelta> deltas = diffClasses(
+        classStats(*beforeDump, DominatorTree(*beforeDump)),
+        classStats(*afterDump, DominatorTree(*afterDump))
+    );
+
+    CHECK(deltas.size() == 3);
+    for (const ClassDelta &delta : deltas) {
+        if (delta.name == "Cache") {
+            CHECK(delta.countDelta() == 0 && delta.retainedDelta() == 16);
+        } else if (delta.name == "Entry") {
+            CHECK(delta.countDelta() == 1 && delta.shallowDelta() == 16);
+        } else {
+            CHECK(delta.name == "Image" && delta.before.count == 0 && delta.retainedDelta() == 1024);
+        }
+    }
+}
+
+/// Dominators by brute force: v dominates w if w is unreachable from the root without v
+static std::vector<uint32_t> bruteForceDominators(const HeapDump &dump, const DominatorTree &tree) {
+    uint32_t n = dump.objectCount(), root = n;
+    auto successors = [&](uint32_t v) {
+        std::vector<uint32_t> targets;
+        if (v == root) {
+            for (uint32_t w = 0; w < n; w++) {
+                if (tree.isRootChild(w)) {
+                    targets.push_back(w);
+                }
+            }
+        } else {
+            EdgeRange edges = dump.edges(v);
+            for (uint32_t e = 0; e < edges.size(); e++) {
+                if (!HeapDump::isUnowned(edges[e])) {
+                    targets.push_back(HeapDump::targetOf(edges[e]));
+                }
+            }
+        }
+        return targets;
+    };
+    auto reachableWithout = [&](uint32_t removed) {
+        std::vector<bool> seen(n + 1, false);
+        std::vector<uint32_t> stack = {root};
+        seen[root] = true;
+        while (!stack.empty()) {
+            uint32_t v = stack.back();
+            stack.pop_back();
+            for (uint32_t w : successors(v)) {
+                if (w != removed && !seen[w]) {
+                    seen[w] = true;
+                    stack.push_back(w);
+                }
+            }
+        }
+        return seen;
+    };
+
+    // dominators[w] lists every strict dominator of w besides the root
+    std::vector<std::vector<uint32_t>> dominators(n);
+    for (uint32_t v = 0; v < n; v++) {
+        std::vector<bool> seen = reachableWithout(v);
+        for (uint32_t w = 0; w < n; w++) {
+            if (w != v && !seen[w]) {
+                dominators[w].push_back(v);
+            }
+        }
+    }
+
+    // The immediate dominator is the strict dominator with the most dominators of its own
+    std::vector<uint32_t> idom(n, root);
+    for (uint32_t w = 0; w < n; w++) {
+        for (uint32_t d : dominators[w]) {
+            if (idom[w] == root || dominators[d].size() > dominators[idom[w]].size()) {
+                idom[w] = d;
+            }
+        }
+    }
+    return idom;
+}
+
+static void testRandomGraphsMatchBruteForce() {
+    std::mt19937 random(42);
+    for (int trial = 0; trial < 200; trial++) {
+        DumpBuilder builder;
+        builder.classes = {"Node"};
+        uint32_t n = 1 + random() % 24;
+        for (uint32_t i = 0; i < n; i++) {
+            builder.add(0, 16);
+        }
+        uint32_t edges = random() % (n * 3);
+        for (uint32_t e = 0; e < edges; e++) {
+            builder.link(random() % n, random() % n, random() % 5 == 0);
+        }
+
+        std::unique_ptr<HeapDump> dump = load(builder, "random");
+        CHECK(dump);
+        if (!dump) {
+            return;
+        }
+
+        DominatorTree tree(*dump);
+        std::vector<uint32_t> expected = bruteForceDominators(*dump, tree);
+        for (uint32_t w = 0; w < n; w++) {
+            CHECK(tree.immediateDominator(w) == expected[w]);
+        }
+    }
+}
+
+static void testRejectsCorruptDumps() {
+    DumpBuilder builder;
+    builder.classes = {"Node"};
+    builder.add(0, 16);
+    builder.link(0, 7);
+
+    std::string error;
+    CHECK(!HeapDump::open(builder.write("out_of_range"), error));
+    CHECK(error.find("out of range") != std::string::npos);
+
+    std::ofstream("flexheap_test_garbage.flexheap") << "not a heap dump at all, just some text";
+    CHECK(!HeapDump::open("flexheap_test_garbage.flexheap", error));
+    CHECK(!HeapDump::open("flexheap_test_missing.flexheap", error));
+}
+
+int main() {
+    testDiamond();
+    testUnownedReferences();
+    testUnreachableCycle();
+    testDiff();
+    testRandomGraphsMatchBruteForce();
+    testRejectsCorruptDumps();
+
+    if (failures) {
+        std::fprintf(stderr, "%d checks failed\n", failures);
+        return EXIT_FAILURE;
+    }
+
+    std::puts("All flexheap tests passed");
+    return EXIT_SUCCESS;
+}